@@ -12,7 +12,7 @@
 #include <Arduino.h>
 #include "controller_config.h"                // includes boarddefs.h and controller_defines.h
 
-#include "SPIFFS.h"
+#include "file_system.h"
 #include <SPI.h>
 #include <WiFi.h>
 #include <WebServer.h>
@@ -74,6 +74,13 @@ extern ASCOM_SERVER *ascomsrvr;
 extern TEMP_PROBE *tempprobe;
 
 
+// ----------------------------------------------------------------------
+// SECOND FOCUSER, DEVICE 1
+// ----------------------------------------------------------------------
+#include "focuser_channel.h"
+extern FOCUSER_CHANNEL *focuser2;
+
+
 // ----------------------------------------------------------------------
 // EXTERNS
 // ----------------------------------------------------------------------
@@ -117,6 +124,7 @@ extern bool  filesystemloaded;                // flag indicator for webserver us
 
 // ASCOM CONST VARS
 #define ASCOMGUID                 "7e239e71-d304-4e7e-acda-3ff2e2b68515"
+#define ASCOMGUID1                "7e239e71-d304-4e7e-acda-3ff2e2b68516"
 #define ASCOMMAXIMUMARGS          10
 #define ASCOMSUCCESS              0
 #define ASCOMNOTIMPLEMENTED       0x400
@@ -131,6 +139,8 @@ extern bool  filesystemloaded;                // flag indicator for webserver us
 #define ASCOMDRIVERINFO           "\"myFP2ESP32 ALPACA SERVER (c) R. Brown. 2020-2022\""
 #define ASCOMMANAGEMENTINFO       "{\"ServerName\":\"myFP2ESP32\",\"Manufacturer\":\"R. Brown\",\"ManufacturerVersion\":\"v1.1\",\"Location\":\"New Zealand\"}"
 #define ASCOMNAME                 "\"myFP2ESPASCOMR\""
+#define ASCOMNAME1                "\"myFP2ESPASCOMR focuser 1\""
+#define ASCOMDEVICE1URL           "/api/v1/focuser/1/"
 #define ASCOMSERVERNOTFOUNDSTR    "<html><head><title>ASCOM ALPACA Server</title></head><body><p>File system not started</p><p><a href=\"/setup/v1/focuser/0/setup\">Setup page</a></p></body></html>"
 
 #define T_NOTIMPLEMENTED          "not implemented"
@@ -285,6 +295,12 @@ void ascomget_supportedactions()
   ascomsrvr->get_supportedactions();
 }
 
+// /api/v1/focuser/1/*
+void ascom_device1()
+{
+  ascomsrvr->device1();
+}
+
 
 // ----------------------------------------------------------------------
 // ASCOM ALPACA REMOTE SERVER CLASS
@@ -366,6 +382,19 @@ bool ASCOM_SERVER::start(void)
   _ascomserver->on("/api/v1/focuser/0/move",               HTTP_PUT, ascomset_move);
   _ascomserver->on("/api/v1/focuser/0/supportedactions",   HTTP_GET, ascomget_supportedactions);
 
+  // focuser 1, one handler for all the endpoints
+  if ( focuser2 != NULL )
+  {
+    const char *device1[] = { "connected", "interfaceversion", "name", "description", "driverinfo", "driverversion", \
+                              "absolute", "maxstep", "maxincrement", "temperature", "position", "halt", "ismoving", \
+                              "stepsize", "tempcomp", "tempcompavailable", "move", "supportedactions"
+                            };
+    for (unsigned int i = 0; i < (sizeof(device1) / sizeof(device1[0])); i++)
+    {
+      _ascomserver->on(String(ASCOMDEVICE1URL) + device1[i], ascom_device1);
+    }
+  }
+
   _ascomserver->onNotFound(ascomget_notfound);            // handle url not found 404
   _ascomserver->begin();
 
@@ -625,11 +654,11 @@ void ASCOM_SERVER::get_setup()
   ASCOM_println("ascomserver: get_setup()");
 
   // spiffs was started earlier when server was started so assume it has started
-  if ( SPIFFS.exists("/ascomhome.html"))
+  if ( FILESYS.exists("/ascomhome.html"))
   {
     ASCOM_println("ascomserver: requesting /ascomhome.html");
 
-    File file = SPIFFS.open("/ascomhome.html", "r");
+    File file = FILESYS.open("/ascomhome.html", "r");
     _ASpg = file.readString();
     file.close();
 
@@ -811,11 +840,11 @@ void ASCOM_SERVER::get_focusersetup()
   }
 
   // construct setup page of ascom server
-  if ( SPIFFS.exists("/ascomsetup.html"))
+  if ( FILESYS.exists("/ascomsetup.html"))
   {
     ASCOM_println("ascomserver: get /ascomsetup.html");
 
-    File file = SPIFFS.open("/ascomsetup.html", "r");
+    File file = FILESYS.open("/ascomsetup.html", "r");
     _ASpg = file.readString();
     file.close();
 
@@ -1128,7 +1157,12 @@ void ASCOM_SERVER::get_man_configureddevices()
   _ASCOMErrorMessage = "";
   getURLParameters();
   // addclientinfo adds clientid, clienttransactionid, servertransactionid, errornumber, errormessage and terminating }
-  jsonretstr = "{\"Value\":[{\"DeviceName\":" + String(ASCOMNAME) + ",\"DeviceType\":\"focuser\",\"DeviceNumber\":0,\"UniqueID\":\"" + String(ASCOMGUID) + "\"}]," + addclientinfo( jsonretstr );
+  jsonretstr = "{\"Value\":[{\"DeviceName\":" + String(ASCOMNAME) + ",\"DeviceType\":\"focuser\",\"DeviceNumber\":0,\"UniqueID\":\"" + String(ASCOMGUID) + "\"}";
+  if ( focuser2 != NULL )
+  {
+    jsonretstr = jsonretstr + ",{\"DeviceName\":" + String(ASCOMNAME1) + ",\"DeviceType\":\"focuser\",\"DeviceNumber\":1,\"UniqueID\":\"" + String(ASCOMGUID1) + "\"}";
+  }
+  jsonretstr = jsonretstr + "]," + addclientinfo( "" );
 
   // sendreply builds http header, sets content type, and then sends jsonretstr
   sendreply( NORMALWEBPAGE, JSONPAGETYPE, jsonretstr);
@@ -1578,6 +1612,131 @@ void ASCOM_SERVER::get_supportedactions()
   sendreply( NORMALWEBPAGE, JSONPAGETYPE, jsonretstr);
 }
 
+// ----------------------------------------------------------------------
+// FOCUSER 1
+// the second focuser, the endpoint is the last part of the uri. It has no
+// temperature compensation and shares the temperature probe of focuser 0
+// ----------------------------------------------------------------------
+void ASCOM_SERVER::device1()
+{
+  String jsonretstr = "";
+  String endpoint = _ascomserver->uri().substring(strlen(ASCOMDEVICE1URL));
+  bool   put = (_ascomserver->method() == HTTP_PUT);
+
+  _ASCOMServerTransactionID++;
+  _ASCOMErrorNumber = 0;
+  _ASCOMErrorMessage = "";
+  // getURLParameters() sets the connected and tempcomp state of focuser 0
+  byte connected = _ASCOMConnectedState;
+  byte tempcomp = _ASCOMTempCompState;
+  getURLParameters();
+  if ( (put == true) && (endpoint == "connected") )
+  {
+    _ASCOMConnectedState1 = _ASCOMConnectedState;
+  }
+  _ASCOMConnectedState = connected;
+  _ASCOMTempCompState = tempcomp;
+
+  String value = "";
+  if ( put == true )
+  {
+    if ( endpoint == "move" )
+    {
+      if ( focuser2->move(_ASCOMpos) == false )
+      {
+        _ASCOMErrorNumber = ASCOMINVALIDOPERATION;
+        _ASCOMErrorMessage = "focuser is moving";
+      }
+    }
+    else if ( endpoint == "halt" )
+    {
+      focuser2->halt();
+    }
+    else if ( endpoint == "tempcomp" )
+    {
+      _ASCOMErrorNumber = ASCOMNOTIMPLEMENTED;
+      _ASCOMErrorMessage = T_NOTIMPLEMENTED;
+    }
+    else if ( endpoint != "connected" )
+    {
+      _ASCOMErrorNumber = ASCOMINVALIDOPERATION;
+      _ASCOMErrorMessage = "get only";
+    }
+  }
+  else if ( endpoint == "position" )
+  {
+    value = String(focuser2->get_position());
+  }
+  else if ( endpoint == "ismoving" )
+  {
+    value = (focuser2->get_ismoving() == true) ? "true" : "false";
+  }
+  else if ( (endpoint == "maxstep") || (endpoint == "maxincrement") )
+  {
+    value = String(focuser2->get_maxstep());
+  }
+  else if ( endpoint == "connected" )
+  {
+    value = (_ASCOMConnectedState1 == 0) ? "false" : "true";
+  }
+  else if ( endpoint == "temperature" )
+  {
+    value = String(temp, 2);
+  }
+  else if ( endpoint == "absolute" )
+  {
+    value = "true";
+  }
+  else if ( (endpoint == "tempcomp") || (endpoint == "tempcompavailable") )
+  {
+    value = "false";
+  }
+  else if ( endpoint == "interfaceversion" )
+  {
+    value = "2";
+  }
+  else if ( endpoint == "name" )
+  {
+    value = ASCOMNAME1;
+  }
+  else if ( endpoint == "description" )
+  {
+    value = ASCOMDESCRIPTION;
+  }
+  else if ( endpoint == "driverinfo" )
+  {
+    value = ASCOMDRIVERINFO;
+  }
+  else if ( endpoint == "driverversion" )
+  {
+    value = "\"" + String(program_version) + "\"";
+  }
+  else if ( endpoint == "supportedactions" )
+  {
+    value = "[]";
+  }
+  else
+  {
+    // stepsize
+    _ASCOMErrorNumber = ASCOMNOTIMPLEMENTED;
+    _ASCOMErrorMessage = T_NOTIMPLEMENTED;
+  }
+
+  if ( value != "" )
+  {
+    jsonretstr = "{\"value\":" + value + ",";
+  }
+  else
+  {
+    jsonretstr = "{";
+  }
+  // addclientinfo adds clientid, clienttransactionid, servertransactionid, errornumber, errormessage and terminating }
+  jsonretstr = addclientinfo( jsonretstr );
+
+  // sendreply builds http header, sets content type, and then sends jsonretstr
+  sendreply( NORMALWEBPAGE, JSONPAGETYPE, jsonretstr);
+}
+
 void ASCOM_SERVER::get_notfound()
 {
   String message = T_NOTFOUND;
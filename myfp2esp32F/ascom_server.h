@@ -65,6 +65,7 @@ class ASCOM_SERVER
     void get_tempcompavailable(void);
     void set_move(void);
     void get_supportedactions(void);
+    void device1(void);                   // all endpoints of focuser 1
        
   private:
     void notloaded(void);   
@@ -85,6 +86,7 @@ class ASCOM_SERVER
     long          _ASCOMpos = 0L;
     byte          _ASCOMTempCompState = 0;
     byte          _ASCOMConnectedState = 0;
+    byte          _ASCOMConnectedState1 = 0;        // focuser 1
 };
 
 #endif // ifndef _ascom_server_h
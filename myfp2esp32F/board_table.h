@@ -0,0 +1,93 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 BOARD DEFINITION TABLE
+// © Copyright Robert Brown 2014-2022. All Rights Reserved.
+// board_table.h
+// ----------------------------------------------------------------------
+// GENERATED by tools/make_board_table.py from data/boards/*.jsn
+// DO NOT EDIT, change the board file and run the script again
+// ----------------------------------------------------------------------
+
+#if !defined(_board_table_h_)
+#define _board_table_h_
+
+
+// ----------------------------------------------------------------------
+// BOARD DESCRIPTOR
+// ----------------------------------------------------------------------
+// json is the original board file, a /boards/xx.jsn file which is the
+// same is not parsed, a file which differs overrides the table entry
+struct board_desc
+{
+  int brdnum;
+  const char *board;
+  int maxstepmode;
+  int stepmode;
+  int enpin;
+  int steppin;
+  int dirpin;
+  int temppin;
+  int hpswpin;
+  int inledpin;
+  int outledpin;
+  int pb1pin;
+  int pb2pin;
+  int irpin;
+  int stepsrev;
+  int fixedsmode;
+  int brdpins[4];
+  unsigned long msdelay;
+  const char *json;
+};
+
+
+// ----------------------------------------------------------------------
+// BOARD TABLE
+// ----------------------------------------------------------------------
+constexpr board_desc board_table[] =
+{
+  // 44.jsn
+  { 44, "PRO2ESP32DRV8825", 32, 1, 14, 33, 32, 13, 4, 18, 19, 34, 35, 15, -1, -1, { 27, 26, 25, -1 }, 4000,
+    "{ \"board\":\"PRO2ESP32DRV8825\",\"maxstepmode\":32,\"stepmode\":1,\"enpin\":14,\"steppin\":33,\"dirpin\":32,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":44,\"stepsrev\":-1,\"fixedsmode\":-1,\"brdpins\":[27,26,25,-1],\"msdelay\":4000 }" },
+  // 45.jsn
+  { 45, "PRO2ESP32ULN2003", 2, 1, -1, -1, -1, 13, 4, 18, 19, 34, 35, 15, 2048, -1, { 25, 27, 14, 26 }, 8000,
+    "{ \"board\":\"PRO2ESP32ULN2003\",\"maxstepmode\":2,\"stepmode\":1,\"enpin\":-1,\"steppin\":-1,\"dirpin\":-1,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":45,\"stepsrev\":2048,\"fixedsmode\":-1,\"brdpins\":[25,27,14,26],\"msdelay\":8000 }\n" },
+  // 46.jsn
+  { 46, "PRO2ESP32L298N", 2, 1, -1, -1, -1, 13, 4, 18, 19, 34, 35, 15, 2048, -1, { 14, 27, 26, 25 }, 8000,
+    "{ \"board\":\"PRO2ESP32L298N\",\"maxstepmode\":2,\"stepmode\":1,\"enpin\":-1,\"steppin\":-1,\"dirpin\":-1,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":46,\"stepsrev\":2048,\"fixedsmode\":-1,\"brdpins\":[14,27,26,25],\"msdelay\":8000 }" },
+  // 47.jsn
+  { 47, "PRO2ESP32L293DMINI", 2, 1, -1, -1, -1, 13, 4, 18, 19, 34, 35, 15, 2048, -1, { 14, 27, 26, 25 }, 8000,
+    "{ \"board\":\"PRO2ESP32L293DMINI\",\"maxstepmode\":2,\"stepmode\":1,\"enpin\":-1,\"steppin\":-1,\"dirpin\":-1,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":47,\"stepsrev\":2048,\"fixedsmode\":-1,\"brdpins\":[14,27,26,25],\"msdelay\":8000 }" },
+  // 48.jsn
+  { 48, "PRO2ESP32L9110S", 2, 1, -1, -1, -1, 13, 4, 18, 19, 34, 35, 15, 2048, -1, { 14, 27, 26, 25 }, 8000,
+    "{ \"board\":\"PRO2ESP32L9110S\",\"maxstepmode\":2,\"stepmode\":1,\"enpin\":-1,\"steppin\":-1,\"dirpin\":-1,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":48,\"stepsrev\":2048,\"fixedsmode\":-1,\"brdpins\":[14,27,26,25],\"msdelay\":8000 }" },
+  // 49.jsn
+  { 49, "PRO2ESP32R3WEMOS", 32, 1, 14, 27, 26, 13, -1, -1, -1, -1, -1, -1, -1, 1, { -1, -1, -1, -1 }, 8000,
+    "{ \"board\":\"PRO2ESP32R3WEMOS\",\"maxstepmode\":32,\"stepmode\":1,\"enpin\":14,\"steppin\":27,\"dirpin\":26,\"temppin\":13,\"hpswpin\":-1,\"inledpin\":-1,\"outledpin\":-1,\"pb1pin\":-1,\"pb2pin\":-1,\"irpin\":-1,\"brdnum\":49,\"stepsrev\":-1,\"fixedsmode\":1,\"brdpins\":[-1,-1,-1,-1],\"msdelay\":8000 }" },
+  // 56.jsn
+  { 56, "PRO2ESP32TMC2225", 256, 4, 14, 33, 32, 13, 4, 18, 19, 34, 35, 15, -1, -1, { 27, 26, -1, -1 }, 4000,
+    "{ \"board\":\"PRO2ESP32TMC2225\",\"maxstepmode\":256,\"stepmode\":4,\"enpin\":14,\"steppin\":33,\"dirpin\":32,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":56,\"stepsrev\":-1,\"fixedsmode\":-1,\"brdpins\":[27,26,-1,-1],\"msdelay\":4000 }\n" },
+  // 57.jsn
+  { 57, "PRO2ES32PTMC2209", 256, 4, 14, 33, 32, 13, 4, 18, 19, 34, 35, 15, -1, -1, { 27, 26, 4, -1 }, 1200,
+    "{ \"board\":\"PRO2ES32PTMC2209\",\"maxstepmode\":256,\"stepmode\":4,\"enpin\":14,\"steppin\":33,\"dirpin\":32,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":57,\"stepsrev\":-1,\"fixedsmode\":-1,\"brdpins\":[27,26,4,-1],\"msdelay\":1200 }\n" },
+  // 58.jsn
+  { 58, "PRO2ESP32TMC2209P", 256, 4, 14, 33, 32, 13, 4, 18, 19, 34, 35, 15, -1, -1, { 27, 26, 4, -1 }, 1200,
+    "{ \"board\":\"PRO2ESP32TMC2209P\",\"maxstepmode\":256,\"stepmode\":4,\"enpin\":14,\"steppin\":33,\"dirpin\":32,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":58,\"stepsrev\":-1,\"fixedsmode\":-1,\"brdpins\":[27,26,4,-1],\"msdelay\":1200 }\n" },
+  // 59.jsn
+  { 59, "PRO2ESP32ST6128", 256, 4, 27, 25, 26, 13, 4, 18, 19, 34, 35, 15, -1, -1, { -1, -1, -1, -1 }, 1200,
+    "{ \"board\":\"PRO2ESP32ST6128\",\"maxstepmode\":256,\"stepmode\":4,\"enpin\":27,\"steppin\":25,\"dirpin\":26,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":59,\"stepsrev\":-1,\"fixedsmode\":-1,\"brdpins\":[-1,-1,-1,-1],\"msdelay\":1200 }\n" },
+  // 99.jsn
+  { 99, "CUSTOM", 32, 1, 14, 33, 32, 13, 4, 18, 19, 34, 35, 15, -1, -1, { 27, 26, 25, -1 }, 4000,
+    "{ \"board\":\"CUSTOM\",\"maxstepmode\":32,\"stepmode\":1,\"enpin\":14,\"steppin\":33,\"dirpin\":32,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":99,\"stepsrev\":-1,\"fixedsmode\":-1,\"brdpins\":[27,26,25,-1],\"msdelay\":4000 }" },
+};
+
+constexpr int board_table_size = sizeof(board_table) / sizeof(board_table[0]);
+
+// index of brdnum in board_table, -1 if not found
+constexpr int board_table_index(int brdnum, int i = 0)
+{
+  return (i >= board_table_size) ? -1 : ((board_table[i].brdnum == brdnum) ? i : board_table_index(brdnum, i + 1));
+}
+
+
+
+#endif // #if !defined(_board_table_h_)
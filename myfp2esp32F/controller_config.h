@@ -133,6 +133,25 @@
 #define ENABLE_READWIFICONFIG   1
 
 
+// ----------------------------------------------------------------------
+// FILE SYSTEM
+// ----------------------------------------------------------------------
+// The data folder is uploaded to the file system selected here. SPIFFS and
+// LittleFS use the same flash partition, use the matching upload tool.
+// FS_MEMORY holds files in RAM, nothing is kept after a reboot
+#define FILESYSTEM  FS_SPIFFS
+//#define FILESYSTEM  FS_LITTLEFS
+//#define FILESYSTEM  FS_MEMORY
+
+
+// ----------------------------------------------------------------------
+// POWER SAVE
+// ----------------------------------------------------------------------
+// When parked and idle the cpu clock is reduced to 80MHz and WiFi modem
+// sleep is allowed. Can be changed in the Management Server
+//#define ENABLE_POWERSAVE  1
+
+
 // -----------------------------------------------------------------------
 // OTA UPDATE (OVER THE AIR UPDATE)
 // If not using OTA, go to DUCKDNS
@@ -145,13 +164,23 @@
 
 // -----------------------------------------------------------------------
 // DUCKDNS
-// If not using DuckDNS, goto TMC2209
+// If not using DuckDNS, goto SECOND FOCUSER
 // Settings for DUCKDNS are in defines/duckdns_defines.h
 // -----------------------------------------------------------------------
 // Cannot use DuckDNS with ACCESSPOINT
 //#define ENABLE_DUCKDNS 	1
 
 
+// ----------------------------------------------------------------------
+// SECOND FOCUSER
+// If not using a second focuser, goto TMC2209
+// Settings for the SECOND FOCUSER are in defines/focuser2_defines.h
+// ----------------------------------------------------------------------
+// A second step/dir driver board on its own pins, moved with tcp/ip
+// commands :@1xx# and as ASCOM Alpaca focuser device 1
+//#define ENABLE_FOCUSER2   1
+
+
 // ----------------------------------------------------------------------
 // TMC2209 HOME POSITION SWITCH OPTIONS
 // If not using the TMC2209 driver chip, then this part is finished
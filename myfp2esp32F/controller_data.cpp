@@ -11,13 +11,17 @@
 #include <Arduino.h>
 #include "controller_config.h"                // includes boarddefs.h and controller_defines.h
 #include <ArduinoJson.h>
-#include "SPIFFS.h"
+#include "file_system.h"
+#include "board_table.h"                      // board definitions generated from data/boards
+#include "task_scheduler.h"
+#include <rom/crc.h>                          // crc32_le() for the binary config images
 
 // DEFAULT CONFIGURATION
 // ControllerData
-// Controller Persistant Data  cntlr_config.jsn
-// Controller Variable Data    cntlr_var.jsn
-// Controller Board Data       board_config.jsn
+// Controller Persistant Data  cntlr_config.bin
+// Controller Operational Data cntlr_oper.bin
+// Controller Variable Data    cntlr_var.bin
+// Controller Board Data       board_config.bin
 
 
 // -----------------------------------------------------------------------
@@ -82,16 +86,10 @@ extern enum Display_Types displaytype;
 extern bool isMoving;
 extern bool filesystemloaded;                     // flag indicator for file usage, rather than use SPIFFS.begin() test
 
-// task timer
-extern volatile int save_var_flag;
-extern volatile int save_board_flag;
-extern volatile int save_cntlr_flag;
-extern portMUX_TYPE varMux;
-extern portMUX_TYPE boardMux;
-extern portMUX_TYPE cntlrMux;
-
-extern unsigned int display_maxcount;
-extern portMUX_TYPE displaytimeMux;
+// task scheduler
+extern TASK_SCHEDULER *tasksched;
+extern int job_display;
+extern int job_park;
 
 
 // ----------------------------------------------------------------------
@@ -109,6 +107,227 @@ extern portMUX_TYPE displaytimeMux;
 #define DEFAULTPOSITION     5000L
 #define DEFAULTMAXSTEPS     80000L
 
+// delayed saves which have expired, CONTROLLER_DATA::_save_due
+#define SAVEDUE_VAR         0x01
+#define SAVEDUE_CNTLR       0x02
+#define SAVEDUE_BOARD       0x04
+
+
+// ----------------------------------------------------------------------
+// BINARY CONFIGURATION IMAGES
+// ----------------------------------------------------------------------
+// The controller, board and var data are each saved as a binary image,
+// a header followed by a packed payload struct, and loaded with a single
+// file read. The header holds the image id, the schema version of the
+// payload, a field presence bitmap (bit n = field n of the payload) and
+// a crc32 of the payload.
+// New fields are only ever appended to the end of a payload and given
+// the next field number, the schema version does not change. An image
+// written by older firmware is shorter, the new fields are not flagged
+// as present and keep their default values. The schema version is only
+// bumped when an existing field changes size or meaning, see MigrateImage()
+#define CFGIMAGE_MAGIC      0x32504643            // "CFP2"
+#define CFGIMAGE_MAXSIZE    1024                  // largest payload accepted by ReadImage()
+#define CFGIMAGE_CNTLR      1                     // image id's
+#define CFGIMAGE_BOARD      2
+#define CFGIMAGE_VAR        3
+#define CFGIMAGE_OPER       4
+#define CNTLRIMAGE_VERSION  1                     // current schema versions
+#define BOARDIMAGE_VERSION  1
+#define VARIMAGE_VERSION    1
+#define OPERIMAGE_VERSION   1
+#define CFGIMAGE_IDS        5                     // size of the save counters, indexed by image id
+#define CFGIMAGE_FIELD(f)   (1ULL << (f))         // field bit in a presence or dirty bitmap
+
+struct cfgimage_header
+{
+  uint32_t magic;
+  uint8_t  id;
+  uint8_t  version;
+  uint16_t length;                                // payload length in bytes
+  uint32_t present[2];                            // field presence bitmap
+  uint32_t crc;                                   // crc32 of payload
+} __attribute__((packed));
+
+// cntlr_config.bin, field numbers and payload
+enum cntlr_image_fields { cf_maxstep, cf_preset, cf_ascom_en, cf_ascom_port, cf_mngt_en, cf_mngt_port,
+                          cf_tcp_en, cf_tcp_port, cf_ws_en, cf_ws_port, cf_ddns_en, cf_ddns_d, cf_ddns_t,
+                          cf_ddns_r, cf_ota_name, cf_ota_pwd, cf_ota_id, cf_d_en, cf_d_pgtime, cf_d_pgopt,
+                          cf_d_updmove, cf_hpsw_en, cf_hpswmsg_en, cf_stall_st, cf_stall_val, cf_tmc2225mA,
+                          cf_tmc2209mA, cf_led_en, cf_led_mode, cf_joy1_en, cf_joy2_en, cf_pb_en, cf_pb_steps,
+                          cf_t_en, cf_t_comp_en, cf_t_mod, cf_t_coe, cf_t_res, cf_t_tcdir, cf_t_tcavail,
+                          cf_blin_en, cf_blout_en, cf_blin_steps, cf_blout_steps, cf_cp_en, cf_dam_en,
+                          cf_dam_time, cf_devname, cf_filelist, cf_mspeed, cf_park_en, cf_park_time,
+                          cf_rdir_en, cf_ss_en, cf_ss_val, cf_ticol, cf_scol, cf_hcol, cf_tcol, cf_bcol,
+                          cf_count
+                        };
+
+struct cntlr_image
+{
+  int32_t  maxstep;
+  int32_t  preset[10];
+  uint8_t  ascom_en;
+  uint32_t ascom_port;
+  uint8_t  mngt_en;
+  uint32_t mngt_port;
+  uint8_t  tcp_en;
+  uint32_t tcp_port;
+  uint8_t  ws_en;
+  uint32_t ws_port;
+  uint8_t  ddns_en;
+  char     ddns_d[64];
+  char     ddns_t[48];
+  uint32_t ddns_r;
+  char     ota_name[32];
+  char     ota_pwd[32];
+  char     ota_id[32];
+  uint8_t  d_en;
+  int32_t  d_pgtime;
+  char     d_pgopt[12];
+  uint8_t  d_updmove;
+  uint8_t  hpsw_en;
+  uint8_t  hpswmsg_en;
+  uint8_t  stall_st;
+  uint8_t  stall_val;
+  int32_t  tmc2225mA;
+  int32_t  tmc2209mA;
+  uint8_t  led_en;
+  uint8_t  led_mode;
+  uint8_t  joy1_en;
+  uint8_t  joy2_en;
+  uint8_t  pb_en;
+  int32_t  pb_steps;
+  uint8_t  t_en;
+  uint8_t  t_comp_en;
+  uint8_t  t_mod;
+  int32_t  t_coe;
+  uint8_t  t_res;
+  uint8_t  t_tcdir;
+  uint8_t  t_tcavail;
+  uint8_t  blin_en;
+  uint8_t  blout_en;
+  uint8_t  blin_steps;
+  uint8_t  blout_steps;
+  uint8_t  cp_en;
+  uint8_t  dam_en;
+  uint8_t  dam_time;
+  char     devname[32];
+  uint8_t  filelist;
+  uint8_t  mspeed;
+  uint8_t  park_en;
+  int32_t  park_time;
+  uint8_t  rdir_en;
+  uint8_t  ss_en;
+  float    ss_val;
+  char     ticol[8];
+  char     scol[8];
+  char     hcol[8];
+  char     tcol[8];
+  char     bcol[8];
+} __attribute__((packed));
+
+// The controller settings are split in two sections. Settings which are
+// changed during a session (presets, temp comp state, motor speed, coil
+// power) are hot and saved to cntlr_oper.bin, everything else (identity,
+// network, services, web colors) is cold and stays in cntlr_config.bin.
+// The cold image keeps the cntlr_image layout, its hot fields are not
+// flagged as present. A cntlr_config.bin written before the split has all
+// fields present, cntlr_oper.bin (if found) then overrides the hot fields
+#define CNTLR_HOTFIELDS     ( CFGIMAGE_FIELD(cf_preset) | CFGIMAGE_FIELD(cf_t_comp_en) | CFGIMAGE_FIELD(cf_t_tcdir) \
+                              | CFGIMAGE_FIELD(cf_mspeed) | CFGIMAGE_FIELD(cf_cp_en) )
+
+// cntlr_oper.bin, field numbers and payload
+enum oper_image_fields { of_preset, of_t_comp_en, of_t_tcdir, of_mspeed, of_cp_en, of_count };
+
+struct oper_image
+{
+  int32_t  preset[10];
+  uint8_t  t_comp_en;
+  uint8_t  t_tcdir;
+  uint8_t  mspeed;
+  uint8_t  cp_en;
+} __attribute__((packed));
+
+// board_config.bin, field numbers and payload
+enum board_image_fields { bf_board, bf_maxstepmode, bf_stepmode, bf_enpin, bf_steppin, bf_dirpin, bf_temppin,
+                          bf_hpswpin, bf_inledpin, bf_outledpin, bf_pb1pin, bf_pb2pin, bf_irpin, bf_brdnum,
+                          bf_stepsrev, bf_fixedsmode, bf_brdpins, bf_msdelay, bf_count
+                        };
+
+struct board_image
+{
+  char     board[32];
+  int32_t  maxstepmode;
+  int32_t  stepmode;
+  int32_t  enpin;
+  int32_t  steppin;
+  int32_t  dirpin;
+  int32_t  temppin;
+  int32_t  hpswpin;
+  int32_t  inledpin;
+  int32_t  outledpin;
+  int32_t  pb1pin;
+  int32_t  pb2pin;
+  int32_t  irpin;
+  int32_t  brdnum;
+  int32_t  stepsrev;
+  int32_t  fixedsmode;
+  int32_t  brdpins[4];
+  uint32_t msdelay;
+} __attribute__((packed));
+
+// cntlr_var.bin, field numbers and payload
+enum var_image_fields { vf_fpos, vf_fdir, vf_count };
+
+struct var_image
+{
+  int32_t  fpos;
+  uint8_t  fdir;
+} __attribute__((packed));
+
+// true if field is flagged as present in the image
+static inline bool image_has(const uint32_t *present, byte field)
+{
+  return (present[field >> 5] >> (field & 31)) & 1;
+}
+
+// bitmap with the first fields bits set
+static inline uint64_t image_fieldmask(byte fields)
+{
+  return (fields >= 64) ? 0xFFFFFFFFFFFFFFFFULL : (CFGIMAGE_FIELD(fields) - 1);
+}
+
+// copy a field from an image payload, if it is present
+template <typename T, typename S>
+static void image_get(const uint32_t *present, byte field, T &dst, S src)
+{
+  if ( image_has(present, field) )
+  {
+    dst = (T) src;
+  }
+}
+
+// copy a string into a fixed size image field, always null terminated
+static void image_putstr(char *dst, const String &src, size_t len)
+{
+  strlcpy(dst, src.c_str(), len);
+}
+
+// copy a json string value, a missing key keeps the current value
+static void json_getstr(const char *src, String &dst)
+{
+  if ( src != NULL )
+  {
+    dst = src;
+  }
+}
+
+// range check an imported json value
+static long json_range(long value, long lo, long hi)
+{
+  return (value < lo) ? lo : ((value > hi) ? hi : value);
+}
+
 
 // ----------------------------------------------------------------------
 // CONTROLLER_DATA CLASS
@@ -116,16 +335,18 @@ extern portMUX_TYPE displaytimeMux;
 CONTROLLER_DATA::CONTROLLER_DATA(void)
 {
   CNTLRDATA_println("CONTROLLER_DATA::CONTROLLER_DATA");
-  // task timer has not started yet, so this is safe
-  save_var_flag   = -1;
-  save_board_flag = -1;
-  save_cntlr_flag = -1;
+  // delayed saves, a job is armed by a change and the save is done by
+  // SaveConfiguration() once the job has expired and the focuser is not moving
+  this->_save_due  = 0;
+  this->_job_var   = tasksched->add("savevar", SaveVarDue, DEFAULTSAVETIME, SCHED_ONESHOT);
+  this->_job_cntlr = tasksched->add("savecntlr", SaveCntlrDue, DEFAULTSAVETIME, SCHED_ONESHOT);
+  this->_job_board = tasksched->add("saveboard", SaveBoardDue, DEFAULTSAVETIME, SCHED_ONESHOT);
 
   // mount SPIFFS
-  if (!SPIFFS.begin())
+  if (!FILESYS.begin())
   {
     ERROR_println("cd: FS start error, formatting..");
-    SPIFFS.format();
+    FILESYS.format();
     filesystemloaded = false;
   }
   else
@@ -138,243 +359,707 @@ CONTROLLER_DATA::CONTROLLER_DATA(void)
 
 // ----------------------------------------------------------------------
 // Loads the configuration from files (cntlr, board, var)
-// If configuration files are not found, or cannot be deserialised, then
-// create Default Configurations for each
+// Each set is loaded from its binary image. If an image is not found or
+// fails its checks, the legacy json file is imported and written back as
+// a binary image. If neither can be loaded, then create Default
+// Configurations for each
 // ----------------------------------------------------------------------
 bool CONTROLLER_DATA::LoadConfiguration()
 {
+  unsigned long loadstart = micros();
+  byte binary = 0;
+  byte json = 0;
+
   CNTLRDATA_println("cd: LoadConfiguration() start");
   // LOAD CONTROLLER PERSISTANT DATA
   CNTLRDATA_print("cd: LoadConfiguration: CONTROLLER: ");
   CNTLRDATA_println(file_cntlr_config);
-
-  // Focuser persistant data - Open cntlr_config.jsn file for reading
-  if ( SPIFFS.exists(file_cntlr_config) == false )
+  if ( LoadCntlrImage() == true )
   {
-    CNTLRDATA_println("cd: cntlr_config.jsn file not found, create default config file");
-    LoadDefaultPersistantData();
+    CNTLRDATA_println("cd: cntlr_config.bin loaded OK");
+    binary++;
   }
-  else
+  else if ( LoadCntlrJsonFile(file_cntlr_json) == true )
   {
-    // file exists so open it
-    File cfile = SPIFFS.open(file_cntlr_config, "r");
-    String cdata;                                 // cntlr_config.jsn controller persistant data
-    cdata.reserve(2400);                          // Controller data, ArduinoJson Assistant 1699, 2048
-
-    cdata = cfile.readString();
-    cfile.close();
-    CNTLRDATA_print("cd: data: ");
-    CNTLRDATA_println(cdata);
-
-    // Allocate a temporary JsonDocument
-    DynamicJsonDocument doc_per(DEFAULTDOCSIZE);
-
-    // Deserialize the JSON document
-    DeserializationError error = deserializeJson(doc_per, cdata);
-    if ( error )
-    {
-      ERROR_println("cd: deserialise error. Create default cntlr config");
-      LoadDefaultPersistantData();
-    }
-    else
+    CNTLRDATA_println("cd: cntlr_config.jsn imported, create cntlr_config.bin");
+    json++;
+    this->_cntlr_dirty = image_fieldmask(cf_count);
+    if ( SavePersitantConfiguration() == true )
     {
-      // maxstep
-      this->maxstep = doc_per["maxstep"];
-      // presets
-      for (int i = 0; i < 10; i++)
-      {
-        this->focuserpreset[i] = doc_per["preset"][i];
-      }
-      // SERVERS - SERVICES
-      this->ascomsrvr_enable  = doc_per["ascom_en"];
-      this->ascomsrvr_port    = doc_per["ascom_port"];
-      this->mngsrvr_enable    = doc_per["mngt_en"];
-      this->mngsrvr_port      = doc_per["mngt_port"];
-      this->tcpipsrvr_enable  = doc_per["tcp_en"];
-      this->tcpipsrvr_port    = doc_per["tcp_port"];
-      this->websrvr_enable    = doc_per["ws_en"];
-      this->websrvr_port      = doc_per["ws_port"];
-      this->duckdns_enable    = doc_per["ddns_en"];
-      this->duckdns_domain    = doc_per["ddns_d"].as<const char*>();
-      this->duckdns_token     = doc_per["ddns_t"].as<const char*>();
-      this->duckdns_refreshtime = doc_per["ddns_r"];
-      this->ota_name          = doc_per["ota_name"].as<const char*>();
-      this->ota_password      = doc_per["ota_pwd"].as<const char*>();
-      this->ota_id            = doc_per["ota_id"].as<const char*>();
-      // DEVICES
-      // display
-      this->display_enable    = doc_per["d_en"];
-      this->displaypagetime   = doc_per["d_pgtime"];
-      this->displaypageoption = doc_per["d_pgopt"].as<const char*>();
-      this->displayupdateonmove = doc_per["d_updmove"];          // update position on display when moving
-      // hpsw
-      this->hpswitch_enable   = doc_per["hpsw_en"];
-      this->hpswmsg_enable    = doc_per["hpswmsg_en"];
-      this->stallguard_state  = doc_per["stall_st"];
-      this->stallguard_value  = doc_per["stall_val"];
-      this->tmc2225current    = doc_per["tmc2225mA"];
-      this->tmc2209current    = doc_per["tmc2209mA"];
-      // leds
-      this->inoutled_enable   = doc_per["led_en"];
-      this->inoutledmode      = doc_per["led_mode"];
-      // joysticks
-      this->joystick1_enable  = doc_per["joy1_en"];
-      this->joystick2_enable  = doc_per["joy2_en"];
-      // pushbuttons
-      this->pushbutton_enable = doc_per["pb_en"];
-      this->pushbutton_steps  = doc_per["pb_steps"];
-      // temperature probe
-      this->tempprobe_enable  = doc_per["t_en"];
-      this->tempcomp_enable   = doc_per["t_comp_en"];       // indicates if temperature compensation is enabled
-      this->tempmode          = doc_per["t_mod"];           // temperature display mode, Celcius=1, Fahrenheit=0
-      this->tempcoefficient   = doc_per["t_coe"];           // steps per degree temperature coefficient value
-      this->tempresolution    = doc_per["t_res"];           // 9 - 12
-      this->tcdirection       = doc_per["t_tcdir"];
-      this->tcavailable       = doc_per["t_tcavail"];
-      // backlash
-      this->backlash_in_enable  = doc_per["blin_en"];
-      this->backlash_out_enable = doc_per["blout_en"];
-      this->backlashsteps_in  = doc_per["blin_steps"];        // number of backlash steps to apply for IN moves
-      this->backlashsteps_out = doc_per["blout_steps"];
-      // coil power
-      this->coilpower_enable  = doc_per["cp_en"];
-      // delay after move
-      this->delayaftermove_enable = doc_per["dam-en"];
-      this->delayaftermove_time = doc_per["dam_time"];
-      // devicename
-      this->devicename      = doc_per["devname"].as<const char*>();
-      // file list format
-      this->filelistformat  = doc_per["filelist"];
-      // motorspeed
-      this->motorspeed      = doc_per["mspeed"];              // motorspeed slow, med, fast
-      // park
-      this->park_enable     = doc_per["park_en"];
-      this->park_time       = doc_per["park_time"];
-      // reverse
-      this->reverse_enable  = doc_per["rdir_en"];
-      // stepsize
-      this->stepsize_enable = doc_per["ss_en"];               // if 1, controller returns step size
-      this->stepsize        = doc_per["ss_val"];              // the step size in microns, ie 7.2 - value * 10, so real stepsize = stepsize / 10 (maxval = 25.6)
-      // web page colors
-      this->titlecolor  = doc_per["ticol"].as<const char*>();
-      this->subtitlecolor = doc_per["scol"].as<const char*>();
-      this->headercolor = doc_per["hcol"].as<const char*>();
-      this->textcolor   = doc_per["tcol"].as<const char*>();
-      this->backcolor   = doc_per["bcol"].as<const char*>();
-
-      CNTLRDATA_println("cd: cntlr_config.jsn loaded OK");
+      FILESYS.remove(file_cntlr_json);
     }
   }
+  else
+  {
+    CNTLRDATA_println("cd: cntlr config file not found, create default config file");
+    LoadDefaultPersistantData();
+  }
 
   // LOAD CONTROLLER BOARD DATA
   CNTLRDATA_println("cd: LoadConfiguration(): BOARD");
-  if ( SPIFFS.exists(file_board_config) == false )
+  if ( LoadBoardImage() == true )
   {
-    CNTLRDATA_println("cd: board_config.jsn file not found, create default board config file");
-    LoadDefaultBoardData();
+    CNTLRDATA_println("cd: board_config.bin loaded OK");
+    binary++;
   }
-  else
+  else if ( LoadBoardJsonFile(file_board_json) == true )
   {
-    // file exists so open it
-    File bfile = SPIFFS.open(file_board_config, "r");
-    String bdata;                                 // board_config.jsn board data
-    bdata.reserve(1024);                          // Board data, ArduinoJson Assistant 384
-
-    bdata = bfile.readString();
-    bfile.close();
-    CNTLRDATA_print("cd: data: ");
-    CNTLRDATA_println(bdata);
-
-    // Allocate a temporary JsonDocument
-    DynamicJsonDocument doc_brd(DEFAULTBOARDSIZE);
-
-    // Deserialize the JSON document
-    DeserializationError error = deserializeJson(doc_brd, bdata);
-    if ( error )
+    CNTLRDATA_println("cd: board_config.jsn imported, create board_config.bin");
+    json++;
+    if ( SaveBoardConfiguration() == true )
     {
-      ERROR_println("cd: deserialise error, create default board file");
-      LoadDefaultBoardData();
-    }
-    else
-    {
-      /*
-        { "board":"PRO2ESP32DRV8825","maxstepmode":32,"stepmode":1,"enpin":14,"steppin":33,
-        "dirpin":32,"temppin":13,"hpswpin":4,"inledpin":18,"outledpin":19,"pb1pin":34,"pb2pin":35,"irpin":15,
-        "brdnum":60, "stepsrev":-1,"fixedsmode":-1,"brdpins":[27,26,25,-1],"msdelay":4000 }
-      */
-      this->board         = doc_brd["board"].as<const char*>();
-      this->maxstepmode   = doc_brd["maxstepmode"];
-      this->stepmode      = doc_brd["stepmode"];
-      this->enablepin     = doc_brd["enpin"];
-      this->steppin       = doc_brd["steppin"];
-      this->dirpin        = doc_brd["dirpin"];
-      this->temppin       = doc_brd["temppin"];
-      this->hpswpin       = doc_brd["hpswpin"];
-      this->inledpin      = doc_brd["inledpin"];
-      this->outledpin     = doc_brd["outledpin"];
-      this->pb1pin        = doc_brd["pb1pin"];
-      this->pb2pin        = doc_brd["pb2pin"];
-      this->irpin         = doc_brd["irpin"];
-      this->boardnumber   = doc_brd["brdnum"];
-      this->stepsperrev   = doc_brd["stepsrev"];
-      this->fixedstepmode = doc_brd["fixedsmode"];
-      for (int i = 0; i < 4; i++)
-      {
-        this->boardpins[i] = doc_brd["brdpins"][i];
-      }
-      this->msdelay = doc_brd["msdelay"];                    // motor speed delay - do not confuse with motorspeed
-      CNTLRDATA_println("cd: board_config.jsn loaded OK");
+      FILESYS.remove(file_board_json);
     }
   }
+  else
+  {
+    CNTLRDATA_println("cd: board config file not found, create default board config file");
+    LoadDefaultBoardData();
+  }
 
   // LOAD CONTROLLER VAR DATA : POSITION : DIRECTION
   // this uses stepmode which is in boardconfig file so this must come after loading the board config
   CNTLRDATA_println("cd: LoadConfiguration(): VAR");
-  if ( SPIFFS.exists(file_cntlr_var) == false )
+  if ( LoadVarImage() == true )
   {
-    CNTLRDATA_println("cd: cntlr_var.jsn file not found, create default var file");
+    CNTLRDATA_println("cd: cntlr_var.bin loaded OK");
+    binary++;
+  }
+  else if ( LoadVarJsonFile(file_var_json) == true )
+  {
+    CNTLRDATA_println("cd: cntlr_var.jsn imported, create cntlr_var.bin");
+    json++;
+    if ( SaveVariableConfiguration() == true )
+    {
+      FILESYS.remove(file_var_json);
+    }
+  }
+  else
+  {
+    CNTLRDATA_println("cd: cntlr var file not found, create default var file");
     LoadDefaultVariableData();
   }
+
+  if ( displaytype == Type_Graphic )
+  {
+    // round position to fullstep motor position, holgers code
+    // only applicable if using a GRAPHICS Display
+    this->fposition = (this->fposition + this->stepmode / 2) / this->stepmode * this->stepmode;
+  }
+
+  this->_cfg_loadtime = micros() - loadstart;
+  if ( binary == 3 )
+  {
+    this->_cfg_loadsource = "binary";
+  }
+  else if ( json != 0 )
+  {
+    this->_cfg_loadsource = "json";
+  }
   else
   {
-    // file exists so open it
-    File vfile = SPIFFS.open(file_cntlr_var, "r");
-    String vdata;                                 // controller variable data (position, direction)
-    vdata.reserve(512);                           // Position and Direction data, ArduinoJson Assistant 32
+    this->_cfg_loadsource = "defaults";
+  }
+  boot_msg_print("Config load time (us) ");
+  boot_msg_print(this->_cfg_loadtime);
+  boot_msg_print(" from ");
+  boot_msg_println(this->_cfg_loadsource);
+  return true;
+}
 
-    vdata = vfile.readString();
-    vfile.close();
-    CNTLRDATA_print("cd: data: ");
-    CNTLRDATA_println(vdata);
 
-    // Allocate a temporary JsonDocument
-    DynamicJsonDocument doc_var(DEFAULTVARDOCSIZE);
+// ----------------------------------------------------------------------
+// Load the controller persistant data from cntlr_config.bin
+// Fields not present in the image keep their default values
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::LoadCntlrImage(void)
+{
+  cntlr_image img;
+  uint32_t present[2];
+  byte version;
 
-    // Deserialize the JSON document
-    DeserializationError error = deserializeJson(doc_var, vdata);
-    if ( error )
+  if ( ReadImage(file_cntlr_config, CFGIMAGE_CNTLR, &img, sizeof(img), version, present) == false )
+  {
+    return false;
+  }
+  if ( MigrateImage(CFGIMAGE_CNTLR, version, &img, present) == false )
+  {
+    return false;
+  }
+
+  SetDefaultPersistantData();
+  image_get(present, cf_maxstep,      this->maxstep,            img.maxstep);
+  for (int i = 0; i < 10; i++)
+  {
+    image_get(present, cf_preset,     this->focuserpreset[i],   img.preset[i]);
+  }
+  // SERVERS - SERVICES
+  image_get(present, cf_ascom_en,     this->ascomsrvr_enable,   img.ascom_en);
+  image_get(present, cf_ascom_port,   this->ascomsrvr_port,     img.ascom_port);
+  image_get(present, cf_mngt_en,      this->mngsrvr_enable,     img.mngt_en);
+  image_get(present, cf_mngt_port,    this->mngsrvr_port,       img.mngt_port);
+  image_get(present, cf_tcp_en,       this->tcpipsrvr_enable,   img.tcp_en);
+  image_get(present, cf_tcp_port,     this->tcpipsrvr_port,     img.tcp_port);
+  image_get(present, cf_ws_en,        this->websrvr_enable,     img.ws_en);
+  image_get(present, cf_ws_port,      this->websrvr_port,       img.ws_port);
+  image_get(present, cf_ddns_en,      this->duckdns_enable,     img.ddns_en);
+  image_get(present, cf_ddns_d,       this->duckdns_domain,     img.ddns_d);
+  image_get(present, cf_ddns_t,       this->duckdns_token,      img.ddns_t);
+  image_get(present, cf_ddns_r,       this->duckdns_refreshtime, img.ddns_r);
+  image_get(present, cf_ota_name,     this->ota_name,           img.ota_name);
+  image_get(present, cf_ota_pwd,      this->ota_password,       img.ota_pwd);
+  image_get(present, cf_ota_id,       this->ota_id,             img.ota_id);
+  // DEVICES
+  image_get(present, cf_d_en,         this->display_enable,     img.d_en);
+  image_get(present, cf_d_pgtime,     this->displaypagetime,    img.d_pgtime);
+  image_get(present, cf_d_pgopt,      this->displaypageoption,  img.d_pgopt);
+  image_get(present, cf_d_updmove,    this->displayupdateonmove, img.d_updmove);
+  image_get(present, cf_hpsw_en,      this->hpswitch_enable,    img.hpsw_en);
+  image_get(present, cf_hpswmsg_en,   this->hpswmsg_enable,     img.hpswmsg_en);
+  image_get(present, cf_stall_st,     this->stallguard_state,   img.stall_st);
+  image_get(present, cf_stall_val,    this->stallguard_value,   img.stall_val);
+  image_get(present, cf_tmc2225mA,    this->tmc2225current,     img.tmc2225mA);
+  image_get(present, cf_tmc2209mA,    this->tmc2209current,     img.tmc2209mA);
+  image_get(present, cf_led_en,       this->inoutled_enable,    img.led_en);
+  image_get(present, cf_led_mode,     this->inoutledmode,       img.led_mode);
+  image_get(present, cf_joy1_en,      this->joystick1_enable,   img.joy1_en);
+  image_get(present, cf_joy2_en,      this->joystick2_enable,   img.joy2_en);
+  image_get(present, cf_pb_en,        this->pushbutton_enable,  img.pb_en);
+  image_get(present, cf_pb_steps,     this->pushbutton_steps,   img.pb_steps);
+  image_get(present, cf_t_en,         this->tempprobe_enable,   img.t_en);
+  image_get(present, cf_t_comp_en,    this->tempcomp_enable,    img.t_comp_en);
+  image_get(present, cf_t_mod,        this->tempmode,           img.t_mod);
+  image_get(present, cf_t_coe,        this->tempcoefficient,    img.t_coe);
+  image_get(present, cf_t_res,        this->tempresolution,     img.t_res);
+  image_get(present, cf_t_tcdir,      this->tcdirection,        img.t_tcdir);
+  image_get(present, cf_t_tcavail,    this->tcavailable,        img.t_tcavail);
+  image_get(present, cf_blin_en,      this->backlash_in_enable, img.blin_en);
+  image_get(present, cf_blout_en,     this->backlash_out_enable, img.blout_en);
+  image_get(present, cf_blin_steps,   this->backlashsteps_in,   img.blin_steps);
+  image_get(present, cf_blout_steps,  this->backlashsteps_out,  img.blout_steps);
+  image_get(present, cf_cp_en,        this->coilpower_enable,   img.cp_en);
+  image_get(present, cf_dam_en,       this->delayaftermove_enable, img.dam_en);
+  image_get(present, cf_dam_time,     this->delayaftermove_time, img.dam_time);
+  image_get(present, cf_devname,      this->devicename,         img.devname);
+  image_get(present, cf_filelist,     this->filelistformat,     img.filelist);
+  image_get(present, cf_mspeed,       this->motorspeed,         img.mspeed);
+  image_get(present, cf_park_en,      this->park_enable,        img.park_en);
+  image_get(present, cf_park_time,    this->park_time,          img.park_time);
+  image_get(present, cf_rdir_en,      this->reverse_enable,     img.rdir_en);
+  image_get(present, cf_ss_en,        this->stepsize_enable,    img.ss_en);
+  image_get(present, cf_ss_val,       this->stepsize,           img.ss_val);
+  // web page colors
+  image_get(present, cf_ticol,        this->titlecolor,         img.ticol);
+  image_get(present, cf_scol,         this->subtitlecolor,      img.scol);
+  image_get(present, cf_hcol,         this->headercolor,        img.hcol);
+  image_get(present, cf_tcol,         this->textcolor,          img.tcol);
+  image_get(present, cf_bcol,         this->backcolor,          img.bcol);
+
+  // hot fields, saved separately
+  this->_cntlr_dirty = 0;
+  if ( LoadOperImage() == true )
+  {
+    CNTLRDATA_println("cd: cntlr_oper.bin loaded OK");
+  }
+  else if ( SaveOperImage() == false )
+  {
+    // the hot fields are only held in memory, cntlr_config.bin does not
+    // hold them, so keep them dirty until cntlr_oper.bin is written
+    ERROR_println("cd: cntlr_oper.bin not written, hot fields kept dirty");
+    this->_cntlr_dirty = CNTLR_HOTFIELDS;
+  }
+  return true;
+}
+
+
+// ----------------------------------------------------------------------
+// Load the controller operational (hot) data from cntlr_oper.bin
+// Overrides the hot fields loaded from cntlr_config.bin
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::LoadOperImage(void)
+{
+  oper_image img;
+  uint32_t present[2];
+  byte version;
+
+  if ( ReadImage(file_cntlr_oper, CFGIMAGE_OPER, &img, sizeof(img), version, present) == false )
+  {
+    return false;
+  }
+  if ( MigrateImage(CFGIMAGE_OPER, version, &img, present) == false )
+  {
+    return false;
+  }
+
+  for (int i = 0; i < 10; i++)
+  {
+    image_get(present, of_preset,     this->focuserpreset[i],   img.preset[i]);
+  }
+  image_get(present, of_t_comp_en,    this->tempcomp_enable,    img.t_comp_en);
+  image_get(present, of_t_tcdir,      this->tcdirection,        img.t_tcdir);
+  image_get(present, of_mspeed,       this->motorspeed,         img.mspeed);
+  image_get(present, of_cp_en,        this->coilpower_enable,   img.cp_en);
+  return true;
+}
+
+
+// ----------------------------------------------------------------------
+// Load the board data from board_config.bin
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::LoadBoardImage(void)
+{
+  board_image img;
+  uint32_t present[2];
+  byte version;
+
+  if ( ReadImage(file_board_config, CFGIMAGE_BOARD, &img, sizeof(img), version, present) == false )
+  {
+    return false;
+  }
+  if ( MigrateImage(CFGIMAGE_BOARD, version, &img, present) == false )
+  {
+    return false;
+  }
+
+  SetDefaultBoardData();
+  image_get(present, bf_board,        this->board,              img.board);
+  image_get(present, bf_maxstepmode,  this->maxstepmode,        img.maxstepmode);
+  image_get(present, bf_stepmode,     this->stepmode,           img.stepmode);
+  image_get(present, bf_enpin,        this->enablepin,          img.enpin);
+  image_get(present, bf_steppin,      this->steppin,            img.steppin);
+  image_get(present, bf_dirpin,       this->dirpin,             img.dirpin);
+  image_get(present, bf_temppin,      this->temppin,            img.temppin);
+  image_get(present, bf_hpswpin,      this->hpswpin,            img.hpswpin);
+  image_get(present, bf_inledpin,     this->inledpin,           img.inledpin);
+  image_get(present, bf_outledpin,    this->outledpin,          img.outledpin);
+  image_get(present, bf_pb1pin,       this->pb1pin,             img.pb1pin);
+  image_get(present, bf_pb2pin,       this->pb2pin,             img.pb2pin);
+  image_get(present, bf_irpin,        this->irpin,              img.irpin);
+  image_get(present, bf_brdnum,       this->boardnumber,        img.brdnum);
+  image_get(present, bf_stepsrev,     this->stepsperrev,        img.stepsrev);
+  image_get(present, bf_fixedsmode,   this->fixedstepmode,      img.fixedsmode);
+  for (int i = 0; i < 4; i++)
+  {
+    image_get(present, bf_brdpins,    this->boardpins[i],       img.brdpins[i]);
+  }
+  image_get(present, bf_msdelay,      this->msdelay,            img.msdelay);
+  return true;
+}
+
+
+// ----------------------------------------------------------------------
+// Load the variable data from cntlr_var.bin
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::LoadVarImage(void)
+{
+  var_image img;
+  uint32_t present[2];
+  byte version;
+
+  if ( ReadImage(file_cntlr_var, CFGIMAGE_VAR, &img, sizeof(img), version, present) == false )
+  {
+    return false;
+  }
+  if ( MigrateImage(CFGIMAGE_VAR, version, &img, present) == false )
+  {
+    return false;
+  }
+
+  this->fposition = DEFAULTPOSITION;
+  this->focuserdirection = moving_in;
+  image_get(present, vf_fpos,         this->fposition,          img.fpos);
+  image_get(present, vf_fdir,         this->focuserdirection,   img.fdir);
+  return true;
+}
+
+
+// ----------------------------------------------------------------------
+// Read a binary config image into payload with a single file read
+// Returns false if the file is missing, or the header or crc is bad
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::ReadImage(const String &fname, byte id, void *payload, size_t size, byte &version, uint32_t *present)
+{
+  String rname = fname;
+  if ( FILESYS.exists(rname) == false )
+  {
+    // power loss during WriteImage(), after the old image was removed
+    rname = fname + ".tmp";
+    if ( FILESYS.exists(rname) == false )
     {
-      ERROR_println("cd: deserialise error, create default var file");
-      LoadDefaultVariableData();
+      return false;
     }
-    else
+    ERROR_println("cd: ReadImage() image missing, using tmp file");
+  }
+  File ifile = FILESYS.open(rname, "r");
+  if (!ifile)
+  {
+    ERROR_println("cd: ReadImage() open file read error");
+    return false;
+  }
+  size_t fsize = ifile.size();
+  if ( (fsize < sizeof(cfgimage_header)) || (fsize > (sizeof(cfgimage_header) + CFGIMAGE_MAXSIZE)) )
+  {
+    ERROR_println("cd: ReadImage() size error");
+    ifile.close();
+    return false;
+  }
+  uint8_t buf[fsize];
+  size_t len = ifile.read(buf, fsize);
+  ifile.close();
+
+  cfgimage_header hdr;
+  memcpy(&hdr, buf, sizeof(hdr));
+  if ( (len != fsize) || (hdr.magic != CFGIMAGE_MAGIC) || (hdr.id != id) || (hdr.length != (fsize - sizeof(hdr))) )
+  {
+    ERROR_println("cd: ReadImage() header error");
+    return false;
+  }
+  if ( crc32_le(0, buf + sizeof(hdr), hdr.length) != hdr.crc )
+  {
+    ERROR_println("cd: ReadImage() crc error");
+    return false;
+  }
+
+  // an image from an older schema is shorter, the missing fields are not flagged as present
+  memset(payload, 0, size);
+  memcpy(payload, buf + sizeof(hdr), (hdr.length < size) ? hdr.length : size);
+  version    = hdr.version;
+  present[0] = hdr.present[0];
+  present[1] = hdr.present[1];
+  CNTLRDATA_print("cd: ReadImage() ");
+  CNTLRDATA_print(fname);
+  CNTLRDATA_print(" version ");
+  CNTLRDATA_println(version);
+  return true;
+}
+
+
+// ----------------------------------------------------------------------
+// Write a binary config image, header and payload, present is the bitmap
+// of the fields held in the payload. The image is written to a temporary
+// file which is renamed over the existing image, LittleFS replaces it in
+// one step. If the rename has to remove the old image first, a power loss
+// between the two leaves only the temporary file, ReadImage() loads it
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::WriteImage(const String &fname, byte id, byte version, uint64_t present, const void *payload, size_t size)
+{
+  uint8_t buf[sizeof(cfgimage_header) + size];
+  cfgimage_header hdr;
+  hdr.magic      = CFGIMAGE_MAGIC;
+  hdr.id         = id;
+  hdr.version    = version;
+  hdr.length     = size;
+  hdr.present[0] = (uint32_t) present;
+  hdr.present[1] = (uint32_t) (present >> 32);
+  hdr.crc        = crc32_le(0, (const uint8_t *) payload, size);
+  memcpy(buf, &hdr, sizeof(hdr));
+  memcpy(buf + sizeof(hdr), payload, size);
+
+  String tmpname = fname + ".tmp";
+  File ifile = FILESYS.open(tmpname, "w");
+  if (!ifile)
+  {
+    ERROR_println("cd: WriteImage() file open for write error");
+    return false;
+  }
+  size_t len = ifile.write(buf, sizeof(buf));
+  ifile.close();
+  if ( len != sizeof(buf) )
+  {
+    ERROR_println("cd: WriteImage() write error");
+    FILESYS.remove(tmpname);
+    return false;
+  }
+  if ( FILESYS.rename(tmpname, fname) == false )
+  {
+    // file system that does not rename over an existing file
+    FILESYS.remove(fname);
+    if ( FILESYS.rename(tmpname, fname) == false )
     {
-      this->fposition = doc_var["fpos"];          // last focuser position
-      this->focuserdirection = doc_var["fdir"];   // keeps track of last focuser move direction
+      ERROR_println("cd: WriteImage() rename error");
+      return false;
+    }
+  }
+  if ( id < CFGIMAGE_IDS )
+  {
+    this->_cfg_saves[id]++;
+    this->_cfg_bytes[id] += sizeof(buf);
+  }
+  return true;
+}
 
-      if ( displaytype == Type_Graphic )
-      {
-        // round position to fullstep motor position, holgers code
-        // only applicable if using a GRAPHICS Display
-        this->fposition = (this->fposition + this->stepmode / 2) / this->stepmode * this->stepmode;
-      }
-      CNTLRDATA_println("cd: cntlr_var.jsn loaded OK");
+
+// ----------------------------------------------------------------------
+// Migrate an image payload from an older schema version to the current one
+// Adding a field does not change the schema version, the field is appended
+// to the payload and flagged in the presence bitmap. The version changes
+// only when an existing field changes size or meaning; add a case here to
+// convert the payload of the old version when that happens.
+// An image written by a newer schema cannot be read and is rejected.
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::MigrateImage(byte id, byte &version, void *payload, uint32_t *present)
+{
+  byte current;
+
+  switch ( id )
+  {
+    case CFGIMAGE_CNTLR:
+      current = CNTLRIMAGE_VERSION;
+      break;
+    case CFGIMAGE_BOARD:
+      current = BOARDIMAGE_VERSION;
+      break;
+    case CFGIMAGE_VAR:
+      current = VARIMAGE_VERSION;
+      break;
+    case CFGIMAGE_OPER:
+      current = OPERIMAGE_VERSION;
+      break;
+    default:
+      return false;
+  }
+
+  if ( (version == 0) || (version > current) )
+  {
+    ERROR_println("cd: MigrateImage() unsupported version");
+    return false;
+  }
+  while ( version < current )
+  {
+    switch ( (id << 8) | version )
+    {
+      // no older schema versions exist yet. A migration step converts the
+      // payload and present bitmap of one version to the next, then bumps version
+      default:
+        ERROR_println("cd: MigrateImage() no migration for version");
+        return false;
     }
   }
   return true;
 }
 
 
+// ----------------------------------------------------------------------
+// Legacy json loaders, used to import the json files written by earlier
+// firmware
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::LoadCntlrJsonFile(const String &fname)
+{
+  if ( FILESYS.exists(fname) == false )
+  {
+    return false;
+  }
+  File cfile = FILESYS.open(fname, "r");
+  if (!cfile)
+  {
+    return false;
+  }
+  String cdata;                                 // cntlr_config.jsn controller persistant data
+  cdata.reserve(2400);                          // Controller data, ArduinoJson Assistant 1699, 2048
+  cdata = cfile.readString();
+  cfile.close();
+  CNTLRDATA_print("cd: data: ");
+  CNTLRDATA_println(cdata);
+
+  SetDefaultPersistantData();
+  return ParseCntlrJson(cdata);
+}
+
+// ----------------------------------------------------------------------
+// Apply a json controller config to the controller settings
+// Keys which are missing keep their current value
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::ParseCntlrJson(String &cdata)
+{
+  // Allocate a temporary JsonDocument
+  DynamicJsonDocument doc_per(DEFAULTDOCSIZE);
+
+  // Deserialize the JSON document
+  DeserializationError error = deserializeJson(doc_per, cdata);
+  if ( error )
+  {
+    ERROR_println("cd: deserialise error, cntlr config");
+    return false;
+  }
+
+  // maxstep
+  this->maxstep = doc_per["maxstep"] | this->maxstep;
+  // presets
+  for (int i = 0; i < 10; i++)
+  {
+    this->focuserpreset[i] = doc_per["preset"][i] | this->focuserpreset[i];
+  }
+  // SERVERS - SERVICES
+  this->ascomsrvr_enable  = doc_per["ascom_en"] | this->ascomsrvr_enable;
+  this->ascomsrvr_port    = doc_per["ascom_port"] | this->ascomsrvr_port;
+  this->mngsrvr_enable    = doc_per["mngt_en"] | this->mngsrvr_enable;
+  this->mngsrvr_port      = doc_per["mngt_port"] | this->mngsrvr_port;
+  this->tcpipsrvr_enable  = doc_per["tcp_en"] | this->tcpipsrvr_enable;
+  this->tcpipsrvr_port    = doc_per["tcp_port"] | this->tcpipsrvr_port;
+  this->websrvr_enable    = doc_per["ws_en"] | this->websrvr_enable;
+  this->websrvr_port      = doc_per["ws_port"] | this->websrvr_port;
+  this->duckdns_enable    = doc_per["ddns_en"] | this->duckdns_enable;
+  json_getstr(doc_per["ddns_d"].as<const char*>(), this->duckdns_domain);
+  json_getstr(doc_per["ddns_t"].as<const char*>(), this->duckdns_token);
+  this->duckdns_refreshtime = doc_per["ddns_r"] | this->duckdns_refreshtime;
+  json_getstr(doc_per["ota_name"].as<const char*>(), this->ota_name);
+  json_getstr(doc_per["ota_pwd"].as<const char*>(), this->ota_password);
+  json_getstr(doc_per["ota_id"].as<const char*>(), this->ota_id);
+  // DEVICES
+  // display
+  this->display_enable    = doc_per["d_en"] | this->display_enable;
+  this->displaypagetime   = doc_per["d_pgtime"] | this->displaypagetime;
+  json_getstr(doc_per["d_pgopt"].as<const char*>(), this->displaypageoption);
+  this->displayupdateonmove = doc_per["d_updmove"] | this->displayupdateonmove;   // update position on display when moving
+  // hpsw
+  this->hpswitch_enable   = doc_per["hpsw_en"] | this->hpswitch_enable;
+  this->hpswmsg_enable    = doc_per["hpswmsg_en"] | this->hpswmsg_enable;
+  this->stallguard_state  = (tmc2209stallguard) (doc_per["stall_st"] | (int) this->stallguard_state);
+  this->stallguard_value  = doc_per["stall_val"] | this->stallguard_value;
+  this->tmc2225current    = doc_per["tmc2225mA"] | this->tmc2225current;
+  this->tmc2209current    = doc_per["tmc2209mA"] | this->tmc2209current;
+  // leds
+  this->inoutled_enable   = doc_per["led_en"] | this->inoutled_enable;
+  this->inoutledmode      = doc_per["led_mode"] | this->inoutledmode;
+  // joysticks
+  this->joystick1_enable  = doc_per["joy1_en"] | this->joystick1_enable;
+  this->joystick2_enable  = doc_per["joy2_en"] | this->joystick2_enable;
+  // pushbuttons
+  this->pushbutton_enable = doc_per["pb_en"] | this->pushbutton_enable;
+  this->pushbutton_steps  = doc_per["pb_steps"] | this->pushbutton_steps;
+  // temperature probe
+  this->tempprobe_enable  = doc_per["t_en"] | this->tempprobe_enable;
+  this->tempcomp_enable   = doc_per["t_comp_en"] | this->tempcomp_enable;     // indicates if temperature compensation is enabled
+  this->tempmode          = doc_per["t_mod"] | this->tempmode;                // temperature display mode, Celcius=1, Fahrenheit=0
+  this->tempcoefficient   = doc_per["t_coe"] | this->tempcoefficient;         // steps per degree temperature coefficient value
+  this->tempresolution    = doc_per["t_res"] | this->tempresolution;          // 9 - 12
+  this->tcdirection       = doc_per["t_tcdir"] | this->tcdirection;
+  this->tcavailable       = doc_per["t_tcavail"] | this->tcavailable;
+  // backlash
+  this->backlash_in_enable  = doc_per["blin_en"] | this->backlash_in_enable;
+  this->backlash_out_enable = doc_per["blout_en"] | this->backlash_out_enable;
+  this->backlashsteps_in  = doc_per["blin_steps"] | this->backlashsteps_in;   // number of backlash steps to apply for IN moves
+  this->backlashsteps_out = doc_per["blout_steps"] | this->backlashsteps_out;
+  // coil power
+  this->coilpower_enable  = doc_per["cp_en"] | this->coilpower_enable;
+  // delay after move
+  this->delayaftermove_enable = doc_per["dam_en"] | this->delayaftermove_enable;
+  this->delayaftermove_time = doc_per["dam_time"] | this->delayaftermove_time;
+  // devicename
+  json_getstr(doc_per["devname"].as<const char*>(), this->devicename);
+  // file list format
+  this->filelistformat  = doc_per["filelist"] | this->filelistformat;
+  // motorspeed
+  this->motorspeed      = doc_per["mspeed"] | this->motorspeed;               // motorspeed slow, med, fast
+  // park
+  this->park_enable     = doc_per["park_en"] | this->park_enable;
+  this->park_time       = doc_per["park_time"] | this->park_time;
+  // reverse
+  this->reverse_enable  = doc_per["rdir_en"] | this->reverse_enable;
+  // stepsize
+  this->stepsize_enable = doc_per["ss_en"] | this->stepsize_enable;           // if 1, controller returns step size
+  this->stepsize        = doc_per["ss_val"] | this->stepsize;                 // the step size in microns, ie 7.2 - value * 10, so real stepsize = stepsize / 10 (maxval = 25.6)
+  // web page colors
+  json_getstr(doc_per["ticol"].as<const char*>(), this->titlecolor);
+  json_getstr(doc_per["scol"].as<const char*>(), this->subtitlecolor);
+  json_getstr(doc_per["hcol"].as<const char*>(), this->headercolor);
+  json_getstr(doc_per["tcol"].as<const char*>(), this->textcolor);
+  json_getstr(doc_per["bcol"].as<const char*>(), this->backcolor);
+  return true;
+}
+
+bool CONTROLLER_DATA::LoadBoardJsonFile(const String &fname)
+{
+  if ( FILESYS.exists(fname) == false )
+  {
+    return false;
+  }
+  File bfile = FILESYS.open(fname, "r");
+  if (!bfile)
+  {
+    return false;
+  }
+  String bdata;                                 // board_config.jsn board data
+  bdata.reserve(1024);                          // Board data, ArduinoJson Assistant 384
+  bdata = bfile.readString();
+  bfile.close();
+  CNTLRDATA_print("cd: data: ");
+  CNTLRDATA_println(bdata);
+
+  // Allocate a temporary JsonDocument
+  DynamicJsonDocument doc_brd(DEFAULTBOARDSIZE);
+
+  // Deserialize the JSON document
+  DeserializationError error = deserializeJson(doc_brd, bdata);
+  if ( error )
+  {
+    ERROR_println("cd: deserialise error, board config");
+    return false;
+  }
+
+  /*
+    { "board":"PRO2ESP32DRV8825","maxstepmode":32,"stepmode":1,"enpin":14,"steppin":33,
+    "dirpin":32,"temppin":13,"hpswpin":4,"inledpin":18,"outledpin":19,"pb1pin":34,"pb2pin":35,"irpin":15,
+    "brdnum":60, "stepsrev":-1,"fixedsmode":-1,"brdpins":[27,26,25,-1],"msdelay":4000 }
+  */
+  this->board         = doc_brd["board"].as<const char*>();
+  this->maxstepmode   = doc_brd["maxstepmode"];
+  this->stepmode      = doc_brd["stepmode"];
+  this->enablepin     = doc_brd["enpin"];
+  this->steppin       = doc_brd["steppin"];
+  this->dirpin        = doc_brd["dirpin"];
+  this->temppin       = doc_brd["temppin"];
+  this->hpswpin       = doc_brd["hpswpin"];
+  this->inledpin      = doc_brd["inledpin"];
+  this->outledpin     = doc_brd["outledpin"];
+  this->pb1pin        = doc_brd["pb1pin"];
+  this->pb2pin        = doc_brd["pb2pin"];
+  this->irpin         = doc_brd["irpin"];
+  this->boardnumber   = doc_brd["brdnum"];
+  this->stepsperrev   = doc_brd["stepsrev"];
+  this->fixedstepmode = doc_brd["fixedsmode"];
+  for (int i = 0; i < 4; i++)
+  {
+    this->boardpins[i] = doc_brd["brdpins"][i];
+  }
+  this->msdelay = doc_brd["msdelay"];                    // motor speed delay - do not confuse with motorspeed
+  return true;
+}
+
+bool CONTROLLER_DATA::LoadVarJsonFile(const String &fname)
+{
+  if ( FILESYS.exists(fname) == false )
+  {
+    return false;
+  }
+  File vfile = FILESYS.open(fname, "r");
+  if (!vfile)
+  {
+    return false;
+  }
+  String vdata;                                 // controller variable data (position, direction)
+  vdata.reserve(512);                           // Position and Direction data, ArduinoJson Assistant 32
+  vdata = vfile.readString();
+  vfile.close();
+  CNTLRDATA_print("cd: data: ");
+  CNTLRDATA_println(vdata);
+
+  // Allocate a temporary JsonDocument
+  DynamicJsonDocument doc_var(DEFAULTVARDOCSIZE);
+
+  // Deserialize the JSON document
+  DeserializationError error = deserializeJson(doc_var, vdata);
+  if ( error )
+  {
+    ERROR_println("cd: deserialise error, var config");
+    return false;
+  }
+  this->fposition = doc_var["fpos"];            // last focuser position
+  this->focuserdirection = doc_var["fdir"];     // keeps track of last focuser move direction
+  return true;
+}
+
+
 // ----------------------------------------------------------------------
 // Load Focuser Variable Data - Position and Direction
 // ----------------------------------------------------------------------
@@ -394,6 +1079,17 @@ void CONTROLLER_DATA::LoadDefaultVariableData()
 void CONTROLLER_DATA::LoadDefaultPersistantData()
 {
   CNTLRDATA_println("cd: LoadDefaultPersistantData: Create a default cntlr_config file");
+  SetDefaultPersistantData();
+  this->_cntlr_dirty = image_fieldmask(cf_count);
+  SavePersitantConfiguration();               // write default values to SPIFFS
+}
+
+
+// ----------------------------------------------------------------------
+// Set the Default Focuser Persistant Data Settings, without saving
+// ----------------------------------------------------------------------
+void CONTROLLER_DATA::SetDefaultPersistantData()
+{
   this->maxstep = DEFAULTMAXSTEPS;
   for (int i = 0; i < 10; i++)
   {
@@ -478,8 +1174,6 @@ void CONTROLLER_DATA::LoadDefaultPersistantData()
   this->headercolor         = DEFAULTHEADERCOLOR;
   this->textcolor           = DEFAULTTEXTCOLLOR;
   this->backcolor           = DEFAULTBACKCOLOR;
-
-  SavePersitantConfiguration();               // write default values to SPIFFS
 }
 
 
@@ -488,49 +1182,164 @@ void CONTROLLER_DATA::LoadDefaultPersistantData()
 // ----------------------------------------------------------------------
 void CONTROLLER_DATA::LoadDefaultBoardData()
 {
-  CNTLRDATA_println("cd: LoadDefaultBoardData: Create a default board_config.jsn file");
-  // we are here because board_config.jsn was not found
+  CNTLRDATA_println("cd: LoadDefaultBoardData: Create a default board config");
+  // we are here because board_config was not found, or the board was edited
   // we can load the default board configuration from DRVBRD defined - DefaultBoardName in .ino file
-  // Driver board data - Open the specific board config .jsn file for reading
 
   // cannot use this->boardnumber because the value has not been set yet
-  // Load the board file from /boards, make up filename first
+  // boards are compiled in from board_table.h, a board file in /boards is
+  // only parsed if it differs from the table entry [edited by Management Server]
   String brdfile = "/boards/" + String(myboardnumber) + ".jsn";
-  CNTLRDATA_print("cd: LoadDefaultBoardData() : loading file ");
-  CNTLRDATA_println(brdfile);
+  int idx = board_table_index(myboardnumber);
 
-  // attempt to load the specified board config file from /boards
-  if ( LoadBrdConfigStart(brdfile) == true )
+  if ( (idx >= 0) && (BoardFileChanged(brdfile, board_table[idx].json) == false) )
+  {
+    CNTLRDATA_println("cd: LoadDefaultBoardData() : board loaded from table");
+    LoadBrdConfigTable(idx);
+  }
+  else if ( LoadBrdConfigStart(brdfile) == true )
+  {
+    // attempt to load the specified board config file from /boards
+    CNTLRDATA_print("cd: LoadDefaultBoardData() : brdfile loaded ");
+    CNTLRDATA_println(brdfile);
+  }
+  else if ( idx >= 0 )
   {
-    CNTLRDATA_println("cd: LoadDefaultBoardData() : brdfile loaded");
+    CNTLRDATA_println("cd: LoadDefaultBoardData() : error, brdfile not loaded, use board table");
+    LoadBrdConfigTable(idx);
   }
   else
   {
     // a board config file could not be loaded, so create a dummy one
     CNTLRDATA_println("cd: LoadDefaultBoardData() : error, brdfile not loaded, create default board");
-    this->board         = "Unknown";
-    this->maxstepmode   = -1;
-    this->stepmode      =  1;                     // full step
-    this->enablepin     = -1;
-    this->steppin       = -1;
-    this->dirpin        = -1;
-    this->temppin       = -1;
-    this->hpswpin       = -1;
-    this->inledpin      = -1;
-    this->outledpin     = -1;
-    this->pb1pin        = -1;
-    this->pb1pin        = -1;
-    this->irpin         = -1;
-    this->boardnumber   = myboardnumber;          // captured from controller_config.h
-    this->fixedstepmode = myfixedstepmode;
-    this->stepsperrev   = mystepsperrev;
-    for (int i = 0; i < 4; i++)
+    SetDefaultBoardData();
+  }
+  SaveBoardConfiguration();
+}
+
+
+// ----------------------------------------------------------------------
+// Load a board from the compiled in board table
+// ----------------------------------------------------------------------
+void CONTROLLER_DATA::LoadBrdConfigTable(int idx)
+{
+  const board_desc &brd = board_table[idx];
+
+  this->board         = brd.board;
+  this->maxstepmode   = brd.maxstepmode;
+  this->stepmode      = brd.stepmode;
+  this->enablepin     = brd.enpin;
+  this->steppin       = brd.steppin;
+  this->dirpin        = brd.dirpin;
+  this->temppin       = brd.temppin;
+  this->hpswpin       = brd.hpswpin;
+  this->inledpin      = brd.inledpin;
+  this->outledpin     = brd.outledpin;
+  this->pb1pin        = brd.pb1pin;
+  this->pb2pin        = brd.pb2pin;
+  this->irpin         = brd.irpin;
+  this->boardnumber   = brd.brdnum;
+  SetBrdStepOverrides(brd.stepsrev, brd.fixedsmode);
+  for (int i = 0; i < 4; i++)
+  {
+    this->boardpins[i] = brd.brdpins[i];
+  }
+  this->msdelay = brd.msdelay;
+}
+
+
+// ----------------------------------------------------------------------
+// Returns true if a board file exists and is not the same as the table entry
+// Compares the file contents, the file is not parsed
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::BoardFileChanged(const String &brdfile, const char *json)
+{
+  if ( FILESYS.exists(brdfile) == false )
+  {
+    return false;
+  }
+  File bfile = FILESYS.open(brdfile, "r");
+  if ( !bfile )
+  {
+    return false;
+  }
+  size_t len = strlen(json);
+  bool changed = (bfile.size() != len);
+  char buf[64];
+  while ( (changed == false) && (len > 0) )
+  {
+    size_t n = bfile.read((uint8_t *) buf, (len < sizeof(buf)) ? len : sizeof(buf));
+    if ( (n == 0) || (memcmp(buf, json, n) != 0) )
     {
-      this->boardpins[i] = -1;
+      changed = true;
     }
-    this->msdelay = 8000;
+    json += n;
+    len -= n;
   }
-  SaveBoardConfiguration();
+  bfile.close();
+  return changed;
+}
+
+
+// ----------------------------------------------------------------------
+// Set steps per revolution and fixed step mode of a board, some boards use
+// STEPSPERREVOLUTION and FIXEDSTEPMODE from controller_config.h instead
+// ----------------------------------------------------------------------
+void CONTROLLER_DATA::SetBrdStepOverrides(int stepsrev, int fixedsmode)
+{
+  // brdstepsperrev comes from STEPSPERREVOLUTION and will be different so must override the default setting in the board files
+  switch ( myboardnumber )
+  {
+    case PRO2ESP32ULN2003:
+    case PRO2ESP32L298N:
+    case PRO2ESP32L293DMINI:
+    case PRO2ESP32L9110S:
+      this->stepsperrev = mystepsperrev;         // override STEPSPERREVOLUTION from controller_config.h FIXEDSTEPMODE
+      break;
+    default:
+      this->stepsperrev = stepsrev;
+      break;
+  }
+  // myfixedstepmode comes from FIXEDSTEPMODE and will be different so must override the default setting in the board files
+  switch ( myboardnumber )
+  {
+    case PRO2ESP32R3WEMOS:
+    case PRO2ESP32ST6128:
+      this->fixedstepmode = myfixedstepmode;     // override fixedstepmode from controller_config.h FIXEDSTEPMODE
+      break;
+    default:
+      this->fixedstepmode = fixedsmode;
+      break;
+  }
+}
+
+
+// ----------------------------------------------------------------------
+// Set a dummy board, used when no board config file can be loaded
+// ----------------------------------------------------------------------
+void CONTROLLER_DATA::SetDefaultBoardData()
+{
+  this->board         = "Unknown";
+  this->maxstepmode   = -1;
+  this->stepmode      =  1;                       // full step
+  this->enablepin     = -1;
+  this->steppin       = -1;
+  this->dirpin        = -1;
+  this->temppin       = -1;
+  this->hpswpin       = -1;
+  this->inledpin      = -1;
+  this->outledpin     = -1;
+  this->pb1pin        = -1;
+  this->pb2pin        = -1;
+  this->irpin         = -1;
+  this->boardnumber   = myboardnumber;            // captured from controller_config.h
+  this->fixedstepmode = myfixedstepmode;
+  this->stepsperrev   = mystepsperrev;
+  for (int i = 0; i < 4; i++)
+  {
+    this->boardpins[i] = -1;
+  }
+  this->msdelay = 8000;
 }
 
 
@@ -540,20 +1349,30 @@ void CONTROLLER_DATA::LoadDefaultBoardData()
 void CONTROLLER_DATA::SetFocuserDefaults(void)
 {
   CNTLRDATA_println("cd: SetFocuserDefaults(): delete existing config files");
-  if ( SPIFFS.exists(file_cntlr_config))
+  if ( FILESYS.exists(file_cntlr_config))
   {
-    SPIFFS.remove(file_cntlr_config);
+    FILESYS.remove(file_cntlr_config);
   }
 
-  if ( SPIFFS.exists(file_board_config))
+  if ( FILESYS.exists(file_board_config))
   {
-    SPIFFS.remove(file_board_config);
+    FILESYS.remove(file_board_config);
   }
 
-  if ( SPIFFS.exists(file_cntlr_var))
+  if ( FILESYS.exists(file_cntlr_var))
   {
-    SPIFFS.remove(file_cntlr_var);
+    FILESYS.remove(file_cntlr_var);
   }
+
+  if ( FILESYS.exists(file_cntlr_oper))
+  {
+    FILESYS.remove(file_cntlr_oper);
+  }
+
+  // remove any legacy json files so they are not imported later
+  FILESYS.remove(file_cntlr_json);
+  FILESYS.remove(file_board_json);
+  FILESYS.remove(file_var_json);
   CNTLRDATA_println("cd: SetFocuserDefaults(): load default config files");
   LoadDefaultPersistantData();
   LoadDefaultBoardData();
@@ -573,11 +1392,9 @@ bool CONTROLLER_DATA::SaveConfiguration(long currentPosition, byte DirOfTravel)
     CNTLRDATA_println("SaveConfiguration: update fpos and dir");
     this->fposition = currentPosition;
     this->focuserdirection = DirOfTravel;
-    // set flag to start 30s counter for saving var file
-    portENTER_CRITICAL(&varMux);
-    save_var_flag = 0;
-    portEXIT_CRITICAL(&varMux);;
-    CNTLRDATA_println("++ request to save cntlr_var.jsn, save_var_flag = 0");
+    // start the delayed save of the var file
+    tasksched->start(this->_job_var);
+    CNTLRDATA_println("++ request to save cntlr_var.bin");
   }
 
   // check the flags to determine what needs to be saved
@@ -590,20 +1407,13 @@ bool CONTROLLER_DATA::SaveConfiguration(long currentPosition, byte DirOfTravel)
   }
   else
   {
-    int t_mux;
-
     // not moving, safe to save files
 
-    // check var flag, if saving of file cntlr_var.jsn is required
-    portENTER_CRITICAL(&varMux);
-    t_mux = save_var_flag;
-    portEXIT_CRITICAL(&varMux);
-    if ( t_mux == 1 )
+    // check var, if saving of file cntlr_var.bin is required
+    if ( this->_save_due & SAVEDUE_VAR )
     {
-      CNTLRDATA_println("++ request to save cntlr_var.jsn, save_var_flag = 1, save NOW");
-      portENTER_CRITICAL(&varMux);
-      save_var_flag = -1;
-      portEXIT_CRITICAL(&varMux);
+      CNTLRDATA_println("++ save cntlr_var.bin NOW");
+      this->_save_due &= ~SAVEDUE_VAR;
       if ( ControllerData->SaveVariableConfiguration() == false )
       {
         ERROR_println("++ save cntlr_var.jsn ERROR");
@@ -616,16 +1426,11 @@ bool CONTROLLER_DATA::SaveConfiguration(long currentPosition, byte DirOfTravel)
       }
     }
 
-    // check cntlr flag
-    portENTER_CRITICAL(&cntlrMux);
-    t_mux = save_cntlr_flag;
-    portEXIT_CRITICAL(&cntlrMux);
-    if ( t_mux == 1 )
+    // check cntlr
+    if ( this->_save_due & SAVEDUE_CNTLR )
     {
-      CNTLRDATA_println("++ request to save cntlr_config.jsn, save_cntlr_flag = 1, save cntlr_config.jsn NOW");
-      portENTER_CRITICAL(&cntlrMux);
-      save_cntlr_flag = -1;
-      portEXIT_CRITICAL(&cntlrMux);
+      CNTLRDATA_println("++ save cntlr_config.bin NOW");
+      this->_save_due &= ~SAVEDUE_CNTLR;
       if ( ControllerData->SavePersitantConfiguration() == false)
       {
         ERROR_println("++ save cntlr_config.jsn error");
@@ -638,16 +1443,11 @@ bool CONTROLLER_DATA::SaveConfiguration(long currentPosition, byte DirOfTravel)
       }
     }
 
-    // check board flag
-    portENTER_CRITICAL(&boardMux);
-    t_mux = save_board_flag;
-    portEXIT_CRITICAL(&boardMux);
-    if ( t_mux == 1 )
+    // check board
+    if ( this->_save_due & SAVEDUE_BOARD )
     {
-      CNTLRDATA_println("++ request to save board_config.jsn, save_board_flag = 1, save board_config.jsn NOW");
-      portENTER_CRITICAL(&boardMux);
-      save_board_flag = -1;
-      portEXIT_CRITICAL(&boardMux);
+      CNTLRDATA_println("++ save board_config.bin NOW");
+      this->_save_due &= ~SAVEDUE_BOARD;
       if ( ControllerData->SaveBoardConfiguration() == false )
       {
         ERROR_println("++ save board_config.jsn error");
@@ -678,83 +1478,227 @@ bool CONTROLLER_DATA::SaveNow(long focuser_position, bool focuser_direction)
 
 
 // ----------------------------------------------------------------------
-// Save variable data (position, dir travel) settings to cntlr_var.jsn
+// Save variable data (position, dir travel) settings to cntlr_var.bin
 // ----------------------------------------------------------------------
 bool CONTROLLER_DATA::SaveVariableConfiguration()
 {
   CNTLRDATA_println("cd: SaveVariableConfiguration() NOW");
+  var_image img;
+
+  memset(&img, 0, sizeof(img));
+  img.fpos = this->fposition;                     // last focuser position
+  img.fdir = this->focuserdirection;              // keeps track of last focuser move direction
 
-  // Delete existing file
-  if ( SPIFFS.exists(file_cntlr_var))
+  if ( WriteImage(file_cntlr_var, CFGIMAGE_VAR, VARIMAGE_VERSION, image_fieldmask(vf_count), &img, sizeof(img)) == false )
   {
-    CNTLRDATA_println("cd: deleted existing cntlr_var.jsn");
-    SPIFFS.remove(file_cntlr_var);
+    ERROR_println("cd: SaveVariableConfiguration() write error, cntlr_var.bin file not saved");
+    return false;
   }
+  CNTLRDATA_println("cd: SaveVariableConfiguration: cntlr_var.bin file written");
+  return true;
+}
 
-  // Open file for writing
-  File vfile = SPIFFS.open(this->file_cntlr_var, "w");
-  if (!vfile)
+
+// ----------------------------------------------------------------------
+// Save Focuser Controller (persistent) Data, only the sections which
+// hold a dirty field are written: hot to cntlr_oper.bin and cold to
+// cntlr_config.bin. If a write fails the fields stay dirty and the
+// delayed save is restarted
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::SavePersitantConfiguration()
+{
+  CNTLRDATA_println("cd: SavePersitantConfiguration()");
+  uint64_t dirty = this->_cntlr_dirty;
+  bool state = true;
+
+  if ( dirty & CNTLR_HOTFIELDS )
   {
-    ERROR_println("cd: Could not open ntlr_var.jsn for W mode");
-    return false;
+    if ( SaveOperImage() == true )
+    {
+      this->_cntlr_dirty &= ~CNTLR_HOTFIELDS;
+    }
+    else
+    {
+      state = false;
+    }
   }
-  CNTLRDATA_println("cd: opened cntlr_var.jsn file for W mode");
-  // Allocate a temporary JsonDocument
-  // Don't forget to change the capacity to match your requirements.
-  // Use arduinojson.org/assistant to compute the capacity.
-  StaticJsonDocument<DEFAULTVARDOCSIZE> doc;
+  if ( dirty & ~CNTLR_HOTFIELDS )
+  {
+    if ( SaveCntlrImage() == true )
+    {
+      this->_cntlr_dirty &= CNTLR_HOTFIELDS;
+    }
+    else
+    {
+      state = false;
+    }
+  }
+  if ( state == false )
+  {
+    this->set_cntlr_flags();
+  }
+  return state;
+}
+
 
-  // Set the values in the document
-  doc["fpos"] = this->fposition;                  // last focuser position
-  doc["fdir"] = this->focuserdirection;           // keeps track of last focuser move direction
+// ----------------------------------------------------------------------
+// Save the controller operational (hot) data to cntlr_oper.bin
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::SaveOperImage(void)
+{
+  CNTLRDATA_println("cd: SaveOperImage()");
+  oper_image img;
 
-  // save settings to file
-  if (serializeJson(doc, vfile) == 0)             // Serialize JSON to file
+  memset(&img, 0, sizeof(img));
+  for (int i = 0; i < 10; i++)
   {
-    ERROR_println("cd: SaveVariableConfiguration() serialise error, cntlr_var.jsn file not saved");
-    vfile.close();
-    return false;
+    img.preset[i]   = this->focuserpreset[i];
   }
-  else
+  img.t_comp_en     = this->tempcomp_enable;
+  img.t_tcdir       = this->tcdirection;
+  img.mspeed        = this->motorspeed;
+  img.cp_en         = this->coilpower_enable;
+
+  if ( WriteImage(file_cntlr_oper, CFGIMAGE_OPER, OPERIMAGE_VERSION, image_fieldmask(of_count), &img, sizeof(img)) == false )
   {
-    CNTLRDATA_println("cd: SaveVariableConfiguration: cntlr_var.jsn file written");
-    vfile.close();
-    return true;
+    ERROR_println("cd: SaveOperImage() write error");
+    return false;
   }
-  return false;
+  CNTLRDATA_println("cd: SaveOperImage: cntlr_oper.bin written");
+  return true;
 }
 
 
 // ----------------------------------------------------------------------
-// Save Focuser Controller (persistent) Data to file cntlr_config.jsn
+// Save the controller (cold) data to cntlr_config.bin, the hot fields
+// are not flagged as present
 // ----------------------------------------------------------------------
-bool CONTROLLER_DATA::SavePersitantConfiguration()
+bool CONTROLLER_DATA::SaveCntlrImage(void)
 {
-  CNTLRDATA_println("cd: SavePersitantConfiguration()");
-  if ( SPIFFS.exists(file_cntlr_config))
+  CNTLRDATA_println("cd: SaveCntlrImage()");
+  cntlr_image img;
+
+  // hot fields are left as zero, they are saved in cntlr_oper.bin
+  memset(&img, 0, sizeof(img));
+  img.maxstep       = this->maxstep;
+  // SERVERS - SERVICES
+  img.ascom_en      = this->ascomsrvr_enable;
+  img.ascom_port    = this->ascomsrvr_port;
+  img.mngt_en       = this->mngsrvr_enable;
+  img.mngt_port     = this->mngsrvr_port;
+  img.tcp_en        = this->tcpipsrvr_enable;
+  img.tcp_port      = this->tcpipsrvr_port;
+  img.ws_en         = this->websrvr_enable;
+  img.ws_port       = this->websrvr_port;
+  img.ddns_en       = this->duckdns_enable;
+  image_putstr(img.ddns_d, this->duckdns_domain, sizeof(img.ddns_d));
+  image_putstr(img.ddns_t, this->duckdns_token, sizeof(img.ddns_t));
+  img.ddns_r        = this->duckdns_refreshtime;
+  image_putstr(img.ota_name, this->ota_name, sizeof(img.ota_name));
+  image_putstr(img.ota_pwd, this->ota_password, sizeof(img.ota_pwd));
+  image_putstr(img.ota_id, this->ota_id, sizeof(img.ota_id));
+  // DEVICES
+  img.d_en          = this->display_enable;
+  img.d_pgtime      = this->displaypagetime;
+  image_putstr(img.d_pgopt, this->displaypageoption, sizeof(img.d_pgopt));
+  img.d_updmove     = this->displayupdateonmove;
+  img.hpsw_en       = this->hpswitch_enable;
+  img.hpswmsg_en    = this->hpswmsg_enable;
+  img.stall_st      = this->stallguard_state;
+  img.stall_val     = this->stallguard_value;
+  img.tmc2225mA     = this->tmc2225current;
+  img.tmc2209mA     = this->tmc2209current;
+  img.led_en        = this->inoutled_enable;
+  img.led_mode      = this->inoutledmode;
+  img.joy1_en       = this->joystick1_enable;
+  img.joy2_en       = this->joystick2_enable;
+  img.pb_en         = this->pushbutton_enable;
+  img.pb_steps      = this->pushbutton_steps;
+  img.t_en          = this->tempprobe_enable;
+  img.t_mod         = this->tempmode;
+  img.t_coe         = this->tempcoefficient;
+  img.t_res         = this->tempresolution;
+  img.t_tcavail     = this->tcavailable;
+  img.blin_en       = this->backlash_in_enable;
+  img.blout_en      = this->backlash_out_enable;
+  img.blin_steps    = this->backlashsteps_in;
+  img.blout_steps   = this->backlashsteps_out;
+  img.dam_en        = this->delayaftermove_enable;
+  img.dam_time      = this->delayaftermove_time;
+  image_putstr(img.devname, this->devicename, sizeof(img.devname));
+  img.filelist      = this->filelistformat;
+  img.park_en       = this->park_enable;
+  img.park_time     = this->park_time;
+  img.rdir_en       = this->reverse_enable;
+  img.ss_en         = this->stepsize_enable;
+  img.ss_val        = this->stepsize;
+  // web page colors
+  image_putstr(img.ticol, this->titlecolor, sizeof(img.ticol));
+  image_putstr(img.scol, this->subtitlecolor, sizeof(img.scol));
+  image_putstr(img.hcol, this->headercolor, sizeof(img.hcol));
+  image_putstr(img.tcol, this->textcolor, sizeof(img.tcol));
+  image_putstr(img.bcol, this->backcolor, sizeof(img.bcol));
+
+  if ( WriteImage(file_cntlr_config, CFGIMAGE_CNTLR, CNTLRIMAGE_VERSION, image_fieldmask(cf_count) & ~CNTLR_HOTFIELDS, &img, sizeof(img)) == false )
   {
-    CNTLRDATA_println("cd: SavePersitantConfiguration: cntlr_config.jsn found: deleting");
-    SPIFFS.remove(file_cntlr_config);
+    ERROR_println("cd: SaveCntlrImage() write error");
+    return false;
   }
-  else
+  CNTLRDATA_println("cd: SaveCntlrImage: cntlr_config.bin written");
+  return true;
+}
+
+
+// ----------------------------------------------------------------------
+// Save Board Data to file board_config.bin
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::SaveBoardConfiguration()
+{
+  CNTLRDATA_println("cd: SaveBoardConfiguration() NOW");
+  board_image img;
+
+  memset(&img, 0, sizeof(img));
+  image_putstr(img.board, this->board, sizeof(img.board));
+  img.maxstepmode   = this->maxstepmode;
+  img.stepmode      = this->stepmode;
+  img.enpin         = this->enablepin;
+  img.steppin       = this->steppin;
+  img.dirpin        = this->dirpin;
+  img.temppin       = this->temppin;
+  img.hpswpin       = this->hpswpin;
+  img.inledpin      = this->inledpin;
+  img.outledpin     = this->outledpin;
+  img.pb1pin        = this->pb1pin;
+  img.pb2pin        = this->pb2pin;
+  img.irpin         = this->irpin;
+  img.brdnum        = this->boardnumber;
+  img.stepsrev      = this->stepsperrev;
+  img.fixedsmode    = this->fixedstepmode;
+  for (int i = 0; i < 4; i++)
   {
-    CNTLRDATA_println("cd: SavePersitantConfiguration() : file not found");
+    img.brdpins[i]  = this->boardpins[i];
   }
+  img.msdelay       = this->msdelay;
 
-  CNTLRDATA_println("cd: SavePersitantConfiguration: cntlr_config.jsn open file for write");
-  File file = SPIFFS.open(file_cntlr_config, "w");         // Open file for writing
-  if (!file)
+  if ( WriteImage(file_board_config, CFGIMAGE_BOARD, BOARDIMAGE_VERSION, image_fieldmask(bf_count), &img, sizeof(img)) == false )
   {
-    ERROR_println("cd: SavePersitantConfiguration() : file open for write error");
+    ERROR_println("cd: SaveBoardConfiguration(): write error");
     return false;
   }
-  CNTLRDATA_println("cd: SavePersitantConfiguration: prepare to write config file");
-  // Allocate a temporary JsonDocument
-  // Don't forget to change the capacity to match your requirements.
-  // Use arduinojson.org/assistant to compute the capacity.
-  CNTLRDATA_println("cd: SavePersitantConfiguration: serialize data");
+  CNTLRDATA_println("cd: SaveBoardConfiguration(): file written");
+  return true;
+}
+
+
+// ----------------------------------------------------------------------
+// Export the controller config as a json string, the same keys as the
+// legacy cntlr_config.jsn file - used by Management Server
+// ----------------------------------------------------------------------
+String CONTROLLER_DATA::get_cntlrconfig_json(void)
+{
+  String jsonstr;
   // 303 - 1170, Size 1536
-  StaticJsonDocument<DEFAULTDOCSIZE> doc;
+  DynamicJsonDocument doc(DEFAULTDOCSIZE);
 
   doc["maxstep"]      = this->maxstep;
   for (int i = 0; i < 10; i++)
@@ -784,8 +1728,8 @@ bool CONTROLLER_DATA::SavePersitantConfiguration()
   doc["d_pgopt"]    = this->displaypageoption;
   doc["d_updmove"]  = this->displayupdateonmove;  // update position on oled when moving
   // hpsw
-  doc["hpsw_en"]    = this->hpswmsg_enable;
-  doc["hpswmsg_en"] = this->hpswitch_enable;
+  doc["hpsw_en"]    = this->hpswitch_enable;
+  doc["hpswmsg_en"] = this->hpswmsg_enable;
   doc["stall_st"]   = this->stallguard_state;
   doc["stall_val"]  = this->stallguard_value;
   doc["tmc2225mA"]  = this->tmc2225current;
@@ -837,85 +1781,265 @@ bool CONTROLLER_DATA::SavePersitantConfiguration()
   doc["hcol"]       = this->headercolor;
   doc["tcol"]       = this->textcolor;
   doc["bcol"]       = this->backcolor;
-  // Serialize JSON to file
-  if (serializeJson(doc, file) == 0)
+
+  serializeJson(doc, jsonstr);
+  return jsonstr;
+}
+
+
+// ----------------------------------------------------------------------
+// Export the board config as a json string, the same keys as the
+// /boards/xx.jsn files - used by Management Server
+// ----------------------------------------------------------------------
+String CONTROLLER_DATA::get_boardconfig_json(void)
+{
+  String jsonstr;
+  DynamicJsonDocument doc_brd(DEFAULTBOARDSIZE);
+
+  doc_brd["board"]        = this->board;
+  doc_brd["maxstepmode"]  = this->maxstepmode;
+  doc_brd["stepmode"]     = this->stepmode;
+  doc_brd["enpin"]        = this->enablepin;
+  doc_brd["steppin"]      = this->steppin;
+  doc_brd["dirpin"]       = this->dirpin;
+  doc_brd["temppin"]      = this->temppin;
+  doc_brd["hpswpin"]      = this->hpswpin;
+  doc_brd["inledpin"]     = this->inledpin;
+  doc_brd["outledpin"]    = this->outledpin;
+  doc_brd["pb1pin"]       = this->pb1pin;
+  doc_brd["pb2pin"]       = this->pb2pin;
+  doc_brd["irpin"]        = this->irpin;
+  doc_brd["brdnum"]       = this->boardnumber;
+  doc_brd["stepsrev"]     = this->stepsperrev;
+  doc_brd["fixedsmode"]   = this->fixedstepmode;
+  for (int i = 0; i < 4; i++)
   {
-    ERROR_println("cd: SavePersitantConfiguration() serialise error");
-    file.close();
+    doc_brd["brdpins"][i] = this->boardpins[i];
+  }
+  doc_brd["msdelay"]      = this->msdelay;
+
+  serializeJson(doc_brd, jsonstr);
+  return jsonstr;
+}
+
+
+// ----------------------------------------------------------------------
+// Import a json controller config - used by Management Server
+// Keys which are missing keep their current value. Each value is range
+// checked and applied through its set_() so that it takes effect now,
+// the binary image is then saved by the delayed update
+// ----------------------------------------------------------------------
+bool CONTROLLER_DATA::ImportCntlrConfigJson(String jsonstr)
+{
+  DynamicJsonDocument doc_per(DEFAULTDOCSIZE);
+  DeserializationError error = deserializeJson(doc_per, jsonstr);
+  if ( error )
+  {
+    ERROR_println("cd: deserialise error, cntlr config import");
     return false;
   }
+  String str;
+
+  set_maxstep(json_range(doc_per["maxstep"] | this->maxstep, FOCUSERLOWERLIMIT, FOCUSERUPPERLIMIT));
+  for (int i = 0; i < 10; i++)
+  {
+    set_focuserpreset(i, json_range(doc_per["preset"][i] | this->focuserpreset[i], 0, this->maxstep));
+  }
+  // SERVERS - SERVICES, a port is only changed if all four stay different
+  set_ascomsrvr_enable(json_range(doc_per["ascom_en"] | this->ascomsrvr_enable, 0, 1));
+  set_mngsrvr_enable(json_range(doc_per["mngt_en"] | this->mngsrvr_enable, 0, 1));
+  set_tcpipsrvr_enable(json_range(doc_per["tcp_en"] | this->tcpipsrvr_enable, 0, 1));
+  set_websrvr_enable(json_range(doc_per["ws_en"] | this->websrvr_enable, 0, 1));
+  unsigned long ascomport = json_range(doc_per["ascom_port"] | this->ascomsrvr_port, 1, 65535);
+  unsigned long mngtport  = json_range(doc_per["mngt_port"] | this->mngsrvr_port, 1, 65535);
+  unsigned long tcpport   = json_range(doc_per["tcp_port"] | this->tcpipsrvr_port, 1, 65535);
+  unsigned long wsport    = json_range(doc_per["ws_port"] | this->websrvr_port, 1, 65535);
+  if ( (ascomport != mngtport) && (ascomport != tcpport) && (ascomport != wsport)
+       && (mngtport != tcpport) && (mngtport != wsport) && (tcpport != wsport) )
+  {
+    set_ascomsrvr_port(ascomport);
+    set_mngsrvr_port(mngtport);
+    set_tcpipsrvr_port(tcpport);
+    set_websrvr_port(wsport);
+  }
   else
   {
-    CNTLRDATA_println("cd: SavePersitantConfiguration: cntlr_config.jsn written");
-    file.close();
-    return true;
+    ERROR_println("cd: cntlr config import, duplicate server ports ignored");
   }
+  set_duckdns_enable(json_range(doc_per["ddns_en"] | this->duckdns_enable, 0, 1));
+  str = this->duckdns_domain;
+  json_getstr(doc_per["ddns_d"].as<const char*>(), str);
+  set_duckdns_domain(str);
+  str = this->duckdns_token;
+  json_getstr(doc_per["ddns_t"].as<const char*>(), str);
+  set_duckdns_token(str);
+  set_duckdns_refreshtime(json_range(doc_per["ddns_r"] | this->duckdns_refreshtime, 60, 3600));
+  str = this->ota_name;
+  json_getstr(doc_per["ota_name"].as<const char*>(), str);
+  set_ota_name(str);
+  str = this->ota_password;
+  json_getstr(doc_per["ota_pwd"].as<const char*>(), str);
+  set_ota_password(str);
+  str = this->ota_id;
+  json_getstr(doc_per["ota_id"].as<const char*>(), str);
+  set_ota_id(str);
+  // DEVICES
+  set_display_enable(json_range(doc_per["d_en"] | this->display_enable, 0, 1));
+  set_displaypagetime(json_range(doc_per["d_pgtime"] | this->displaypagetime, V_DISPLAYPAGETIMEMIN, V_DISPLAYPAGETIMEMAX));
+  str = this->displaypageoption;
+  json_getstr(doc_per["d_pgopt"].as<const char*>(), str);
+  set_displaypageoption(str);
+  set_displayupdateonmove(json_range(doc_per["d_updmove"] | this->displayupdateonmove, 0, 1));
+  set_hpswitch_enable(json_range(doc_per["hpsw_en"] | this->hpswitch_enable, 0, 1));
+  set_hpswmsg_enable(json_range(doc_per["hpswmsg_en"] | this->hpswmsg_enable, 0, 1));
+  set_stallguard_state((tmc2209stallguard) json_range(doc_per["stall_st"] | (int) this->stallguard_state, Use_Stallguard, Use_None));
+  set_stallguard_value(json_range(doc_per["stall_val"] | this->stallguard_value, 0, 255));
+  set_tmc2225current(json_range(doc_per["tmc2225mA"] | this->tmc2225current, 0, 2000));
+  set_tmc2209current(json_range(doc_per["tmc2209mA"] | this->tmc2209current, 0, 2000));
+  set_inoutled_enable(json_range(doc_per["led_en"] | this->inoutled_enable, 0, 1));
+  set_inoutledmode(json_range(doc_per["led_mode"] | this->inoutledmode, LEDPULSE, LEDMOVE));
+  set_joystick1_enable(json_range(doc_per["joy1_en"] | this->joystick1_enable, 0, 1));
+  set_joystick2_enable(json_range(doc_per["joy2_en"] | this->joystick2_enable, 0, 1));
+  set_pushbutton_enable(json_range(doc_per["pb_en"] | this->pushbutton_enable, 0, 1));
+  set_pushbutton_steps(json_range(doc_per["pb_steps"] | this->pushbutton_steps, 1, 1000));
+  set_tempprobe_enable(json_range(doc_per["t_en"] | this->tempprobe_enable, 0, 1));
+  set_tempcomp_enable(json_range(doc_per["t_comp_en"] | this->tempcomp_enable, 0, 1));
+  set_tempmode(json_range(doc_per["t_mod"] | this->tempmode, 0, 1));
+  set_tempcoefficient(json_range(doc_per["t_coe"] | this->tempcoefficient, 0, 400));
+  set_tempresolution(json_range(doc_per["t_res"] | this->tempresolution, 9, 12));
+  set_tcdirection(json_range(doc_per["t_tcdir"] | this->tcdirection, 0, 1));
+  set_tcavailable(json_range(doc_per["t_tcavail"] | this->tcavailable, 0, 1));
+  set_backlash_in_enable(json_range(doc_per["blin_en"] | this->backlash_in_enable, 0, 1));
+  set_backlash_out_enable(json_range(doc_per["blout_en"] | this->backlash_out_enable, 0, 1));
+  set_backlashsteps_in(json_range(doc_per["blin_steps"] | this->backlashsteps_in, 0, 255));
+  set_backlashsteps_out(json_range(doc_per["blout_steps"] | this->backlashsteps_out, 0, 255));
+  set_coilpower_enable(json_range(doc_per["cp_en"] | this->coilpower_enable, 0, 1));
+  set_delayaftermove_enable(json_range(doc_per["dam_en"] | this->delayaftermove_enable, 0, 1));
+  set_delayaftermove_time(json_range(doc_per["dam_time"] | this->delayaftermove_time, 0, 255));
+  str = this->devicename;
+  json_getstr(doc_per["devname"].as<const char*>(), str);
+  set_devicename(str);
+  set_filelistformat(json_range(doc_per["filelist"] | this->filelistformat, LISTSHORT, LISTLONG));
+  set_motorspeed(json_range(doc_per["mspeed"] | this->motorspeed, SLOW, FAST));
+  set_park_enable(json_range(doc_per["park_en"] | this->park_enable, 0, 1));
+  set_parktime(json_range(doc_per["park_time"] | this->park_time, 0, 600));
+  set_reverse_enable(json_range(doc_per["rdir_en"] | this->reverse_enable, 0, 1));
+  set_stepsize_enable(json_range(doc_per["ss_en"] | this->stepsize_enable, 0, 1));
+  float ss = doc_per["ss_val"] | this->stepsize;
+  ss = (ss < MINIMUMSTEPSIZE) ? MINIMUMSTEPSIZE : ss;
+  ss = (ss > MAXIMUMSTEPSIZE) ? MAXIMUMSTEPSIZE : ss;
+  set_stepsize(ss);
+  // web page colors
+  str = this->titlecolor;
+  json_getstr(doc_per["ticol"].as<const char*>(), str);
+  set_wp_titlecolor(str);
+  str = this->subtitlecolor;
+  json_getstr(doc_per["scol"].as<const char*>(), str);
+  set_wp_subtitlecolor(str);
+  str = this->headercolor;
+  json_getstr(doc_per["hcol"].as<const char*>(), str);
+  set_wp_headercolor(str);
+  str = this->textcolor;
+  json_getstr(doc_per["tcol"].as<const char*>(), str);
+  set_wp_textcolor(str);
+  str = this->backcolor;
+  json_getstr(doc_per["bcol"].as<const char*>(), str);
+  set_wp_backcolor(str);
+  return true;
 }
 
 
 // ----------------------------------------------------------------------
-// Save Board Data to file board_config.jsn
+// Compare the load time of the controller config as json and as a
+// binary image, both loaded from SPIFFS. Any pending save is written
+// first so that both loads read the current settings. Both are loaded
+// into scratch copies, the running settings are not changed.
+// Returns a json string - used by Management Server
 // ----------------------------------------------------------------------
-bool CONTROLLER_DATA::SaveBoardConfiguration()
+String CONTROLLER_DATA::ConfigLoadBenchmark(void)
 {
-  CNTLRDATA_println("cd: SaveBoardConfiguration() NOW");
-  if ( SPIFFS.exists(file_board_config))
+  if ( (tasksched->armed(this->_job_cntlr) == true) || (this->_save_due & SAVEDUE_CNTLR) )
   {
-    CNTLRDATA_println("cd: SaveBoardConfiguration(): board_config.jsn found: deleting");
-    SPIFFS.remove(file_board_config);
+    tasksched->stop(this->_job_cntlr);
+    this->_save_due &= ~SAVEDUE_CNTLR;
+    SavePersitantConfiguration();
   }
-  CNTLRDATA_println("cd: SaveBoardConfiguration(): board_config.jsn preparing to write");
-  File bfile = SPIFFS.open(file_board_config, "w");         // Open file for writing
-  if (!bfile)
+
+  // write the current config as a json file
+  String jsonstr = get_cntlrconfig_json();
+  File jfile = FILESYS.open(file_bench_json, "w");
+  if (!jfile)
   {
-    CNTLRDATA_println("cd: SaveBoardConfiguration() : write board_config.jsn error");
-    return false;
+    return "{ \"err\":\"unable to write file\" }";
   }
-  else
-  {
-    // Allocate a temporary JsonDocument
-    // Don't forget to change the capacity to match your requirements.
-    // Use arduinojson.org/assistant to compute the capacity.
-    StaticJsonDocument<DEFAULTBOARDSIZE> doc_brd;
-    CNTLRDATA_println("cd: SaveBoardConfiguration(): prepare to write board_config.jsn file");
-    // Set the values in the document
-    doc_brd["board"]        = this->board;
-    doc_brd["maxstepmode"]  = this->maxstepmode;
-    doc_brd["stepmode"]     = this->stepmode;
-    doc_brd["enpin"]        = this->enablepin;
-    doc_brd["steppin"]      = this->steppin;
-    doc_brd["dirpin"]       = this->dirpin;
-    doc_brd["temppin"]      = this->temppin;
-    doc_brd["hpswpin"]      = this->hpswpin;
-    doc_brd["inledpin"]     = this->inledpin;
-    doc_brd["outledpin"]    = this->outledpin;
-    doc_brd["pb1pin"]       = this->pb1pin;
-    doc_brd["pb2pin"]       = this->pb2pin;
-    doc_brd["irpin"]        = this->irpin;
-    doc_brd["brdnum"]       = this->boardnumber;
-    doc_brd["stepsrev"]     = this->stepsperrev;
-    doc_brd["fixedsmode"]   = this->fixedstepmode;
-    for (int i = 0; i < 4; i++)
-    {
-      doc_brd["brdpins"][i] = this->boardpins[i];
-    }
-    doc_brd["msdelay"]      = this->msdelay;
+  jfile.print(jsonstr);
+  jfile.close();
 
-    // Serialize JSON to file
-    CNTLRDATA_println("cd: SaveBoardConfiguration(): serialise data");
-    if (serializeJson(doc_brd, bfile) == 0)
-    {
-      ERROR_println("cd: SaveBoardConfiguration(): serialise error");
-      bfile.close();
-      return false;
-    }
-    else
-    {
-      CNTLRDATA_println("cd: SaveBoardConfiguration(): file written");
-      bfile.close();
-    }
+  unsigned long jsonstart = micros();
+  bool jsonok = false;
+  jfile = FILESYS.open(file_bench_json, "r");
+  if (jfile)
+  {
+    String cdata = jfile.readString();
+    jfile.close();
+    DynamicJsonDocument doc_bench(DEFAULTDOCSIZE);
+    jsonok = !deserializeJson(doc_bench, cdata);
   }
-  return true;
+  unsigned long jsontime = micros() - jsonstart;
+  FILESYS.remove(file_bench_json);
+
+  unsigned long binstart = micros();
+  cntlr_image cimg;
+  oper_image oimg;
+  uint32_t present[2];
+  byte version;
+  bool binok = ReadImage(file_cntlr_config, CFGIMAGE_CNTLR, &cimg, sizeof(cimg), version, present)
+               && ReadImage(file_cntlr_oper, CFGIMAGE_OPER, &oimg, sizeof(oimg), version, present);
+  unsigned long bintime = micros() - binstart;
+
+  // the binary config is held in two images, cold and hot
+  size_t binsize = 0;
+  File bfile = FILESYS.open(file_cntlr_config, "r");
+  if (bfile)
+  {
+    binsize = bfile.size();
+    bfile.close();
+  }
+  bfile = FILESYS.open(file_cntlr_oper, "r");
+  if (bfile)
+  {
+    binsize += bfile.size();
+    bfile.close();
+  }
+
+  String result = "{ \"bootload\":" + String(this->_cfg_loadtime) \
+                  + ", \"bootsource\":\"" + this->_cfg_loadsource \
+                  + "\", \"jsonload\":" + String(jsonok ? jsontime : 0) \
+                  + ", \"jsonsize\":" + String(jsonstr.length()) \
+                  + ", \"binload\":" + String(binok ? bintime : 0) \
+                  + ", \"binsize\":" + String(binsize) + " }";
+  return result;
+}
+
+
+// ----------------------------------------------------------------------
+// Save counters for each config image, number of saves and bytes written
+// since boot. Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String CONTROLLER_DATA::get_cfgsave_stats(void)
+{
+  char dirty[20];
+  snprintf(dirty, sizeof(dirty), "%08x%08x", (unsigned int) (this->_cntlr_dirty >> 32), (unsigned int) this->_cntlr_dirty);
+  String result = "{ \"opersaves\":" + String(this->_cfg_saves[CFGIMAGE_OPER]) \
+                  + ", \"operbytes\":" + String(this->_cfg_bytes[CFGIMAGE_OPER]) \
+                  + ", \"cntlrsaves\":" + String(this->_cfg_saves[CFGIMAGE_CNTLR]) \
+                  + ", \"cntlrbytes\":" + String(this->_cfg_bytes[CFGIMAGE_CNTLR]) \
+                  + ", \"boardsaves\":" + String(this->_cfg_saves[CFGIMAGE_BOARD]) \
+                  + ", \"boardbytes\":" + String(this->_cfg_bytes[CFGIMAGE_BOARD]) \
+                  + ", \"varsaves\":" + String(this->_cfg_saves[CFGIMAGE_VAR]) \
+                  + ", \"varbytes\":" + String(this->_cfg_bytes[CFGIMAGE_VAR]) \
+                  + ", \"dirty\":\"" + String(dirty) + "\" }";
+  return result;
 }
 
 
@@ -1249,10 +2373,8 @@ String CONTROLLER_DATA::get_wp_subtitlecolor(void)
 void CONTROLLER_DATA::set_fposition(long fposition)
 {
   this->fposition = fposition;                          // last focuser position
-  portENTER_CRITICAL(&varMux);
-  save_var_flag = 0;
-  portEXIT_CRITICAL(&varMux);
-  CNTLRDATA_println("cd: set_fposition: Set var flag: var flag and count to 0, start count");
+  tasksched->start(this->_job_var);
+  CNTLRDATA_println("cd: set_fposition: start delayed save of var");
 }
 
 void CONTROLLER_DATA::set_focuserdirection(byte newdir)
@@ -1262,190 +2384,188 @@ void CONTROLLER_DATA::set_focuserdirection(byte newdir)
 
 void CONTROLLER_DATA::set_maxstep(long newval)
 {
-  this->StartDelayedUpdate(this->maxstep, newval);      // max steps
+  this->StartDelayedUpdate(this->maxstep, newval, cf_maxstep);      // max steps
 }
 
 void CONTROLLER_DATA::set_focuserpreset(byte idx, long pos)
 {
-  this->StartDelayedUpdate(this->focuserpreset[idx % 10], pos);
+  this->StartDelayedUpdate(this->focuserpreset[idx % 10], pos, cf_preset);
 }
 
 void CONTROLLER_DATA::set_display_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->display_enable, newstate);
+  this->StartDelayedUpdate(this->display_enable, newstate, cf_d_en);
 }
 
 void CONTROLLER_DATA::set_duckdns_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->duckdns_enable, newstate);
+  this->StartDelayedUpdate(this->duckdns_enable, newstate, cf_ddns_en);
 }
 
 void CONTROLLER_DATA::set_tempprobe_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->tempprobe_enable, newstate);
+  this->StartDelayedUpdate(this->tempprobe_enable, newstate, cf_t_en);
 }
 
 void CONTROLLER_DATA::set_ascomsrvr_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->ascomsrvr_enable, newstate);
+  this->StartDelayedUpdate(this->ascomsrvr_enable, newstate, cf_ascom_en);
 }
 
 void CONTROLLER_DATA::set_mngsrvr_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->mngsrvr_enable, newstate);
+  this->StartDelayedUpdate(this->mngsrvr_enable, newstate, cf_mngt_en);
 }
 
 void CONTROLLER_DATA::set_tcpipsrvr_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->tcpipsrvr_enable, newstate);
+  this->StartDelayedUpdate(this->tcpipsrvr_enable, newstate, cf_tcp_en);
 }
 
 void CONTROLLER_DATA::set_websrvr_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->websrvr_enable, newstate);
+  this->StartDelayedUpdate(this->websrvr_enable, newstate, cf_ws_en);
 }
 
 void CONTROLLER_DATA::set_backlash_in_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->backlash_in_enable, newstate);
+  this->StartDelayedUpdate(this->backlash_in_enable, newstate, cf_blin_en);
 }
 
 void CONTROLLER_DATA::set_backlash_out_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->backlash_out_enable, newstate);
+  this->StartDelayedUpdate(this->backlash_out_enable, newstate, cf_blout_en);
 }
 
 void CONTROLLER_DATA::set_coilpower_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->coilpower_enable, newstate);
+  this->StartDelayedUpdate(this->coilpower_enable, newstate, cf_cp_en);
 }
 
 void CONTROLLER_DATA::set_delayaftermove_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->delayaftermove_enable, newstate);
+  this->StartDelayedUpdate(this->delayaftermove_enable, newstate, cf_dam_en);
 }
 
 void CONTROLLER_DATA::set_hpswmsg_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->hpswmsg_enable, newstate);
+  this->StartDelayedUpdate(this->hpswmsg_enable, newstate, cf_hpswmsg_en);
 }
 
 void CONTROLLER_DATA::set_hpswitch_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->hpswitch_enable, newstate);
+  this->StartDelayedUpdate(this->hpswitch_enable, newstate, cf_hpsw_en);
 }
 
 void CONTROLLER_DATA::set_inoutled_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->inoutled_enable, newstate);
+  this->StartDelayedUpdate(this->inoutled_enable, newstate, cf_led_en);
 }
 
 void CONTROLLER_DATA::set_park_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->park_enable, newstate);
+  this->StartDelayedUpdate(this->park_enable, newstate, cf_park_en);
 }
 
 void CONTROLLER_DATA::set_pushbutton_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->pushbutton_enable, newstate);
+  this->StartDelayedUpdate(this->pushbutton_enable, newstate, cf_pb_en);
 }
 
 void CONTROLLER_DATA::set_joystick1_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->joystick1_enable, newstate);
+  this->StartDelayedUpdate(this->joystick1_enable, newstate, cf_joy1_en);
 }
 
 void CONTROLLER_DATA::set_joystick2_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->joystick2_enable, newstate);
+  this->StartDelayedUpdate(this->joystick2_enable, newstate, cf_joy2_en);
 }
 
 void CONTROLLER_DATA::set_reverse_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->reverse_enable, newstate);
+  this->StartDelayedUpdate(this->reverse_enable, newstate, cf_rdir_en);
 }
 
 void CONTROLLER_DATA::set_stepsize_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->stepsize_enable, newstate); // if 1, controller returns step size
+  this->StartDelayedUpdate(this->stepsize_enable, newstate, cf_ss_en); // if 1, controller returns step size
 }
 
 void CONTROLLER_DATA::set_tempcomp_enable(byte newstate)
 {
-  this->StartDelayedUpdate(this->tempcomp_enable, newstate); // indicates if temperature compensation is enabled
+  this->StartDelayedUpdate(this->tempcomp_enable, newstate, cf_t_comp_en); // indicates if temperature compensation is enabled
 }
 
 void CONTROLLER_DATA::set_ascomsrvr_port(unsigned long newport)
 {
-  this->StartDelayedUpdate(this->ascomsrvr_port, newport);
+  this->StartDelayedUpdate(this->ascomsrvr_port, newport, cf_ascom_port);
 }
 
 void CONTROLLER_DATA::set_mngsrvr_port(unsigned long newport)
 {
-  this->StartDelayedUpdate(this->mngsrvr_port, newport);
+  this->StartDelayedUpdate(this->mngsrvr_port, newport, cf_mngt_port);
 }
 
 void CONTROLLER_DATA::set_tcpipsrvr_port(unsigned long newport)
 {
-  this->StartDelayedUpdate(this->tcpipsrvr_port, newport);
+  this->StartDelayedUpdate(this->tcpipsrvr_port, newport, cf_tcp_port);
 }
 
 void CONTROLLER_DATA::set_websrvr_port(unsigned long newport)
 {
-  this->StartDelayedUpdate(this->websrvr_port, newport);
+  this->StartDelayedUpdate(this->websrvr_port, newport, cf_ws_port);
 }
 
 void CONTROLLER_DATA::set_duckdns_domain(String newdomain)
 {
-  this->StartDelayedUpdate(this->duckdns_domain, newdomain);
+  this->StartDelayedUpdate(this->duckdns_domain, newdomain, cf_ddns_d);
 }
 
 void CONTROLLER_DATA::set_duckdns_token(String newtoken)
 {
-  this->StartDelayedUpdate(this->duckdns_token, newtoken);
+  this->StartDelayedUpdate(this->duckdns_token, newtoken, cf_ddns_t);
 }
 
 void CONTROLLER_DATA::set_ota_name(String newname)
 {
-  this->StartDelayedUpdate(this->ota_name, newname);
+  this->StartDelayedUpdate(this->ota_name, newname, cf_ota_name);
 }
 
 void CONTROLLER_DATA::set_ota_password(String newpwd)
 {
-  this->StartDelayedUpdate(this->ota_password, newpwd);
+  this->StartDelayedUpdate(this->ota_password, newpwd, cf_ota_pwd);
 }
 
 void CONTROLLER_DATA::set_ota_id(String newid)
 {
-  this->StartDelayedUpdate(this->ota_id, newid);
+  this->StartDelayedUpdate(this->ota_id, newid, cf_ota_id);
 }
 
 void CONTROLLER_DATA::set_backlashsteps_in(byte newval)
 {
-  this->StartDelayedUpdate(this->backlashsteps_in, newval); // number of backlash steps to apply for IN moves
+  this->StartDelayedUpdate(this->backlashsteps_in, newval, cf_blin_steps); // number of backlash steps to apply for IN moves
 }
 
 void CONTROLLER_DATA::set_backlashsteps_out(byte newval)
 {
-  this->StartDelayedUpdate(this->backlashsteps_out, newval); // number of backlash steps to apply for OUT moves
+  this->StartDelayedUpdate(this->backlashsteps_out, newval, cf_blout_steps); // number of backlash steps to apply for OUT moves
 }
 
 void CONTROLLER_DATA::set_delayaftermove_time(byte newtime)
 {
-  this->StartDelayedUpdate(this->delayaftermove_time, newtime);
+  this->StartDelayedUpdate(this->delayaftermove_time, newtime, cf_dam_time);
 }
 
 void CONTROLLER_DATA::set_devicename(String newname)
 {
-  this->StartDelayedUpdate(this->devicename, newname);
+  this->StartDelayedUpdate(this->devicename, newname, cf_devname);
 }
 
 void CONTROLLER_DATA::set_displaypagetime(int newtime)
 {
-  portENTER_CRITICAL(&displaytimeMux);
-  display_maxcount = newtime * 10;                         // convert to timeslices
-  portEXIT_CRITICAL(&displaytimeMux);
-  this->StartDelayedUpdate(this->displaypagetime, newtime);
+  tasksched->set_period(job_display, newtime * 1000);
+  this->StartDelayedUpdate(this->displaypagetime, newtime, cf_d_pgtime);
 }
 
 void CONTROLLER_DATA::set_displaypageoption(String newoption)
@@ -1457,192 +2577,203 @@ void CONTROLLER_DATA::set_displaypageoption(String newoption)
   }
   tmp = tmp + "";
   this->displaypageoption = tmp;
-  this->StartDelayedUpdate(this->displaypageoption, newoption);
+  this->StartDelayedUpdate(this->displaypageoption, newoption, cf_d_pgopt);
 }
 
 void CONTROLLER_DATA::set_displayupdateonmove(byte newstate)
 {
-  this->StartDelayedUpdate(this->displayupdateonmove, newstate); // update position on oled when moving
+  this->StartDelayedUpdate(this->displayupdateonmove, newstate, cf_d_updmove); // update position on oled when moving
 }
 
 void CONTROLLER_DATA::set_duckdns_refreshtime(unsigned int newtime)
 {
-  this->StartDelayedUpdate(this->duckdns_refreshtime, newtime);
+  this->StartDelayedUpdate(this->duckdns_refreshtime, newtime, cf_ddns_r);
 }
 
 void CONTROLLER_DATA::set_inoutledmode(byte newmode)
 {
-  this->StartDelayedUpdate(this->inoutledmode, newmode);
+  this->StartDelayedUpdate(this->inoutledmode, newmode, cf_led_mode);
 }
 
 void CONTROLLER_DATA::set_motorspeed(byte newval)
 {
-  this->StartDelayedUpdate(this->motorspeed, newval);
+  this->StartDelayedUpdate(this->motorspeed, newval, cf_mspeed);
 }
 
 void CONTROLLER_DATA::set_parktime(int newtime)
 {
-  this->StartDelayedUpdate(this->park_time, newtime);
+  tasksched->set_period(job_park, newtime * 1000);
+  this->StartDelayedUpdate(this->park_time, newtime, cf_park_time);
 }
 
 void CONTROLLER_DATA::set_pushbutton_steps(int newval)
 {
-  this->StartDelayedUpdate(this->pushbutton_steps, newval);
+  this->StartDelayedUpdate(this->pushbutton_steps, newval, cf_pb_steps);
 }
 
 void CONTROLLER_DATA::set_stepsize(float newval)
 {
-  this->StartDelayedUpdate(this->stepsize, newval);   // the step size in microns, ie 7.2 - value * 10, so real stepsize = stepsize / 10 (maxval = 25.6)
+  this->StartDelayedUpdate(this->stepsize, newval, cf_ss_val);   // the step size in microns, ie 7.2 - value * 10, so real stepsize = stepsize / 10 (maxval = 25.6)
 }
 
 void CONTROLLER_DATA::set_tempmode(byte newmode)
 {
-  this->StartDelayedUpdate(this->tempmode, newmode);   // temperature display mode, Celcius=1, Fahrenheit=0
+  this->StartDelayedUpdate(this->tempmode, newmode, cf_t_mod);   // temperature display mode, Celcius=1, Fahrenheit=0
 }
 
 void CONTROLLER_DATA::set_tempcoefficient(int newval)
 {
-  this->StartDelayedUpdate(this->tempcoefficient, newval); // steps per degree temperature coefficient value (maxval=256)
+  this->StartDelayedUpdate(this->tempcoefficient, newval, cf_t_coe); // steps per degree temperature coefficient value (maxval=256)
 }
 
 void CONTROLLER_DATA::set_tempresolution(byte newval)
 {
-  this->StartDelayedUpdate(this->tempresolution, newval);
+  this->StartDelayedUpdate(this->tempresolution, newval, cf_t_res);
 }
 
 void CONTROLLER_DATA::set_tcdirection(byte newdirection)
 {
-  this->StartDelayedUpdate(this->tcdirection, newdirection);
+  this->StartDelayedUpdate(this->tcdirection, newdirection, cf_t_tcdir);
 }
 
 void CONTROLLER_DATA::set_tcavailable(byte newval)
 {
-  this->StartDelayedUpdate(this->tcavailable, newval);
+  this->StartDelayedUpdate(this->tcavailable, newval, cf_t_tcavail);
 }
 
 void CONTROLLER_DATA::set_stallguard_state(tmc2209stallguard newstate)
 {
-  this->StartDelayedUpdate(this->stallguard_state, newstate);
+  this->StartDelayedUpdate(this->stallguard_state, newstate, cf_stall_st);
 }
 
 void CONTROLLER_DATA::set_stallguard_value(byte newval)
 {
-  this->StartDelayedUpdate(this->stallguard_value, newval);
+  this->StartDelayedUpdate(this->stallguard_value, newval, cf_stall_val);
 }
 
 void CONTROLLER_DATA::set_tmc2225current(int newval)
 {
-  this->StartDelayedUpdate(this->tmc2225current, newval);
+  this->StartDelayedUpdate(this->tmc2225current, newval, cf_tmc2225mA);
 }
 
 void CONTROLLER_DATA::set_tmc2209current(int newval)
 {
-  this->StartDelayedUpdate(this->tmc2209current, newval);
+  this->StartDelayedUpdate(this->tmc2209current, newval, cf_tmc2209mA);
 }
 
 void CONTROLLER_DATA::set_filelistformat(byte newlistformat)
 {
-  this->StartDelayedUpdate(this->filelistformat, newlistformat);
+  this->StartDelayedUpdate(this->filelistformat, newlistformat, cf_filelist);
 }
 
 void CONTROLLER_DATA::set_wp_backcolor(String newcolor)
 {
-  this->StartDelayedUpdate(this->backcolor, newcolor);
+  this->StartDelayedUpdate(this->backcolor, newcolor, cf_bcol);
 }
 
 void CONTROLLER_DATA::set_wp_textcolor(String newcolor)
 {
-  this->StartDelayedUpdate(this->textcolor, newcolor);
+  this->StartDelayedUpdate(this->textcolor, newcolor, cf_tcol);
 }
 
 void CONTROLLER_DATA::set_wp_headercolor(String newcolor)
 {
-  this->StartDelayedUpdate(this->headercolor, newcolor);
+  this->StartDelayedUpdate(this->headercolor, newcolor, cf_hcol);
 }
 
 void CONTROLLER_DATA::set_wp_titlecolor(String newcolor)
 {
-  this->StartDelayedUpdate(this->titlecolor, newcolor);
+  this->StartDelayedUpdate(this->titlecolor, newcolor, cf_ticol);
 }
 
 void CONTROLLER_DATA::set_wp_subtitlecolor(String newcolor)
 {
-  this->StartDelayedUpdate(this->subtitlecolor, newcolor);
+  this->StartDelayedUpdate(this->subtitlecolor, newcolor, cf_scol);
 }
 
 
 // ----------------------------------------------------------------------
 // Delayed Write routines which update the focuser setting with the
-// new value, then sets a flag for when the data should be written to file
+// new value, mark the field as dirty, then sets a flag for when the data
+// should be written to file. Only the sections (hot/cold) which hold a
+// dirty field are written
 // ----------------------------------------------------------------------
-void CONTROLLER_DATA::StartDelayedUpdate(int & org_data, int new_data)
+void CONTROLLER_DATA::StartDelayedUpdate(int & org_data, int new_data, byte field)
 {
   if (org_data != new_data)
   {
     org_data = new_data;
+    this->_cntlr_dirty |= CFGIMAGE_FIELD(field);
     this->set_cntlr_flags();
   }
 }
 
-void CONTROLLER_DATA::StartDelayedUpdate(tmc2209stallguard & org_data, tmc2209stallguard new_data)
+void CONTROLLER_DATA::StartDelayedUpdate(tmc2209stallguard & org_data, tmc2209stallguard new_data, byte field)
 {
   if (org_data != new_data)
   {
     org_data = new_data;
+    this->_cntlr_dirty |= CFGIMAGE_FIELD(field);
     this->set_cntlr_flags();
   }
 }
 
-void CONTROLLER_DATA::StartDelayedUpdate(unsigned int & org_data, unsigned int new_data)
+void CONTROLLER_DATA::StartDelayedUpdate(unsigned int & org_data, unsigned int new_data, byte field)
 {
   if (org_data != new_data)
   {
     org_data = new_data;
+    this->_cntlr_dirty |= CFGIMAGE_FIELD(field);
     this->set_cntlr_flags();
   }
 }
 
-void CONTROLLER_DATA::StartDelayedUpdate(long & org_data, long new_data)
+void CONTROLLER_DATA::StartDelayedUpdate(long & org_data, long new_data, byte field)
 {
   if (org_data != new_data)
   {
     org_data = new_data;
+    this->_cntlr_dirty |= CFGIMAGE_FIELD(field);
     this->set_cntlr_flags();
   }
 }
 
-void CONTROLLER_DATA::StartDelayedUpdate(unsigned long & org_data, unsigned long new_data)
+void CONTROLLER_DATA::StartDelayedUpdate(unsigned long & org_data, unsigned long new_data, byte field)
 {
   if (org_data != new_data)
   {
     org_data = new_data;
+    this->_cntlr_dirty |= CFGIMAGE_FIELD(field);
     this->set_cntlr_flags();
   }
 }
 
-void CONTROLLER_DATA::StartDelayedUpdate(float & org_data, float new_data)
+void CONTROLLER_DATA::StartDelayedUpdate(float & org_data, float new_data, byte field)
 {
   if (org_data != new_data)
   {
     org_data = new_data;
+    this->_cntlr_dirty |= CFGIMAGE_FIELD(field);
     this->set_cntlr_flags();
   }
 }
 
-void CONTROLLER_DATA::StartDelayedUpdate(byte & org_data, byte new_data)
+void CONTROLLER_DATA::StartDelayedUpdate(byte & org_data, byte new_data, byte field)
 {
   if (org_data != new_data)
   {
     org_data = new_data;
+    this->_cntlr_dirty |= CFGIMAGE_FIELD(field);
     this->set_cntlr_flags();
   }
 }
 
-void CONTROLLER_DATA::StartDelayedUpdate(String & org_data, String new_data)
+void CONTROLLER_DATA::StartDelayedUpdate(String & org_data, String new_data, byte field)
 {
   if (org_data != new_data)
   {
     org_data = new_data;
+    this->_cntlr_dirty |= CFGIMAGE_FIELD(field);
     this->set_cntlr_flags();
   }
 }
@@ -1653,7 +2784,7 @@ void CONTROLLER_DATA::StartDelayedUpdate(String & org_data, String new_data)
 // ----------------------------------------------------------------------
 bool CONTROLLER_DATA::LoadBrdConfigStart(String brdfile)
 {
-  File bfile = SPIFFS.open(brdfile, "r");                         // Open file for writing
+  File bfile = FILESYS.open(brdfile, "r");                         // Open file for writing
   if (!bfile)
   {
     ERROR_println("cd: LoadBrdConfigStart() open file read error");
@@ -1693,30 +2824,7 @@ bool CONTROLLER_DATA::LoadBrdConfigStart(String brdfile)
       this->pb2pin        = doc_brd["pb2pin"];
       this->irpin         = doc_brd["irpin"];
       this->boardnumber   = doc_brd["brdnum"];
-      // brdstepsperrev comes from STEPSPERREVOLUTION and will be different so must override the default setting in the board files
-      switch ( myboardnumber )
-      {
-        case PRO2ESP32ULN2003:
-        case PRO2ESP32L298N:
-        case PRO2ESP32L293DMINI:
-        case PRO2ESP32L9110S:
-          this->stepsperrev = mystepsperrev;         // override STEPSPERREVOLUTION from controller_config.h FIXEDSTEPMODE
-          break;
-        default:
-          this->stepsperrev = doc_brd["stepsrev"];
-          break;
-      }
-      // myfixedstepmode comes from FIXEDSTEPMODE and will be different so must override the default setting in the board files
-      switch ( myboardnumber )
-      {
-        case PRO2ESP32R3WEMOS:
-        case PRO2ESP32ST6128:
-          this->fixedstepmode = myfixedstepmode;     // override fixedstepmode from controller_config.h FIXEDSTEPMODE
-          break;
-        default:
-          this->fixedstepmode = doc_brd["fixedsmode"];
-          break;
-      }
+      SetBrdStepOverrides(doc_brd["stepsrev"], doc_brd["fixedsmode"]);
       for (int i = 0; i < 4; i++)
       {
         this->boardpins[i] = doc_brd["brdpins"][i];
@@ -2022,18 +3130,30 @@ void CONTROLLER_DATA::StartBoardDelayedUpdate(String & org_data, String new_data
 
 void CONTROLLER_DATA::set_cntlr_flags(void)
 {
-  portENTER_CRITICAL(&cntlrMux);
-  save_cntlr_flag = 0;
-  portEXIT_CRITICAL(&cntlrMux);
-  CNTLRDATA_println("++ request to save cntlr_config.jsn, save_cntlr_flag = 0");
+  tasksched->start(this->_job_cntlr);
+  CNTLRDATA_println("++ request to save cntlr_config.bin");
 }
 
 void CONTROLLER_DATA::set_board_flags(void)
 {
-  portENTER_CRITICAL(&boardMux);
-  save_board_flag = 0;
-  portEXIT_CRITICAL(&boardMux);
-  CNTLRDATA_println("++ request to save board_config.jsn, save_board_flag = 0");
+  tasksched->start(this->_job_board);
+  CNTLRDATA_println("++ request to save board_config.bin");
+}
+
+// delayed save jobs, the save is done by SaveConfiguration()
+void CONTROLLER_DATA::SaveVarDue(void)
+{
+  ControllerData->_save_due |= SAVEDUE_VAR;
+}
+
+void CONTROLLER_DATA::SaveCntlrDue(void)
+{
+  ControllerData->_save_due |= SAVEDUE_CNTLR;
+}
+
+void CONTROLLER_DATA::SaveBoardDue(void)
+{
+  ControllerData->_save_due |= SAVEDUE_BOARD;
 }
 
 
@@ -2042,7 +3162,7 @@ void CONTROLLER_DATA::set_board_flags(void)
 // ----------------------------------------------------------------------
 void CONTROLLER_DATA::ListDir(const char * dirname, uint8_t levels)
 {
-  File root = SPIFFS.open(dirname);
+  File root = FILESYS.open(dirname);
   CNTLRDATA_print("cd: Listing directory: {");
   if (!root)
   {
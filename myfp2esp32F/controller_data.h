@@ -45,6 +45,13 @@ class CONTROLLER_DATA
 
     bool CreateBoardConfigfromjson(String);   // create a board config from a json string - used by Management Server
 
+    // json import/export of the binary config images - used by Management Server
+    String get_cntlrconfig_json(void);
+    String get_boardconfig_json(void);
+    bool ImportCntlrConfigJson(String);
+    String ConfigLoadBenchmark(void);         // compare json and binary config load times
+    String get_cfgsave_stats(void);           // save count and bytes written for each config image
+
     long get_fposition(void);
     long get_maxstep(void);
     long get_focuserpreset(byte);
@@ -243,15 +250,18 @@ class CONTROLLER_DATA
     void LoadDefaultVariableData(void);
     void LoadBoardConfiguration(void);
     void SetDefaultBoardData(void);
-
-    void StartDelayedUpdate(unsigned long &, unsigned long);
-    void StartDelayedUpdate(long &, long);
-    void StartDelayedUpdate(float &, float);
-    void StartDelayedUpdate(byte &, byte);
-    void StartDelayedUpdate(int &, int);
-    void StartDelayedUpdate(tmc2209stallguard &, tmc2209stallguard);
-    void StartDelayedUpdate(unsigned int &, unsigned int);
-    void StartDelayedUpdate(String &, String);
+    void LoadBrdConfigTable(int);             // load a board from board_table.h, no file access
+    bool BoardFileChanged(const String &, const char *);
+    void SetBrdStepOverrides(int, int);
+
+    void StartDelayedUpdate(unsigned long &, unsigned long, byte);
+    void StartDelayedUpdate(long &, long, byte);
+    void StartDelayedUpdate(float &, float, byte);
+    void StartDelayedUpdate(byte &, byte, byte);
+    void StartDelayedUpdate(int &, int, byte);
+    void StartDelayedUpdate(tmc2209stallguard &, tmc2209stallguard, byte);
+    void StartDelayedUpdate(unsigned int &, unsigned int, byte);
+    void StartDelayedUpdate(String &, String, byte);
 
     void StartBoardDelayedUpdate(unsigned long &, unsigned long);
     void StartBoardDelayedUpdate(float &, float);
@@ -261,9 +271,44 @@ class CONTROLLER_DATA
 
     void ListDir(const char*, uint8_t);
 
-    const String file_cntlr_config = "/cntlr_config.jsn";       // Controller JSON configuration
-    const String file_cntlr_var    = "/cntlr_var.jsn";          // variable JSON setup data, position and direction
-    const String file_board_config = "/board_config.jsn";       // board JSON configuration
+    void SetDefaultPersistantData(void);
+    bool LoadCntlrImage(void);
+    bool LoadBoardImage(void);
+    bool LoadVarImage(void);
+    bool LoadOperImage(void);
+    bool SaveCntlrImage(void);
+    bool SaveOperImage(void);
+    bool LoadCntlrJsonFile(const String &);
+    bool LoadBoardJsonFile(const String &);
+    bool LoadVarJsonFile(const String &);
+    bool ParseCntlrJson(String &);
+    bool ReadImage(const String &, byte, void *, size_t, byte &, uint32_t *);
+    bool WriteImage(const String &, byte, byte, uint64_t, const void *, size_t);
+    bool MigrateImage(byte, byte &, void *, uint32_t *);
+
+    const String file_cntlr_config = "/cntlr_config.bin";       // Controller binary configuration image
+    const String file_cntlr_var    = "/cntlr_var.bin";          // variable binary image, position and direction
+    const String file_cntlr_oper   = "/cntlr_oper.bin";         // Controller operational (hot) settings binary image
+    const String file_board_config = "/board_config.bin";       // board binary configuration image
+    const String file_cntlr_json   = "/cntlr_config.jsn";       // legacy JSON files, imported once if no image exists
+    const String file_var_json     = "/cntlr_var.jsn";
+    const String file_board_json   = "/board_config.jsn";
+    const String file_bench_json   = "/cfg_bench.jsn";          // scratch file for ConfigLoadBenchmark()
+
+    unsigned long _cfg_loadtime = 0;          // boot time config load, microseconds
+    String        _cfg_loadsource = "none";   // binary, json or defaults
+    // delayed saves, scheduler jobs and the saves which are due
+    static void SaveVarDue(void);
+    static void SaveCntlrDue(void);
+    static void SaveBoardDue(void);
+    int           _job_var;
+    int           _job_cntlr;
+    int           _job_board;
+    byte          _save_due;
+
+    uint64_t      _cntlr_dirty = 0;           // controller fields changed since last save, bit n = cntlr_image field n
+    unsigned long _cfg_saves[5] = { 0 };      // save count, indexed by image id
+    unsigned long _cfg_bytes[5] = { 0 };      // bytes written, indexed by image id
 
     long fposition;                 // last focuser position
     long maxstep;                   // max steps
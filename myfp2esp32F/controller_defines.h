@@ -18,8 +18,6 @@ enum Oled_States { oled_off, oled_on };
 
 enum Focuser_States { State_Idle, State_InitMove, State_Backlash, State_Moving, State_FinishedMove, State_SetHomePosition, State_DelayAfterMove, State_EndMove };
 
-enum Option_States  { Option_pushbtn_joystick, Option_IRRemote, Option_Display, Option_Temperature, Option_WiFi };
-
 // display_graphic
 enum logo_num { nwifi, ntemp, nreboot };    // add nmove later once graphics display is working
 
@@ -35,6 +33,11 @@ enum tmc2209stallguard { Use_Stallguard, Use_Physical_Switch, Use_None };
 #define DYNAMICIP         1
 #define STATICIP          2
 
+// file systems, select with FILESYSTEM in controller_config.h
+#define FS_SPIFFS         1
+#define FS_LITTLEFS       2
+#define FS_MEMORY         3
+
 // Value Defines
 #define V_STOPPED         0               // service state stopped
 #define V_RUNNING         1               // service state running
@@ -70,6 +73,7 @@ enum tmc2209stallguard { Use_Stallguard, Use_Physical_Switch, Use_None };
 #undef ENABLE_READWIFICONFIG
 #undef ENABLE_ELEGANTOTA
 #undef ENABLE_DUCKDNS
+#undef FILESYSTEM
 
 // Watch dog timer
 #define WDT_TIMEOUT             30            // in seconds
@@ -112,6 +116,13 @@ enum tmc2209stallguard { Use_Stallguard, Use_Physical_Switch, Use_None };
 #define V_DISPLAYPAGETIMEMAX    10            // 10s maximum oled page display time
 #define DISPLAYUPDATEONMOVE     15            // number of steps before refreshing position when moving if oledupdateonmove is 1
 #define DEFAULTDISPLAYPAGETIMEMIN 4
+#define DISPLAYTASKSTACK        4096          // display task, renders and writes to the display
+#define DISPLAYTASKPRIORITY     1             // lowest priority above idle
+#define DISPLAYTASKCORE         0             // loop() runs on core 1
+#define DISPLAY_NOTIFY_PAGE     0x01          // display task notification bits
+#define DISPLAY_NOTIFY_POSITION 0x02
+#define DISPLAY_NOTIFY_ON       0x04
+#define DISPLAY_NOTIFY_OFF      0x08
 
 // DUCKDNS SERVICE
 #define DUCKDNS_REFRESHRATE     120           // duck dns, check ip address every 2 minutes for an update
@@ -125,11 +136,14 @@ enum tmc2209stallguard { Use_Stallguard, Use_Physical_Switch, Use_None };
 #define SERIALPORTSPEED         115200        // 9600, 14400, 19200, 28800, 38400, 57600, 115200
 
 // TEMPERATURE PROBE
-#define DEFAULTTEMPREFRESHTIME  30            // refresh rate between temperature conversions - 30 timeslices = 3s
+#define DEFAULTTEMPREFRESHTIME  3500          // refresh rate between temperature conversions, milliseconds
 #define DEFAULTTEMPRESOLUTION   10            // Set the default DS18B20 resolution to 0.25 of a degree 9=0.5, 10=0.25, 11=0.125, 12=0.0625
 
 // DELAY TIME BEFORE CHANGES ARE WRITTEN TO SPIFFS FILE
-#define DEFAULTSAVETIME         600           // 600 timeslices, 10 timeslices per second = 600 / 10 = 60 seconds
+#define DEFAULTSAVETIME         60000         // 60 seconds, in milliseconds
+
+// WIFI CONNECTION CHECK [STATIONMODE]
+#define DEFAULTWIFICHECKTIME    120000        // 120 seconds, in milliseconds
 
 // DEFAULT PARK TIME (Can be changed in Management Server)
 #define DEFAULTPARKTIME         120           // 30-300s
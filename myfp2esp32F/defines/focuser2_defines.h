@@ -0,0 +1,38 @@
+// -------------------------------------------------------------------------
+// myFP2ESP32 SECOND FOCUSER DEFINES
+// © Copyright Robert Brown 2020-2022.
+// All Rights Reserved.
+// -------------------------------------------------------------------------
+// Only used when ENABLE_FOCUSER2 is defined in controller_config.h
+// The second focuser must be a step/dir driver [DRV8825, TMC2225, TMC2209
+// in step/dir mode], the pins must not be used by the first driver board
+// or any other option. 16 and 17 are Serial2, the uart of the TMC boards.
+// begin() refuses pins used by the board, the I2C display or Serial2
+
+
+// ----------------------------------------------------------------------
+// PINS
+// ----------------------------------------------------------------------
+#define FOCUSER2_STEPPIN      23
+#define FOCUSER2_DIRPIN       5           // strapping pin, an output after boot
+#define FOCUSER2_ENABLEPIN    2           // strapping pin, -1 if the enable pin is not connected
+
+#if (FOCUSER2_STEPPIN == I2CDATAPIN) || (FOCUSER2_STEPPIN == I2CCLKPIN) || (FOCUSER2_DIRPIN == I2CDATAPIN) \
+ || (FOCUSER2_DIRPIN == I2CCLKPIN) || (FOCUSER2_ENABLEPIN == I2CDATAPIN) || (FOCUSER2_ENABLEPIN == I2CCLKPIN)
+#error "focuser2: a pin is used by the I2C display"
+#endif
+#if (DRVBRD == PRO2ESP32TMC2225) || (DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P)
+#if (FOCUSER2_STEPPIN == 16) || (FOCUSER2_STEPPIN == 17) || (FOCUSER2_DIRPIN == 16) || (FOCUSER2_DIRPIN == 17) \
+ || (FOCUSER2_ENABLEPIN == 16) || (FOCUSER2_ENABLEPIN == 17)
+#error "focuser2: pins 16 and 17 are the uart of the TMC driver board"
+#endif
+#endif
+
+
+// ----------------------------------------------------------------------
+// SETTINGS
+// ----------------------------------------------------------------------
+#define FOCUSER2_MAXSTEP      50000       // maximum position
+#define FOCUSER2_STEPDELAY    4000        // us between steps
+#define FOCUSER2_REVERSE      false       // true to reverse the direction
+#define FOCUSER2_COILPOWER    false       // true to keep the motor enabled after a move
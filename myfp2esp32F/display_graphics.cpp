@@ -21,7 +21,7 @@
 #include "controller_config.h" // includes boarddefs.h and controller_defines.h
 
 #if defined(ENABLE_GRAPHICDISPLAY)
-#include "SPIFFS.h"
+#include "file_system.h"
 
 
 // -----------------------------------------------------------------------
@@ -51,27 +51,6 @@
 extern CONTROLLER_DATA *ControllerData;
 
 
-// ----------------------------------------------------------------------
-// DRIVER BOARD CLASS
-// ----------------------------------------------------------------------
-#include "driver_board.h"
-extern DRIVER_BOARD *driverboard;
-
-
-// ----------------------------------------------------------------------
-// TEMPERATURE CLASS
-// ----------------------------------------------------------------------
-#include "temp_probe.h"
-extern TEMP_PROBE *tempprobe;
-
-
-// ----------------------------------------------------------------------
-// TCPIP CLASS
-// ----------------------------------------------------------------------
-#include "tcpip_server.h"
-extern TCPIP_SERVER *tcpipsrvr;
-
-
 // For an optional class should not have access to the update flags etc
 // For an optional class, keep serial messages to a minimum
 
@@ -137,6 +116,9 @@ GRAPHIC_DISPLAY::GRAPHIC_DISPLAY(uint8_t addr) : _addr(addr)
 {
   this->_found = false;             // display found
   this->_state = false;             // display running
+  memset(&_large, 0, sizeof(_large));
+  memset(&_small, 0, sizeof(_small));
+  memset(_logos, 0, sizeof(_logos));
 }
 
 // ----------------------------------------------------------------------
@@ -176,9 +158,15 @@ bool GRAPHIC_DISPLAY::start(void)
 #endif
     this->_found = true;
     this->_state = true;
-    _display->init();
+    _display->init();                 // clears the display ram
+    memset(_shown, 0, sizeof(_shown));
     delay(1000);
     _display->flipScreenVertically();
+    build_glyphs(_large, ArialMT_Plain_24);
+    build_glyphs(_small, ArialMT_Plain_10);
+    build_logo(nwifi, wifi_width, wifi_height, i_wifi);
+    build_logo(ntemp, temp_width, temp_height, i_temp);
+    build_logo(nreboot, reboot_width, reboot_height, i_reboot);
     _display->setFont(ArialMT_Plain_10);
     _display->setTextAlignment(TEXT_ALIGN_LEFT);
     _display->clear();
@@ -188,7 +176,6 @@ bool GRAPHIC_DISPLAY::start(void)
     _display->drawString(0, 12, "SSID: " + String(mySSID));
     //_display->drawXbm(34, 14, WiFi_Logo_width, WiFi_Logo_height, WiFi_Logo_bits); // draw wifi logo
     display_draw_xbm(nwifi, 34, 14);
-    _display->display();
     DISPLAY_println("GRAPHIC_DISPLAY::start(), display found, running");
   }
   return true;
@@ -201,6 +188,7 @@ bool GRAPHIC_DISPLAY::start(void)
 // -----------------------------------------------------------------------
 void GRAPHIC_DISPLAY::stop(void)
 {
+  free_bitmaps();
   delete _display;
   this->_state = false;
 }
@@ -214,6 +202,7 @@ void GRAPHIC_DISPLAY::clear(void)
   if ( this->_state )
   {
     _display->clear();
+    flush(micros());
   }
 }
 
@@ -243,14 +232,16 @@ void GRAPHIC_DISPLAY::on(void)
 }
 
 // -----------------------------------------------------------------------
-// void update(void);
+// void update(display_state &);
 // UPDATE DISPLAY PAGE
+// called from the display task
 // -----------------------------------------------------------------------
-void GRAPHIC_DISPLAY::update()
+void GRAPHIC_DISPLAY::update(display_state &ds)
 {
   if ( this->_state )
   {
-    draw_main_update();
+    _ds = ds;
+    draw_main_update(true);
   }
   else
   {
@@ -260,40 +251,40 @@ void GRAPHIC_DISPLAY::update()
 }
 
 // -----------------------------------------------------------------------
-// void update_position(long);
+// void update_position(display_state &);
 // UPDATE POSITION
-// writes focuser position at specific location on display when the focuser is moving
-// pixels: x = 0 - 127, y = 0 - 63
+// redraws the page with the new position when the focuser is moving, only
+// the columns of the digits which changed are sent
+// called from the display task
 // -----------------------------------------------------------------------
-void GRAPHIC_DISPLAY::update_position(long position)
+void GRAPHIC_DISPLAY::update_position(display_state &ds)
 {
-  // it is ok to comment this code out
-  //int x = 48;
-  //int y = 0;
-
-  //if( ( _state == V_RUNNING) && (ControllerData->get_oledstate() == true) )
-  //{
-  //  char buff[12];
-  //  snprintf(buff, sizeof(buff), "%ld", position);
-  //  _display->drawString( 64, 28, buff);
-  //  _display->display();
-  //}
+  if ( this->_state )
+  {
+    _ds.position = ds.position;
+    _ds.target   = ds.target;
+    _ds.ismoving = ds.ismoving;
+    draw_main_update(false);
+  }
 }
 
 const char heartbeat[] = { '|', '/' , '-', '\\'};
 
-void GRAPHIC_DISPLAY::draw_main_update()
+// draw the page into the frame buffer, then send the changes
+// heartbeat is only advanced by a page update
+void GRAPHIC_DISPLAY::draw_main_update(bool heartbeat_next)
 {
   char buffer[80];
 
   if ( this->_state )
   {
+    unsigned long start = micros();
     _display->clear();
     _display->setTextAlignment(TEXT_ALIGN_CENTER);
     _display->setFont(ArialMT_Plain_24);
 
     // check if there is a client connected
-    if ( tcpipsrvr->get_clients() == false)
+    if ( _ds.clients == false)
     {
       // no client connected
       _display->drawString(64, 28, F("offline"));
@@ -307,22 +298,34 @@ void GRAPHIC_DISPLAY::draw_main_update()
     else
     {
       // tcpip client is connected
-      char dir = (ControllerData->get_focuserdirection() == moving_in ) ? '<' : '>';
-      snprintf(buffer, sizeof(buffer), "%ld:%i %c", driverboard->getposition(), (int)(driverboard->getposition() % ControllerData->get_brdstepmode()), dir);
-      _display->drawString(64, 28, buffer);
+      char dir = (_ds.direction == moving_in ) ? '<' : '>';
+      snprintf(buffer, sizeof(buffer), "%ld:%i %c", _ds.position, (int)(_ds.position % _ds.stepmode), dir);
+      if ( draw_glyphs(_large, 64 - (glyphs_width(_large, buffer) / 2), 28, buffer) == false )
+      {
+        _display->drawString(64, 28, buffer);
+      }
 
       _display->setFont(ArialMT_Plain_10);
-      snprintf(buffer, sizeof(buffer), "µSteps: %i MaxPos: %ld", ControllerData->get_brdstepmode(), ControllerData->get_maxstep());
+      snprintf(buffer, sizeof(buffer), "µSteps: %i MaxPos: %ld", _ds.stepmode, _ds.maxstep);
       _display->drawString(64, 0, buffer);
-      snprintf(buffer, sizeof(buffer), "TargetPos:  %ld", ftargetPosition);
-      _display->drawString(64, 12, buffer);
+      // label is drawn by the library, the number from the glyph cache
+      const char *label = "TargetPos:  ";
+      snprintf(buffer, sizeof(buffer), "%ld", _ds.target);
+      int16_t lw = _display->getStringWidth(label);
+      int16_t x = 64 - ((lw + glyphs_width(_small, buffer)) / 2);
+      _display->setTextAlignment(TEXT_ALIGN_LEFT);
+      _display->drawString(x, 12, label);
+      if ( draw_glyphs(_small, x + lw, 12, buffer) == false )
+      {
+        _display->drawString(x + lw, 12, buffer);
+      }
     }
 
     _display->setTextAlignment(TEXT_ALIGN_LEFT);
 
-    if ( tempprobe->get_state() == true)
+    if ( _ds.tempprobe == true)
     {
-      snprintf(buffer, sizeof(buffer), "TEMP: %.2f C", temp);
+      snprintf(buffer, sizeof(buffer), "TEMP: %.2f C", _ds.temp);
       _display->drawString(54, 54, buffer);
     }
     else
@@ -330,14 +333,252 @@ void GRAPHIC_DISPLAY::draw_main_update()
       snprintf(buffer, sizeof(buffer), "TEMP: %.2f C", 20.0);
     }
 
-    snprintf(buffer, sizeof(buffer), "BL: %i", ControllerData->get_backlashsteps_out());
+    snprintf(buffer, sizeof(buffer), "BL: %i", _ds.backlashsteps_out);
     _display->drawString(0, 54, buffer);
 
-    snprintf(buffer, sizeof(buffer), "%c", heartbeat[++count_hb % 4]);
+    if ( heartbeat_next == true )
+    {
+      count_hb++;
+    }
+    snprintf(buffer, sizeof(buffer), "%c", heartbeat[count_hb % 4]);
     _display->drawString(8, 14, buffer);
 
-    _display->display();
+    flush(start);
+  }
+}
+
+// -----------------------------------------------------------------------
+// void flush(unsigned long);
+// SEND CHANGES
+// compares the frame buffer with the display ram copy, and writes the
+// changed columns of each page. display() would send all 1024 bytes
+// -----------------------------------------------------------------------
+void GRAPHIC_DISPLAY::flush(unsigned long start)
+{
+  uint8_t *frame = _display->buffer;
+  uint32_t bytes = 0;
+  for (int page = 0; page < GD_PAGES; page++)
+  {
+    int base = page * SCREEN_WIDTH;
+    int first = 0;
+    while ( (first < SCREEN_WIDTH) && (frame[base + first] == _shown[base + first]) )
+    {
+      first++;
+    }
+    if ( first == SCREEN_WIDTH )
+    {
+      continue;
+    }
+    int last = SCREEN_WIDTH - 1;
+    while ( frame[base + last] == _shown[base + last] )
+    {
+      last--;
+    }
+
+    Wire.beginTransmission(_addr);
+    Wire.write(0x00);                 // command stream
+#if defined(USE_SSD1306)
+    Wire.write(0x21);                 // column address, start, end
+    Wire.write(first);
+    Wire.write(last);
+    Wire.write(0x22);                 // page address, start, end
+    Wire.write(page);
+    Wire.write(page);
+#else
+    Wire.write(0xB0 | page);
+    Wire.write(0x10 | ((first + GD_COLOFFSET) >> 4));
+    Wire.write((first + GD_COLOFFSET) & 0x0F);
+#endif
+    Wire.endTransmission();
+
+    for (int col = first; col <= last; col += GD_I2CCHUNK)
+    {
+      int end = ((col + GD_I2CCHUNK) > (last + 1)) ? (last + 1) : (col + GD_I2CCHUNK);
+      Wire.beginTransmission(_addr);
+      Wire.write(0x40);               // data stream
+      for (int i = col; i < end; i++)
+      {
+        Wire.write(frame[base + i]);
+      }
+      Wire.endTransmission();
+    }
+    memcpy(&_shown[base + first], &frame[base + first], last - first + 1);
+    bytes += GD_CURSORBYTES + (last - first + 1);
+  }
+
+  uint32_t us = micros() - start;
+  _refreshes++;
+  _bytes_last   = bytes;
+  _bytes_total += bytes;
+  _bytes_max    = (bytes > _bytes_max) ? bytes : _bytes_max;
+  _us_last      = us;
+  _us_total    += us;
+  _us_max       = (us > _us_max) ? us : _us_max;
+}
+
+// -----------------------------------------------------------------------
+// GLYPH AND LOGO CACHE
+// glyphs are rasterised once by the library into the frame buffer and
+// copied out, drawString() would decode the font for every refresh
+// -----------------------------------------------------------------------
+void GRAPHIC_DISPLAY::build_glyphs(gd_glyphset &set, const uint8_t *font)
+{
+  const char *chars = GD_GLYPHCHARS;
+  byte pages = (pgm_read_byte(font + 1) + 7) / 8;     // font height is the second byte
+  set.font = font;
+  _display->setFont(font);
+  _display->setTextAlignment(TEXT_ALIGN_LEFT);
+  for (int i = 0; i < GD_GLYPHS; i++)
+  {
+    char str[2] = { chars[i], 0 };
+    gd_bitmap &g = set.glyph[i];
+    g.width = _display->getStringWidth(str);
+    g.pages = pages;
+    g.data  = new uint8_t[g.width * pages];
+    _display->clear();
+    _display->drawString(0, 0, str);
+    for (int page = 0; page < pages; page++)
+    {
+      memcpy(&g.data[page * g.width], &_display->buffer[page * SCREEN_WIDTH], g.width);
+    }
+  }
+  _display->clear();
+}
+
+// xbm is 1 bit per pixel, rows of bytes, lsb first
+void GRAPHIC_DISPLAY::build_logo(logo_num num, int16_t width, int16_t height, const uint8_t *xbm)
+{
+  gd_bitmap &logo = _logos[num];
+  int rowbytes = (width + 7) / 8;
+  logo.width = width;
+  logo.pages = (height + 7) / 8;
+  logo.data  = new uint8_t[width * logo.pages];
+  memset(logo.data, 0, width * logo.pages);
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < width; x++)
+    {
+      if ( pgm_read_byte(xbm + (y * rowbytes) + (x / 8)) & (1 << (x & 7)) )
+      {
+        logo.data[((y / 8) * width) + x] |= (1 << (y & 7));
+      }
+    }
+  }
+}
+
+void GRAPHIC_DISPLAY::free_bitmaps(void)
+{
+  for (int i = 0; i < GD_GLYPHS; i++)
+  {
+    delete[] _large.glyph[i].data;
+    delete[] _small.glyph[i].data;
+  }
+  for (int i = 0; i < GD_LOGOS; i++)
+  {
+    delete[] _logos[i].data;
   }
+  memset(&_large, 0, sizeof(_large));
+  memset(&_small, 0, sizeof(_small));
+  memset(_logos, 0, sizeof(_logos));
+}
+
+// or a bitmap into the frame buffer, y need not be on a page boundary
+void GRAPHIC_DISPLAY::blit(const gd_bitmap &bm, int16_t x, int16_t y)
+{
+  if ( (bm.data == NULL) || (y < 0) )
+  {
+    return;
+  }
+  uint8_t *frame = _display->buffer;
+  int shift = y & 7;
+  int top = y / 8;
+  for (int page = 0; page < bm.pages; page++)
+  {
+    int p = top + page;
+    if ( p >= GD_PAGES )
+    {
+      break;
+    }
+    for (int col = 0; col < bm.width; col++)
+    {
+      int fx = x + col;
+      if ( (fx < 0) || (fx >= SCREEN_WIDTH) )
+      {
+        continue;
+      }
+      uint16_t bits = bm.data[(page * bm.width) + col] << shift;
+      frame[(p * SCREEN_WIDTH) + fx] |= (bits & 0xFF);
+      if ( (shift != 0) && ((p + 1) < GD_PAGES) )
+      {
+        frame[((p + 1) * SCREEN_WIDTH) + fx] |= (bits >> 8);
+      }
+    }
+  }
+}
+
+int16_t GRAPHIC_DISPLAY::glyphs_width(gd_glyphset &set, const char *str)
+{
+  int16_t width = 0;
+  for (const char *s = str; *s != 0; s++)
+  {
+    const char *c = strchr(GD_GLYPHCHARS, *s);
+    if ( (c == NULL) || (set.glyph[0].data == NULL) )
+    {
+      // not cached, measured by the library
+      _display->setFont(set.font);
+      return _display->getStringWidth(str);
+    }
+    width += set.glyph[c - GD_GLYPHCHARS].width;
+  }
+  return width;
+}
+
+// returns false if a character is not cached, nothing is drawn
+bool GRAPHIC_DISPLAY::draw_glyphs(gd_glyphset &set, int16_t x, int16_t y, const char *str)
+{
+  for (const char *s = str; *s != 0; s++)
+  {
+    if ( (strchr(GD_GLYPHCHARS, *s) == NULL) || (set.glyph[0].data == NULL) )
+    {
+      return false;
+    }
+  }
+  for ( ; *str != 0; str++)
+  {
+    const gd_bitmap &g = set.glyph[strchr(GD_GLYPHCHARS, *str) - GD_GLYPHCHARS];
+    blit(g, x, y);
+    x += g.width;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------
+// REFRESH STATS
+// String get_stats(void);
+// bytes are display ram and address command bytes, not I2C framing. full
+// is the size of the frame buffer
+// Returns a json string - used by Management Server
+// -----------------------------------------------------------------------
+String GRAPHIC_DISPLAY::get_stats(void)
+{
+  uint32_t refreshes = (_refreshes == 0) ? 1 : _refreshes;
+  String jsonstr = "{ \"type\":\"graphic\", \"refreshes\":" + String(_refreshes) \
+                   + ", \"bytes_last\":" + String(_bytes_last) + ", \"bytes_avg\":" + String(_bytes_total / refreshes) \
+                   + ", \"bytes_max\":" + String(_bytes_max) + ", \"full\":" + String(GD_FRAMEBYTES) \
+                   + ", \"us_last\":" + String(_us_last) + ", \"us_avg\":" + String(_us_total / refreshes) \
+                   + ", \"us_max\":" + String(_us_max) + " }";
+  return jsonstr;
+}
+
+void GRAPHIC_DISPLAY::reset_stats(void)
+{
+  _refreshes   = 0;
+  _bytes_last  = 0;
+  _bytes_total = 0;
+  _bytes_max   = 0;
+  _us_last     = 0;
+  _us_total    = 0;
+  _us_max      = 0;
 }
 
 // TODO
@@ -364,20 +605,20 @@ void GRAPHIC_DISPLAY::display_draw_xbm(logo_num num, int16_t x, int16_t y)
     switch ( num )
     {
       case nwifi:
-        _display->drawXbm(((MAX_WIDTH - wifi_width) - 2), ((MAX_HEIGHT - wifi_height) - 1), wifi_width, wifi_height, i_wifi);
+        blit(_logos[nwifi], ((MAX_WIDTH - wifi_width) - 2), ((MAX_HEIGHT - wifi_height) - 1));
         break;
       // temperature is bottom left aligned
       case ntemp:
-        _display->drawXbm(2, ((MAX_HEIGHT - temp_height) - 1), temp_width, temp_height, i_temp); // draw temperature
+        blit(_logos[ntemp], 2, ((MAX_HEIGHT - temp_height) - 1)); // draw temperature
         break;
       // reboot is centered
       case nreboot:
         // x pos is (max width / 2) - (reboot_width / 2)
         // y pos is (max height / 2) - (reboot_height / 2)
-        _display->drawXbm( ((MAX_WIDTH / 2) - ((reboot_width / 2) - 1)), ((MAX_HEIGHT / 2) - ((reboot_height / 2) - 1)), reboot_width, reboot_height, i_reboot ); // draw reboot icon
+        blit(_logos[nreboot], ((MAX_WIDTH / 2) - ((reboot_width / 2) - 1)), ((MAX_HEIGHT / 2) - ((reboot_height / 2) - 1))); // draw reboot icon
         break;
     }
-    _display->display();
+    flush(micros());
   }
 }
 
@@ -391,7 +632,7 @@ void GRAPHIC_DISPLAY::reboot(void)
     _display->setTextAlignment(TEXT_ALIGN_CENTER);
     _display->setFont(ArialMT_Plain_24);
     _display->drawString(64, 28, "REBOOT");
-    _display->display();
+    flush(micros());
   }
 }
 
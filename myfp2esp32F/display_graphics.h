@@ -25,6 +25,7 @@
 // assume SSH1106 display
 #include <SH1106Wire.h>                                   // for the OLED 128x64 1.3" display using the SSH1106 driver                     
 #endif // #if defined(USE_SSH1106)
+#include "display_state.h"
 
 
 // ----------------------------------------------------------------------
@@ -32,9 +33,42 @@
 // ----------------------------------------------------------------------
 #define SCREEN_WIDTH          128           // OLED display width, in pixels
 #define SCREEN_HEIGHT         64            // OLED display height, in pixels
+#define GD_FRAMEBYTES         ((SCREEN_WIDTH * SCREEN_HEIGHT) / 8)   // display ram bytes, a full refresh
+#define GD_PAGES              (SCREEN_HEIGHT / 8)                    // display ram page is 8 pixel rows
+#if defined(USE_SSD1306)
+#define GD_CURSORBYTES        6             // column and page address commands
+#define GD_COLOFFSET          0
+#else
+#define GD_CURSORBYTES        3             // page and column commands
+#define GD_COLOFFSET          2             // SH1106 ram is 132 columns, the panel starts at column 2
+#endif
+#define GD_I2CCHUNK           31            // display ram bytes in one I2C write, plus the control byte
+#define GD_GLYPHCHARS         "0123456789:-<> "                       // cached characters, position and target
+#define GD_GLYPHS             15
+#define GD_LOGOS              3             // logo_num, nwifi, ntemp, nreboot
 // OLED_ADDR found in controller_defines.h
 
 
+// ----------------------------------------------------------------------
+// BITMAP
+// ----------------------------------------------------------------------
+// Pre-rasterised glyph or logo, in display ram order: a byte is 8 pixel
+// rows of one column, page by page
+struct gd_bitmap
+{
+  byte    width;
+  byte    pages;
+  uint8_t *data;
+};
+
+// glyphs of one font
+struct gd_glyphset
+{
+  const uint8_t *font;
+  gd_bitmap     glyph[GD_GLYPHS];
+};
+
+
 // Note: TEXT/GRAPHICS use the exact same class definition, but
 // private members can be different.
 // ----------------------------------------------------------------------
@@ -47,8 +81,8 @@ class GRAPHIC_DISPLAY
 
     bool start(void);
     void stop(void);  
-    void update(void);
-    void update_position(long);
+    void update(display_state &);
+    void update_position(display_state &);
     
     void clear(void);
     void on(void);
@@ -56,14 +90,38 @@ class GRAPHIC_DISPLAY
 
     void reboot(void);
 
+    String get_stats(void);
+    void reset_stats(void);
+
   private:
-    void draw_main_update(void);
+    void draw_main_update(bool);
     void display_draw_xbm(logo_num, int16_t, int16_t);
+    void flush(unsigned long);
+    void build_glyphs(gd_glyphset &, const uint8_t *);
+    void build_logo(logo_num, int16_t, int16_t, const uint8_t *);
+    void free_bitmaps(void);
+    void blit(const gd_bitmap &, int16_t, int16_t);
+    int16_t glyphs_width(gd_glyphset &, const char *);
+    bool draw_glyphs(gd_glyphset &, int16_t, int16_t, const char *);
         
     uint8_t _addr;              // I2C address of display
     bool    _found = false;
     bool    _state = false;    
     byte    count_hb = 0;       // heart beat counter
+    display_state _ds;          // copy of the state being rendered
+    uint8_t _shown[GD_FRAMEBYTES];  // display ram, only pages and columns which differ are sent
+    gd_glyphset _large;         // ArialMT_Plain_24, position
+    gd_glyphset _small;         // ArialMT_Plain_10, target
+    gd_bitmap _logos[GD_LOGOS];
+
+    // refresh stats
+    uint32_t _refreshes = 0;
+    uint32_t _bytes_last = 0;
+    uint32_t _bytes_total = 0;
+    uint32_t _bytes_max = 0;
+    uint32_t _us_last = 0;
+    uint32_t _us_total = 0;
+    uint32_t _us_max = 0;
 
 #if defined(USE_SSD1306)
     SSD1306Wire *_display;
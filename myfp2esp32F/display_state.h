@@ -0,0 +1,72 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 DISPLAY STATE DEFINITIONS
+// © Copyright Robert Brown 2014-2022. All Rights Reserved.
+// display_state.h
+// ----------------------------------------------------------------------
+
+#if !defined(_display_state_h_)
+#define _display_state_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+
+
+// ----------------------------------------------------------------------
+// DISPLAY STATE
+// ----------------------------------------------------------------------
+// Copy of the focuser state shown on the display. It is filled in by
+// loop() and copied by the display task, so the display classes never
+// read ControllerData or the drivers while the main loop changes them.
+struct display_state
+{
+  // position, updated during a move
+  long  position;
+  long  target;
+  bool  ismoving;
+  // focuser
+  float temp;
+  byte  tempmode;
+  long  maxstep;
+  byte  motorspeed;
+  int   stepmode;
+  byte  direction;
+  byte  coilpower;
+  byte  reverse;
+  byte  backlash_in;
+  byte  backlash_out;
+  byte  backlashsteps_in;
+  byte  backlashsteps_out;
+  float stepsize;
+  byte  stepsize_enable;
+  byte  hpsw_enable;
+  byte  inoutled_enable;
+  byte  inoutledmode;
+  bool  pushbuttons;
+  bool  tempprobe;
+  byte  tempcomp_enable;
+  int   tempcoefficient;
+  byte  tcdirection;
+  long  presets[6];
+  // display
+  int   pagetime;
+  byte  updateonmove;
+  char  pageoption[9];
+  // services
+  bool  clients;
+  byte  ota;
+  byte  ascomsrvr;
+  byte  mngsrvr;
+  byte  tcpipsrvr;
+  byte  websrvr;
+  unsigned long ascomport;
+  unsigned long mngport;
+  unsigned long tcpipport;
+  unsigned long webport;
+};
+
+
+
+#endif // #if !defined(_display_state_h_)
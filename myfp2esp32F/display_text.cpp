@@ -21,15 +21,6 @@
 #include "controller_data.h"
 extern CONTROLLER_DATA *ControllerData;
 
-#include "driver_board.h"
-extern DRIVER_BOARD *driverboard;
-
-// ----------------------------------------------------------------------
-// TEMPERATURE PROBE
-// ----------------------------------------------------------------------
-#include "temp_probe.h"
-extern TEMP_PROBE *tempprobe;
-
 // For an optional class should not have access to the update flags etc
 // For an optional class, keep serial messages to a minimum
 
@@ -68,15 +59,7 @@ extern TEMP_PROBE *tempprobe;
 // ----------------------------------------------------------------------
 extern char  mySSID[];
 extern int   myfp2esp32mode; // controllermode, ACCESSPOINTMODE=1, STATIONMODE=2
-extern bool  isMoving;
-extern long  ftargetPosition;
-extern float temp;
 extern char  ipStr[16]; // correction Eric Harant 
-extern byte  ota_status;
-extern byte  ascomsrvr_status;
-extern byte  mngsrvr_status;
-extern byte  tcpipsrvr_status;
-extern byte  websrvr_status;
 
 
 // ----------------------------------------------------------------------
@@ -160,6 +143,8 @@ TEXT_DISPLAY::TEXT_DISPLAY(uint8_t addr) : _addr(addr)
 {
   this->_found = false;
   this->_state = false;
+  blank_frame();
+  invalidate();
 }
 
 
@@ -216,6 +201,7 @@ bool TEXT_DISPLAY::start()
     _display->println("myFP2ESP");
     _display->set1X();
     _display->println("booting");
+    invalidate();                                         // boot message is not in the frame
     DISPLAY_println("TEXT_DISPLAY::start(), display found, running");
   }
   return true;
@@ -240,6 +226,8 @@ void TEXT_DISPLAY::clear(void)
   if ( this->_state )
   {
     _display->clear();
+    blank_frame();
+    memcpy(_shown, _frame, sizeof(_shown));
   }
 }
 
@@ -269,79 +257,83 @@ void TEXT_DISPLAY::on( void )
 
 // -----------------------------------------------------------------------
 // UPDATE DISPLAY PAGE
-// void update(void);
+// void update(display_state &);
+// called from the display task
 // -----------------------------------------------------------------------
-void TEXT_DISPLAY::update()
+void TEXT_DISPLAY::update(display_state &ds)
 {
   if ( this->_state )
   {
+    _ds = ds;
     draw_main_update();
   }
 }
 
 // -----------------------------------------------------------------------
 // UPDATE POSITION
+// only the digits which have changed are sent
+// called from the display task
 // -----------------------------------------------------------------------
-void TEXT_DISPLAY::update_position(long position)
+void TEXT_DISPLAY::update_position(display_state &ds)
 {
   if ( this->_state )
   {
-    _display->setCursor(0, 0);
-    _display->print(DT_POSITION);
-    _display->print(position);
-    _display->clearToEOL();
-    _display->println();
-
-    _display->print(DT_TARGETPOSITION);
-    _display->print(ftargetPosition);
-    _display->clearToEOL();
-    _display->println();
+    unsigned long start = micros();
+    _ds = ds;
+    field(0, DT_POSITION, String(_ds.position));
+    field(1, DT_TARGETPOSITION, String(_ds.target));
+    render(start);
+  }
+}
+
+// -----------------------------------------------------------------------
+// PAGE LIST
+// void build_pages(void);
+// the enabled pages are rebuilt only when the page option changes
+// -----------------------------------------------------------------------
+void TEXT_DISPLAY::build_pages(void)
+{
+  if ( strcmp(_ds.pageoption, _pageoption) == 0 )
+  {
+    return;
+  }
+  strlcpy(_pageoption, _ds.pageoption, sizeof(_pageoption));
+  _pagecount = 0;
+  // first character is page 8, last is page 1
+  int len = strlen(_pageoption);
+  for (int pg = 1; pg <= TD_PAGES; pg++)
+  {
+    int i = len - pg;
+    if ( (i >= 0) && (_pageoption[i] == '1') )
+    {
+      _pages[_pagecount++] = pg;
+    }
+  }
+  if ( _pagecount == 0 )
+  {
+    _pages[_pagecount++] = 1;
   }
+  _pageindex = 0;
 }
 
 // -----------------------------------------------------------------------
 // UPDATE DISPLAY PAGE
 // void draw_main_update(void);
-// controlled by task timer
+// page time is controlled by the task scheduler
 // -----------------------------------------------------------------------
 void TEXT_DISPLAY::draw_main_update()
 {
-
   if ( this->_state )
   {
-    static int displaybitmask = 1;
-
-    _display->clear();                                      // clrscr OLED
-    int page = 0;
-    String mypage = ControllerData->get_displaypageoption();
-    for (int i = 0; i < mypage.length(); i++)
+    unsigned long start = micros();
+    build_pages();
+    if ( _pageindex >= _pagecount )
     {
-      page *= 2;
-      if (mypage[i] == '1')
-      {
-        page++;
-      }
+      _pageindex = 0;
     }
 
-    // find the next page to display
-    while ( (page & displaybitmask) == 0 )              // mask off one bit at a time, skip page if not enabled
-    {
-      displaybitmask *= 2;
-      if ( displaybitmask > 255 )                       // 255 = B11111111
-      {
-        break;
-      }
-    } // while ( (page & displaybitmask) == 0 )
-
-    // bitmask has stopped at current page indicating 1 in page option string
-    // ensure that mask does not exceed page value
-    if ( displaybitmask > 255 )                         // 255 = B111111111
-    {
-      displaybitmask = 1;                               // reset bitmask
-    }
-
-    // displaybitmask is now the page to display, 1=pg1, 2=pg2, 4=pg3, 8=pg4 etc
-    switch (displaybitmask)
+    blank_frame();
+    switch (_pages[_pageindex])
     {
       case 1:
         page1();
@@ -349,272 +341,185 @@ void TEXT_DISPLAY::draw_main_update()
       case 2:
         page2();
         break;
-      case 4:
+      case 3:
         page3();
         break;
-      case 8:
+      case 4:
         page4();
         break;
-      case 16:
+      case 5:
         page5();
         break;
-      case 32:
+      case 6:
         page6();
         break;
-      case 64:
+      case 7:
         page7();
         break;
-      case 128:
+      case 8:
         page8();
         break;
       default:
         page1();
         break;
-    } // switch (displaybitmask)
-    displaybitmask *= 2;                                // next page
-  } // for (int i = 0; i < mypage.length(); i++)
-} //   if ( (_found == true) && (_loaded == true) )
+    }
+    printpagenumber(_pages[_pageindex]);
+    _pageindex++;                                       // next page
+    render(start);
+  }
+}
 
 // -----------------------------------------------------------------------
-// Print page number at bottom of display
+// FRAME
+// pages write lines to the frame, render() sends the characters which
+// differ from those on the display
 // -----------------------------------------------------------------------
-void TEXT_DISPLAY::printpagenumber(byte pagenum)
+void TEXT_DISPLAY::blank_frame(void)
 {
-  if ( this->_state )
+  for (int row = 0; row < TD_ROWS; row++)
   {
-    _display->setCursor(0, 7);                            // place page number on bottom line of display
-    _display->print(DT_PAGENUMBER);
-    _display->print(pagenum);
+    memset(_frame[row], ' ', TD_COLS);
+    _frame[row][TD_COLS] = 0;
   }
 }
 
-// -----------------------------------------------------------------------
-// void page1(long, float);
-// -----------------------------------------------------------------------
-void TEXT_DISPLAY::page1()
+// display content is unknown, the next render sends every character
+void TEXT_DISPLAY::invalidate(void)
 {
-  if ( this->_state )
-  {
-    char tempString[20];
-
-    // Position
-    _display->home();
-    _display->print(DT_POSITION);
-    _display->print(driverboard->getposition());
-    _display->clearToEOL();
-
-    // Target
-    _display->println();
-    _display->print(DT_TARGETPOSITION);
-    _display->print(ftargetPosition);
-    _display->clearToEOL();
-    _display->println();
-
-    // ismoving
-    _display->print(DT_ISMOVING);
-    if ( isMoving == true )
-    {
-      _display->print(T_YES);
-    }
-    else
-    {
-      _display->print(T_NO);
-    }
-    _display->clearToEOL();
-    _display->println();
-
-    // Temperature
-    _display->print(DT_TEMPERATURE);
-    _display->print(String(temp, 2));
-    if ( ControllerData->get_tempmode() == V_CELSIUS)
-    {
-      _display->print(" c");
-    }
-    else
-    {
-      _display->print(" f");
-    }
-    _display->clearToEOL();
-    _display->println();
-
-    // MaxSteps
-    _display->print(DT_MAXSTEPS);
-    ltoa(ControllerData->get_maxstep(), tempString, 10);
-    _display->print(tempString);
-    _display->clearToEOL();
-    _display->println();
-
-    // Motor speed
-    _display->print(DT_MOTORSPEED);
-    _display->print(motor_speed[ControllerData->get_motorspeed()][0]);
-    _display->clearToEOL();
-    _display->println();
-
-    // Step mode
-    _display->print(DT_STEPMODE);
-    _display->print(ControllerData->get_brdstepmode());
-    _display->clearToEOL();
-    _display->println();
-
-    printpagenumber(1);
-  }
+  memset(_shown, 0, sizeof(_shown));
 }
 
-// -----------------------------------------------------------------------
-// void page2(void);
-// -----------------------------------------------------------------------
-void TEXT_DISPLAY::page2(void)
+void TEXT_DISPLAY::field(byte row, const char *label, String value)
 {
-  if ( this->_state )
+  if ( row >= TD_ROWS )
   {
-    // Coil power
-    _display->print(DT_COILPOWER);
-    if ( ControllerData->get_coilpower_enable() == V_ENABLED )
-    {
-      _display->print(DT_ON);
-    }
-    else
-    {
-      _display->print(DT_OFF);
-    }
-    _display->clearToEOL();
-    _display->println();
+    return;
+  }
+  char *line = _frame[row];
+  int len = snprintf(line, TD_COLS + 1, "%s%s", label, value.c_str());
+  len = (len > TD_COLS) ? TD_COLS : len;
+  memset(line + len, ' ', TD_COLS - len);
+  line[TD_COLS] = 0;
+}
 
-    // Reverse direction
-    _display->print(DT_REVERSE);
-    if ( ControllerData->get_reverse_enable() == V_ENABLED )
-    {
-      _display->print(DT_ON);
-    }
-    else
-    {
-      _display->print(DT_OFF);
-    }
-    _display->clearToEOL();
-    _display->println();
+void TEXT_DISPLAY::field(byte row, const char *label, bool state)
+{
+  field(row, label, String((state == true) ? DT_ON : DT_OFF));
+}
 
-    // backlash in state
-    _display->print(DT_BACKLASHIN);
-    if ( ControllerData->get_backlash_in_enable() == V_ENABLED )
+void TEXT_DISPLAY::render(unsigned long start)
+{
+  uint32_t bytes = 0;
+  for (int row = 0; row < TD_ROWS; row++)
+  {
+    int first = 0;
+    while ( (first < TD_COLS) && (_frame[row][first] == _shown[row][first]) )
     {
-      _display->print(DT_ON);
+      first++;
     }
-    else
+    if ( first == TD_COLS )
     {
-      _display->print(DT_OFF);
+      continue;
     }
-    _display->clearToEOL();
-    _display->println();
-
-    // backlash out state
-    _display->print(DT_BACKLASHOUT);
-    if ( ControllerData->get_backlash_out_enable() == V_ENABLED )
+    int last = TD_COLS - 1;
+    while ( _frame[row][last] == _shown[row][last] )
     {
-      _display->print(DT_ON);
+      last--;
     }
-    else
+    _display->setCursor(first * TD_CHARWIDTH, row);
+    for (int col = first; col <= last; col++)
     {
-      _display->print(DT_OFF);
+      _display->write((uint8_t) _frame[row][col]);
     }
-    _display->clearToEOL();
-    _display->println();
-
-    // backlash in steps
-    _display->print(DT_BACKLASHINSTEPS);
-    _display->print(ControllerData->get_backlashsteps_in());
-    _display->clearToEOL();
-    _display->println();
-
-    // backlash out steps
-    _display->print(DT_BACKLASHOUTSTEPS);
-    _display->print(ControllerData->get_backlashsteps_out());
-    _display->clearToEOL();
-    _display->println();
-
-    printpagenumber(2);
+    memcpy(&_shown[row][first], &_frame[row][first], last - first + 1);
+    bytes += TD_CURSORBYTES + ((last - first + 1) * TD_CHARWIDTH);
   }
+
+  uint32_t us = micros() - start;
+  _refreshes++;
+  _bytes_last   = bytes;
+  _bytes_total += bytes;
+  _bytes_max    = (bytes > _bytes_max) ? bytes : _bytes_max;
+  _us_last      = us;
+  _us_total    += us;
+  _us_max       = (us > _us_max) ? us : _us_max;
 }
 
 // -----------------------------------------------------------------------
-// void page3(void);
+// REFRESH STATS
+// String get_stats(void);
+// bytes are display ram and cursor command bytes, not I2C framing. full
+// is the cost of the previous clear and redraw of a page
+// Returns a json string - used by Management Server
 // -----------------------------------------------------------------------
-void TEXT_DISPLAY::page3(void)
+String TEXT_DISPLAY::get_stats(void)
 {
-  if ( this->_state )
-  {
-    // Step Size
-    _display->print(DT_STEPSIZE);
-    _display->print(ControllerData->get_stepsize(), 2);
-    _display->clearToEOL();
-    _display->println();
-
-    // Step Size state
-    _display->print(DT_STEPSIZESTATE);
-    if ( ControllerData->get_stepsize_enable() == V_ENABLED )
-    {
-      _display->print(DT_ON);
-    }
-    else
-    {
-      _display->print(DT_OFF);
-    }
-    _display->clearToEOL();
-    _display->println();
+  uint32_t refreshes = (_refreshes == 0) ? 1 : _refreshes;
+  String jsonstr = "{ \"type\":\"text\", \"refreshes\":" + String(_refreshes) \
+                   + ", \"bytes_last\":" + String(_bytes_last) + ", \"bytes_avg\":" + String(_bytes_total / refreshes) \
+                   + ", \"bytes_max\":" + String(_bytes_max) + ", \"full\":" + String(TD_FULLBYTES) \
+                   + ", \"us_last\":" + String(_us_last) + ", \"us_avg\":" + String(_us_total / refreshes) \
+                   + ", \"us_max\":" + String(_us_max) + " }";
+  return jsonstr;
+}
 
-    // HPSW Enable State
-    _display->print(DT_HPSWSTATE);
-    if ( ControllerData->get_hpswitch_enable() == V_ENABLED )
-    {
-      _display->print(DT_ON);
-    }
-    else
-    {
-      _display->print(DT_OFF);
-    }
-    _display->clearToEOL();
-    _display->println();
+void TEXT_DISPLAY::reset_stats(void)
+{
+  _refreshes   = 0;
+  _bytes_last  = 0;
+  _bytes_total = 0;
+  _bytes_max   = 0;
+  _us_last     = 0;
+  _us_total    = 0;
+  _us_max      = 0;
+}
 
+// -----------------------------------------------------------------------
+// Print page number at bottom of display
+// -----------------------------------------------------------------------
+void TEXT_DISPLAY::printpagenumber(byte pagenum)
+{
+  field(TD_ROWS - 1, DT_PAGENUMBER, String(pagenum));
+}
 
-    // IN-OUT LED state
-    _display->print(DT_INOUTLEDSTATE);
-    if ( ControllerData->get_inoutled_enable() == V_ENABLED )
-    {
-      _display->print(DT_ON);
-    }
-    else
-    {
-      _display->print(DT_OFF);
-    }
-    _display->clearToEOL();
-    _display->println();
+// -----------------------------------------------------------------------
+// void page1(void);
+// -----------------------------------------------------------------------
+void TEXT_DISPLAY::page1()
+{
+  field(0, DT_POSITION, String(_ds.position));
+  field(1, DT_TARGETPOSITION, String(_ds.target));
+  field(2, DT_ISMOVING, String((_ds.ismoving == true) ? T_YES : T_NO));
+  field(3, DT_TEMPERATURE, String(_ds.temp, 2) + ((_ds.tempmode == V_CELSIUS) ? " c" : " f"));
+  field(4, DT_MAXSTEPS, String(_ds.maxstep));
+  field(5, DT_MOTORSPEED, String(motor_speed[_ds.motorspeed][0]));
+  field(6, DT_STEPMODE, String(_ds.stepmode));
+}
 
-    // IN-OUT LED mode
-    _display->print(DT_INOUTLEDMODE);
-    if ( ControllerData->get_inoutledmode() == LEDPULSE )
-    {
-      _display->print(DT_PULSEMODE);
-    }
-    else
-    {
-      _display->print(DT_MOVEMODE);
-    }
-    _display->clearToEOL();
-    _display->println();
+// -----------------------------------------------------------------------
+// void page2(void);
+// -----------------------------------------------------------------------
+void TEXT_DISPLAY::page2(void)
+{
+  field(0, DT_COILPOWER, (bool) (_ds.coilpower == V_ENABLED));
+  field(1, DT_REVERSE, (bool) (_ds.reverse == V_ENABLED));
+  field(2, DT_BACKLASHIN, (bool) (_ds.backlash_in == V_ENABLED));
+  field(3, DT_BACKLASHOUT, (bool) (_ds.backlash_out == V_ENABLED));
+  field(4, DT_BACKLASHINSTEPS, String(_ds.backlashsteps_in));
+  field(5, DT_BACKLASHOUTSTEPS, String(_ds.backlashsteps_out));
+}
 
-    // Push Button state
-    _display->print(DT_PBSTATE);
-    if ( driverboard->get_pushbuttons_loaded() == V_ENABLED )
-    {
-      _display->print(DT_ON);
-    }
-    else
-    {
-      _display->print(DT_OFF);
-    }
-    _display->clearToEOL();
-    _display->println();
-    printpagenumber(3);
-  }
+// -----------------------------------------------------------------------
+// void page3(void);
+// -----------------------------------------------------------------------
+void TEXT_DISPLAY::page3(void)
+{
+  field(0, DT_STEPSIZE, String(_ds.stepsize, 2));
+  field(1, DT_STEPSIZESTATE, (bool) (_ds.stepsize_enable == V_ENABLED));
+  field(2, DT_HPSWSTATE, (bool) (_ds.hpsw_enable == V_ENABLED));
+  field(3, DT_INOUTLEDSTATE, (bool) (_ds.inoutled_enable == V_ENABLED));
+  field(4, DT_INOUTLEDMODE, String((_ds.inoutledmode == LEDPULSE) ? DT_PULSEMODE : DT_MOVEMODE));
+  field(5, DT_PBSTATE, _ds.pushbuttons);
 }
 
 // -----------------------------------------------------------------------
@@ -622,63 +527,11 @@ void TEXT_DISPLAY::page3(void)
 // -----------------------------------------------------------------------
 void TEXT_DISPLAY::page4(void)
 {
-  if ( this->_state )
-  {
-    //_display->setCursor(0,0);
-
-    // temperature mode C/F
-    _display->print(DT_TEMPMODE);
-    if ( ControllerData->get_tempmode() == V_CELSIUS)
-    {
-      _display->print(DT_TEMPCELSIUS);
-    }
-    else
-    {
-      _display->print(DT_TEMPFAHRENHEIT);
-    }
-    _display->clearToEOL();
-    _display->println();
-
-    // Temp Probe State
-    _display->print(DT_TEMPPROBESTATE);
-    if ( tempprobe->get_state() == true)
-    {
-      _display->print(DT_ON);
-    }
-    else
-    {
-      _display->print(DT_OFF);
-    }
-    _display->clearToEOL();
-    _display->println();
-
-    // temperature compenstation enable state
-    _display->print(DT_TEMPCOMPSTATE);
-    if ( ControllerData->get_tempcomp_enable() == V_ENABLED)
-    {
-      _display->print(DT_ON);
-    }
-    else
-    {
-      _display->print(DT_OFF);
-    }
-    _display->clearToEOL();
-    _display->println();
-
-    // temperature compensation coefficient #steps
-    _display->print(DT_TEMPCOMPSTEPS);
-    _display->print(ControllerData->get_tempcoefficient());
-    _display->clearToEOL();
-    _display->println();
-
-    // temperature compensation direction
-    _display->print(DT_TEMPCOMPDIRECTION);
-    _display->print(ControllerData->get_tcdirection());
-    _display->clearToEOL();
-    _display->println();
-
-    printpagenumber(4);
-  }
+  field(0, DT_TEMPMODE, String((_ds.tempmode == V_CELSIUS) ? DT_TEMPCELSIUS : DT_TEMPFAHRENHEIT));
+  field(1, DT_TEMPPROBESTATE, _ds.tempprobe);
+  field(2, DT_TEMPCOMPSTATE, (bool) (_ds.tempcomp_enable == V_ENABLED));
+  field(3, DT_TEMPCOMPSTEPS, String(_ds.tempcoefficient));
+  field(4, DT_TEMPCOMPDIRECTION, String(_ds.tcdirection));
 }
 
 // -----------------------------------------------------------------------
@@ -686,31 +539,11 @@ void TEXT_DISPLAY::page4(void)
 // -----------------------------------------------------------------------
 void TEXT_DISPLAY::page5(void)
 {
-  if ( this->_state )
-  {
-    _display->print(DT_PAGETIME);
-    _display->print(ControllerData->get_displaypagetime());
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_SHOWPOSONMOVE);        // update position when moving
-    _display->print(ControllerData->get_displayupdateonmove() );
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_OTAUPDATE);
-    _display->print(ota_status);
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_DRIVERBOARD);
-    _display->print(DRVBRD);
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_FIRMWAREVERSION);
-    _display->print(program_version);
-    _display->clearToEOL();
-    _display->println();
-
-    printpagenumber(5);
-  }
+  field(0, DT_PAGETIME, String(_ds.pagetime));
+  field(1, DT_SHOWPOSONMOVE, String(_ds.updateonmove));   // update position when moving
+  field(2, DT_OTAUPDATE, String(_ds.ota));
+  field(3, DT_DRIVERBOARD, String(DRVBRD));
+  field(4, DT_FIRMWAREVERSION, String(program_version));
 }
 
 // -----------------------------------------------------------------------
@@ -719,38 +552,13 @@ void TEXT_DISPLAY::page5(void)
 // -----------------------------------------------------------------------
 void TEXT_DISPLAY::page6(void)
 {
-  if ( this->_state )
-  {
-    _display->print(DT_PRESETS);
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_PRESET1);
-    _display->print(ControllerData->get_focuserpreset(0));
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_PRESET2);
-    _display->print(ControllerData->get_focuserpreset(1));
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_PRESET3);
-    _display->print(ControllerData->get_focuserpreset(2));
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_PRESET4);
-    _display->print(ControllerData->get_focuserpreset(3));
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_PRESET5);
-    _display->print(ControllerData->get_focuserpreset(4));
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_PRESET6);
-    _display->print(ControllerData->get_focuserpreset(5));
-    _display->clearToEOL();
-    _display->println();
-
-    printpagenumber(6);
-  }
+  field(0, DT_PRESETS, String(""));
+  field(1, DT_PRESET1, String(_ds.presets[0]));
+  field(2, DT_PRESET2, String(_ds.presets[1]));
+  field(3, DT_PRESET3, String(_ds.presets[2]));
+  field(4, DT_PRESET4, String(_ds.presets[3]));
+  field(5, DT_PRESET5, String(_ds.presets[4]));
+  field(6, DT_PRESET6, String(_ds.presets[5]));
 }
 
 // -----------------------------------------------------------------------
@@ -759,49 +567,13 @@ void TEXT_DISPLAY::page6(void)
 // -----------------------------------------------------------------------
 void TEXT_DISPLAY::page7(void)
 {
-  if ( this->_state )
-  {
-    _display->setCursor(0, 0);
-    _display->print(DT_SSID);
-    _display->println(mySSID);
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_IP);
-    _display->print(ipStr);
-    _display->clearToEOL();
-    _display->println();
-    if ( myfp2esp32mode == ACCESSPOINT)
-    {
-      _display->print(DT_ACCESSPOINT);
-      _display->clearToEOL();
-      _display->println();
-    }
-    else
-    {
-      _display->print(DT_STATIONMODE);
-      _display->clearToEOL();
-      _display->println();
-    }
-
-    _display->print(DT_ASCOMSRVRSTATE);
-    (ascomsrvr_status == V_RUNNING) ? _display->print(DT_SRVRSTATERUN) : _display->print(DT_SRVRSTATESTOP);
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_SRVRPORT);
-    _display->print(ControllerData->get_ascomsrvr_port());
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_MANAGEMENTSRVRSTATE);
-    (mngsrvr_status == V_RUNNING) ? _display->print(DT_SRVRSTATERUN) : _display->print(DT_SRVRSTATESTOP);
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_SRVRPORT);
-    _display->print(ControllerData->get_mngsrvr_port());
-    _display->clearToEOL();
-    _display->println();
-
-    printpagenumber(7);
-  }
+  field(0, DT_SSID, String(mySSID));
+  field(1, DT_IP, String(ipStr));
+  field(2, (myfp2esp32mode == ACCESSPOINT) ? DT_ACCESSPOINT : DT_STATIONMODE, String(""));
+  field(3, DT_ASCOMSRVRSTATE, String((_ds.ascomsrvr == V_RUNNING) ? DT_SRVRSTATERUN : DT_SRVRSTATESTOP));
+  field(4, DT_SRVRPORT, String(_ds.ascomport));
+  field(5, DT_MANAGEMENTSRVRSTATE, String((_ds.mngsrvr == V_RUNNING) ? DT_SRVRSTATERUN : DT_SRVRSTATESTOP));
+  field(6, DT_SRVRPORT, String(_ds.mngport));
 }
 
 
@@ -811,29 +583,10 @@ void TEXT_DISPLAY::page7(void)
 // -----------------------------------------------------------------------
 void TEXT_DISPLAY::page8(void)
 {
-  if ( this->_state )
-  {
-    //_display->setCursor(0, 0);
-    _display->print(DT_TCPIPSRVRSTATE);
-    (tcpipsrvr_status == V_RUNNING) ? _display->print("R") : _display->print("S");
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_SRVRPORT);
-    _display->print(ControllerData->get_tcpipsrvr_port());
-    _display->clearToEOL();
-    _display->println();
-
-    _display->print(DT_WEBSRVRSTATE);
-    (websrvr_status == V_RUNNING) ? _display->print("R") : _display->print("S");
-    _display->clearToEOL();
-    _display->println();
-    _display->print(DT_SRVRPORT);
-    _display->print(ControllerData->get_websrvr_port());
-    _display->clearToEOL();
-    _display->println();
-
-    printpagenumber(8);
-  }
+  field(0, DT_TCPIPSRVRSTATE, String((_ds.tcpipsrvr == V_RUNNING) ? "R" : "S"));
+  field(1, DT_SRVRPORT, String(_ds.tcpipport));
+  field(2, DT_WEBSRVRSTATE, String((_ds.websrvr == V_RUNNING) ? "R" : "S"));
+  field(3, DT_SRVRPORT, String(_ds.webport));
 }
 
 void TEXT_DISPLAY::reboot( void )
@@ -843,6 +596,7 @@ void TEXT_DISPLAY::reboot( void )
     _display->clear();
     _display->set2X();
     _display->println("REBOOT");
+    invalidate();
   }
 }
 
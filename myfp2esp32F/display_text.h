@@ -18,6 +18,18 @@
 
 #include <mySSD1306Ascii.h>
 #include <mySSD1306AsciiWire.h>
+#include "display_state.h"
+
+
+// ----------------------------------------------------------------------
+// DEFINITIONS
+// ----------------------------------------------------------------------
+#define TD_ROWS         8                 // 64 pixels, 8 pixel font height
+#define TD_COLS         21                // 128 pixels, 5x7 font plus 1 pixel spacing
+#define TD_CHARWIDTH    6                 // pixel columns, display ram bytes, per character
+#define TD_CURSORBYTES  3                 // command bytes to set the cursor
+#define TD_PAGES        8
+#define TD_FULLBYTES    (1024 + (TD_ROWS * (TD_CURSORBYTES + (TD_COLS * TD_CHARWIDTH))))   // clear and redraw every line
 
 
 // Note: TEXT/GRAPHICS use the exact same class definition, but
@@ -32,8 +44,8 @@ class TEXT_DISPLAY
     
     bool start(void);
     void stop(void);
-    void update();
-    void update_position(long);
+    void update(display_state &);
+    void update_position(display_state &);
 
     void clear(void);
     void on(void);
@@ -41,8 +53,17 @@ class TEXT_DISPLAY
 
     void reboot(void);
 
+    String get_stats(void);
+    void reset_stats(void);
+
   private:
     void draw_main_update(void);
+    void build_pages(void);
+    void blank_frame(void);
+    void invalidate(void);
+    void field(byte, const char *, String);
+    void field(byte, const char *, bool);
+    void render(unsigned long);
     void printpagenumber(byte);
     void page1(void);
     void page2(void);
@@ -61,6 +82,27 @@ class TEXT_DISPLAY
     bool    _state;
     String _images;
     SSD1306AsciiWire *_display;
+
+    display_state _ds;          // copy of the state being rendered
+
+    // page list, built from the display page option
+    char   _pageoption[9] = "";
+    byte   _pages[TD_PAGES];
+    byte   _pagecount = 0;
+    byte   _pageindex = 0;
+
+    // next frame and the characters on the display
+    char   _frame[TD_ROWS][TD_COLS + 1];
+    char   _shown[TD_ROWS][TD_COLS + 1];
+
+    // refresh stats
+    uint32_t _refreshes = 0;
+    uint32_t _bytes_last = 0;
+    uint32_t _bytes_total = 0;
+    uint32_t _bytes_max = 0;
+    uint32_t _us_last = 0;
+    uint32_t _us_total = 0;
+    uint32_t _us_max = 0;
 };
 
 
@@ -61,6 +61,7 @@
 // ----------------------------------------------------------------------
 #include <Arduino.h>
 #include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "hal.h"                              // gpio, critical sections and the move timer
 
 
 // -----------------------------------------------------------------------
@@ -111,22 +112,45 @@ extern DRIVER_BOARD *driverboard;
 // ----------------------------------------------------------------------
 extern volatile bool timerSemaphore;
 extern volatile uint32_t stepcount;           // number of steps to move in timer interrupt service routine
-extern portMUX_TYPE timerSemaphoreMux;
-extern portMUX_TYPE stepcountMux;
+extern hal_mux_t timerSemaphoreMux;
+extern hal_mux_t stepcountMux;
 extern bool filesystemloaded;                 // flag indicator for file access, rather than use SPIFFS.begin() test
 extern long ftargetPosition;
+extern bool isMoving;
+extern volatile bool halt_alert;
+extern hal_mux_t  halt_alertMux;
+
+#include "step_recorder.h"
+extern STEP_RECORDER *steprec;
+
+#include "power_manager.h"
+extern POWER_MANAGER *powermgr;
+
+#include "stall_monitor.h"
+extern STALL_MONITOR *stallmon;
+
+#include "tmc_uart.h"
+extern TMC_UART *tmcuart;
+
+#include "tmc_tuner.h"
+extern TMC_TUNER *tmctuner;
 
 
 // ----------------------------------------------------------------------
 // JOYSTICK DEFINITIONS
 // ----------------------------------------------------------------------
 // joystick pin definitions come from the Board config
+// other joystick settings are in jog_engine.h
+#include "jog_engine.h"
+extern JOG_ENGINE *jogengine;
+
 
-// other joystick settings
-#define JZEROPOINT    1837                    // value read when joystick is centered
-#define JTHRESHOLD    300                     // margin of error around center position
-#define JMAXVALUE     4095                    // maximum value reading of joystick
-#define JMINVALUE     0                       // minimum value reading of joystick
+// ----------------------------------------------------------------------
+// PUSHBUTTON DEFINITIONS
+// ----------------------------------------------------------------------
+// debounce, hold and jog curve are in push_buttons.h
+#include "push_buttons.h"
+extern PUSH_BUTTONS *pbinput;
 
 
 // ----------------------------------------------------------------------
@@ -145,7 +169,7 @@ bool stepdir;                                 // direction of steps to move
 // timer Interrupt
 // ----------------------------------------------------------------------
 #include "esp32-hal-cpu.h"                    // so we can get CPU frequency
-hw_timer_t * movetimer = NULL;                // use a unique name for the timer
+hal_timer_t * movetimer = NULL;               // use a unique name for the timer
 
 /*
   if (stepcount  && !(driverboard->hpsw_alert() && stepdir == moving_in))
@@ -217,22 +241,24 @@ void IRAM_ATTR onTimer()
   if (stepcount  && !(driverboard->hpsw_alert() && stepdir == moving_in))
   {
     driverboard->movemotor(stepdir, true);
-    portENTER_CRITICAL(&stepcountMux);
+    hal_enter(&stepcountMux);
     stepcount--;
-    portEXIT_CRITICAL(&stepcountMux);
+    hal_exit(&stepcountMux);
+    steprec->step();                          // does nothing unless recording
+    powermgr->step();                         // wake to first step latency
     mjob = true;                              // mark a running job
   }
   else
   {
     if (mjob == true)
     {
-      portENTER_CRITICAL(&stepcountMux);
+      hal_enter(&stepcountMux);
       stepcount = 0;                          // just in case hps_alert was fired up
-      portEXIT_CRITICAL(&stepcountMux);
+      hal_exit(&stepcountMux);
       mjob = false;                           // wait, and do nothing
-      portENTER_CRITICAL(&timerSemaphoreMux);
+      hal_enter(&timerSemaphoreMux);
       timerSemaphore = true;
-      portEXIT_CRITICAL(&timerSemaphoreMux);
+      hal_exit(&timerSemaphoreMux);
     }
   }
 }
@@ -266,34 +292,34 @@ void DRIVER_BOARD::start(long startposition)
   do {
     _clock_frequency = ESP.getCpuFreqMHz();       // returns the CPU frequency in MHz as an unsigned 8-bit integer
 
-    portENTER_CRITICAL(&timerSemaphoreMux);       // make sure timersemaphore is false when DRIVER_BOARD created
+    hal_enter(&timerSemaphoreMux);       // make sure timersemaphore is false when DRIVER_BOARD created
     timerSemaphore = false;
-    portEXIT_CRITICAL(&timerSemaphoreMux);
-    portENTER_CRITICAL(&stepcountMux);            // make sure stepcount is 0 when DRIVER_BOARD created
+    hal_exit(&timerSemaphoreMux);
+    hal_enter(&stepcountMux);            // make sure stepcount is 0 when DRIVER_BOARD created
     stepcount = 0;
-    portEXIT_CRITICAL(&stepcountMux);
+    hal_exit(&stepcountMux);
 
     // get board number
     this->_boardnum = ControllerData->get_brdnumber();  // get board number and cache it locally here
     // setup board
     if ( this->_boardnum == PRO2ESP32R3WEMOS )
     {
-      pinMode(ControllerData->get_brdenablepin(), OUTPUT);
-      pinMode(ControllerData->get_brddirpin(), OUTPUT);
-      pinMode(ControllerData->get_brdsteppin(), OUTPUT);
-      digitalWrite(ControllerData->get_brdenablepin(), 1);
+      hal_pinmode(ControllerData->get_brdenablepin(), OUTPUT);
+      hal_pinmode(ControllerData->get_brddirpin(), OUTPUT);
+      hal_pinmode(ControllerData->get_brdsteppin(), OUTPUT);
+      hal_digitalwrite(ControllerData->get_brdenablepin(), 1);
       // fixed step mode
     }
     else if ( this->_boardnum == PRO2ESP32DRV8825 )
     {
-      pinMode(ControllerData->get_brdenablepin(), OUTPUT);
-      pinMode(ControllerData->get_brddirpin(), OUTPUT);
-      pinMode(ControllerData->get_brdsteppin(), OUTPUT);
-      digitalWrite(ControllerData->get_brdenablepin(), 1);
-      digitalWrite(ControllerData->get_brdsteppin(), 0);
-      pinMode(ControllerData->get_brdboardpins(0), OUTPUT);
-      pinMode(ControllerData->get_brdboardpins(1), OUTPUT);
-      pinMode(ControllerData->get_brdboardpins(2), OUTPUT);
+      hal_pinmode(ControllerData->get_brdenablepin(), OUTPUT);
+      hal_pinmode(ControllerData->get_brddirpin(), OUTPUT);
+      hal_pinmode(ControllerData->get_brdsteppin(), OUTPUT);
+      hal_digitalwrite(ControllerData->get_brdenablepin(), 1);
+      hal_digitalwrite(ControllerData->get_brdsteppin(), 0);
+      hal_pinmode(ControllerData->get_brdboardpins(0), OUTPUT);
+      hal_pinmode(ControllerData->get_brdboardpins(1), OUTPUT);
+      hal_pinmode(ControllerData->get_brdboardpins(2), OUTPUT);
       // restore step mode
       setstepmode( ControllerData->get_brdstepmode() );
     }
@@ -306,7 +332,7 @@ void DRIVER_BOARD::start(long startposition)
       this->_inputpins[3] = ControllerData->get_brdboardpins(3);
       for (int i = 0; i < 4; i++)
       {
-        pinMode(this->_inputpins[i], OUTPUT);
+        hal_pinmode(this->_inputpins[i], OUTPUT);
       }
       myhstepper = new HalfStepper(ControllerData->get_brdstepsperrev(), this->_inputpins[0], this->_inputpins[1], this->_inputpins[2], this->_inputpins[3]);  // ok
       // restore step mode
@@ -321,7 +347,7 @@ void DRIVER_BOARD::start(long startposition)
       this->_inputpins[3] = ControllerData->get_brdboardpins(3);
       for (int i = 0; i < 4; i++)
       {
-        pinMode(this->_inputpins[i], OUTPUT);
+        hal_pinmode(this->_inputpins[i], OUTPUT);
       }
       myhstepper = new HalfStepper(ControllerData->get_brdstepsperrev(), this->_inputpins[0], this->_inputpins[1], this->_inputpins[2], this->_inputpins[3]);  // ok
       // restore step mode
@@ -336,7 +362,7 @@ void DRIVER_BOARD::start(long startposition)
       this->_inputpins[3] = ControllerData->get_brdboardpins(3);
       for (int i = 0; i < 4; i++)
       {
-        pinMode(this->_inputpins[i], OUTPUT);
+        hal_pinmode(this->_inputpins[i], OUTPUT);
       }
       myhstepper = new HalfStepper(ControllerData->get_brdstepsperrev(), this->_inputpins[0], this->_inputpins[1], this->_inputpins[2], this->_inputpins[3]);  // ok
       // restore step mode
@@ -351,7 +377,7 @@ void DRIVER_BOARD::start(long startposition)
       this->_inputpins[3] = ControllerData->get_brdboardpins(3);
       for (int i = 0; i < 4; i++)
       {
-        pinMode(this->_inputpins[i], OUTPUT);
+        hal_pinmode(this->_inputpins[i], OUTPUT);
       }
       myhstepper = new HalfStepper(ControllerData->get_brdstepsperrev(), this->_inputpins[0], this->_inputpins[1], this->_inputpins[2], this->_inputpins[3]);  // ok
       // restore step mode
@@ -360,25 +386,25 @@ void DRIVER_BOARD::start(long startposition)
     else if ( this->_boardnum == PRO2ESP32TMC2225 )
     {
       // init tmc2225
-      pinMode(ControllerData->get_brdenablepin(), OUTPUT);
-      pinMode(ControllerData->get_brddirpin(), OUTPUT);
-      pinMode(ControllerData->get_brdsteppin(), OUTPUT);
-      digitalWrite(ControllerData->get_brdenablepin(), 1);      // high disables the driver chip
-      digitalWrite(ControllerData->get_brdsteppin(), 0);
-      pinMode(ControllerData->get_brdboardpins(0), OUTPUT);     // ms1
-      pinMode(ControllerData->get_brdboardpins(1), OUTPUT);     // ms2
+      hal_pinmode(ControllerData->get_brdenablepin(), OUTPUT);
+      hal_pinmode(ControllerData->get_brddirpin(), OUTPUT);
+      hal_pinmode(ControllerData->get_brdsteppin(), OUTPUT);
+      hal_digitalwrite(ControllerData->get_brdenablepin(), 1);      // high disables the driver chip
+      hal_digitalwrite(ControllerData->get_brdsteppin(), 0);
+      hal_pinmode(ControllerData->get_brdboardpins(0), OUTPUT);     // ms1
+      hal_pinmode(ControllerData->get_brdboardpins(1), OUTPUT);     // ms2
       init_tmc2225();                                     // set step mode handled by init_tmc2225
     }
     else if ( this->_boardnum == PRO2ESP32TMC2209 || this->_boardnum == PRO2ESP32TMC2209P )
     {
       // init tmc2209
-      pinMode(ControllerData->get_brdenablepin(), OUTPUT);
-      pinMode(ControllerData->get_brddirpin(), OUTPUT);
-      pinMode(ControllerData->get_brdsteppin(), OUTPUT);
-      digitalWrite(ControllerData->get_brdenablepin(), 1);      // high disables the driver chip
-      digitalWrite(ControllerData->get_brdsteppin(), 0);
-      pinMode(ControllerData->get_brdboardpins(0), OUTPUT);     // ms1
-      pinMode(ControllerData->get_brdboardpins(1), OUTPUT);     // ms2
+      hal_pinmode(ControllerData->get_brdenablepin(), OUTPUT);
+      hal_pinmode(ControllerData->get_brddirpin(), OUTPUT);
+      hal_pinmode(ControllerData->get_brdsteppin(), OUTPUT);
+      hal_digitalwrite(ControllerData->get_brdenablepin(), 1);      // high disables the driver chip
+      hal_digitalwrite(ControllerData->get_brdsteppin(), 0);
+      hal_pinmode(ControllerData->get_brdboardpins(0), OUTPUT);     // ms1
+      hal_pinmode(ControllerData->get_brdboardpins(1), OUTPUT);     // ms2
       init_tmc2209();                                     // set step mode handled by init_tmc2209()
     }
   } while (0);
@@ -455,8 +481,8 @@ bool DRIVER_BOARD::set_leds(bool state)
       return false;
     }
     ControllerData->set_inoutled_enable(V_ENABLED);
-    pinMode(ControllerData->get_brdinledpin(), OUTPUT);
-    pinMode(ControllerData->get_brdoutledpin(), OUTPUT);
+    hal_pinmode(ControllerData->get_brdinledpin(), OUTPUT);
+    hal_pinmode(ControllerData->get_brdoutledpin(), OUTPUT);
     this->_leds_loaded = V_ENABLED;
     return true;
   }
@@ -530,8 +556,7 @@ bool DRIVER_BOARD::set_pushbuttons(bool state)
             // enable pushbuttons
             DRVBRD_println("drvbrd: set_pushbuttons(true), enable pb now");
             ControllerData->set_pushbutton_enable(V_ENABLED);
-            pinMode(ControllerData->get_brdpb2pin(), INPUT);
-            pinMode(ControllerData->get_brdpb1pin(), INPUT);
+            pbinput->begin(ControllerData->get_brdpb1pin(), ControllerData->get_brdpb2pin());
             this->_pushbuttons_loaded = V_ENABLED;
           }
         }
@@ -542,6 +567,10 @@ bool DRIVER_BOARD::set_pushbuttons(bool state)
   {
     // no need to check if it is already stopped/notenabled
     DRVBRD_println("drvbrd: set_pushbuttons(false), disable cd->pb enable()");
+    if ( this->_pushbuttons_loaded == V_ENABLED )
+    {
+      pbinput->end();
+    }
     ControllerData->set_pushbutton_enable(V_NOTENABLED);
     this->_pushbuttons_loaded = V_NOTENABLED;
   }
@@ -560,31 +589,16 @@ bool DRIVER_BOARD::get_pushbuttons_loaded(void)
 // ----------------------------------------------------------------------
 // UPDATE PUSHBUTTONS
 // driverboard->update_pushbuttons()
+// a press moves the target by the pushbutton steps, a hold jogs
+// returns true if there was a button event
 // ----------------------------------------------------------------------
-void DRIVER_BOARD::update_pushbuttons(void)
+bool DRIVER_BOARD::update_pushbuttons(void)
 {
   if ( this->_pushbuttons_loaded == true )
   {
-    static long newpos;
-
-    // PB are active high - pins are low by virtue of pull down resistors through J16 and J17 jumpers
-    // read from the board pin number, and compare the return pin value - if 1 then button is pressed
-    if ( digitalRead(ControllerData->get_brdpb1pin()) == 1 )
-    {
-      newpos = ftargetPosition - ControllerData->get_pushbutton_steps();
-      newpos = (newpos < 0 ) ? 0 : newpos;
-      ftargetPosition = newpos;
-    }
-    if ( digitalRead(ControllerData->get_brdpb2pin()) == 1 )
-    {
-      newpos = ftargetPosition + ControllerData->get_pushbutton_steps();
-      // an unsigned long range is 0 to 4,294,967,295
-      // when an unsigned long decrements from 0-1 it goes to largest +ve value, ie 4,294,967,295
-      // which would in likely be much much greater than maxstep
-      newpos = (newpos > ControllerData->get_maxstep()) ? ControllerData->get_maxstep() : newpos;
-      ftargetPosition = newpos;
-    }
+    return (pbinput->update() != pb_none);
   }
+  return false;
 }
 
 // ----------------------------------------------------------------------
@@ -636,9 +650,10 @@ bool DRIVER_BOARD::set_joystick1(bool state)
             // enable joystick1
             DRVBRD_println("drvbrd: set_joystick1_enable(true), enable joystick1 now");
             // enable joystick1, joystick 1 does not use brdpb2pin
-            pinMode(ControllerData->get_brdpb2pin(), INPUT);
-            pinMode(ControllerData->get_brdpb1pin(), INPUT);
+            hal_pinmode(ControllerData->get_brdpb2pin(), INPUT);
+            hal_pinmode(ControllerData->get_brdpb1pin(), INPUT);
             ControllerData->set_joystick1_enable(V_ENABLED);
+            jogengine->begin(ControllerData->get_brdpb1pin());
             this->_joystick1_loaded = V_ENABLED;
           }
         }
@@ -650,6 +665,7 @@ bool DRIVER_BOARD::set_joystick1(bool state)
     // state is false
     DRVBRD_println("drvbrd: set_joystick1_enable(false)");
     // disable joystick1
+    jog(0);
     ControllerData->set_joystick1_enable(V_NOTENABLED);
     this->_joystick1_loaded = V_NOTENABLED;
   }
@@ -668,36 +684,13 @@ bool DRIVER_BOARD::get_joystick1_loaded(void)
 // ----------------------------------------------------------------------
 // UPDATE JOYSTICK1
 // driverboard->update_joystick1()
+// the deflection sets the jog rate
 // ----------------------------------------------------------------------
 void DRIVER_BOARD::update_joystick1(void)
 {
   if ( this->_joystick1_loaded == true )
   {
-    static int joyval;
-    static long newpos;
-
-    joyval = analogRead(ControllerData->get_brdpb1pin());
-    DRVBRD_print("drvbrd: Raw joyval:");
-    DRVBRD_println(joyval);
-    if ( joyval < (JZEROPOINT - JTHRESHOLD) )
-    {
-      newpos = ftargetPosition - 1;
-      newpos = (newpos < 0 ) ? 0 : newpos;
-      ftargetPosition = newpos;
-      DRVBRD_print("drvbrd: X IN joyval:");
-      DRVBRD_println(joyval);
-    }
-    else if ( joyval > (JZEROPOINT + JTHRESHOLD) )
-    {
-      newpos = ftargetPosition + 1;
-      // an unsigned long range is 0 to 4,294,967,295
-      // when an unsigned long decrements from 0-1 it goes to largest +ve value, ie 4,294,967,295
-      // which would in likely be much much greater than maxstep
-      newpos = (newpos > ControllerData->get_maxstep()) ? ControllerData->get_maxstep() : newpos;
-      ftargetPosition = newpos;
-      DRVBRD_print("drvbrd: X OUT joyval:");
-      DRVBRD_println(joyval);
-    }
+    jog(jogengine->update());
   }
   else
   {
@@ -755,10 +748,11 @@ bool DRIVER_BOARD::set_joystick2(bool state)
             DRVBRD_println("drvbrd: set_joystick2_enable(true), enable joystick2 now");
             ControllerData->set_joystick2_enable(V_ENABLED);
             this->_joystick2_swstate = false;
-            pinMode(ControllerData->get_brdpb2pin(), INPUT);
-            pinMode(ControllerData->get_brdpb1pin(), INPUT);
+            hal_pinmode(ControllerData->get_brdpb2pin(), INPUT);
+            hal_pinmode(ControllerData->get_brdpb1pin(), INPUT);
             // setup interrupt, falling edge, pin state = HIGH and falls to GND (0) when pressed
             attachInterrupt(ControllerData->get_brdpb2pin(), joystick2sw_isr, FALLING);
+            jogengine->begin(ControllerData->get_brdpb1pin());
             this->_joystick2_loaded = V_ENABLED;
           }
         }
@@ -775,6 +769,7 @@ bool DRIVER_BOARD::set_joystick2(bool state)
       // detach interrupt
       detachInterrupt(ControllerData->get_brdpb2pin());
     }
+    jog(0);
     this->_joystick2_swstate = false;
     this->_joystick2_loaded = false;
     ControllerData->set_joystick2_enable(V_NOTENABLED);
@@ -794,36 +789,13 @@ bool DRIVER_BOARD::get_joystick2_loaded(void)
 // ----------------------------------------------------------------------
 // UPDATE JOYSTICK2
 // driverboard->update_joystick2()
+// the deflection sets the jog rate
 // ----------------------------------------------------------------------
 void DRIVER_BOARD::update_joystick2(void)
 {
   if ( _joystick2_loaded == true )
   {
-    static int joyval;
-    static long newpos;
-
-    analogRead(ControllerData->get_brdpb1pin());
-    DRVBRD_print("drvbrd: Raw joyval:");
-    DRVBRD_println(joyval);
-    if ( joyval < (JZEROPOINT - JTHRESHOLD) )
-    {
-      newpos = ftargetPosition - 1;
-      newpos = (newpos < 0 ) ? 0 : newpos;
-      ftargetPosition = newpos;
-      DRVBRD_print("drvbrd: X IN joyval:");
-      DRVBRD_println(joyval);
-    }
-    else if ( joyval > (JZEROPOINT + JTHRESHOLD) )
-    {
-      newpos = ftargetPosition + 1;
-      // an unsigned long range is 0 to 4,294,967,295
-      // when an unsigned long decrements from 0-1 it goes to largest +ve value, ie 4,294,967,295
-      // which would in likely be much much greater than maxstep
-      newpos = (newpos > ControllerData->get_maxstep()) ? ControllerData->get_maxstep() : newpos;
-      ftargetPosition = newpos;
-      DRVBRD_print("drvbrd: X OUT joyval:");
-      DRVBRD_println(joyval);
-    }
+    jog(jogengine->update());
 
     // handle switch
     if ( this->_joystick2_swstate == true)                    // switch is pressed
@@ -899,22 +871,22 @@ bool DRIVER_BOARD::init_hpsw(void)
       // sensitivity. A higher value makes StallGuard4 more sensitive and requires less torque to
       // indicate a stall. The double of this value is compared to SG_RESULT.
       // The stall output becomes active if SG_RESULT falls below this value.
-      pinMode(ControllerData->get_brdhpswpin(), INPUT_PULLUP);    // initialize the pin
-      mytmcstepper->SGTHRS(ControllerData->get_stallguard_value());
+      hal_pinmode(ControllerData->get_brdhpswpin(), INPUT_PULLUP);    // initialize the pin
+      tmcuart->set(Tmc_Sgthrs, ControllerData->get_stallguard_value());
       DRVBRD_println("drvbrd: init_hpsw: use stall guard");
       state = true;
       break;
 
     case Use_Physical_Switch:
       // if using a physical switch then hpsw in controllerdata must also be enabled
-      pinMode(ControllerData->get_brdhpswpin(), INPUT_PULLUP);    // initialize the pin
-      mytmcstepper->SGTHRS(0);
+      hal_pinmode(ControllerData->get_brdhpswpin(), INPUT_PULLUP);    // initialize the pin
+      tmcuart->set(Tmc_Sgthrs, 0);
       DRVBRD_println("drvbrd: init_hpsw: use physical switch");
       state = true;
       break;
 
     case Use_None:
-      mytmcstepper->SGTHRS(0);
+      tmcuart->set(Tmc_Sgthrs, 0);
       DRVBRD_println("drvbrd: init_hpsw: use none");
       state = true;
       break;
@@ -924,7 +896,7 @@ bool DRIVER_BOARD::init_hpsw(void)
   // for all other boards
   if ( ControllerData->get_hpswitch_enable() == V_ENABLED )
   {
-    pinMode(ControllerData->get_brdhpswpin(), INPUT_PULLUP);    // initialize the pin
+    hal_pinmode(ControllerData->get_brdhpswpin(), INPUT_PULLUP);    // initialize the pin
     return true;
   }
   return false;
@@ -944,29 +916,31 @@ void DRIVER_BOARD::init_tmc2209(void)
   mytmcstepper->pdn_disable(1);                                 // Use PDN/UART pin for communication
   mytmcstepper->mstep_reg_select(1);                            // Adjust stepMode from the registers
   mytmcstepper->I_scale_analog(0);                              // Adjust current from the registers
-  mytmcstepper->toff(TOFF_VALUE);                               // use TMC22xx Calculations sheet to get these
-  mytmcstepper->tbl(2);
-  mytmcstepper->rms_current(ControllerData->get_tmc2209current()); // set driver current mA
+  // the remaining settings go through the uart task, which writes them once started
+  tmcuart->set(Tmc_Toff, TOFF_VALUE);                           // use TMC22xx Calculations sheet to get these
+  tmcuart->set(Tmc_Tbl, 2);
+  tmcuart->set(Tmc_Current, ControllerData->get_tmc2209current());  // set driver current mA
   // step mode
   int sm = ControllerData->get_brdstepmode(); // stepmode set according to ControllerData->get_brdstepmode()
   sm = (sm == STEP1) ? 0 : sm;                                  // handle full steps
   DRVBRD_print("drvbrd: init_tmc2209() set microsteps: ");
   DRVBRD_println(sm);
-  mytmcstepper->microsteps(sm);
+  tmcuart->set(Tmc_Microsteps, sm);
 
   // stall guard settings
-  mytmcstepper->semin(0);
+  tmcuart->set(Tmc_Semin, 0);
   // lower threshold velocity for switching on smart energy CoolStep and StallGuard to DIAG output
-  mytmcstepper->TCOOLTHRS(0xFFFFF);                             // 20bit max
-  mytmcstepper->hysteresis_end(0);                              // use TMC22xx Calculations sheet to get these
-  mytmcstepper->hysteresis_start(0);                            // use TMC22xx Calculations sheet to get these
+  tmcuart->set(Tmc_Tcoolthrs, 0xFFFFF);                         // 20bit max
+  tmcuart->set(Tmc_Hend, 0);                                    // use TMC22xx Calculations sheet to get these
+  tmcuart->set(Tmc_Hstrt, 0);                                   // use TMC22xx Calculations sheet to get these
+  tmcuart->begin(mytmcstepper, mytmcstepper);
 
   // setup of stall guard moved to init_hpsw()
 
   DRVBRD_print("drvbrd: TMC2209 Status: ");
   DRVBRD_println( driver.test_connection() == 0 ? "OK" : "NOT OK" );
   DRVBRD_print("drvbrd: Motor is ");
-  DRVBRD_println(digitalRead(ControllerData->get_brdenablepin()) ? "DISABLED" : "ENABLED");
+  DRVBRD_println(hal_digitalread(ControllerData->get_brdenablepin()) ? "DISABLED" : "ENABLED");
   DRVBRD_print("drvbrd: stepMode is ");
   DRVBRD_println(driver.microsteps());
 #endif // #if (DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P)
@@ -982,22 +956,24 @@ void DRIVER_BOARD::init_tmc2225(void)
   // protection around mytmcstepper - it is not defined if not using tmc2209 or tmc2225
   mytmcstepper = new TMC2208Stepper(&SERIAL_PORT2);             // specify the serial2 interface to the tmc2225
   Serial2.begin(TMC2225SPEED);
-  mytmcstepper.begin();
+  mytmcstepper->begin();
   mytmcstepper->pdn_disable(1);                                 // use PDN/UART pin for communication
   mytmcstepper->mstep_reg_select(true);
   mytmcstepper->I_scale_analog(0);                              // adjust current from the registers
-  mytmcstepper->rms_current(ControllerData->get_tmc2225current());   // set driver current [recommended NEMA = 400mA, set to 300mA]
-  mytmcstepper->toff(2);                                        // enable driver
+  // the remaining settings go through the uart task, which writes them once started
+  tmcuart->set(Tmc_Current, ControllerData->get_tmc2225current());  // set driver current [recommended NEMA = 400mA, set to 300mA]
+  tmcuart->set(Tmc_Toff, 2);                                    // enable driver
   unsigned short sm = (unsigned short) ControllerData->get_brdstepmode(); // stepmode set according to ControllerData->get_brdstepmode();
   sm = (sm == STEP1) ? 0 : sm;                                  // handle full steps
-  mytmcstepper->microsteps(sm);
+  tmcuart->set(Tmc_Microsteps, sm);
   // step mode = 1/4 - default specified in boardfile.jsn
-  mytmcstepper->hysteresis_end(0);
-  mytmcstepper->hysteresis_start(0);
+  tmcuart->set(Tmc_Hend, 0);
+  tmcuart->set(Tmc_Hstrt, 0);
+  tmcuart->begin(mytmcstepper, NULL);
   DRVBRD_print("drvbrd: TMC2225 Status: ");
   DRVBRD_println( driver.test_connection() == 0 ? "OK" : "NOT OK" );
   DRVBRD_print("drvbrd: Motor is ");
-  DRVBRD_println(digitalRead(ControllerData->get_brdenablepin()) ? "DISABLED" : "ENABLED");
+  DRVBRD_println(hal_digitalread(ControllerData->get_brdenablepin()) ? "DISABLED" : "ENABLED");
   DRVBRD_print("drvbrd: stepMode is ");
   DRVBRD_println(driver.microsteps());
 #endif // #if (DRVBRD == PRO2ESP32TMC2225)
@@ -1043,13 +1019,13 @@ bool DRIVER_BOARD::hpsw_alert(void)
       {
         DRVBRD_println("drvbrd: hpsw_alert: use stall guard");
         // diag pin = HIGH if stall guard found, we return high if DIAG, low otherwise
-        return (bool) digitalRead(ControllerData->get_brdhpswpin());
+        return (bool) hal_digitalread(ControllerData->get_brdhpswpin());
       }
       else if ( ControllerData->get_stallguard_state() == Use_Physical_Switch)
       {
         DRVBRD_println("drvbrd: hpsw_alert: use physical switch");
         // diag pin = HIGH if stall guard found, we return high if DIAG, low otherwise
-        return !( (bool)digitalRead(ControllerData->get_brdhpswpin()) );
+        return !( (bool)hal_digitalread(ControllerData->get_brdhpswpin()) );
       }
       else
       {
@@ -1061,7 +1037,7 @@ bool DRIVER_BOARD::hpsw_alert(void)
     else
     {
       // switch uses internal pullup, if hpsw is closed = low, so we need to invert state to return high when switch is closed
-      return !( (bool)digitalRead(ControllerData->get_brdhpswpin()) );
+      return !( (bool)hal_digitalread(ControllerData->get_brdhpswpin()) );
     }
   }
   return state;
@@ -1086,39 +1062,39 @@ void DRIVER_BOARD::setstepmode(int smode)
       switch (smode)
       {
         case STEP1:
-          digitalWrite(ControllerData->get_brdboardpins(0), 0);
-          digitalWrite(ControllerData->get_brdboardpins(1), 0);
-          digitalWrite(ControllerData->get_brdboardpins(2), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(0), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(1), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(2), 0);
           break;
         case STEP2:
-          digitalWrite(ControllerData->get_brdboardpins(0), 1);
-          digitalWrite(ControllerData->get_brdboardpins(1), 0);
-          digitalWrite(ControllerData->get_brdboardpins(2), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(0), 1);
+          hal_digitalwrite(ControllerData->get_brdboardpins(1), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(2), 0);
           break;
         case STEP4:
-          digitalWrite(ControllerData->get_brdboardpins(0), 0);
-          digitalWrite(ControllerData->get_brdboardpins(1), 1);
-          digitalWrite(ControllerData->get_brdboardpins(2), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(0), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(1), 1);
+          hal_digitalwrite(ControllerData->get_brdboardpins(2), 0);
           break;
         case STEP8:
-          digitalWrite(ControllerData->get_brdboardpins(0), 1);
-          digitalWrite(ControllerData->get_brdboardpins(1), 1);
-          digitalWrite(ControllerData->get_brdboardpins(2), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(0), 1);
+          hal_digitalwrite(ControllerData->get_brdboardpins(1), 1);
+          hal_digitalwrite(ControllerData->get_brdboardpins(2), 0);
           break;
         case STEP16:
-          digitalWrite(ControllerData->get_brdboardpins(0), 0);
-          digitalWrite(ControllerData->get_brdboardpins(1), 0);
-          digitalWrite(ControllerData->get_brdboardpins(2), 1);
+          hal_digitalwrite(ControllerData->get_brdboardpins(0), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(1), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(2), 1);
           break;
         case STEP32:
-          digitalWrite(ControllerData->get_brdboardpins(0), 1);
-          digitalWrite(ControllerData->get_brdboardpins(1), 0);
-          digitalWrite(ControllerData->get_brdboardpins(2), 1);
+          hal_digitalwrite(ControllerData->get_brdboardpins(0), 1);
+          hal_digitalwrite(ControllerData->get_brdboardpins(1), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(2), 1);
           break;
         default:
-          digitalWrite(ControllerData->get_brdboardpins(0), 0);
-          digitalWrite(ControllerData->get_brdboardpins(1), 0);
-          digitalWrite(ControllerData->get_brdboardpins(2), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(0), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(1), 0);
+          hal_digitalwrite(ControllerData->get_brdboardpins(2), 0);
           smode = STEP1;
           break;
       }
@@ -1151,8 +1127,8 @@ void DRIVER_BOARD::setstepmode(int smode)
       // handle full stepmode
       smode = (smode == STEP1) ? 0 : smode;     // tmc uses 0 as full step mode
 #if (DRVBRD == PRO2ESP32TMC2225 || DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P )
-      // protection around mytmcstepper - it is not defined if not using tmc2209 or tmc2225
-      mytmcstepper->microsteps(smode);
+      // written by the tmc uart task
+      tmcuart->set(Tmc_Microsteps, smode);
 #endif // #if (DRVBRD == PRO2ESP32TMC2225 || DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P )
       if (smode == 0)                           // controller uses 1 as full step mode
       {
@@ -1174,7 +1150,7 @@ void DRIVER_BOARD::enablemotor(void)
   if  (this->_boardnum == PRO2ESP32DRV8825 || this->_boardnum == PRO2ESP32R3WEMOS || this->_boardnum == PRO2ESP32TMC2225 \
        || this->_boardnum == PRO2ESP32TMC2209 || this->_boardnum == PRO2ESP32TMC2209P || this->_boardnum == PRO2ESP32ST6128 )
   {
-    digitalWrite(ControllerData->get_brdenablepin(), 0);
+    hal_digitalwrite(ControllerData->get_brdenablepin(), 0);
     delay(1);                                                   // boards require 1ms before stepping can occur
   }
 }
@@ -1189,14 +1165,14 @@ void DRIVER_BOARD::releasemotor(void)
   if  (this->_boardnum == PRO2ESP32DRV8825 || this->_boardnum == PRO2ESP32R3WEMOS || this->_boardnum == PRO2ESP32TMC2225 \
        || this->_boardnum == PRO2ESP32TMC2209 || this->_boardnum == PRO2ESP32TMC2209P || this->_boardnum == PRO2ESP32ST6128 )
   {
-    digitalWrite(ControllerData->get_brdenablepin(), 1);
+    hal_digitalwrite(ControllerData->get_brdenablepin(), 1);
   }
   else if  (this->_boardnum == PRO2ESP32ULN2003 || this->_boardnum == PRO2ESP32L298N || this->_boardnum == PRO2ESP32L293DMINI || this->_boardnum == PRO2ESP32L9110S)
   {
-    digitalWrite(this->_inputpins[0], 0 );
-    digitalWrite(this->_inputpins[1], 0 );
-    digitalWrite(this->_inputpins[2], 0 );
-    digitalWrite(this->_inputpins[3], 0 );
+    hal_digitalwrite(this->_inputpins[0], 0 );
+    hal_digitalwrite(this->_inputpins[1], 0 );
+    hal_digitalwrite(this->_inputpins[2], 0 );
+    hal_digitalwrite(this->_inputpins[3], 0 );
   }
 }
 
@@ -1214,7 +1190,7 @@ void DRIVER_BOARD::movemotor(byte ddir, bool updatefpos)
   // turn on leds
   if (  (this->_leds_loaded == V_ENABLED) &&  (this->_ledmode == LEDPULSE) )
   {
-    ( stepdir == moving_in ) ? digitalWrite(ControllerData->get_brdinledpin(), 1) : digitalWrite(ControllerData->get_brdoutledpin(), 1);
+    ( stepdir == moving_in ) ? hal_digitalwrite(ControllerData->get_brdinledpin(), 1) : hal_digitalwrite(ControllerData->get_brdoutledpin(), 1);
   }
 
   // do direction, enable and step motor
@@ -1223,14 +1199,14 @@ void DRIVER_BOARD::movemotor(byte ddir, bool updatefpos)
   {
     if ( ControllerData->get_reverse_enable() == V_ENABLED )
     {
-      digitalWrite(ControllerData->get_brddirpin(), !stepdir);  // set Direction of travel
+      hal_digitalwrite(ControllerData->get_brddirpin(), !stepdir);  // set Direction of travel
     }
     else
     {
-      digitalWrite(ControllerData->get_brddirpin(), stepdir);   // set Direction of travel
+      hal_digitalwrite(ControllerData->get_brddirpin(), stepdir);   // set Direction of travel
     }
     // board is enabled by init_motor() before timer starts, so not required here
-    digitalWrite(ControllerData->get_brdsteppin(), 1);          // Step pin on
+    hal_digitalwrite(ControllerData->get_brdsteppin(), 1);          // Step pin on
     // assume clock frequency is 240mHz
     asm1uS();                                                   // ESP32 must be 2uS delay for DRV8825 chip
     asm1uS();
@@ -1238,7 +1214,7 @@ void DRIVER_BOARD::movemotor(byte ddir, bool updatefpos)
     asm1uS();
     asm1uS();
     asm1uS();
-    digitalWrite(ControllerData->get_brdsteppin(), 0);          // Step pin off
+    hal_digitalwrite(ControllerData->get_brdsteppin(), 0);          // Step pin off
   }
   else if ( this->_boardnum == PRO2ESP32ULN2003 || this->_boardnum == PRO2ESP32L298N || this->_boardnum == PRO2ESP32L293DMINI || this->_boardnum == PRO2ESP32L9110S )
   {
@@ -1271,7 +1247,7 @@ void DRIVER_BOARD::movemotor(byte ddir, bool updatefpos)
   // turn off leds
   if (  (this->_leds_loaded == V_ENABLED) &&  (this->_ledmode == LEDPULSE))
   {
-    ( stepdir == moving_in ) ? digitalWrite(ControllerData->get_brdinledpin(), 0) : digitalWrite(ControllerData->get_brdoutledpin(), 0);
+    ( stepdir == moving_in ) ? hal_digitalwrite(ControllerData->get_brdinledpin(), 0) : hal_digitalwrite(ControllerData->get_brdoutledpin(), 0);
   }
 
   // update focuser position
@@ -1289,13 +1265,13 @@ void DRIVER_BOARD::movemotor(byte ddir, bool updatefpos)
 void DRIVER_BOARD::initmove(bool mdir, long steps)
 {
   stepdir = mdir;
-  portENTER_CRITICAL(&stepcountMux);                            // make sure stepcount is 0 when DRIVER_BOARD created
+  hal_enter(&stepcountMux);                            // make sure stepcount is 0 when DRIVER_BOARD created
   stepcount = steps;
-  portEXIT_CRITICAL(&stepcountMux);
+  hal_exit(&stepcountMux);
   DRIVER_BOARD::enablemotor();
-  portENTER_CRITICAL(&timerSemaphoreMux);
+  hal_enter(&timerSemaphoreMux);
   timerSemaphore = false;
-  portEXIT_CRITICAL(&timerSemaphoreMux);
+  hal_exit(&timerSemaphoreMux);
 
   DRVBRD_print("drvbrd: init_move(), steps: ");
   DRVBRD_println(steps);
@@ -1306,9 +1282,68 @@ void DRIVER_BOARD::initmove(bool mdir, long steps)
   // if ledmode is ledmove then turn on leds now
   if ( this->_ledmode == LEDMOVE )
   {
-    ( stepdir == moving_in ) ? digitalWrite(ControllerData->get_brdinledpin(), 1) : digitalWrite(ControllerData->get_brdoutledpin(), 1);
+    ( stepdir == moving_in ) ? hal_digitalwrite(ControllerData->get_brdinledpin(), 1) : hal_digitalwrite(ControllerData->get_brdoutledpin(), 1);
+  }
+
+  unsigned long curspd = get_stepdelay();                       // fastest step delay for the board and step mode
+
+  DRVBRD_print("drvbrd:initmove: speed-delay: ");
+  DRVBRD_println(curspd);
+
+  // for TMC2209 stall guard, setting varies with speed setting so we need to adjust sgval for best results
+  // handle different motor peeds
+  byte sgval = ControllerData->get_stallguard_value();
+  bool sgchanged = false;
+  switch ( ControllerData->get_motorspeed() )
+  {
+    case 0: // slow, 1/3rd the speed
+      curspd *= 3;
+      // no need to change stall guard
+      break;
+    case 1: // med, 1/2 the speed
+      curspd *= 2;
+      sgval = sgval / 2;
+      break;
+    case 2: // fast, 1/1 the speed
+      //curspd *= 1;                                           // obviously not needed
+      sgval = sgval / 6;
+      break;
+  }
+  // a threshold calibrated for the speed replaces the scaled value
+  sgval = stallmon->get_sgthrs(ControllerData->get_motorspeed(), sgval);
+  DRVBRD_print("drvbrd: SG value to write: ");
+  DRVBRD_println(sgval);
+#if (DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P )
+  // don't change the value in ControllerData : this is for a speed calculation
+  // queued, not written if the same as the last move
+  sgchanged = tmcuart->set(Tmc_Sgthrs, sgval);
+#endif
+
+  // a jog sets its own step rate
+  if ( this->_jogdelay != 0 )
+  {
+    curspd = this->_jogdelay;
   }
 
+  sgchanged = tmctuner->startmove(curspd, mdir) || sgchanged;  // chopper mode and hold current for this move
+  // the stall output must use the settings of this move from the first step
+  if ( sgchanged == true )
+  {
+    tmcuart->flush(TMCUART_FLUSHTIME);
+  }
+  steprec->begin(curspd);                                      // starts recording if armed for this move
+  // call onTimer function every interval value curspd (value in microseconds)
+  movetimer = hal_timer_start(1, curspd, &onTimer);            // timer-number, interval time, our handler
+  this->_timerrunning = true;
+}
+
+// ----------------------------------------------------------------------
+// GET STEP DELAY
+// driverboard->get_stepdelay()
+// us between steps at the fastest motor speed, before the motorspeed setting
+// ----------------------------------------------------------------------
+unsigned long DRIVER_BOARD::get_stepdelay(void)
+{
   unsigned long curspd = ControllerData->get_brdmsdelay();      // get current board speed delay value
 
   // handle the board step delays for TMC22xx steppers differently
@@ -1348,42 +1383,48 @@ void DRIVER_BOARD::initmove(bool mdir, long steps)
         break;
     }
   } // if( this->_boardnum == PRO2ESP32TMC2225 || this->_boardnum == PRO2ESP32TMC2209 || this->_boardnum == PRO2ESP32TMC2209P)
+  return curspd;
+}
 
-  DRVBRD_print("drvbrd:initmove: speed-delay: ");
-  DRVBRD_println(curspd);
-
-  // for TMC2209 stall guard, setting varies with speed setting so we need to adjust sgval for best results
-  // handle different motor peeds
-  byte sgval = ControllerData->get_stallguard_value();
-  switch ( ControllerData->get_motorspeed() )
+// ----------------------------------------------------------------------
+// JOG
+// driverboard->jog(rate)
+// rate is permille of the fastest step rate, +ve moves out, 0 stops
+// A jog is one move towards the end of travel. A change of rate is
+// written to the move timer without stopping the move, a return to 0
+// halts the move. A change of direction halts first, the move the other
+// way starts on a later call.
+// ----------------------------------------------------------------------
+void DRIVER_BOARD::jog(int rate)
+{
+  if ( (rate == 0) || ((this->_jograte != 0) && ((rate > 0) != (this->_jograte > 0))) )
   {
-    case 0: // slow, 1/3rd the speed
-      curspd *= 3;
-      // no need to change stall guard
-      break;
-    case 1: // med, 1/2 the speed
-      curspd *= 2;
-      sgval = sgval / 2;
-      break;
-    case 2: // fast, 1/1 the speed
-      //curspd *= 1;                                           // obviously not needed
-      sgval = sgval / 6;
-      break;
+    if ( this->_jograte != 0 )
+    {
+      this->_jograte  = 0;
+      this->_jogdelay = 0;
+      if ( isMoving == true )
+      {
+        hal_enter(&halt_alertMux);
+        halt_alert = true;
+        hal_exit(&halt_alertMux);
+      }
+    }
+    return;
   }
-  DRVBRD_print("drvbrd: SG value to write: ");
-  DRVBRD_println(sgval);
-#if (DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P )
-  // protection required around mytmcstepper - it is not defined if not using tmc2209 or tmc2225
-  // don't change the value in ControllerData : this is for a speed calculation
-  mytmcstepper->SGTHRS(sgval);
-#endif
 
-  movetimer = timerBegin(1, 80, true);                         // timer-number, prescaler, count up (true) or down (false)
-  timerAttachInterrupt(movetimer, &onTimer, true);             // our handler name, address of function int handler, edge=true
-  // Set alarm to call onTimer function every interval value curspd (value in microseconds).
-  // Repeat the alarm (third parameter)
-  timerAlarmWrite(movetimer, curspd, true);                    // timer for ISR, interval time, reload=true
-  timerAlarmEnable(movetimer);
+  unsigned long jogdelay = JOG_CURVE::stepdelay(get_stepdelay(), rate);
+  // small changes are ignored so the timer is not rewritten every sample
+  if ( JOG_CURVE::retime(this->_jogdelay, jogdelay) == true )
+  {
+    this->_jogdelay = jogdelay;
+    if ( this->_timerrunning == true )
+    {
+      hal_timer_interval(movetimer, jogdelay);
+    }
+  }
+  this->_jograte = rate;
+  ftargetPosition = (rate > 0) ? ControllerData->get_maxstep() : 0;
 }
 
 // ----------------------------------------------------------------------
@@ -1396,15 +1437,15 @@ void DRIVER_BOARD::end_move(void)
   DRVBRD_println("drvbrd: end_move()");
 
   // stop the timer
-  timerStop(movetimer);
-  timerAlarmDisable(movetimer);       // stop alarm
-  timerDetachInterrupt(movetimer);
+  hal_timer_stop(movetimer);
+  this->_timerrunning = false;
+  steprec->end();
 
   // if using led move mode then turn off leds at end of move
   if (  (this->_leds_loaded == V_ENABLED) &&  (this->_ledmode == LEDMOVE) )
   {
-    digitalWrite(ControllerData->get_brdinledpin(), 0);
-    digitalWrite(ControllerData->get_brdoutledpin(), 0);
+    hal_digitalwrite(ControllerData->get_brdinledpin(), 0);
+    hal_digitalwrite(ControllerData->get_brdoutledpin(), 0);
   }
 }
 
@@ -1426,18 +1467,35 @@ void DRIVER_BOARD::setposition(long newpos)
 byte DRIVER_BOARD::getstallguardvalue(void)
 {
 #if (DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P )
-  // protection required around mytmcstepper - it is not defined if not using tmc2209 or tmc2225
-  byte sgval = mytmcstepper->SGTHRS();   // read sgthreshold
+  // the value held by the uart task, the driver is not read
+  byte sgval = tmcuart->get(Tmc_Sgthrs);
   ControllerData->set_stallguard_value(sgval);
 #endif
   return ControllerData->get_stallguard_value();
 }
 
+// ----------------------------------------------------------------------
+// live StallGuard4 load measurement, lower is a higher load
+// -1 if not a TMC2209 board, not moving or jogging [speed is not known]
+// Queues a read for the next call and returns the last value read, so
+// the caller does not wait for the uart
+// ----------------------------------------------------------------------
+int DRIVER_BOARD::get_sgresult(void)
+{
+#if (DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P )
+  if ( (this->_timerrunning == true) && (this->_jograte == 0) )
+  {
+    tmcuart->read(Tmc_SgResult, NULL);
+    return tmcuart->get_read(Tmc_SgResult);
+  }
+#endif
+  return -1;
+}
+
 void DRIVER_BOARD::setstallguardvalue(byte newval)
 {
 #if (DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P )
-  // protection required around mytmcstepper - it is not defined if not using tmc2209 or tmc2225
-  mytmcstepper->SGTHRS(newval); // write sgthreshold
+  tmcuart->set(Tmc_Sgthrs, newval);     // write sgthreshold
 #endif
   ControllerData->set_stallguard_value(newval);
 }
@@ -1446,8 +1504,7 @@ void DRIVER_BOARD::settmc2209current(int newval)
 {
   ControllerData->set_tmc2209current(newval);
 #if (DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P )
-  // protection required around mytmcstepper - it is not defined if not using tmc2209 or tmc2225
-  mytmcstepper->rms_current(ControllerData->get_tmc2209current());     // Set driver current
+  tmcuart->set(Tmc_Current, ControllerData->get_tmc2209current());     // Set driver current
 #endif
 }
 
@@ -1455,7 +1512,6 @@ void DRIVER_BOARD::settmc2225current(int newval)
 {
   ControllerData->set_tmc2225current(newval);
 #if (DRVBRD == PRO2ESP32TMC2225)
-  // protection around mytmcstepper - it is not defined if not using tmc2209 or tmc2225
-  mytmcstepper->rms_current(ControllerData->get_tmc2225current());     // Set driver current
+  tmcuart->set(Tmc_Current, ControllerData->get_tmc2225current());     // Set driver current
 #endif
 }
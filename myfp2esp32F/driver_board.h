@@ -68,6 +68,8 @@ class DRIVER_BOARD
     void init_tmc2225(void);
     bool hpsw_alert(void);                        // check for HPSW, and for TMC2209 stall guard or physical switch
     void end_move(void);                          // end a move
+    void jog(int);                                // jog rate, permille of the fastest step rate, 0 stops
+    unsigned long get_stepdelay(void);            // us, fastest step delay for the board and step mode
 
     
     bool set_leds(bool);
@@ -76,7 +78,7 @@ class DRIVER_BOARD
 
     bool set_pushbuttons(bool);
     bool get_pushbuttons_loaded(void);
-    void update_pushbuttons(void);
+    bool update_pushbuttons(void);
     // no need for pushbuttons_enable because it is in ControllerData
 
     bool set_joystick1(bool);
@@ -95,6 +97,7 @@ class DRIVER_BOARD
     // get
     long getposition(void);
     byte getstallguardvalue(void);
+    int  get_sgresult(void);                      // StallGuard4 load while moving, -1 if not available
     bool getdirection(void);
     
     // set
@@ -129,6 +132,9 @@ class DRIVER_BOARD
     bool _joystick1_loaded  = false;
     bool _joystick2_loaded  = false;
     bool _joystick2_swstate = false;   
+    int  _jograte = 0;              // permille, +ve is out, 0 when not jogging
+    unsigned long _jogdelay = 0;    // us between steps of a jog
+    bool _timerrunning = false;     // move timer alarm is enabled
 };
 
 
@@ -0,0 +1,213 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 FILE SYSTEM
+// © Copyright Robert Brown 2014-2022. All Rights Reserved.
+// file_system.cpp
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "file_system.h"
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define FILESYS_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  FILESYS_PRINT
+#define FILESYS_print(...)   Serial.print(__VA_ARGS__)
+#define FILESYS_println(...) Serial.println(__VA_ARGS__)
+#else
+#define FILESYS_print(...)
+#define FILESYS_println(...)
+#endif
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define FSBENCH_MAXFILES  24
+#define FSBENCH_WRITE     "/fsbench.tmp"      // scratch files for the write and rename timings
+#define FSBENCH_RENAME    "/fsbench.ren"
+
+
+// ----------------------------------------------------------------------
+// list the files used by the controller, config, web page and board files
+// ----------------------------------------------------------------------
+static int fs_benchfiles(fs::FS &fs, String *files)
+{
+  int count = 0;
+
+  files[count++] = "/cntlr_config.bin";
+  files[count++] = "/cntlr_config.jsn";
+  files[count++] = "/index.html";
+
+  // LittleFS has directories, on SPIFFS the board files are listed from root
+  File dir = fs.open("/boards");
+  if ( !dir || !dir.isDirectory() )
+  {
+    dir = fs.open("/");
+  }
+  if ( dir && dir.isDirectory() )
+  {
+    File file = dir.openNextFile();
+    while ( file && (count < FSBENCH_MAXFILES) )
+    {
+      String fname = file.path();
+      if ( !file.isDirectory() && fname.startsWith("/boards/") )
+      {
+        files[count++] = fname;
+      }
+      file.close();
+      file = dir.openNextFile();
+    }
+    dir.close();
+  }
+  return count;
+}
+
+// ----------------------------------------------------------------------
+// time exists/open/read/write/rename for one file, in microseconds
+// the write and rename use scratch files, the file itself is not changed
+// ----------------------------------------------------------------------
+static String fs_benchfile(fs::FS &fs, const String &fname)
+{
+  unsigned long start = micros();
+  bool found = fs.exists(fname);
+  unsigned long t_exists = micros() - start;
+  if ( found == false )
+  {
+    return "";
+  }
+
+  start = micros();
+  File file = fs.open(fname, "r");
+  unsigned long t_open = micros() - start;
+  if ( !file )
+  {
+    return "";
+  }
+  size_t size = file.size();
+  uint8_t *buf = (uint8_t *) malloc(size + 1);
+  if ( buf == NULL )
+  {
+    file.close();
+    return "";
+  }
+  start = micros();
+  size_t len = file.read(buf, size);
+  unsigned long t_read = micros() - start;
+  file.close();
+
+  start = micros();
+  File wfile = fs.open(FSBENCH_WRITE, "w");
+  if ( wfile )
+  {
+    wfile.write(buf, len);
+    wfile.close();
+  }
+  unsigned long t_write = micros() - start;
+  free(buf);
+
+  start = micros();
+  fs.rename(FSBENCH_WRITE, FSBENCH_RENAME);
+  unsigned long t_rename = micros() - start;
+  fs.remove(FSBENCH_WRITE);
+  fs.remove(FSBENCH_RENAME);
+
+  return "{ \"file\":\"" + fname + "\", \"size\":" + String(len) + ", \"exists\":" + String(t_exists) \
+         + ", \"open\":" + String(t_open) + ", \"read\":" + String(t_read) + ", \"write\":" + String(t_write) \
+         + ", \"rename\":" + String(t_rename) + " }";
+}
+
+// ----------------------------------------------------------------------
+// time each of the files, returns a json array
+// ----------------------------------------------------------------------
+static String fs_benchfiles_json(fs::FS &fs, String *files, int count)
+{
+  String jsonstr = "[";
+  bool first = true;
+
+  for (int i = 0; i < count; i++)
+  {
+    String result = fs_benchfile(fs, files[i]);
+    if ( result != "" )
+    {
+      jsonstr += (first == true) ? " " : ", ";
+      jsonstr += result;
+      first = false;
+    }
+  }
+  jsonstr += " ]";
+  return jsonstr;
+}
+
+// ----------------------------------------------------------------------
+// copy a file from one file system to another
+// ----------------------------------------------------------------------
+static bool fs_copyfile(fs::FS &from, fs::FS &to, const String &fname)
+{
+  uint8_t buf[256];
+  File src = from.open(fname, "r");
+  if ( !src )
+  {
+    return false;
+  }
+  File dst = to.open(fname, "w");
+  if ( !dst )
+  {
+    src.close();
+    return false;
+  }
+  size_t len;
+  while ( (len = src.read(buf, sizeof(buf))) > 0 )
+  {
+    dst.write(buf, len);
+  }
+  dst.close();
+  src.close();
+  return true;
+}
+
+// ----------------------------------------------------------------------
+// String fs_benchmark(void);
+// Time exists/open/read/write/rename of the controller files on the file
+// system in use (FILESYS). The same files are then copied into the memory
+// file system and timed there. To compare SPIFFS and LittleFS, build with
+// each FILESYSTEM setting, they share the same flash partition.
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String fs_benchmark(void)
+{
+  String files[FSBENCH_MAXFILES];
+  int count = fs_benchfiles(FILESYS, files);
+
+  FILESYS_print("fs: benchmark files ");
+  FILESYS_println(count);
+  String jsonstr = "{ \"fs\":\"" FILESYSNAME "\", \"files\":" + fs_benchfiles_json(FILESYS, files, count);
+
+#if (FILESYSTEM != FS_MEMORY)
+  // copy the files into the memory file system, time them, then release the memory
+  MemoryFS.begin();
+  MemoryFS.format();
+  for (int i = 0; i < count; i++)
+  {
+    fs_copyfile(FILESYS, MemoryFS, files[i]);
+  }
+  jsonstr += ", \"memory\":" + fs_benchfiles_json(MemoryFS, files, count);
+  MemoryFS.format();
+  MemoryFS.end();
+#endif
+
+  jsonstr += " }";
+  return jsonstr;
+}
@@ -0,0 +1,50 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 FILE SYSTEM DEFINITIONS
+// © Copyright Robert Brown 2014-2022. All Rights Reserved.
+// file_system.h
+// ----------------------------------------------------------------------
+
+#if !defined(_file_system_h_)
+#define _file_system_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include <FS.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+
+
+// ----------------------------------------------------------------------
+// FILE SYSTEM
+// ----------------------------------------------------------------------
+// All modules access files through FILESYS, which is a fs::FS object
+// [SPIFFS, LittleFS or MemoryFS] selected by FILESYSTEM in controller_config.h
+// The memory file system is always built, it is used by fs_benchmark()
+// and is the file system of host builds [ARDUINO is not defined]
+#include "file_system_memory.h"
+
+#if (FILESYSTEM == FS_LITTLEFS)
+#include <LittleFS.h>
+#define FILESYS           LittleFS
+#define FILESYSNAME       "littlefs"
+#elif (FILESYSTEM == FS_MEMORY) || !defined(ARDUINO)
+#define FILESYS           MemoryFS
+#define FILESYSNAME       "memory"
+#else
+#include <SPIFFS.h>
+#define FILESYS           SPIFFS
+#define FILESYSNAME       "spiffs"
+#endif
+
+
+// ----------------------------------------------------------------------
+// SUPPORT FUNCTIONS
+// ----------------------------------------------------------------------
+// time open/read/write/rename of the controller files, returns a json string
+String fs_benchmark(void);
+
+
+
+#endif // #if !defined(_file_system_h_)
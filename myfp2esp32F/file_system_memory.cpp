@@ -0,0 +1,504 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 MEMORY FILE SYSTEM CLASS
+// © Copyright Robert Brown 2014-2022. All Rights Reserved.
+// file_system_memory.cpp
+// A fs::FS held in RAM, for host (Linux) builds and benchmarks
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include <FS.h>
+#include <FSImpl.h>
+#include <map>
+#include <set>
+#include <vector>
+#include <memory>
+#include <time.h>
+
+#include "file_system_memory.h"
+
+using namespace fs;
+
+
+// ----------------------------------------------------------------------
+// FILE STORE
+// ----------------------------------------------------------------------
+// file contents are shared between the store and any open file, so a file
+// which is removed or renamed while open stays valid until it is closed
+struct memfs_data
+{
+  std::vector<uint8_t> bytes;
+  time_t lastwrite;
+};
+typedef std::shared_ptr<memfs_data> memfs_ptr;
+
+static std::map<String, memfs_ptr> memfs_files;     // full path, contents
+static std::set<String> memfs_dirs;                 // directories made with mkdir()
+static bool memfs_mounted = false;
+
+// make a path absolute, with no trailing /
+static String memfs_path(const char *path)
+{
+  String p = (path == NULL) ? "/" : path;
+  if ( !p.startsWith("/") )
+  {
+    p = "/" + p;
+  }
+  while ( (p.length() > 1) && p.endsWith("/") )
+  {
+    p.remove(p.length() - 1);
+  }
+  return p;
+}
+
+// prefix of the entries held in a directory
+static String memfs_dirprefix(const String &dir)
+{
+  return (dir == "/") ? dir : dir + "/";
+}
+
+// true if path is the root, a directory made with mkdir(), or holds a file
+static bool memfs_isdir(const String &dir)
+{
+  if ( (dir == "/") || (memfs_dirs.count(dir) != 0) )
+  {
+    return true;
+  }
+  String prefix = memfs_dirprefix(dir);
+  for (auto it = memfs_files.begin(); it != memfs_files.end(); ++it)
+  {
+    if ( it->first.startsWith(prefix) )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+static size_t memfs_used(void)
+{
+  size_t used = 0;
+  for (auto it = memfs_files.begin(); it != memfs_files.end(); ++it)
+  {
+    used += it->second->bytes.size();
+  }
+  return used;
+}
+
+static FileImplPtr memfs_open(const char *path, const char *mode);
+
+
+// ----------------------------------------------------------------------
+// FILE
+// ----------------------------------------------------------------------
+class MemFileImpl : public FileImpl
+{
+  public:
+    MemFileImpl(const String &path, memfs_ptr data, bool canread, bool canwrite, bool append)
+      : _path(path), _data(data), _read(canread), _write(canwrite), _append(append)
+    {
+      _pos = (append == true) ? data->bytes.size() : 0;
+    }
+
+    size_t write(const uint8_t *buf, size_t size)
+    {
+      if ( (_open == false) || (_write == false) )
+      {
+        return 0;
+      }
+      if ( _append == true )
+      {
+        _pos = _data->bytes.size();
+      }
+      // limit any growth of the file to the free space
+      size_t end = _pos + size;
+      if ( end > _data->bytes.size() )
+      {
+        size_t freespace = MEMORYFS_SIZE - memfs_used();
+        size_t grow = end - _data->bytes.size();
+        if ( grow > freespace )
+        {
+          size -= (grow - freespace);
+          end = _pos + size;
+        }
+        if ( end > _data->bytes.size() )
+        {
+          _data->bytes.resize(end);
+        }
+      }
+      memcpy(_data->bytes.data() + _pos, buf, size);
+      _pos += size;
+      _data->lastwrite = time(NULL);
+      return size;
+    }
+
+    size_t read(uint8_t *buf, size_t size)
+    {
+      if ( (_open == false) || (_read == false) || (_pos >= _data->bytes.size()) )
+      {
+        return 0;
+      }
+      size_t len = _data->bytes.size() - _pos;
+      len = (size < len) ? size : len;
+      memcpy(buf, _data->bytes.data() + _pos, len);
+      _pos += len;
+      return len;
+    }
+
+    void flush()
+    {
+    }
+
+    bool seek(uint32_t pos, SeekMode mode)
+    {
+      size_t newpos;
+      switch ( mode )
+      {
+        case SeekCur:
+          newpos = _pos + pos;
+          break;
+        case SeekEnd:
+          newpos = _data->bytes.size() + pos;
+          break;
+        default:
+          newpos = pos;
+          break;
+      }
+      if ( newpos > _data->bytes.size() )
+      {
+        return false;
+      }
+      _pos = newpos;
+      return true;
+    }
+
+    size_t position() const
+    {
+      return _pos;
+    }
+
+    size_t size() const
+    {
+      return _data->bytes.size();
+    }
+
+    bool setBufferSize(size_t size)
+    {
+      return true;
+    }
+
+    void close()
+    {
+      _open = false;
+    }
+
+    time_t getLastWrite()
+    {
+      return _data->lastwrite;
+    }
+
+    const char* path() const
+    {
+      return _path.c_str();
+    }
+
+    const char* name() const
+    {
+      return _path.c_str() + _path.lastIndexOf('/') + 1;
+    }
+
+    boolean isDirectory(void)
+    {
+      return false;
+    }
+
+    FileImplPtr openNextFile(const char* mode)
+    {
+      return FileImplPtr();
+    }
+
+    void rewindDirectory(void)
+    {
+    }
+
+    operator bool()
+    {
+      return _open;
+    }
+
+  private:
+    String    _path;
+    memfs_ptr _data;
+    size_t    _pos;
+    bool      _read;
+    bool      _write;
+    bool      _append;
+    bool      _open = true;
+};
+
+
+// ----------------------------------------------------------------------
+// DIRECTORY
+// ----------------------------------------------------------------------
+class MemDirImpl : public FileImpl
+{
+  public:
+    MemDirImpl(const String &path) : _path(path)
+    {
+      rewindDirectory();
+    }
+
+    size_t write(const uint8_t *buf, size_t size)
+    {
+      return 0;
+    }
+
+    size_t read(uint8_t *buf, size_t size)
+    {
+      return 0;
+    }
+
+    void flush()
+    {
+    }
+
+    bool seek(uint32_t pos, SeekMode mode)
+    {
+      return false;
+    }
+
+    size_t position() const
+    {
+      return 0;
+    }
+
+    size_t size() const
+    {
+      return 0;
+    }
+
+    bool setBufferSize(size_t size)
+    {
+      return false;
+    }
+
+    void close()
+    {
+      _open = false;
+      _entries.clear();
+    }
+
+    time_t getLastWrite()
+    {
+      return 0;
+    }
+
+    const char* path() const
+    {
+      return _path.c_str();
+    }
+
+    const char* name() const
+    {
+      return _path.c_str() + _path.lastIndexOf('/') + 1;
+    }
+
+    boolean isDirectory(void)
+    {
+      return true;
+    }
+
+    FileImplPtr openNextFile(const char* mode)
+    {
+      if ( (_open == false) || (_next >= _entries.size()) )
+      {
+        return FileImplPtr();
+      }
+      return memfs_open(_entries[_next++].c_str(), mode);
+    }
+
+    // list the files and sub directories held in this directory
+    void rewindDirectory(void)
+    {
+      std::set<String> entries;
+      String prefix = memfs_dirprefix(_path);
+      for (auto it = memfs_files.begin(); it != memfs_files.end(); ++it)
+      {
+        if ( it->first.startsWith(prefix) )
+        {
+          int slash = it->first.indexOf('/', prefix.length());
+          entries.insert((slash < 0) ? it->first : it->first.substring(0, slash));
+        }
+      }
+      for (auto it = memfs_dirs.begin(); it != memfs_dirs.end(); ++it)
+      {
+        if ( it->startsWith(prefix) && (it->indexOf('/', prefix.length()) < 0) )
+        {
+          entries.insert(*it);
+        }
+      }
+      _entries.assign(entries.begin(), entries.end());
+      _next = 0;
+    }
+
+    operator bool()
+    {
+      return _open;
+    }
+
+  private:
+    String _path;
+    std::vector<String> _entries;
+    size_t _next = 0;
+    bool   _open = true;
+};
+
+
+// ----------------------------------------------------------------------
+// FILE SYSTEM
+// ----------------------------------------------------------------------
+// modes are as fopen(), r r+ w w+ a a+
+static FileImplPtr memfs_open(const char *path, const char *mode)
+{
+  if ( (memfs_mounted == false) || (mode == NULL) )
+  {
+    return FileImplPtr();
+  }
+  String p = memfs_path(path);
+  bool update = (strchr(mode, '+') != NULL);
+  auto it = memfs_files.find(p);
+
+  if ( mode[0] == 'r' )
+  {
+    if ( it == memfs_files.end() )
+    {
+      if ( (update == false) && memfs_isdir(p) )
+      {
+        return std::make_shared<MemDirImpl>(p);
+      }
+      return FileImplPtr();
+    }
+    return std::make_shared<MemFileImpl>(p, it->second, true, update, false);
+  }
+
+  if ( (mode[0] != 'w') && (mode[0] != 'a') )
+  {
+    return FileImplPtr();
+  }
+  if ( (p == "/") || ((it == memfs_files.end()) && memfs_isdir(p)) )
+  {
+    return FileImplPtr();
+  }
+  if ( (it == memfs_files.end()) || (mode[0] == 'w') )
+  {
+    // create the file, or truncate it
+    memfs_ptr data = std::make_shared<memfs_data>();
+    data->lastwrite = time(NULL);
+    memfs_files[p] = data;
+    return std::make_shared<MemFileImpl>(p, data, update, true, false);
+  }
+  return std::make_shared<MemFileImpl>(p, it->second, update, true, true);
+}
+
+class MemFSImpl : public FSImpl
+{
+  public:
+    FileImplPtr open(const char* path, const char* mode, const bool create)
+    {
+      return memfs_open(path, mode);
+    }
+
+    bool exists(const char* path)
+    {
+      if ( memfs_mounted == false )
+      {
+        return false;
+      }
+      String p = memfs_path(path);
+      return (memfs_files.count(p) != 0) || memfs_isdir(p);
+    }
+
+    bool rename(const char* pathFrom, const char* pathTo)
+    {
+      String from = memfs_path(pathFrom);
+      String to = memfs_path(pathTo);
+      auto it = memfs_files.find(from);
+      if ( (memfs_mounted == false) || (it == memfs_files.end()) || memfs_isdir(to) )
+      {
+        return false;
+      }
+      memfs_ptr data = it->second;
+      memfs_files.erase(it);
+      memfs_files[to] = data;
+      return true;
+    }
+
+    bool remove(const char* path)
+    {
+      return (memfs_mounted == true) && (memfs_files.erase(memfs_path(path)) != 0);
+    }
+
+    bool mkdir(const char *path)
+    {
+      String p = memfs_path(path);
+      if ( (memfs_mounted == false) || (memfs_files.count(p) != 0) )
+      {
+        return false;
+      }
+      memfs_dirs.insert(p);
+      return true;
+    }
+
+    bool rmdir(const char *path)
+    {
+      String p = memfs_path(path);
+      if ( memfs_mounted == false )
+      {
+        return false;
+      }
+      memfs_dirs.erase(p);
+      // a directory which still holds files cannot be removed
+      return !memfs_isdir(p);
+    }
+};
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+MEMORY_FS MemoryFS;
+
+MEMORY_FS::MEMORY_FS() : FS(FSImplPtr(new MemFSImpl()))
+{
+
+}
+
+bool MEMORY_FS::begin(bool formatOnFail, const char *basePath, uint8_t maxOpenFiles, const char *partitionLabel)
+{
+  memfs_mounted = true;
+  return true;
+}
+
+bool MEMORY_FS::format(void)
+{
+  memfs_files.clear();
+  memfs_dirs.clear();
+  return true;
+}
+
+size_t MEMORY_FS::totalBytes(void)
+{
+  return MEMORYFS_SIZE;
+}
+
+size_t MEMORY_FS::usedBytes(void)
+{
+  return memfs_used();
+}
+
+void MEMORY_FS::end(void)
+{
+  memfs_mounted = false;
+}
@@ -0,0 +1,53 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 MEMORY FILE SYSTEM CLASS DEFINITIONS
+// © Copyright Robert Brown 2014-2022. All Rights Reserved.
+// file_system_memory.h
+// ----------------------------------------------------------------------
+
+#if !defined(_file_system_memory_h_)
+#define _file_system_memory_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include <FS.h>
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+// the memory file system holds its files in heap, limit the total size
+// a host build holds all of data/ [~140KB]
+#if !defined(MEMORYFS_SIZE)
+#if defined(ARDUINO)
+#define MEMORYFS_SIZE     65536
+#else
+#define MEMORYFS_SIZE     1048576
+#endif
+#endif
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// A fs::FS held in RAM, with the same calls as SPIFFS and LittleFS.
+// Paths with a / are treated as directories, as on LittleFS.
+// Used for host (Linux) builds and by fs_benchmark()
+class MEMORY_FS : public fs::FS
+{
+  public:
+    MEMORY_FS();
+    bool begin(bool formatOnFail = false, const char *basePath = "/memory", uint8_t maxOpenFiles = 10, const char *partitionLabel = NULL);
+    bool format(void);
+    size_t totalBytes(void);
+    size_t usedBytes(void);
+    void end(void);
+};
+
+extern MEMORY_FS MemoryFS;
+
+
+
+#endif // #if !defined(_file_system_memory_h_)
@@ -0,0 +1,414 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 FOCUSER CHANNEL CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// focuser_channel.cpp
+// A second focuser on a step/dir driver, with its own move timer
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "focuser_channel.h"
+
+#if defined(ARDUINO)
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "file_system.h"
+
+#include "power_manager.h"
+extern POWER_MANAGER *powermgr;
+
+#include "controller_data.h"
+extern CONTROLLER_DATA *ControllerData;
+
+extern bool filesystemloaded;
+#else
+#define ERROR_println(...)
+#endif
+
+extern FOCUSER_CHANNEL *focuser2;
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define FOCUSER2_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  FOCUSER2_PRINT
+#define FOCUSER2_print(...)   Serial.print(__VA_ARGS__)
+#define FOCUSER2_println(...) Serial.println(__VA_ARGS__)
+#else
+#define FOCUSER2_print(...)
+#define FOCUSER2_println(...)
+#endif
+
+
+// ----------------------------------------------------------------------
+// TIMER ISR
+// ----------------------------------------------------------------------
+// This must be outside of class
+void IRAM_ATTR focuser2_isr()
+{
+  focuser2->step();
+}
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+FOCUSER_CHANNEL::FOCUSER_CHANNEL(int channel, int timernum, hal_isr isr)
+{
+  _channel  = channel;
+  _timernum = timernum;
+  _isr      = isr;
+}
+
+bool FOCUSER_CHANNEL::begin(int steppin, int dirpin, int enablepin, long maxstep, unsigned long stepdelay, bool reverse, bool coilpower)
+{
+  if ( (steppin < 0) || (dirpin < 0) )
+  {
+    ERROR_println("focuser2: begin error, no step or dir pin");
+    return false;
+  }
+  if ( (pin_inuse(steppin) == true) || (pin_inuse(dirpin) == true) || (pin_inuse(enablepin) == true) )
+  {
+    ERROR_println("focuser2: begin error, pin used by the driver board");
+    return false;
+  }
+  _steppin   = steppin;
+  _dirpin    = dirpin;
+  _enablepin = enablepin;
+  _maxstep   = maxstep;
+  _stepdelay = stepdelay;
+  _reverse   = reverse;
+  _coilpower = coilpower;
+
+  hal_pinmode(_steppin, OUTPUT);
+  hal_pinmode(_dirpin, OUTPUT);
+  hal_digitalwrite(_steppin, 0);
+  if ( _enablepin >= 0 )
+  {
+    hal_pinmode(_enablepin, OUTPUT);
+    hal_digitalwrite(_enablepin, (_coilpower == true) ? 0 : 1);   // enable is active low
+  }
+  load_position();
+  _target = _position;
+  _loaded = true;
+  FOCUSER2_print("focuser2: position ");
+  FOCUSER2_println(_position);
+  return true;
+}
+
+// ----------------------------------------------------------------------
+// the step pulse, the position is updated as each step is made so it
+// can be read while moving
+// ----------------------------------------------------------------------
+void IRAM_ATTR FOCUSER_CHANNEL::step(void)
+{
+  if ( (_stepcount > 0) && (_halt == false) )
+  {
+    hal_digitalwrite(_steppin, 1);
+    hal_delayus(FC_PULSEWIDTH);
+    hal_digitalwrite(_steppin, 0);
+    hal_enter(&_mux);
+    _stepcount--;
+    _position += _stepdir;
+    hal_exit(&_mux);
+  }
+  else if ( _done == false )
+  {
+    hal_enter(&_mux);
+    _stepcount = 0;
+    _done = true;
+    hal_exit(&_mux);
+  }
+}
+
+// ----------------------------------------------------------------------
+// state machine, the timer runs only while moving
+// ----------------------------------------------------------------------
+bool FOCUSER_CHANNEL::update(void)
+{
+  if ( _loaded == false )
+  {
+    return false;
+  }
+  switch ( _state )
+  {
+    case FC_Idle:
+      if ( _halt == true )
+      {
+        // halt of a move not yet started
+        _target = get_position();
+        _halt = false;
+        _halts++;
+      }
+      if ( _target != _position )
+      {
+        long steps = _target - _position;
+#if defined(ARDUINO)
+        powermgr->activity();                 // full clock, the wake latency is only timed for the driver board
+#endif
+        if ( _enablepin >= 0 )
+        {
+          hal_digitalwrite(_enablepin, 0);
+        }
+        hal_digitalwrite(_dirpin, ((steps > 0) != _reverse) ? 1 : 0);
+        hal_enter(&_mux);
+        _stepdir   = (steps > 0) ? 1 : -1;
+        _stepcount = (steps > 0) ? steps : -steps;
+        _done      = false;
+        hal_exit(&_mux);
+        _steps += (steps > 0) ? steps : -steps;
+        _moves++;
+        FOCUSER2_print("focuser2: move to ");
+        FOCUSER2_println(_target);
+        _timer = hal_timer_start(_timernum, _stepdelay, _isr);
+        _state = FC_Moving;
+        return true;
+      }
+      if ( (_savedue == true) && ((hal_millis() - _endtime) > FC_SAVEDELAY) )
+      {
+        save_position();
+        _savedue = false;
+      }
+      return false;
+
+    case FC_Moving:
+      if ( _done == true )
+      {
+        _state = FC_EndMove;
+      }
+      return true;
+
+    case FC_EndMove:
+      hal_timer_stop(_timer);
+      _timer = NULL;
+      if ( (_enablepin >= 0) && (_coilpower == false) )
+      {
+        hal_digitalwrite(_enablepin, 1);
+      }
+      if ( _halt == true )
+      {
+        _target = _position;
+        _halt = false;
+        _halts++;
+      }
+      _endtime = hal_millis();
+      _savedue = true;
+      FOCUSER2_print("focuser2: end move ");
+      FOCUSER2_println(_position);
+      _state = FC_Idle;
+      return true;
+
+    default:
+      _state = FC_Idle;
+      return false;
+  }
+}
+
+bool FOCUSER_CHANNEL::move(long target)
+{
+  if ( get_ismoving() == true )
+  {
+    return false;
+  }
+  target = (target < 0) ? 0 : target;
+  _target = (target > _maxstep) ? _maxstep : target;
+  return true;
+}
+
+bool FOCUSER_CHANNEL::move_steps(long steps)
+{
+  return move(get_position() + steps);
+}
+
+void FOCUSER_CHANNEL::halt(void)
+{
+  if ( get_ismoving() == true )
+  {
+    _halt = true;
+  }
+}
+
+bool FOCUSER_CHANNEL::set_position(long position)
+{
+  if ( get_ismoving() == true )
+  {
+    return false;
+  }
+  position = (position < 0) ? 0 : position;
+  position = (position > _maxstep) ? _maxstep : position;
+  hal_enter(&_mux);
+  _position = position;
+  hal_exit(&_mux);
+  _target = position;
+  _savedue = true;
+  _endtime = hal_millis();
+  return true;
+}
+
+// the settings are from focuser2_defines.h at boot, a change is kept
+// until the next reboot
+void FOCUSER_CHANNEL::set_maxstep(long maxstep)
+{
+  long position = get_position();
+  _maxstep = (maxstep < position) ? position : maxstep;
+}
+
+// the enable pin follows at once if not moving, else at the end of the move
+void FOCUSER_CHANNEL::set_coilpower(bool coilpower)
+{
+  _coilpower = coilpower;
+  if ( (_enablepin >= 0) && (get_ismoving() == false) )
+  {
+    hal_digitalwrite(_enablepin, (_coilpower == true) ? 0 : 1);
+  }
+}
+
+bool FOCUSER_CHANNEL::set_reverse(bool reverse)
+{
+  if ( get_ismoving() == true )
+  {
+    return false;
+  }
+  _reverse = reverse;
+  return true;
+}
+
+void FOCUSER_CHANNEL::set_stepdelay(unsigned long stepdelay)
+{
+  _stepdelay = stepdelay;
+}
+
+long FOCUSER_CHANNEL::get_position(void)
+{
+  hal_enter(&_mux);
+  long position = _position;
+  hal_exit(&_mux);
+  return position;
+}
+
+long FOCUSER_CHANNEL::get_target(void)
+{
+  return _target;
+}
+
+long FOCUSER_CHANNEL::get_maxstep(void)
+{
+  return _maxstep;
+}
+
+bool FOCUSER_CHANNEL::get_coilpower(void)
+{
+  return _coilpower;
+}
+
+bool FOCUSER_CHANNEL::get_reverse(void)
+{
+  return _reverse;
+}
+
+unsigned long FOCUSER_CHANNEL::get_stepdelay(void)
+{
+  return _stepdelay;
+}
+
+// a move is pending from move() until the state machine ends it
+bool FOCUSER_CHANNEL::get_ismoving(void)
+{
+  return (_state != FC_Idle) || (_target != get_position());
+}
+
+int FOCUSER_CHANNEL::get_channel(void)
+{
+  return _channel;
+}
+
+// ----------------------------------------------------------------------
+// position and moves since boot
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String FOCUSER_CHANNEL::get_stats(void)
+{
+  String jsonstr = "{ \"channel\":" + String(_channel) + ", \"position\":" + String(get_position()) \
+                   + ", \"target\":" + String(_target) + ", \"maxstep\":" + String(_maxstep) \
+                   + ", \"ismoving\":" + String((get_ismoving() == true) ? "true" : "false") \
+                   + ", \"moves\":" + String(_moves) + ", \"halts\":" + String(_halts) \
+                   + ", \"steps\":" + String(_steps) + " }";
+  return jsonstr;
+}
+
+// ----------------------------------------------------------------------
+// the pins of the driver board, the options on the board, the I2C display
+// and on a TMC board the Serial2 uart, cannot be used by this channel
+// ----------------------------------------------------------------------
+bool FOCUSER_CHANNEL::pin_inuse(int pin)
+{
+  if ( pin < 0 )
+  {
+    return false;
+  }
+#if defined(ARDUINO)
+  int brdpins[] = { ControllerData->get_brdsteppin(), ControllerData->get_brddirpin(), ControllerData->get_brdenablepin(),
+                    ControllerData->get_brdtemppin(), ControllerData->get_brdhpswpin(), ControllerData->get_brdinledpin(),
+                    ControllerData->get_brdoutledpin(), ControllerData->get_brdpb1pin(), ControllerData->get_brdpb2pin(),
+                    ControllerData->get_brdirpin(), ControllerData->get_brdboardpins(0), ControllerData->get_brdboardpins(1),
+                    ControllerData->get_brdboardpins(2), ControllerData->get_brdboardpins(3), I2CDATAPIN, I2CCLKPIN
+                  };
+  for (unsigned int i = 0; i < sizeof(brdpins) / sizeof(brdpins[0]); i++)
+  {
+    if ( brdpins[i] == pin )
+    {
+      return true;
+    }
+  }
+  int brd = ControllerData->get_brdnumber();
+  if ( (brd == PRO2ESP32TMC2225) || (brd == PRO2ESP32TMC2209) || (brd == PRO2ESP32TMC2209P) )
+  {
+    return (pin == FC_SERIAL2RX) || (pin == FC_SERIAL2TX);
+  }
+#endif
+  return false;
+}
+
+// ----------------------------------------------------------------------
+// the position is kept in its own file, written some time after a move
+// so a series of small moves is one write
+// ----------------------------------------------------------------------
+void FOCUSER_CHANNEL::load_position(void)
+{
+#if defined(ARDUINO)
+  if ( (filesystemloaded == true) && FILESYS.exists(FOCUSER2_FILE) )
+  {
+    File file = FILESYS.open(FOCUSER2_FILE, "r");
+    long position = file.readString().toInt();
+    file.close();
+    _position = (position < 0) ? 0 : ((position > _maxstep) ? _maxstep : position);
+  }
+#endif
+}
+
+void FOCUSER_CHANNEL::save_position(void)
+{
+#if defined(ARDUINO)
+  if ( filesystemloaded == false )
+  {
+    return;
+  }
+  File file = FILESYS.open(FOCUSER2_FILE, "w");
+  if ( !file )
+  {
+    ERROR_println("focuser2: unable to save position");
+    return;
+  }
+  file.print(get_position());
+  file.close();
+#endif
+}
@@ -0,0 +1,104 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 FOCUSER CHANNEL CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// focuser_channel.h
+// ----------------------------------------------------------------------
+
+#if !defined(_focuser_channel_h_)
+#define _focuser_channel_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "hal.h"
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define FOCUSER2_TIMER      0             // hw timer, 1 is the move timer of the driver board, 2 the task scheduler
+#define FOCUSER2_FILE       "/focuser2.txt"
+#define FC_SAVEDELAY        30000         // ms after a move ends before the position is saved
+#define FC_PULSEWIDTH       2             // us, DRV8825 needs 1.9us
+#define FC_SERIAL2RX        16            // uart of the TMC driver boards
+#define FC_SERIAL2TX        17
+
+enum FC_States { FC_Idle, FC_Moving, FC_EndMove };
+
+void IRAM_ATTR focuser2_isr(void);        // move timer isr of focuser2
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// An extra focuser on a step/dir driver. Each channel has its own hw
+// timer, isr and step count, so its moves run at the same time as moves
+// of the driver board without sharing any state with the move timer.
+// update() is the state machine, called by the loop scheduler.
+class FOCUSER_CHANNEL
+{
+  public:
+    FOCUSER_CHANNEL(int, int, hal_isr);   // channel, hw timer, isr that calls step()
+
+    bool begin(int, int, int, long, unsigned long, bool, bool);  // step, dir, enable pin, maxstep, step delay us, reverse, coil power
+    bool update(void);                    // state machine, true while moving
+    void IRAM_ATTR step(void);            // called from the isr
+
+    bool move(long);                      // goto target, false if moving
+    bool move_steps(long);                // relative move, false if moving
+    void halt(void);
+    bool set_position(long);              // false if moving
+    void set_maxstep(long);               // not below the position
+    void set_coilpower(bool);
+    bool set_reverse(bool);               // false if moving
+    void set_stepdelay(unsigned long);    // us, used from the next move
+
+    long get_position(void);
+    long get_target(void);
+    long get_maxstep(void);
+    bool get_coilpower(void);
+    bool get_reverse(void);
+    unsigned long get_stepdelay(void);
+    bool get_ismoving(void);
+    int  get_channel(void);
+    String get_stats(void);
+
+  private:
+    void load_position(void);
+    void save_position(void);
+    bool pin_inuse(int);
+
+    int  _channel;
+    int  _timernum;
+    hal_isr _isr;
+    hal_timer_t *_timer = NULL;
+    hal_mux_t _mux = HAL_MUX_INITIALIZER;  // protects the isr variables
+    enum FC_States _state = FC_Idle;
+    int  _steppin = -1;
+    int  _dirpin = -1;
+    int  _enablepin = -1;
+    long _maxstep = 0;
+    unsigned long _stepdelay = 4000;
+    bool _reverse = false;
+    bool _coilpower = false;
+    bool _loaded = false;
+    long _target = 0;
+    bool _savedue = false;
+    uint32_t _endtime = 0;                // ms, end of the last move
+    // isr
+    volatile long     _position = 0;
+    volatile uint32_t _stepcount = 0;
+    volatile int      _stepdir = 1;       // +1 out, -1 in
+    volatile bool     _halt = false;
+    volatile bool     _done = false;
+    // stats
+    uint32_t _moves = 0;
+    uint32_t _halts = 0;
+    uint32_t _steps = 0;
+};
+
+
+
+#endif // #if !defined(_focuser_channel_h_)
@@ -0,0 +1,211 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HARDWARE ABSTRACTION LAYER
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// hal.cpp
+// Host implementation, the ESP32 calls are inline in hal.h
+// ----------------------------------------------------------------------
+
+#if !defined(ARDUINO)
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include "hal.h"
+
+
+// ----------------------------------------------------------------------
+// DATA
+// ----------------------------------------------------------------------
+struct hal_timer
+{
+  bool     running;
+  bool     oneshot;                       // stops when the isr is called
+  uint32_t interval;                      // us
+  uint64_t due;                           // clock of the next call
+  hal_isr  isr;
+};
+
+static uint64_t     hal_clock = 0;        // us since reset
+static int          hal_levels[HAL_PINS];
+static int          hal_analog[HAL_PINS];
+static hal_timer    hal_timers[HAL_TIMERS];
+static hal_pin_hook hal_hook = NULL;
+
+static bool hal_valid(int pin)
+{
+  return (pin >= 0) && (pin < HAL_PINS);
+}
+
+
+// ----------------------------------------------------------------------
+// TIME AND GPIO
+// ----------------------------------------------------------------------
+uint32_t hal_millis(void)
+{
+  return (uint32_t) (hal_clock / 1000);
+}
+
+uint32_t hal_micros(void)
+{
+  return (uint32_t) hal_clock;
+}
+
+void hal_pinmode(int pin, int mode)
+{
+  if ( hal_valid(pin) && (mode == INPUT_PULLUP) )
+  {
+    hal_levels[pin] = 1;
+  }
+}
+
+void hal_digitalwrite(int pin, int level)
+{
+  if ( hal_valid(pin) )
+  {
+    hal_levels[pin] = (level != 0);
+    if ( hal_hook != NULL )
+    {
+      hal_hook(pin, hal_levels[pin]);
+    }
+  }
+}
+
+int hal_digitalread(int pin)
+{
+  return hal_valid(pin) ? hal_levels[pin] : 0;
+}
+
+int hal_analogread(int pin)
+{
+  return hal_valid(pin) ? hal_analog[pin] : 0;
+}
+
+
+// ----------------------------------------------------------------------
+// TIMERS
+// ----------------------------------------------------------------------
+hal_timer_t *hal_timer_start(int num, uint32_t us, hal_isr isr)
+{
+  if ( (num < 0) || (num >= HAL_TIMERS) )
+  {
+    return NULL;
+  }
+  hal_timer_t *timer = &hal_timers[num];
+  timer->running  = true;
+  timer->oneshot  = false;
+  timer->interval = (us == 0) ? 1 : us;
+  timer->due      = hal_clock + timer->interval;
+  timer->isr      = isr;
+  return timer;
+}
+
+void hal_timer_interval(hal_timer_t *timer, uint32_t us)
+{
+  timer->interval = (us == 0) ? 1 : us;
+  if ( timer->due > (hal_clock + timer->interval) )
+  {
+    timer->due = hal_clock + timer->interval;
+  }
+}
+
+void hal_timer_stop(hal_timer_t *timer)
+{
+  timer->running = false;
+}
+
+hal_timer_t *hal_timer_attach(int num, hal_isr isr)
+{
+  if ( (num < 0) || (num >= HAL_TIMERS) )
+  {
+    return NULL;
+  }
+  hal_timer_t *timer = &hal_timers[num];
+  timer->running = false;
+  timer->oneshot = true;
+  timer->isr     = isr;
+  return timer;
+}
+
+void hal_timer_alarm(hal_timer_t *timer, uint64_t us)
+{
+  timer->running = true;
+  timer->due     = hal_clock + ((us == 0) ? 1 : us);
+}
+
+void hal_timer_disarm(hal_timer_t *timer)
+{
+  timer->running = false;
+}
+
+
+// ----------------------------------------------------------------------
+// SIMULATION
+// ----------------------------------------------------------------------
+void hal_host_reset(void)
+{
+  hal_clock = 0;
+  for (int i = 0; i < HAL_PINS; i++)
+  {
+    hal_levels[i] = 0;
+    hal_analog[i] = 0;
+  }
+  for (int i = 0; i < HAL_TIMERS; i++)
+  {
+    hal_timers[i].running = false;
+  }
+  hal_hook = NULL;
+}
+
+// run the timers in order of their due times up to the end of the period
+void hal_host_advance(uint64_t us)
+{
+  uint64_t end = hal_clock + us;
+  for (;;)
+  {
+    hal_timer_t *next = NULL;
+    for (int i = 0; i < HAL_TIMERS; i++)
+    {
+      if ( hal_timers[i].running && (hal_timers[i].due <= end) && ((next == NULL) || (hal_timers[i].due < next->due)) )
+      {
+        next = &hal_timers[i];
+      }
+    }
+    if ( next == NULL )
+    {
+      break;
+    }
+    hal_clock = next->due;
+    next->due += next->interval;
+    next->running = !next->oneshot;
+    next->isr();
+  }
+  hal_clock = end;
+}
+
+uint64_t hal_host_clock(void)
+{
+  return hal_clock;
+}
+
+void hal_host_setpin(int pin, int level)
+{
+  if ( hal_valid(pin) )
+  {
+    hal_levels[pin] = (level != 0);
+  }
+}
+
+void hal_host_setanalog(int pin, int value)
+{
+  if ( hal_valid(pin) )
+  {
+    hal_analog[pin] = value;
+  }
+}
+
+void hal_host_onwrite(hal_pin_hook hook)
+{
+  hal_hook = hook;
+}
+
+#endif // #if !defined(ARDUINO)
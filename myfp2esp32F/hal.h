@@ -0,0 +1,195 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HARDWARE ABSTRACTION LAYER DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// hal.h
+// ----------------------------------------------------------------------
+
+#if !defined(_hal_h_)
+#define _hal_h_
+
+
+// ----------------------------------------------------------------------
+// NOTES
+// ----------------------------------------------------------------------
+// Time, gpio, critical sections and the move timer used by the motion
+// code. On the ESP32 these are inline calls to the Arduino core. On a
+// host build [ARDUINO not defined] hal.cpp provides a virtual clock,
+// simulated pins and timers that run when the clock is advanced, so the
+// motion code can run as a native process.
+// The rest of the Arduino core a host build needs is in host/ [String,
+// Serial, FreeRTOS, the file system as MemoryFS, WiFi, sockets and the
+// WebServer], see test_programs/host-firmware
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define HAL_TIMERS        4               // hw timers 0 - 3
+#define HAL_PINS          40              // gpio 0 - 39
+
+typedef void (*hal_isr)(void);
+
+
+#if defined(ARDUINO)
+// ----------------------------------------------------------------------
+// ESP32
+// ----------------------------------------------------------------------
+typedef hw_timer_t   hal_timer_t;
+typedef portMUX_TYPE hal_mux_t;
+#define HAL_MUX_INITIALIZER   portMUX_INITIALIZER_UNLOCKED
+
+inline uint32_t hal_millis(void)
+{
+  return millis();
+}
+
+inline uint32_t hal_micros(void)
+{
+  return micros();
+}
+
+inline void hal_pinmode(int pin, int mode)
+{
+  pinMode(pin, mode);
+}
+
+inline void hal_digitalwrite(int pin, int level)
+{
+  digitalWrite(pin, level);
+}
+
+inline int hal_digitalread(int pin)
+{
+  return digitalRead(pin);
+}
+
+inline int hal_analogread(int pin)
+{
+  return analogRead(pin);
+}
+
+// busy wait, used for step pulse widths, safe in an isr
+inline void hal_delayus(uint32_t us)
+{
+  delayMicroseconds(us);
+}
+
+inline void hal_enter(hal_mux_t *mux)
+{
+  portENTER_CRITICAL(mux);
+}
+
+inline void hal_exit(hal_mux_t *mux)
+{
+  portEXIT_CRITICAL(mux);
+}
+
+// periodic timer with a 1us tick, the isr is called every us microseconds
+inline hal_timer_t *hal_timer_start(int num, uint32_t us, hal_isr isr)
+{
+  hw_timer_t *timer = timerBegin(num, 80, true);               // timer-number, prescaler, count up
+  timerAttachInterrupt(timer, isr, true);                      // edge=true
+  timerAlarmWrite(timer, us, true);                            // interval time, reload=true
+  timerAlarmEnable(timer);
+  return timer;
+}
+
+// change the interval of a running timer, if the count has passed the
+// new alarm the isr is called now rather than after the counter wraps
+inline void hal_timer_interval(hal_timer_t *timer, uint32_t us)
+{
+  timerAlarmWrite(timer, us, true);
+  if ( timerRead(timer) >= us )
+  {
+    timerWrite(timer, us - 1);
+  }
+}
+
+inline void hal_timer_stop(hal_timer_t *timer)
+{
+  timerStop(timer);
+  timerAlarmDisable(timer);
+  timerDetachInterrupt(timer);
+}
+
+// one shot timer with a 1us tick, the alarm is off until hal_timer_alarm()
+inline hal_timer_t *hal_timer_attach(int num, hal_isr isr)
+{
+  hw_timer_t *timer = timerBegin(num, 80, true);
+  timerAttachInterrupt(timer, isr, true);
+  return timer;
+}
+
+// the isr is called once, us microseconds from now
+inline void hal_timer_alarm(hal_timer_t *timer, uint64_t us)
+{
+  timerAlarmDisable(timer);
+  timerWrite(timer, 0);
+  timerAlarmWrite(timer, us, false);                           // reload=false
+  timerAlarmEnable(timer);
+}
+
+inline void hal_timer_disarm(hal_timer_t *timer)
+{
+  timerAlarmDisable(timer);
+}
+
+#else
+// ----------------------------------------------------------------------
+// HOST, hal.cpp
+// ----------------------------------------------------------------------
+#if !defined(INPUT)
+#define INPUT             0x01
+#define OUTPUT            0x03
+#define INPUT_PULLUP      0x05
+#endif
+#if !defined(IRAM_ATTR)
+#define IRAM_ATTR
+#endif
+
+// one thread, the timer isrs run inside hal_host_advance()
+typedef int hal_mux_t;
+#define HAL_MUX_INITIALIZER   0
+
+typedef struct hal_timer hal_timer_t;
+typedef void (*hal_pin_hook)(int, int);   // pin, level
+
+uint32_t hal_millis(void);
+uint32_t hal_micros(void);
+void hal_pinmode(int, int);
+void hal_digitalwrite(int, int);
+int  hal_digitalread(int);
+int  hal_analogread(int);
+inline void hal_delayus(uint32_t) {}     // the virtual clock only moves in hal_host_advance()
+inline void hal_enter(hal_mux_t *) {}
+inline void hal_exit(hal_mux_t *) {}
+hal_timer_t *hal_timer_start(int, uint32_t, hal_isr);
+void hal_timer_interval(hal_timer_t *, uint32_t);
+void hal_timer_stop(hal_timer_t *);
+hal_timer_t *hal_timer_attach(int, hal_isr);
+void hal_timer_alarm(hal_timer_t *, uint64_t);
+void hal_timer_disarm(hal_timer_t *);
+
+// simulation
+void hal_host_reset(void);                // clock to 0, pins low, timers stopped
+void hal_host_advance(uint64_t);          // us, timer isrs run at their due times
+uint64_t hal_host_clock(void);            // us
+void hal_host_setpin(int, int);           // level of an input pin
+void hal_host_setanalog(int, int);        // adc value of a pin
+void hal_host_onwrite(hal_pin_hook);      // called on each hal_digitalwrite()
+#endif // #if defined(ARDUINO)
+
+
+
+#endif // #if !defined(_hal_h_)
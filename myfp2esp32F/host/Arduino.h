@@ -0,0 +1,248 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST ARDUINO CORE DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/Arduino.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_arduino_h_)
+#define _host_arduino_h_
+
+
+// ----------------------------------------------------------------------
+// NOTES
+// ----------------------------------------------------------------------
+// The part of the Arduino ESP32 core used by the controller, for a host
+// build [ARDUINO not defined]. Time and gpio are the HAL virtual clock
+// and pins, Serial is stdout. There is no FreeRTOS scheduler, tasks are
+// not created, so the display, infra red and TMC uart tasks do not run.
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+#include <algorithm>
+
+#define HIGH              0x1
+#define LOW               0x0
+#define INPUT             0x01
+#define OUTPUT            0x03
+#define INPUT_PULLUP      0x05
+#define RISING            0x01
+#define FALLING           0x02
+#define CHANGE            0x03
+
+#include "hal.h"
+#include "WString.h"
+#include "Stream.h"
+
+
+// ----------------------------------------------------------------------
+// TYPES AND MACROS
+// ----------------------------------------------------------------------
+typedef uint8_t  byte;
+typedef bool     boolean;
+typedef uint16_t word;
+
+#define PROGMEM
+#define PSTR(s)           (s)
+#define F(s)              (s)
+#define pgm_read_byte(a)  (*(const uint8_t *) (a))
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+using std::min;
+using std::max;
+
+long random(long);
+long random(long, long);
+void randomSeed(unsigned long);
+long map(long, long, long, long, long);
+
+char *itoa(int, char *, int);
+char *ltoa(long, char *, int);
+char *utoa(unsigned int, char *, int);
+#if defined(__GLIBC__) && ((__GLIBC__ < 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ < 38)))
+size_t strlcpy(char *, const char *, size_t);
+#endif
+
+
+// ----------------------------------------------------------------------
+// TIME AND GPIO
+// ----------------------------------------------------------------------
+inline unsigned long millis(void)
+{
+  return hal_millis();
+}
+
+inline unsigned long micros(void)
+{
+  return hal_micros();
+}
+
+// moves the virtual clock, the timer isrs due in the delay are run
+inline void delay(uint32_t ms)
+{
+  hal_host_advance((uint64_t) ms * 1000);
+}
+
+// as delay(), used between the backlash and home switch steps of loop()
+inline void delayMicroseconds(uint32_t us)
+{
+  hal_host_advance(us);
+}
+
+inline void yield(void)
+{
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode)
+{
+  hal_pinmode(pin, mode);
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t level)
+{
+  hal_digitalwrite(pin, level);
+}
+
+inline int digitalRead(uint8_t pin)
+{
+  return hal_digitalread(pin);
+}
+
+inline uint16_t analogRead(uint8_t pin)
+{
+  return hal_analogread(pin);
+}
+
+// pin interrupts are not simulated, inputs are polled
+inline void attachInterrupt(uint8_t, void (*)(void), int)
+{
+}
+
+inline void detachInterrupt(uint8_t)
+{
+}
+
+inline int digitalPinToInterrupt(int pin)
+{
+  return pin;
+}
+
+
+// ----------------------------------------------------------------------
+// ESP
+// ----------------------------------------------------------------------
+typedef hal_mux_t portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED  HAL_MUX_INITIALIZER
+#define portENTER_CRITICAL(mux)       hal_enter(mux)
+#define portEXIT_CRITICAL(mux)        hal_exit(mux)
+#define portENTER_CRITICAL_ISR(mux)   hal_enter(mux)
+#define portEXIT_CRITICAL_ISR(mux)    hal_exit(mux)
+
+// the cycle count runs at the cpu clock from the host monotonic clock, so
+// the profilers and benchmarks time the host code
+class EspClass
+{
+  public:
+    uint32_t getCpuFreqMHz(void);
+    uint32_t getCycleCount(void);
+    uint32_t getFreeHeap(void);
+    uint32_t getHeapSize(void);
+    uint32_t getMinFreeHeap(void);
+    uint32_t getMaxAllocHeap(void);
+    void restart(void);
+};
+
+extern EspClass ESP;
+
+bool setCpuFrequencyMhz(uint32_t);
+uint32_t getCpuFrequencyMhz(void);
+
+
+// ----------------------------------------------------------------------
+// FREERTOS
+// ----------------------------------------------------------------------
+typedef void    *TaskHandle_t;
+typedef void    *QueueHandle_t;
+typedef void    *SemaphoreHandle_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef enum { eNoAction, eSetBits, eIncrement, eSetValueWithOverwrite, eSetValueWithoutOverwrite } eNotifyAction;
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              1
+#define pdFAIL              0
+#define portMAX_DELAY       0xFFFFFFFF
+#define portTICK_PERIOD_MS  1
+#define pdMS_TO_TICKS(ms)   (ms)
+
+BaseType_t xTaskCreatePinnedToCore(void (*)(void *), const char *, uint32_t, void *, UBaseType_t, TaskHandle_t *, BaseType_t);
+void vTaskDelete(TaskHandle_t);
+void vTaskDelay(TickType_t);
+TickType_t xTaskGetTickCount(void);
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t);
+BaseType_t xTaskNotifyGive(TaskHandle_t);
+BaseType_t xTaskNotify(TaskHandle_t, uint32_t, eNotifyAction);
+BaseType_t xTaskNotifyWait(uint32_t, uint32_t, uint32_t *, TickType_t);
+
+QueueHandle_t xQueueCreate(UBaseType_t, UBaseType_t);
+BaseType_t xQueueSend(QueueHandle_t, const void *, TickType_t);
+BaseType_t xQueueReceive(QueueHandle_t, void *, TickType_t);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t);
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t);
+
+
+// ----------------------------------------------------------------------
+// SERIAL
+// ----------------------------------------------------------------------
+// Serial writes to stdout and reads nothing, Serial2 [TMC uart] has no driver
+class HardwareSerial : public Stream
+{
+  public:
+    HardwareSerial(FILE *out) : _out(out) {}
+    void begin(unsigned long, uint32_t config = 0, int8_t rxpin = -1, int8_t txpin = -1) {}
+    void end(void) {}
+    int available(void)
+    {
+      return 0;
+    }
+    int read(void)
+    {
+      return -1;
+    }
+    int peek(void)
+    {
+      return -1;
+    }
+    size_t write(uint8_t);
+    size_t write(const uint8_t *, size_t);
+    using Print::write;
+    void flush(void);
+    operator bool() const
+    {
+      return true;
+    }
+
+  private:
+    FILE *_out;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;
+
+
+
+#endif // #if !defined(_host_arduino_h_)
@@ -0,0 +1,136 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST FILE SYSTEM DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/FS.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_fs_h_)
+#define _host_fs_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <memory>
+#include <time.h>
+#include "Arduino.h"
+
+
+// ----------------------------------------------------------------------
+// CLASSES
+// ----------------------------------------------------------------------
+// fs::FS and fs::File as the Arduino ESP32 core, a file system provides
+// an FSImpl [host/FSImpl.h]. The host file system is MemoryFS.
+namespace fs
+{
+
+#define FILE_READ         "r"
+#define FILE_WRITE        "w"
+#define FILE_APPEND       "a"
+
+class File;
+
+class FileImpl;
+typedef std::shared_ptr<FileImpl> FileImplPtr;
+class FSImpl;
+typedef std::shared_ptr<FSImpl> FSImplPtr;
+
+enum SeekMode
+{
+  SeekSet = 0,
+  SeekCur = 1,
+  SeekEnd = 2
+};
+
+class File : public Stream
+{
+  public:
+    File(FileImplPtr p = FileImplPtr()) : _p(p) {}
+
+    size_t write(uint8_t);
+    size_t write(const uint8_t *, size_t);
+    using Print::write;
+    int available(void);
+    int read(void);
+    int peek(void);
+    void flush(void);
+    size_t read(uint8_t *, size_t);
+    size_t readBytes(char *buffer, size_t length)
+    {
+      return read((uint8_t *) buffer, length);
+    }
+
+    bool seek(uint32_t, SeekMode);
+    bool seek(uint32_t pos)
+    {
+      return seek(pos, SeekSet);
+    }
+    size_t position(void) const;
+    size_t size(void) const;
+    bool setBufferSize(size_t);
+    void close(void);
+    operator bool() const;
+    time_t getLastWrite(void);
+    const char *path(void) const;
+    const char *name(void) const;
+
+    bool isDirectory(void);
+    File openNextFile(const char *mode = FILE_READ);
+    void rewindDirectory(void);
+
+  protected:
+    FileImplPtr _p;
+};
+
+class FS
+{
+  public:
+    FS(FSImplPtr impl) : _impl(impl) {}
+
+    File open(const char *, const char *mode = FILE_READ, const bool create = false);
+    File open(const String &path, const char *mode = FILE_READ, const bool create = false)
+    {
+      return open(path.c_str(), mode, create);
+    }
+    bool exists(const char *);
+    bool exists(const String &path)
+    {
+      return exists(path.c_str());
+    }
+    bool remove(const char *);
+    bool remove(const String &path)
+    {
+      return remove(path.c_str());
+    }
+    bool rename(const char *, const char *);
+    bool rename(const String &from, const String &to)
+    {
+      return rename(from.c_str(), to.c_str());
+    }
+    bool mkdir(const char *);
+    bool mkdir(const String &path)
+    {
+      return mkdir(path.c_str());
+    }
+    bool rmdir(const char *);
+    bool rmdir(const String &path)
+    {
+      return rmdir(path.c_str());
+    }
+
+  protected:
+    FSImplPtr _impl;
+};
+
+} // namespace fs
+
+using fs::FS;
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+
+
+#endif // #if !defined(_host_fs_h_)
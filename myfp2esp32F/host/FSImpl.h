@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST FILE SYSTEM IMPLEMENTATION DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/FSImpl.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_fsimpl_h_)
+#define _host_fsimpl_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+#include "FS.h"
+
+
+// ----------------------------------------------------------------------
+// CLASSES
+// ----------------------------------------------------------------------
+// the interface a file system provides to fs::FS and fs::File
+namespace fs
+{
+
+class FileImpl
+{
+  public:
+    virtual ~FileImpl() {}
+    virtual size_t write(const uint8_t *, size_t) = 0;
+    virtual size_t read(uint8_t *, size_t) = 0;
+    virtual void flush() = 0;
+    virtual bool seek(uint32_t, SeekMode) = 0;
+    virtual size_t position() const = 0;
+    virtual size_t size() const = 0;
+    virtual bool setBufferSize(size_t) = 0;
+    virtual void close() = 0;
+    virtual time_t getLastWrite() = 0;
+    virtual const char *path() const = 0;
+    virtual const char *name() const = 0;
+    virtual boolean isDirectory(void) = 0;
+    virtual FileImplPtr openNextFile(const char *) = 0;
+    virtual void rewindDirectory(void) = 0;
+    virtual operator bool() = 0;
+};
+
+class FSImpl
+{
+  public:
+    virtual ~FSImpl() {}
+    virtual FileImplPtr open(const char *, const char *, const bool) = 0;
+    virtual bool exists(const char *) = 0;
+    virtual bool rename(const char *, const char *) = 0;
+    virtual bool remove(const char *) = 0;
+    virtual bool mkdir(const char *) = 0;
+    virtual bool rmdir(const char *) = 0;
+};
+
+} // namespace fs
+
+
+
+#endif // #if !defined(_host_fsimpl_h_)
@@ -0,0 +1,67 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST IP ADDRESS CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/IPAddress.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_ipaddress_h_)
+#define _host_ipaddress_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include "Arduino.h"
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// an IPv4 address, the uint32_t form is in network byte order as the
+// Arduino core
+class IPAddress
+{
+  public:
+    IPAddress(void);
+    IPAddress(uint8_t, uint8_t, uint8_t, uint8_t);
+    IPAddress(uint32_t);
+
+    bool fromString(const char *);
+    bool fromString(const String &address)
+    {
+      return fromString(address.c_str());
+    }
+    String toString(void) const;
+
+    operator uint32_t() const
+    {
+      return _address.dword;
+    }
+    bool operator==(const IPAddress &addr) const
+    {
+      return _address.dword == addr._address.dword;
+    }
+    bool operator!=(const IPAddress &addr) const
+    {
+      return _address.dword != addr._address.dword;
+    }
+    uint8_t operator[](int index) const
+    {
+      return _address.bytes[index];
+    }
+    uint8_t &operator[](int index)
+    {
+      return _address.bytes[index];
+    }
+
+  private:
+    union
+    {
+      uint8_t  bytes[4];
+      uint32_t dword;
+    } _address;
+};
+
+
+
+#endif // #if !defined(_host_ipaddress_h_)
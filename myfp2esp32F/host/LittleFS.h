@@ -0,0 +1,15 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST LITTLEFS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/LittleFS.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_littlefs_h_)
+#define _host_littlefs_h_
+
+// the host has no flash, LittleFS is the memory file system
+#include "file_system_memory.h"
+
+#define LittleFS            MemoryFS
+
+#endif // #if !defined(_host_littlefs_h_)
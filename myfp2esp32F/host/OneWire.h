@@ -0,0 +1,21 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST ONE WIRE
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/OneWire.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_onewire_h_)
+#define _host_onewire_h_
+
+#include "Arduino.h"
+
+// the bus of the temperature probe, nothing is connected on the host
+class OneWire
+{
+  public:
+    OneWire(void) {}
+    OneWire(uint8_t) {}
+    void begin(uint8_t) {}
+};
+
+#endif // #if !defined(_host_onewire_h_)
@@ -0,0 +1,13 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST SPI
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/SPI.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_spi_h_)
+#define _host_spi_h_
+
+// nothing on the host uses SPI, the header is included by the controller
+#include "Arduino.h"
+
+#endif // #if !defined(_host_spi_h_)
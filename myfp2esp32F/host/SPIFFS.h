@@ -0,0 +1,15 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST SPIFFS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/SPIFFS.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_spiffs_h_)
+#define _host_spiffs_h_
+
+// the host has no flash, SPIFFS is the memory file system
+#include "file_system_memory.h"
+
+#define SPIFFS            MemoryFS
+
+#endif // #if !defined(_host_spiffs_h_)
@@ -0,0 +1,123 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST PRINT AND STREAM CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/Stream.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_stream_h_)
+#define _host_stream_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "WString.h"
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define DEC               10
+#define HEX               16
+#define OCT               8
+#define BIN               2
+
+#define STREAM_TIMEOUT    1000            // ms, default of readString() and readBytes()
+
+
+// ----------------------------------------------------------------------
+// PRINT
+// ----------------------------------------------------------------------
+// the Arduino Print, a class only provides write()
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t *, size_t);
+    size_t write(const char *s)
+    {
+      return (s == NULL) ? 0 : write((const uint8_t *) s, strlen(s));
+    }
+    size_t write(const char *buf, size_t size)
+    {
+      return write((const uint8_t *) buf, size);
+    }
+    virtual void flush(void) {}
+
+    size_t print(const String &);
+    size_t print(const char *);
+    size_t print(char);
+    size_t print(unsigned char, int base = DEC);
+    size_t print(int, int base = DEC);
+    size_t print(unsigned int, int base = DEC);
+    size_t print(long, int base = DEC);
+    size_t print(unsigned long, int base = DEC);
+    size_t print(long long, int base = DEC);
+    size_t print(unsigned long long, int base = DEC);
+    size_t print(double, int digits = 2);
+
+    size_t println(void);
+    template<typename T>
+    size_t println(const T &value)
+    {
+      size_t n = print(value);
+      return n + println();
+    }
+    template<typename T>
+    size_t println(const T &value, int format)
+    {
+      size_t n = print(value, format);
+      return n + println();
+    }
+
+    size_t printf(const char *, ...) __attribute__ ((format (printf, 2, 3)));
+};
+
+
+// ----------------------------------------------------------------------
+// STREAM
+// ----------------------------------------------------------------------
+// a read waits up to the timeout for data, wait() is the host side of it
+class Stream : public Print
+{
+  public:
+    virtual int available(void) = 0;
+    virtual int read(void) = 0;
+    virtual int peek(void) = 0;
+
+    void setTimeout(unsigned long timeout)
+    {
+      _timeout = timeout;
+    }
+    unsigned long getTimeout(void)
+    {
+      return _timeout;
+    }
+
+    size_t readBytes(char *, size_t);
+    size_t readBytes(uint8_t *buf, size_t length)
+    {
+      return readBytes((char *) buf, length);
+    }
+    size_t readBytesUntil(char, char *, size_t);
+    String readString(void);
+    String readStringUntil(char);
+    long parseInt(void);
+
+  protected:
+    int timedRead(void);
+    virtual bool wait(unsigned long)      // ms, false if no more data can arrive
+    {
+      return false;
+    }
+
+    unsigned long _timeout = STREAM_TIMEOUT;
+};
+
+
+
+#endif // #if !defined(_host_stream_h_)
@@ -0,0 +1,177 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST TMC STEPPER
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/TMCStepper.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_tmcstepper_h_)
+#define _host_tmcstepper_h_
+
+#include "Arduino.h"
+
+// no driver answers on the host uart, a register reads as 0 and a write
+// is discarded
+class TMC2208Stepper
+{
+  public:
+    TMC2208Stepper(HardwareSerial *, float = 0.11f, uint8_t = 0) {}
+    void begin(void) {}
+    uint8_t test_connection(void)
+    {
+      return 1;
+    }
+    void pdn_disable(bool) {}
+    void mstep_reg_select(bool) {}
+    void I_scale_analog(bool) {}
+    void toff(uint8_t) {}
+    uint8_t toff(void)
+    {
+      return 0;
+    }
+    void tbl(uint8_t) {}
+    void blank_time(uint8_t) {}
+    void rms_current(uint16_t) {}
+    void rms_current(uint16_t, float) {}
+    uint16_t rms_current(void)
+    {
+      return 0;
+    }
+    void microsteps(uint16_t) {}
+    uint16_t microsteps(void)
+    {
+      return 0;
+    }
+    void hysteresis_end(int8_t) {}
+    void hysteresis_start(uint8_t) {}
+    void TPWMTHRS(uint32_t) {}
+    uint32_t TPWMTHRS(void)
+    {
+      return 0;
+    }
+    void en_spreadCycle(bool) {}
+    bool en_spreadCycle(void)
+    {
+      return false;
+    }
+    void pwm_autoscale(bool) {}
+    void pwm_autograd(bool) {}
+    void ihold(uint8_t) {}
+    uint8_t ihold(void)
+    {
+      return 0;
+    }
+    void irun(uint8_t) {}
+    uint8_t irun(void)
+    {
+      return 0;
+    }
+    void iholddelay(uint8_t) {}
+    void TPOWERDOWN(uint8_t) {}
+    uint16_t cs2rms(uint8_t)
+    {
+      return 0;
+    }
+    uint8_t cs_actual(void)
+    {
+      return 0;
+    }
+    uint32_t DRV_STATUS(void)
+    {
+      return 0;
+    }
+    bool ot(void)
+    {
+      return false;
+    }
+    bool otpw(void)
+    {
+      return false;
+    }
+    bool t120(void)
+    {
+      return false;
+    }
+    bool t143(void)
+    {
+      return false;
+    }
+    bool t150(void)
+    {
+      return false;
+    }
+    bool t157(void)
+    {
+      return false;
+    }
+    uint32_t TSTEP(void)
+    {
+      return 0;
+    }
+    void GSTAT(uint8_t) {}
+    uint8_t GSTAT(void)
+    {
+      return 0;
+    }
+    uint32_t IOIN(void)
+    {
+      return 0;
+    }
+    uint8_t IFCNT(void)
+    {
+      return 0;
+    }
+    void GCONF(uint32_t) {}
+    uint32_t GCONF(void)
+    {
+      return 0;
+    }
+    void CHOPCONF(uint32_t) {}
+    uint32_t CHOPCONF(void)
+    {
+      return 0;
+    }
+    void IHOLD_IRUN(uint32_t) {}
+    uint32_t IHOLD_IRUN(void)
+    {
+      return 0;
+    }
+    void PWMCONF(uint32_t) {}
+    uint32_t PWMCONF(void)
+    {
+      return 0;
+    }
+    void mres(uint8_t) {}
+    uint8_t CRCerror = 0;
+};
+
+class TMC2209Stepper : public TMC2208Stepper
+{
+  public:
+    TMC2209Stepper(HardwareSerial *serial, float rsense, uint8_t address) : TMC2208Stepper(serial, rsense, address) {}
+    void SGTHRS(uint8_t) {}
+    uint8_t SGTHRS(void)
+    {
+      return 0;
+    }
+    uint16_t SG_RESULT(void)
+    {
+      return 0;
+    }
+    void TCOOLTHRS(uint32_t) {}
+    uint32_t TCOOLTHRS(void)
+    {
+      return 0;
+    }
+    void semin(uint8_t) {}
+    void semax(uint8_t) {}
+    void sedn(uint8_t) {}
+    void seup(uint8_t) {}
+    void seimin(bool) {}
+    void COOLCONF(uint16_t) {}
+    uint32_t COOLCONF(void)
+    {
+      return 0;
+    }
+};
+
+#endif // #if !defined(_host_tmcstepper_h_)
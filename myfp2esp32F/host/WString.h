@@ -0,0 +1,200 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST STRING CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/WString.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_wstring_h_)
+#define _host_wstring_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <type_traits>
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// The Arduino String, held in a std::string. Numbers are converted as the
+// Arduino core does, a char is a character and a byte is a number.
+class String
+{
+  public:
+    String(void) {}
+    String(const char *);
+    String(const String &) = default;
+    String(const std::string &s) : _s(s) {}
+    explicit String(char);
+    explicit String(unsigned char, unsigned char base = 10);
+    explicit String(int, unsigned char base = 10);
+    explicit String(unsigned int, unsigned char base = 10);
+    explicit String(long, unsigned char base = 10);
+    explicit String(unsigned long, unsigned char base = 10);
+    explicit String(long long, unsigned char base = 10);
+    explicit String(unsigned long long, unsigned char base = 10);
+    explicit String(float, unsigned int decimalPlaces = 2);
+    explicit String(double, unsigned int decimalPlaces = 2);
+
+    String &operator=(const String &) = default;
+    String &operator=(const char *);
+
+    // as the Arduino String, a string tests true in an if [even if empty]
+    typedef void (String::*StringIfHelperType)() const;
+    void StringIfHelper() const {}
+    operator StringIfHelperType() const
+    {
+      return &String::StringIfHelper;
+    }
+
+    unsigned int length(void) const
+    {
+      return _s.size();
+    }
+    const char *c_str(void) const
+    {
+      return _s.c_str();
+    }
+    bool isEmpty(void) const
+    {
+      return _s.empty();
+    }
+    bool reserve(unsigned int size)
+    {
+      _s.reserve(size);
+      return true;
+    }
+
+    // concatenate, a number is added as its decimal text
+    bool concat(const String &s)
+    {
+      _s += s._s;
+      return true;
+    }
+    bool concat(const char *);
+    bool concat(const char *, unsigned int);
+    bool concat(char c)
+    {
+      _s += c;
+      return true;
+    }
+    template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+    bool concat(T n)
+    {
+      return concat(String(n));
+    }
+    template<typename T>
+    String &operator+=(const T &rhs)
+    {
+      concat(rhs);
+      return *this;
+    }
+
+    int  compareTo(const String &) const;
+    bool equals(const String &s) const
+    {
+      return _s == s._s;
+    }
+    bool equals(const char *) const;
+    bool equalsIgnoreCase(const String &) const;
+    bool operator==(const String &s) const
+    {
+      return equals(s);
+    }
+    bool operator==(const char *s) const
+    {
+      return equals(s);
+    }
+    bool operator!=(const String &s) const
+    {
+      return !equals(s);
+    }
+    bool operator!=(const char *s) const
+    {
+      return !equals(s);
+    }
+    bool operator<(const String &s) const
+    {
+      return compareTo(s) < 0;
+    }
+    bool operator>(const String &s) const
+    {
+      return compareTo(s) > 0;
+    }
+    bool startsWith(const String &) const;
+    bool startsWith(const String &, unsigned int) const;
+    bool endsWith(const String &) const;
+
+    char charAt(unsigned int) const;
+    void setCharAt(unsigned int, char);
+    char operator[](unsigned int index) const
+    {
+      return charAt(index);
+    }
+    char &operator[](unsigned int);
+    void getBytes(unsigned char *, unsigned int, unsigned int index = 0) const;
+    void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const
+    {
+      getBytes((unsigned char *) buf, bufsize, index);
+    }
+
+    int indexOf(char, unsigned int from = 0) const;
+    int indexOf(const String &, unsigned int from = 0) const;
+    int lastIndexOf(char) const;
+    int lastIndexOf(char, unsigned int) const;
+    int lastIndexOf(const String &) const;
+    String substring(unsigned int) const;
+    String substring(unsigned int, unsigned int) const;
+
+    void replace(char, char);
+    void replace(const String &, const String &);
+    void remove(unsigned int);
+    void remove(unsigned int, unsigned int);
+    void toLowerCase(void);
+    void toUpperCase(void);
+    void trim(void);
+
+    long   toInt(void) const;
+    float  toFloat(void) const;
+    double toDouble(void) const;
+
+  private:
+    std::string _s;
+};
+
+// ----------------------------------------------------------------------
+// CONCATENATION
+// ----------------------------------------------------------------------
+String operator+(const String &, const String &);
+String operator+(const String &, const char *);
+String operator+(const char *, const String &);
+
+template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+String operator+(const String &lhs, T rhs)
+{
+  return lhs + String(rhs);
+}
+
+template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+String operator+(T lhs, const String &rhs)
+{
+  return String(lhs) + rhs;
+}
+
+inline bool operator==(const char *lhs, const String &rhs)
+{
+  return rhs.equals(lhs);
+}
+
+inline bool operator!=(const char *lhs, const String &rhs)
+{
+  return !rhs.equals(lhs);
+}
+
+
+
+#endif // #if !defined(_host_wstring_h_)
@@ -0,0 +1,180 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST WEB SERVER CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/WebServer.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_webserver_h_)
+#define _host_webserver_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <functional>
+#include <vector>
+#include "Arduino.h"
+#include "FS.h"
+#include "WiFi.h"
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+
+#define HTTP_UPLOAD_BUFLEN      1436
+#define HTTP_MAX_DATA_WAIT      5000      // ms to wait for the request
+#define CONTENT_LENGTH_UNKNOWN  ((size_t) -1)
+#define CONTENT_LENGTH_NOT_SET  ((size_t) -2)
+
+typedef struct
+{
+  HTTPUploadStatus status;
+  String  filename;
+  String  name;
+  String  type;
+  size_t  totalSize;
+  size_t  currentSize;
+  uint8_t buf[HTTP_UPLOAD_BUFLEN];
+} HTTPUpload;
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// The calls of the Arduino ESP32 WebServer used by the controller. One
+// request is read and handled for each connection, then the connection
+// is closed. Query, form and multipart arguments are parsed, a body of
+// another type is the argument "plain".
+class WebServer
+{
+  public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    WebServer(int port = 80) : _server(port) {}
+    void begin(void)
+    {
+      _server.begin();
+    }
+    void begin(uint16_t port)
+    {
+      _server.begin(port);
+    }
+    void stop(void);
+    void close(void)
+    {
+      stop();
+    }
+    void handleClient(void);
+
+    void on(const String &, THandlerFunction);
+    void on(const String &, HTTPMethod, THandlerFunction);
+    void on(const String &, HTTPMethod, THandlerFunction, THandlerFunction);
+    void onNotFound(THandlerFunction fn)
+    {
+      _notfound = fn;
+    }
+
+    String uri(void)
+    {
+      return _uri;
+    }
+    HTTPMethod method(void)
+    {
+      return _method;
+    }
+    WiFiClient client(void)
+    {
+      return _client;
+    }
+    HTTPUpload &upload(void)
+    {
+      return _upload;
+    }
+
+    String arg(const String &);
+    String arg(int);
+    String argName(int);
+    int  args(void)
+    {
+      return _args.size();
+    }
+    bool hasArg(const String &);
+    String header(const String &);
+    bool hasHeader(const String &);
+    String hostHeader(void)
+    {
+      return header("Host");
+    }
+    void collectHeaders(const char **, size_t) {}    // all headers are kept
+
+    bool authenticate(const char *, const char *);
+    void requestAuthentication(void);
+
+    void enableCORS(bool enable = true)
+    {
+      _cors = enable;
+    }
+    void setContentLength(const size_t length)
+    {
+      _contentlength = length;
+    }
+    void sendHeader(const String &, const String &, bool first = false);
+    void send(int, const char *content_type = NULL, const String &content = String());
+    void send(int code, const String &content_type, const String &content)
+    {
+      send(code, content_type.c_str(), content);
+    }
+    void send(int code, const char *content_type, const char *content)
+    {
+      send(code, content_type, String(content));
+    }
+    void send_P(int code, const char *content_type, const char *content)
+    {
+      send(code, content_type, String(content));
+    }
+    void sendContent(const String &);
+    void sendContent(const char *content, size_t size);
+    size_t streamFile(File &, const String &);
+
+  private:
+    struct route
+    {
+      String uri;
+      HTTPMethod method;
+      THandlerFunction fn;
+      THandlerFunction upload;
+    };
+    struct param
+    {
+      String key;
+      String value;
+    };
+
+    bool read_request(void);
+    void parse_args(const String &);
+    void parse_multipart(const String &, const String &, route *);
+    void send_header(int, const char *, size_t);
+    void finish(void);
+
+    WiFiServer _server;
+    WiFiClient _client;
+    std::vector<route> _routes;
+    THandlerFunction _notfound;
+    String     _uri;
+    HTTPMethod _method = HTTP_ANY;
+    std::vector<param> _args;
+    std::vector<param> _headers;          // request
+    String     _body;                     // request
+    String     _response;                 // headers added by sendHeader()
+    size_t     _contentlength = CONTENT_LENGTH_NOT_SET;
+    bool       _sent = false;
+    bool       _cors = false;
+    HTTPUpload _upload;
+};
+
+
+
+#endif // #if !defined(_host_webserver_h_)
@@ -0,0 +1,105 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST WIFI CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/WiFi.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_wifi_h_)
+#define _host_wifi_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+#include "WiFiServer.h"
+#include "WiFiUdp.h"
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+typedef enum
+{
+  WL_NO_SHIELD       = 255,
+  WL_IDLE_STATUS     = 0,
+  WL_NO_SSID_AVAIL   = 1,
+  WL_SCAN_COMPLETED  = 2,
+  WL_CONNECTED       = 3,
+  WL_CONNECT_FAILED  = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED    = 6
+} wl_status_t;
+
+typedef enum
+{
+  WIFI_OFF,
+  WIFI_STA,
+  WIFI_AP,
+  WIFI_AP_STA
+} wifi_mode_t;
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// The host is always connected, in station and access point mode the
+// controller is at the loopback address and the servers listen on all
+// interfaces of the host.
+class WiFiClass
+{
+  public:
+    bool mode(wifi_mode_t);
+    wifi_mode_t getMode(void)
+    {
+      return _mode;
+    }
+    wl_status_t begin(const char *, const char *passphrase = NULL);
+    bool config(IPAddress, IPAddress, IPAddress, IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress());
+    bool disconnect(bool wifioff = false, bool eraseap = false);
+    bool reconnect(void);
+    wl_status_t status(void)
+    {
+      return _status;
+    }
+    bool softAP(const char *, const char *passphrase = NULL, int channel = 1, int hidden = 0, int maxconnection = 4);
+    bool softAPConfig(IPAddress, IPAddress, IPAddress);
+    IPAddress softAPIP(void);
+    IPAddress localIP(void);
+    IPAddress gatewayIP(void);
+    IPAddress subnetMask(void);
+    int32_t RSSI(void);
+    String SSID(void)
+    {
+      return _ssid;
+    }
+    String macAddress(void);
+    bool setHostname(const char *);
+    const char *getHostname(void)
+    {
+      return _hostname.c_str();
+    }
+    bool setSleep(bool)
+    {
+      return true;
+    }
+    bool setAutoReconnect(bool)
+    {
+      return true;
+    }
+    void persistent(bool) {}
+
+  private:
+    wifi_mode_t _mode = WIFI_OFF;
+    wl_status_t _status = WL_DISCONNECTED;
+    String _ssid;
+    String _hostname = "myfp2esp32";
+};
+
+extern WiFiClass WiFi;
+
+
+
+#endif // #if !defined(_host_wifi_h_)
@@ -0,0 +1,62 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST WIFI CLIENT CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/WiFiClient.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_wificlient_h_)
+#define _host_wificlient_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <memory>
+#include "Arduino.h"
+#include "IPAddress.h"
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// A tcp connection on a POSIX socket. Copies share the socket, which is
+// closed when the last copy is stopped or destroyed, as the Arduino core.
+struct host_socket;
+
+class WiFiClient : public Stream
+{
+  public:
+    WiFiClient(void) {}
+    WiFiClient(int);                      // connected socket
+
+    int connect(IPAddress, uint16_t);
+    int connect(const char *, uint16_t);
+    size_t write(uint8_t);
+    size_t write(const uint8_t *, size_t);
+    using Print::write;
+    int available(void);
+    int read(void);
+    int read(uint8_t *, size_t);
+    int peek(void);
+    void flush(void) {}
+    void stop(void);
+    uint8_t connected(void);
+    operator bool()
+    {
+      return connected() != 0;
+    }
+    IPAddress remoteIP(void) const;
+    uint16_t remotePort(void) const;
+    int setNoDelay(bool);
+    int fd(void) const;
+
+  protected:
+    bool wait(unsigned long);
+
+  private:
+    std::shared_ptr<host_socket> _sock;
+};
+
+
+
+#endif // #if !defined(_host_wificlient_h_)
@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST WIFI SERVER CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/WiFiServer.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_wifiserver_h_)
+#define _host_wifiserver_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// a non blocking tcp listener on all interfaces
+class WiFiServer
+{
+  public:
+    WiFiServer(uint16_t port = 80) : _port(port) {}
+    ~WiFiServer()
+    {
+      end();
+    }
+    void begin(uint16_t port = 0);
+    WiFiClient available(void);           // a new connection, or a client which is not connected
+    WiFiClient accept(void)
+    {
+      return available();
+    }
+    bool hasClient(void);
+    void setNoDelay(bool nodelay)
+    {
+      _nodelay = nodelay;
+    }
+    void end(void);
+    void stop(void)
+    {
+      end();
+    }
+    void close(void)
+    {
+      end();
+    }
+    operator bool()
+    {
+      return _fd >= 0;
+    }
+
+  private:
+    uint16_t _port;
+    int      _fd = -1;
+    bool     _nodelay = false;
+};
+
+
+
+#endif // #if !defined(_host_wifiserver_h_)
@@ -0,0 +1,69 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST WIFI UDP CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/WiFiUdp.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_wifiudp_h_)
+#define _host_wifiudp_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <vector>
+#include "Arduino.h"
+#include "IPAddress.h"
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// udp on a POSIX socket, a packet is read whole by parsePacket() and a
+// reply is sent by endPacket()
+class WiFiUDP : public Stream
+{
+  public:
+    ~WiFiUDP()
+    {
+      stop();
+    }
+    uint8_t begin(uint16_t);
+    void stop(void);
+    int parsePacket(void);
+    int available(void);
+    int read(void);
+    int read(unsigned char *, size_t);
+    int read(char *buf, size_t len)
+    {
+      return read((unsigned char *) buf, len);
+    }
+    int peek(void);
+    IPAddress remoteIP(void)
+    {
+      return _remoteip;
+    }
+    uint16_t remotePort(void)
+    {
+      return _remoteport;
+    }
+    int beginPacket(IPAddress, uint16_t);
+    int endPacket(void);
+    size_t write(uint8_t);
+    size_t write(const uint8_t *, size_t);
+    using Print::write;
+
+  private:
+    int       _fd = -1;
+    IPAddress _remoteip;
+    uint16_t  _remoteport = 0;
+    IPAddress _sendip;
+    uint16_t  _sendport = 0;
+    std::vector<uint8_t> _rx;
+    size_t    _rxpos = 0;
+    std::vector<uint8_t> _tx;
+};
+
+
+
+#endif // #if !defined(_host_wifiudp_h_)
@@ -0,0 +1,54 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST I2C
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/Wire.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_wire_h_)
+#define _host_wire_h_
+
+#include "Arduino.h"
+
+// the host has no I2C devices, every address is a NACK
+class TwoWire
+{
+  public:
+    bool begin(void)
+    {
+      return true;
+    }
+    bool begin(int, int, uint32_t = 0)
+    {
+      return true;
+    }
+    void setClock(uint32_t) {}
+    void beginTransmission(int) {}
+    uint8_t endTransmission(bool = true)
+    {
+      return 2;
+    }
+    size_t write(uint8_t)
+    {
+      return 1;
+    }
+    size_t write(const uint8_t *, size_t size)
+    {
+      return size;
+    }
+    uint8_t requestFrom(int, int)
+    {
+      return 0;
+    }
+    int available(void)
+    {
+      return 0;
+    }
+    int read(void)
+    {
+      return -1;
+    }
+};
+
+extern TwoWire Wire;
+
+#endif // #if !defined(_host_wire_h_)
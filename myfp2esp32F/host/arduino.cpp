@@ -0,0 +1,292 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST ARDUINO CORE
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/arduino.cpp
+// Arduino ESP32 core calls for host builds
+// ----------------------------------------------------------------------
+
+#if !defined(ARDUINO)
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <time.h>
+#include <deque>
+#include <vector>
+#include "Arduino.h"
+#include "Wire.h"
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define HOST_CPUMHZ       240             // nominal ESP32 clock
+#define HOST_HEAP         327680          // reported heap, the host has no fixed heap
+
+
+// ----------------------------------------------------------------------
+// MISC
+// ----------------------------------------------------------------------
+long random(long howbig)
+{
+  return (howbig <= 0) ? 0 : (rand() % howbig);
+}
+
+long random(long howsmall, long howbig)
+{
+  return (howsmall >= howbig) ? howsmall : (howsmall + random(howbig - howsmall));
+}
+
+void randomSeed(unsigned long seed)
+{
+  srand(seed);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  return (in_max == in_min) ? out_min : ((x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min);
+}
+
+char *ltoa(long value, char *buf, int base)
+{
+  strcpy(buf, String(value, (unsigned char) base).c_str());
+  return buf;
+}
+
+char *itoa(int value, char *buf, int base)
+{
+  return ltoa(value, buf, base);
+}
+
+char *utoa(unsigned int value, char *buf, int base)
+{
+  strcpy(buf, String(value, (unsigned char) base).c_str());
+  return buf;
+}
+
+#if defined(__GLIBC__) && ((__GLIBC__ < 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ < 38)))
+size_t strlcpy(char *dst, const char *src, size_t size)
+{
+  size_t len = strlen(src);
+  if ( size != 0 )
+  {
+    size_t n = (len < size) ? len : (size - 1);
+    memcpy(dst, src, n);
+    dst[n] = 0;
+  }
+  return len;
+}
+#endif
+
+
+// ----------------------------------------------------------------------
+// ESP
+// ----------------------------------------------------------------------
+EspClass ESP;
+
+static uint32_t host_mhz = HOST_CPUMHZ;
+
+uint32_t EspClass::getCpuFreqMHz(void)
+{
+  return host_mhz;
+}
+
+uint32_t EspClass::getCycleCount(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t ns = ((uint64_t) ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+  return (uint32_t) ((ns * host_mhz) / 1000);
+}
+
+uint32_t EspClass::getFreeHeap(void)
+{
+  return HOST_HEAP;
+}
+
+uint32_t EspClass::getHeapSize(void)
+{
+  return HOST_HEAP;
+}
+
+uint32_t EspClass::getMinFreeHeap(void)
+{
+  return HOST_HEAP;
+}
+
+uint32_t EspClass::getMaxAllocHeap(void)
+{
+  return HOST_HEAP;
+}
+
+// a host process cannot reboot, it ends and can be started again
+void EspClass::restart(void)
+{
+  Serial.flush();
+  printf("restart\n");
+  exit(0);
+}
+
+bool setCpuFrequencyMhz(uint32_t mhz)
+{
+  host_mhz = mhz;
+  return true;
+}
+
+uint32_t getCpuFrequencyMhz(void)
+{
+  return host_mhz;
+}
+
+
+// ----------------------------------------------------------------------
+// FREERTOS
+// ----------------------------------------------------------------------
+// no scheduler, a task is not created and the caller carries on without it
+BaseType_t xTaskCreatePinnedToCore(void (*)(void *), const char *name, uint32_t, void *, UBaseType_t, TaskHandle_t *task, BaseType_t)
+{
+  printf("host: task %s not created\n", name);
+  if ( task != NULL )
+  {
+    *task = NULL;
+  }
+  return pdFAIL;
+}
+
+void vTaskDelete(TaskHandle_t)
+{
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+  delay(ticks * portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+  return millis() / portTICK_PERIOD_MS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t)
+{
+  return 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t)
+{
+  return pdPASS;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t, uint32_t, eNotifyAction)
+{
+  return pdPASS;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t, uint32_t, uint32_t *bits, TickType_t)
+{
+  if ( bits != NULL )
+  {
+    *bits = 0;
+  }
+  return pdFALSE;
+}
+
+// a queue is a list of fixed size items
+struct host_queue
+{
+  size_t length;
+  size_t itemsize;
+  std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemsize)
+{
+  host_queue *q = new host_queue;
+  q->length = length;
+  q->itemsize = itemsize;
+  return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t)
+{
+  host_queue *q = (host_queue *) queue;
+  if ( (q == NULL) || (q->items.size() >= q->length) )
+  {
+    return pdFALSE;
+  }
+  const uint8_t *p = (const uint8_t *) item;
+  q->items.push_back(std::vector<uint8_t>(p, p + q->itemsize));
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t)
+{
+  host_queue *q = (host_queue *) queue;
+  if ( (q == NULL) || q->items.empty() )
+  {
+    return pdFALSE;
+  }
+  memcpy(item, q->items.front().data(), q->itemsize);
+  q->items.pop_front();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+  host_queue *q = (host_queue *) queue;
+  return (q == NULL) ? 0 : q->items.size();
+}
+
+// one thread, a mutex is always free
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+  static int mutex;
+  return &mutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t)
+{
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t)
+{
+  return pdTRUE;
+}
+
+
+// ----------------------------------------------------------------------
+// SERIAL, I2C
+// ----------------------------------------------------------------------
+HardwareSerial Serial(stdout);
+HardwareSerial Serial2(NULL);
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  if ( _out != NULL )
+  {
+    fputc(c, _out);
+  }
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t size)
+{
+  if ( _out != NULL )
+  {
+    fwrite(buf, 1, size, _out);
+  }
+  return size;
+}
+
+void HardwareSerial::flush(void)
+{
+  if ( _out != NULL )
+  {
+    fflush(_out);
+  }
+}
+
+TwoWire Wire;
+
+#endif // #if !defined(ARDUINO)
@@ -0,0 +1,13 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST CPU
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/esp32-hal-cpu.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_esp32_hal_cpu_h_)
+#define _host_esp32_hal_cpu_h_
+
+// setCpuFrequencyMhz() and getCpuFrequencyMhz() are in Arduino.h
+#include "Arduino.h"
+
+#endif // #if !defined(_host_esp32_hal_cpu_h_)
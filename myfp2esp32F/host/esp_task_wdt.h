@@ -0,0 +1,33 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST TASK WATCHDOG
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/esp_task_wdt.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_esp_task_wdt_h_)
+#define _host_esp_task_wdt_h_
+
+#include "Arduino.h"
+
+// no watchdog on the host
+typedef int esp_err_t;
+#define ESP_OK            0
+
+inline esp_err_t esp_task_wdt_init(uint32_t, bool)
+{
+  return ESP_OK;
+}
+inline esp_err_t esp_task_wdt_add(TaskHandle_t)
+{
+  return ESP_OK;
+}
+inline esp_err_t esp_task_wdt_delete(TaskHandle_t)
+{
+  return ESP_OK;
+}
+inline esp_err_t esp_task_wdt_reset(void)
+{
+  return ESP_OK;
+}
+
+#endif // #if !defined(_host_esp_task_wdt_h_)
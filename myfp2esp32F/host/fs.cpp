@@ -0,0 +1,173 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST FILE SYSTEM
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/fs.cpp
+// fs::FS and fs::File for host builds
+// ----------------------------------------------------------------------
+
+#if !defined(ARDUINO)
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include "FS.h"
+#include "FSImpl.h"
+
+using namespace fs;
+
+
+// ----------------------------------------------------------------------
+// FILE
+// ----------------------------------------------------------------------
+size_t File::write(uint8_t c)
+{
+  return (_p) ? _p->write(&c, 1) : 0;
+}
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+  return (_p) ? _p->write(buf, size) : 0;
+}
+
+int File::available(void)
+{
+  return (_p) ? (int) (_p->size() - _p->position()) : 0;
+}
+
+int File::read(void)
+{
+  uint8_t c;
+  return ((_p) && (_p->read(&c, 1) == 1)) ? c : -1;
+}
+
+size_t File::read(uint8_t *buf, size_t size)
+{
+  return (_p) ? _p->read(buf, size) : 0;
+}
+
+int File::peek(void)
+{
+  if ( !_p )
+  {
+    return -1;
+  }
+  size_t pos = _p->position();
+  int c = read();
+  _p->seek(pos, SeekSet);
+  return c;
+}
+
+void File::flush(void)
+{
+  if ( _p )
+  {
+    _p->flush();
+  }
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+  return (_p) ? _p->seek(pos, mode) : false;
+}
+
+size_t File::position(void) const
+{
+  return (_p) ? _p->position() : 0;
+}
+
+size_t File::size(void) const
+{
+  return (_p) ? _p->size() : 0;
+}
+
+bool File::setBufferSize(size_t size)
+{
+  return (_p) ? _p->setBufferSize(size) : false;
+}
+
+void File::close(void)
+{
+  if ( _p )
+  {
+    _p->close();
+    _p = NULL;
+  }
+}
+
+File::operator bool() const
+{
+  return (_p) && (*_p);
+}
+
+time_t File::getLastWrite(void)
+{
+  return (_p) ? _p->getLastWrite() : 0;
+}
+
+const char *File::path(void) const
+{
+  return (_p) ? _p->path() : NULL;
+}
+
+const char *File::name(void) const
+{
+  return (_p) ? _p->name() : NULL;
+}
+
+bool File::isDirectory(void)
+{
+  return (_p) ? _p->isDirectory() : false;
+}
+
+File File::openNextFile(const char *mode)
+{
+  return (_p) ? File(_p->openNextFile(mode)) : File();
+}
+
+void File::rewindDirectory(void)
+{
+  if ( _p )
+  {
+    _p->rewindDirectory();
+  }
+}
+
+
+// ----------------------------------------------------------------------
+// FILE SYSTEM
+// ----------------------------------------------------------------------
+File FS::open(const char *path, const char *mode, const bool create)
+{
+  if ( !_impl || (path == NULL) || (path[0] != '/') )
+  {
+    return File();
+  }
+  return File(_impl->open(path, mode, create));
+}
+
+bool FS::exists(const char *path)
+{
+  return (_impl) && (path != NULL) && _impl->exists(path);
+}
+
+bool FS::remove(const char *path)
+{
+  return (_impl) && (path != NULL) && _impl->remove(path);
+}
+
+bool FS::rename(const char *from, const char *to)
+{
+  return (_impl) && (from != NULL) && (to != NULL) && _impl->rename(from, to);
+}
+
+bool FS::mkdir(const char *path)
+{
+  return (_impl) && (path != NULL) && _impl->mkdir(path);
+}
+
+bool FS::rmdir(const char *path)
+{
+  return (_impl) && (path != NULL) && _impl->rmdir(path);
+}
+
+#endif // #if !defined(ARDUINO)
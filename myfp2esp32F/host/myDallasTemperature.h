@@ -0,0 +1,55 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST DALLAS TEMPERATURE
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/myDallasTemperature.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_mydallastemperature_h_)
+#define _host_mydallastemperature_h_
+
+#include "OneWire.h"
+
+typedef uint8_t DeviceAddress[8];
+
+#define DEVICE_DISCONNECTED_C   -127
+
+// no probe is found on the host, the controller runs without one
+class DallasTemperature
+{
+  public:
+    DallasTemperature(OneWire *) {}
+    void begin(void) {}
+    uint8_t getDeviceCount(void)
+    {
+      return 0;
+    }
+    bool getAddress(uint8_t *, uint8_t)
+    {
+      return false;
+    }
+    bool setResolution(const uint8_t *, uint8_t, bool = false)
+    {
+      return false;
+    }
+    void setResolution(uint8_t) {}
+    void setWaitForConversion(bool) {}
+    void requestTemperatures(void) {}
+    bool requestTemperaturesByAddress(const uint8_t *)
+    {
+      return false;
+    }
+    bool isConversionComplete(void)
+    {
+      return true;
+    }
+    float getTempC(const uint8_t *)
+    {
+      return DEVICE_DISCONNECTED_C;
+    }
+    float getTempCByIndex(uint8_t)
+    {
+      return DEVICE_DISCONNECTED_C;
+    }
+};
+
+#endif // #if !defined(_host_mydallastemperature_h_)
@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST HALF STEPPER
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/myHalfStepperESP32.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_myhalfstepperesp32_h_)
+#define _host_myhalfstepperesp32_h_
+
+#include "Arduino.h"
+
+enum class SteppingMode { FULL, HALF };
+
+// the coil sequence of the unipolar and L298/L293/L9110 boards is not
+// modelled, step() only counts
+class Stepper
+{
+  public:
+    Stepper(int, int, int, int, int) {}
+    void setSpeed(long) {}
+    void step(int n)
+    {
+      _steps += n;
+    }
+    long steps(void)
+    {
+      return _steps;
+    }
+  private:
+    long _steps = 0;
+};
+
+class HalfStepper : public Stepper
+{
+  public:
+    HalfStepper(int n, int p1, int p2, int p3, int p4) : Stepper(n, p1, p2, p3, p4) {}
+    void SetSteppingMode(SteppingMode) {}
+};
+
+#endif // #if !defined(_host_myhalfstepperesp32_h_)
@@ -0,0 +1,28 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST ROM CRC
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/rom/crc.h
+// ----------------------------------------------------------------------
+
+#if !defined(_host_rom_crc_h_)
+#define _host_rom_crc_h_
+
+#include <stdint.h>
+
+// crc32_le() of the ESP32 rom, CRC-32 (0xEDB88320) with the crc inverted
+// on entry and on exit, so the crc of a block can be continued
+inline uint32_t crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+  crc = ~crc;
+  while ( len-- )
+  {
+    crc ^= *buf++;
+    for (int i = 0; i < 8; i++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+#endif // #if !defined(_host_rom_crc_h_)
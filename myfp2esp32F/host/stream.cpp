@@ -0,0 +1,209 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST PRINT AND STREAM CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/stream.cpp
+// Print and Stream for host builds
+// ----------------------------------------------------------------------
+
+#if !defined(ARDUINO)
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include "Stream.h"
+
+
+// ----------------------------------------------------------------------
+// PRINT
+// ----------------------------------------------------------------------
+size_t Print::write(const uint8_t *buf, size_t size)
+{
+  size_t n = 0;
+  while ( (n < size) && (write(buf[n]) == 1) )
+  {
+    n++;
+  }
+  return n;
+}
+
+size_t Print::print(const String &s)
+{
+  return write((const uint8_t *) s.c_str(), s.length());
+}
+
+size_t Print::print(const char *s)
+{
+  return write(s);
+}
+
+size_t Print::print(char c)
+{
+  return write((uint8_t) c);
+}
+
+size_t Print::print(unsigned char value, int base)
+{
+  return print(String(value, base));
+}
+
+size_t Print::print(int value, int base)
+{
+  return print(String(value, base));
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+  return print(String(value, base));
+}
+
+size_t Print::print(long value, int base)
+{
+  return print(String(value, base));
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+  return print(String(value, base));
+}
+
+size_t Print::print(long long value, int base)
+{
+  return print(String(value, base));
+}
+
+size_t Print::print(unsigned long long value, int base)
+{
+  return print(String(value, base));
+}
+
+size_t Print::print(double value, int digits)
+{
+  return print(String(value, digits));
+}
+
+size_t Print::println(void)
+{
+  return write("\r\n");
+}
+
+size_t Print::printf(const char *format, ...)
+{
+  char buf[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  if ( len < 0 )
+  {
+    return 0;
+  }
+  if ( (size_t) len < sizeof(buf) )
+  {
+    return write((const uint8_t *) buf, len);
+  }
+  char *big = new char[len + 1];
+  va_start(args, format);
+  vsnprintf(big, len + 1, format, args);
+  va_end(args);
+  size_t n = write((const uint8_t *) big, len);
+  delete[] big;
+  return n;
+}
+
+
+// ----------------------------------------------------------------------
+// STREAM
+// ----------------------------------------------------------------------
+int Stream::timedRead(void)
+{
+  int c = read();
+  while ( (c < 0) && (wait(_timeout) == true) )
+  {
+    c = read();
+  }
+  return c;
+}
+
+size_t Stream::readBytes(char *buf, size_t length)
+{
+  size_t n = 0;
+  while ( n < length )
+  {
+    int c = timedRead();
+    if ( c < 0 )
+    {
+      break;
+    }
+    buf[n++] = (char) c;
+  }
+  return n;
+}
+
+size_t Stream::readBytesUntil(char terminator, char *buf, size_t length)
+{
+  size_t n = 0;
+  while ( n < length )
+  {
+    int c = timedRead();
+    if ( (c < 0) || (c == terminator) )
+    {
+      break;
+    }
+    buf[n++] = (char) c;
+  }
+  return n;
+}
+
+String Stream::readString(void)
+{
+  String s;
+  int c = timedRead();
+  while ( c >= 0 )
+  {
+    s += (char) c;
+    c = timedRead();
+  }
+  return s;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+  String s;
+  int c = timedRead();
+  while ( (c >= 0) && (c != terminator) )
+  {
+    s += (char) c;
+    c = timedRead();
+  }
+  return s;
+}
+
+long Stream::parseInt(void)
+{
+  int c = timedRead();
+  while ( (c >= 0) && (c != '-') && !isdigit(c) )
+  {
+    c = timedRead();
+  }
+  bool negative = (c == '-');
+  long value = 0;
+  if ( negative == true )
+  {
+    c = timedRead();
+  }
+  while ( (c >= 0) && isdigit(c) )
+  {
+    value = (value * 10) + (c - '0');
+    if ( !isdigit(peek()) )
+    {
+      break;
+    }
+    c = timedRead();
+  }
+  return (negative == true) ? -value : value;
+}
+
+#endif // #if !defined(ARDUINO)
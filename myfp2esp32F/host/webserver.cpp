@@ -0,0 +1,509 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST WEB SERVER
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/webserver.cpp
+// The Arduino ESP32 WebServer calls for host builds
+// ----------------------------------------------------------------------
+
+#if !defined(ARDUINO)
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include "WebServer.h"
+
+
+// ----------------------------------------------------------------------
+// SUPPORT
+// ----------------------------------------------------------------------
+static const char *http_reason(int code)
+{
+  switch ( code )
+  {
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 500: return "Internal Server Error";
+    default:  return "";
+  }
+}
+
+static HTTPMethod http_method(const String &m)
+{
+  if ( m == "GET" )     return HTTP_GET;
+  if ( m == "HEAD" )    return HTTP_HEAD;
+  if ( m == "POST" )    return HTTP_POST;
+  if ( m == "PUT" )     return HTTP_PUT;
+  if ( m == "PATCH" )   return HTTP_PATCH;
+  if ( m == "DELETE" )  return HTTP_DELETE;
+  if ( m == "OPTIONS" ) return HTTP_OPTIONS;
+  return HTTP_ANY;
+}
+
+static int http_hex(char c)
+{
+  if ( (c >= '0') && (c <= '9') ) return c - '0';
+  if ( (c >= 'a') && (c <= 'f') ) return c - 'a' + 10;
+  if ( (c >= 'A') && (c <= 'F') ) return c - 'A' + 10;
+  return -1;
+}
+
+// + is a space, %xx a byte
+static String http_urldecode(const String &s)
+{
+  String out;
+  out.reserve(s.length());
+  for (unsigned int i = 0; i < s.length(); i++)
+  {
+    char c = s[i];
+    if ( c == '+' )
+    {
+      out += ' ';
+    }
+    else if ( (c == '%') && ((i + 2) < s.length()) && (http_hex(s[i + 1]) >= 0) && (http_hex(s[i + 2]) >= 0) )
+    {
+      out += (char) ((http_hex(s[i + 1]) << 4) | http_hex(s[i + 2]));
+      i += 2;
+    }
+    else
+    {
+      out += c;
+    }
+  }
+  return out;
+}
+
+static String http_base64decode(const String &s)
+{
+  static const char *table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  String out;
+  uint32_t bits = 0;
+  int count = 0;
+  for (unsigned int i = 0; i < s.length(); i++)
+  {
+    const char *p = strchr(table, s[i]);
+    if ( (p == NULL) || (s[i] == 0) )
+    {
+      break;
+    }
+    bits = (bits << 6) | (p - table);
+    count += 6;
+    if ( count >= 8 )
+    {
+      count -= 8;
+      out += (char) ((bits >> count) & 0xFF);
+    }
+  }
+  return out;
+}
+
+// value of a parameter in a header, name="value" or name=value
+static String http_headerparam(const String &header, const String &name)
+{
+  int start = header.indexOf(name + "=");
+  if ( start < 0 )
+  {
+    return String();
+  }
+  start += name.length() + 1;
+  if ( header[start] == '"' )
+  {
+    int end = header.indexOf('"', start + 1);
+    return header.substring(start + 1, (end < 0) ? header.length() : end);
+  }
+  int end = header.indexOf(';', start);
+  String value = header.substring(start, (end < 0) ? header.length() : end);
+  value.trim();
+  return value;
+}
+
+
+// ----------------------------------------------------------------------
+// ROUTES
+// ----------------------------------------------------------------------
+void WebServer::on(const String &uri, THandlerFunction fn)
+{
+  on(uri, HTTP_ANY, fn);
+}
+
+void WebServer::on(const String &uri, HTTPMethod method, THandlerFunction fn)
+{
+  on(uri, method, fn, NULL);
+}
+
+void WebServer::on(const String &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction upload)
+{
+  route r = { uri, method, fn, upload };
+  _routes.push_back(r);
+}
+
+void WebServer::stop(void)
+{
+  _client.stop();
+  _server.end();
+}
+
+
+// ----------------------------------------------------------------------
+// REQUEST
+// ----------------------------------------------------------------------
+void WebServer::handleClient(void)
+{
+  _client = _server.available();
+  if ( !_client )
+  {
+    return;
+  }
+  _client.setTimeout(HTTP_MAX_DATA_WAIT);
+  if ( read_request() == false )
+  {
+    _client.stop();
+    return;
+  }
+
+  route *match = NULL;
+  for (size_t i = 0; i < _routes.size(); i++)
+  {
+    if ( (_routes[i].uri == _uri) && ((_routes[i].method == HTTP_ANY) || (_routes[i].method == _method)) )
+    {
+      match = &_routes[i];
+      break;
+    }
+  }
+
+  String type = header("Content-Type");
+  if ( type.startsWith("multipart/form-data") )
+  {
+    parse_multipart(http_headerparam(type, "boundary"), _body, match);
+  }
+  _body = String();
+
+  if ( match != NULL )
+  {
+    match->fn();
+  }
+  else if ( _notfound )
+  {
+    _notfound();
+  }
+  else
+  {
+    send(404, "text/plain", String("Not found: ") + _uri);
+  }
+  finish();
+}
+
+// request line, headers and body, the arguments of the query and of a
+// form are parsed
+bool WebServer::read_request(void)
+{
+  String line = _client.readStringUntil('\n');
+  line.trim();
+  int sp1 = line.indexOf(' ');
+  int sp2 = line.indexOf(' ', sp1 + 1);
+  if ( (sp1 < 0) || (sp2 < 0) )
+  {
+    return false;
+  }
+  _method = http_method(line.substring(0, sp1));
+  String url = line.substring(sp1 + 1, sp2);
+  int query = url.indexOf('?');
+  _uri = http_urldecode((query < 0) ? url : url.substring(0, query));
+  _args.clear();
+  _headers.clear();
+  _response = String();
+  _contentlength = CONTENT_LENGTH_NOT_SET;
+  _sent = false;
+  if ( query >= 0 )
+  {
+    parse_args(url.substring(query + 1));
+  }
+
+  for (;;)
+  {
+    line = _client.readStringUntil('\n');
+    line.trim();
+    if ( line.length() == 0 )
+    {
+      break;
+    }
+    int colon = line.indexOf(':');
+    if ( colon > 0 )
+    {
+      param h = { line.substring(0, colon), line.substring(colon + 1) };
+      h.value.trim();
+      _headers.push_back(h);
+    }
+  }
+
+  long length = header("Content-Length").toInt();
+  _body = String();
+  if ( length > 0 )
+  {
+    _body.reserve(length);
+    char buf[1024];
+    while ( (long) _body.length() < length )
+    {
+      size_t want = length - _body.length();
+      size_t n = _client.readBytes(buf, (want < sizeof(buf)) ? want : sizeof(buf));
+      if ( n == 0 )
+      {
+        break;
+      }
+      _body.concat(buf, n);
+    }
+  }
+  String type = header("Content-Type");
+  if ( type.startsWith("application/x-www-form-urlencoded") )
+  {
+    parse_args(_body);
+  }
+  else if ( (_body.length() > 0) && !type.startsWith("multipart/form-data") )
+  {
+    param p = { "plain", _body };
+    _args.push_back(p);
+  }
+  return true;
+}
+
+void WebServer::parse_args(const String &data)
+{
+  unsigned int pos = 0;
+  while ( pos < data.length() )
+  {
+    int amp = data.indexOf('&', pos);
+    String item = data.substring(pos, (amp < 0) ? data.length() : amp);
+    pos = (amp < 0) ? data.length() : amp + 1;
+    if ( item.length() == 0 )
+    {
+      continue;
+    }
+    int eq = item.indexOf('=');
+    param p;
+    p.key = http_urldecode((eq < 0) ? item : item.substring(0, eq));
+    p.value = (eq < 0) ? String() : http_urldecode(item.substring(eq + 1));
+    _args.push_back(p);
+  }
+}
+
+// a part with a filename goes to the upload handler of the route, in
+// blocks of HTTP_UPLOAD_BUFLEN, other parts are arguments
+void WebServer::parse_multipart(const String &boundary, const String &body, route *match)
+{
+  if ( boundary.length() == 0 )
+  {
+    return;
+  }
+  String delim = "--" + boundary;
+  int pos = body.indexOf(delim);
+  while ( pos >= 0 )
+  {
+    pos += delim.length();
+    if ( body.substring(pos, pos + 2) == "--" )
+    {
+      break;
+    }
+    int headend = body.indexOf("\r\n\r\n", pos);
+    int next = body.indexOf(delim, pos);
+    if ( (headend < 0) || (next < 0) )
+    {
+      break;
+    }
+    String headers = body.substring(pos, headend);
+    int start = headend + 4;
+    int end = next - 2;                                       // less the \r\n before the delimiter
+    String name = http_headerparam(headers, "name");
+    String filename = http_headerparam(headers, "filename");
+    if ( filename.length() == 0 )
+    {
+      param p = { name, body.substring(start, end) };
+      _args.push_back(p);
+    }
+    else if ( (match != NULL) && match->upload )
+    {
+      _upload.filename = filename;
+      _upload.name = name;
+      int type = headers.indexOf("Content-Type:");
+      _upload.type = (type < 0) ? String() : headers.substring(type + 13, headers.indexOf('\r', type));
+      _upload.type.trim();
+      _upload.totalSize = 0;
+      _upload.currentSize = 0;
+      _upload.status = UPLOAD_FILE_START;
+      match->upload();
+      _upload.status = UPLOAD_FILE_WRITE;
+      for (int i = start; i < end; i += HTTP_UPLOAD_BUFLEN)
+      {
+        size_t n = ((end - i) < HTTP_UPLOAD_BUFLEN) ? (end - i) : HTTP_UPLOAD_BUFLEN;
+        memcpy(_upload.buf, body.c_str() + i, n);
+        _upload.currentSize = n;
+        _upload.totalSize += n;
+        match->upload();
+      }
+      _upload.status = UPLOAD_FILE_END;
+      _upload.currentSize = 0;
+      match->upload();
+    }
+    pos = next;
+  }
+}
+
+String WebServer::arg(const String &name)
+{
+  for (size_t i = 0; i < _args.size(); i++)
+  {
+    if ( _args[i].key == name )
+    {
+      return _args[i].value;
+    }
+  }
+  return String();
+}
+
+String WebServer::arg(int i)
+{
+  return ((i >= 0) && ((size_t) i < _args.size())) ? _args[i].value : String();
+}
+
+String WebServer::argName(int i)
+{
+  return ((i >= 0) && ((size_t) i < _args.size())) ? _args[i].key : String();
+}
+
+bool WebServer::hasArg(const String &name)
+{
+  for (size_t i = 0; i < _args.size(); i++)
+  {
+    if ( _args[i].key == name )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+String WebServer::header(const String &name)
+{
+  for (size_t i = 0; i < _headers.size(); i++)
+  {
+    if ( _headers[i].key.equalsIgnoreCase(name) )
+    {
+      return _headers[i].value;
+    }
+  }
+  return String();
+}
+
+bool WebServer::hasHeader(const String &name)
+{
+  for (size_t i = 0; i < _headers.size(); i++)
+  {
+    if ( _headers[i].key.equalsIgnoreCase(name) )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool WebServer::authenticate(const char *username, const char *password)
+{
+  String auth = header("Authorization");
+  if ( !auth.startsWith("Basic ") )
+  {
+    return false;
+  }
+  return http_base64decode(auth.substring(6)) == (String(username) + ":" + password);
+}
+
+void WebServer::requestAuthentication(void)
+{
+  sendHeader("WWW-Authenticate", "Basic realm=\"Login Required\"");
+  send(401, "text/html", "<html><body>Unauthorized</body></html>");
+}
+
+
+// ----------------------------------------------------------------------
+// RESPONSE
+// ----------------------------------------------------------------------
+void WebServer::sendHeader(const String &name, const String &value, bool first)
+{
+  String line = name + ": " + value + "\r\n";
+  _response = (first == true) ? line + _response : _response + line;
+}
+
+// with an unknown length the body ends when the connection is closed
+void WebServer::send_header(int code, const char *content_type, size_t length)
+{
+  String head = "HTTP/1.1 " + String(code) + " " + http_reason(code) + "\r\n";
+  head += "Content-Type: " + String((content_type == NULL) ? "text/html" : content_type) + "\r\n";
+  if ( _contentlength == CONTENT_LENGTH_UNKNOWN )
+  {
+    length = CONTENT_LENGTH_UNKNOWN;
+  }
+  else if ( _contentlength != CONTENT_LENGTH_NOT_SET )
+  {
+    length = _contentlength;
+  }
+  if ( length != CONTENT_LENGTH_UNKNOWN )
+  {
+    head += "Content-Length: " + String((unsigned long) length) + "\r\n";
+  }
+  if ( _cors == true )
+  {
+    head += "Access-Control-Allow-Origin: *\r\n";
+  }
+  head += _response;
+  head += "Connection: close\r\n\r\n";
+  _client.print(head);
+  _response = String();
+  _sent = true;
+}
+
+void WebServer::send(int code, const char *content_type, const String &content)
+{
+  send_header(code, content_type, content.length());
+  if ( (content.length() != 0) && (_method != HTTP_HEAD) )
+  {
+    _client.print(content);
+  }
+}
+
+void WebServer::sendContent(const String &content)
+{
+  _client.print(content);
+}
+
+void WebServer::sendContent(const char *content, size_t size)
+{
+  _client.write((const uint8_t *) content, size);
+}
+
+size_t WebServer::streamFile(File &file, const String &content_type)
+{
+  send_header(200, content_type.c_str(), file.size());
+  size_t total = 0;
+  uint8_t buf[1024];
+  size_t n;
+  while ( (n = file.read(buf, sizeof(buf))) > 0 )
+  {
+    total += _client.write(buf, n);
+  }
+  return total;
+}
+
+// the handler has replied, or written to client() itself
+void WebServer::finish(void)
+{
+  _client.flush();
+  _client.stop();
+  _args.clear();
+  _headers.clear();
+}
+
+#endif // #if !defined(ARDUINO)
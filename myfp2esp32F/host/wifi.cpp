@@ -0,0 +1,543 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST WIFI AND SOCKETS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/wifi.cpp
+// WiFi, tcp client and server, and udp on POSIX sockets for host builds
+// ----------------------------------------------------------------------
+
+#if !defined(ARDUINO)
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include "WiFi.h"
+
+
+// ----------------------------------------------------------------------
+// SUPPORT
+// ----------------------------------------------------------------------
+static void net_nonblocking(int fd)
+{
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  // a write to a closed connection returns an error, not SIGPIPE
+  signal(SIGPIPE, SIG_IGN);
+}
+
+static IPAddress net_ipaddress(const struct sockaddr_in &addr)
+{
+  return IPAddress((uint32_t) addr.sin_addr.s_addr);
+}
+
+static struct sockaddr_in net_sockaddr(IPAddress ip, uint16_t port)
+{
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = (uint32_t) ip;
+  return addr;
+}
+
+
+// ----------------------------------------------------------------------
+// IP ADDRESS
+// ----------------------------------------------------------------------
+IPAddress::IPAddress(void)
+{
+  _address.dword = 0;
+}
+
+IPAddress::IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+{
+  _address.bytes[0] = a;
+  _address.bytes[1] = b;
+  _address.bytes[2] = c;
+  _address.bytes[3] = d;
+}
+
+IPAddress::IPAddress(uint32_t address)
+{
+  _address.dword = address;
+}
+
+bool IPAddress::fromString(const char *address)
+{
+  struct in_addr addr;
+  if ( (address == NULL) || (inet_pton(AF_INET, address, &addr) != 1) )
+  {
+    return false;
+  }
+  _address.dword = addr.s_addr;
+  return true;
+}
+
+String IPAddress::toString(void) const
+{
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _address.bytes[0], _address.bytes[1], _address.bytes[2], _address.bytes[3]);
+  return String(buf);
+}
+
+
+// ----------------------------------------------------------------------
+// TCP CLIENT
+// ----------------------------------------------------------------------
+struct host_socket
+{
+  int       fd;
+  IPAddress remoteip;
+  uint16_t  remoteport;
+
+  host_socket(int s) : fd(s), remoteport(0)
+  {
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if ( getpeername(fd, (struct sockaddr *) &addr, &len) == 0 )
+    {
+      remoteip = net_ipaddress(addr);
+      remoteport = ntohs(addr.sin_port);
+    }
+  }
+
+  ~host_socket()
+  {
+    ::close(fd);
+  }
+};
+
+WiFiClient::WiFiClient(int fd)
+{
+  net_nonblocking(fd);
+  _sock = std::make_shared<host_socket>(fd);
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port)
+{
+  stop();
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if ( fd < 0 )
+  {
+    return 0;
+  }
+  struct sockaddr_in addr = net_sockaddr(ip, port);
+  if ( ::connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0 )
+  {
+    ::close(fd);
+    return 0;
+  }
+  net_nonblocking(fd);
+  _sock = std::make_shared<host_socket>(fd);
+  return 1;
+}
+
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+  struct addrinfo hints;
+  struct addrinfo *res = NULL;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if ( (host == NULL) || (getaddrinfo(host, NULL, &hints, &res) != 0) || (res == NULL) )
+  {
+    return 0;
+  }
+  IPAddress ip = net_ipaddress(*(struct sockaddr_in *) res->ai_addr);
+  freeaddrinfo(res);
+  return connect(ip, port);
+}
+
+size_t WiFiClient::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+// waits for the socket to take all of the data, as the Arduino core
+size_t WiFiClient::write(const uint8_t *buf, size_t size)
+{
+  if ( !_sock )
+  {
+    return 0;
+  }
+  size_t sent = 0;
+  while ( sent < size )
+  {
+    ssize_t n = send(_sock->fd, buf + sent, size - sent, 0);
+    if ( n > 0 )
+    {
+      sent += n;
+      continue;
+    }
+    if ( (n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)) )
+    {
+      struct pollfd pfd = { _sock->fd, POLLOUT, 0 };
+      if ( poll(&pfd, 1, _timeout) > 0 )
+      {
+        continue;
+      }
+    }
+    break;
+  }
+  return sent;
+}
+
+int WiFiClient::available(void)
+{
+  int count = 0;
+  if ( !_sock || (ioctl(_sock->fd, FIONREAD, &count) != 0) )
+  {
+    return 0;
+  }
+  return count;
+}
+
+int WiFiClient::read(void)
+{
+  uint8_t c;
+  return (read(&c, 1) == 1) ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buf, size_t size)
+{
+  if ( !_sock )
+  {
+    return -1;
+  }
+  ssize_t n = recv(_sock->fd, buf, size, 0);
+  return (n > 0) ? (int) n : -1;
+}
+
+int WiFiClient::peek(void)
+{
+  uint8_t c;
+  if ( !_sock || (recv(_sock->fd, &c, 1, MSG_PEEK) != 1) )
+  {
+    return -1;
+  }
+  return c;
+}
+
+void WiFiClient::stop(void)
+{
+  _sock = NULL;
+}
+
+// a peek of 0 bytes is an orderly close by the peer
+uint8_t WiFiClient::connected(void)
+{
+  if ( !_sock )
+  {
+    return 0;
+  }
+  uint8_t c;
+  ssize_t n = recv(_sock->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  if ( n > 0 )
+  {
+    return 1;
+  }
+  if ( (n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)) )
+  {
+    return 1;
+  }
+  return 0;
+}
+
+IPAddress WiFiClient::remoteIP(void) const
+{
+  return (_sock) ? _sock->remoteip : IPAddress();
+}
+
+uint16_t WiFiClient::remotePort(void) const
+{
+  return (_sock) ? _sock->remoteport : 0;
+}
+
+int WiFiClient::setNoDelay(bool nodelay)
+{
+  int flag = (nodelay == true) ? 1 : 0;
+  return (_sock) ? setsockopt(_sock->fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag)) : -1;
+}
+
+int WiFiClient::fd(void) const
+{
+  return (_sock) ? _sock->fd : -1;
+}
+
+bool WiFiClient::wait(unsigned long timeout)
+{
+  if ( !_sock )
+  {
+    return false;
+  }
+  struct pollfd pfd = { _sock->fd, POLLIN, 0 };
+  return (poll(&pfd, 1, timeout) > 0) && (connected() != 0);
+}
+
+
+// ----------------------------------------------------------------------
+// TCP SERVER
+// ----------------------------------------------------------------------
+void WiFiServer::begin(uint16_t port)
+{
+  end();
+  _port = (port != 0) ? port : _port;
+  _fd = socket(AF_INET, SOCK_STREAM, 0);
+  if ( _fd < 0 )
+  {
+    return;
+  }
+  int flag = 1;
+  setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+  struct sockaddr_in addr = net_sockaddr(IPAddress(0, 0, 0, 0), _port);
+  if ( (bind(_fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) || (listen(_fd, 4) != 0) )
+  {
+    printf("host: unable to listen on port %u, %s\n", _port, strerror(errno));
+    ::close(_fd);
+    _fd = -1;
+    return;
+  }
+  net_nonblocking(_fd);
+}
+
+WiFiClient WiFiServer::available(void)
+{
+  if ( _fd < 0 )
+  {
+    return WiFiClient();
+  }
+  int fd = ::accept(_fd, NULL, NULL);
+  if ( fd < 0 )
+  {
+    return WiFiClient();
+  }
+  WiFiClient client(fd);
+  client.setNoDelay(_nodelay);
+  return client;
+}
+
+bool WiFiServer::hasClient(void)
+{
+  struct pollfd pfd = { _fd, POLLIN, 0 };
+  return (_fd >= 0) && (poll(&pfd, 1, 0) > 0);
+}
+
+void WiFiServer::end(void)
+{
+  if ( _fd >= 0 )
+  {
+    ::close(_fd);
+    _fd = -1;
+  }
+}
+
+
+// ----------------------------------------------------------------------
+// UDP
+// ----------------------------------------------------------------------
+uint8_t WiFiUDP::begin(uint16_t port)
+{
+  stop();
+  _fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if ( _fd < 0 )
+  {
+    return 0;
+  }
+  int flag = 1;
+  setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+  setsockopt(_fd, SOL_SOCKET, SO_BROADCAST, &flag, sizeof(flag));
+  struct sockaddr_in addr = net_sockaddr(IPAddress(0, 0, 0, 0), port);
+  if ( bind(_fd, (struct sockaddr *) &addr, sizeof(addr)) != 0 )
+  {
+    printf("host: unable to bind udp port %u, %s\n", port, strerror(errno));
+    ::close(_fd);
+    _fd = -1;
+    return 0;
+  }
+  net_nonblocking(_fd);
+  return 1;
+}
+
+void WiFiUDP::stop(void)
+{
+  if ( _fd >= 0 )
+  {
+    ::close(_fd);
+    _fd = -1;
+  }
+  _rx.clear();
+  _rxpos = 0;
+}
+
+int WiFiUDP::parsePacket(void)
+{
+  _rx.clear();
+  _rxpos = 0;
+  if ( _fd < 0 )
+  {
+    return 0;
+  }
+  uint8_t buf[1460];
+  struct sockaddr_in addr;
+  socklen_t len = sizeof(addr);
+  ssize_t n = recvfrom(_fd, buf, sizeof(buf), 0, (struct sockaddr *) &addr, &len);
+  if ( n <= 0 )
+  {
+    return 0;
+  }
+  _rx.assign(buf, buf + n);
+  _remoteip = net_ipaddress(addr);
+  _remoteport = ntohs(addr.sin_port);
+  return n;
+}
+
+int WiFiUDP::available(void)
+{
+  return _rx.size() - _rxpos;
+}
+
+int WiFiUDP::read(void)
+{
+  return (_rxpos < _rx.size()) ? _rx[_rxpos++] : -1;
+}
+
+int WiFiUDP::read(unsigned char *buf, size_t len)
+{
+  size_t n = _rx.size() - _rxpos;
+  n = (len < n) ? len : n;
+  memcpy(buf, _rx.data() + _rxpos, n);
+  _rxpos += n;
+  return n;
+}
+
+int WiFiUDP::peek(void)
+{
+  return (_rxpos < _rx.size()) ? _rx[_rxpos] : -1;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port)
+{
+  _sendip = ip;
+  _sendport = port;
+  _tx.clear();
+  return 1;
+}
+
+int WiFiUDP::endPacket(void)
+{
+  if ( _fd < 0 )
+  {
+    return 0;
+  }
+  struct sockaddr_in addr = net_sockaddr(_sendip, _sendport);
+  ssize_t n = sendto(_fd, _tx.data(), _tx.size(), 0, (struct sockaddr *) &addr, sizeof(addr));
+  _tx.clear();
+  return (n >= 0) ? 1 : 0;
+}
+
+size_t WiFiUDP::write(uint8_t c)
+{
+  _tx.push_back(c);
+  return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t *buf, size_t size)
+{
+  _tx.insert(_tx.end(), buf, buf + size);
+  return size;
+}
+
+
+// ----------------------------------------------------------------------
+// WIFI
+// ----------------------------------------------------------------------
+WiFiClass WiFi;
+
+bool WiFiClass::mode(wifi_mode_t m)
+{
+  _mode = m;
+  return true;
+}
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *passphrase)
+{
+  _ssid = ssid;
+  _status = WL_CONNECTED;
+  return _status;
+}
+
+bool WiFiClass::config(IPAddress, IPAddress, IPAddress, IPAddress, IPAddress)
+{
+  return true;
+}
+
+bool WiFiClass::disconnect(bool, bool)
+{
+  _status = WL_DISCONNECTED;
+  return true;
+}
+
+bool WiFiClass::reconnect(void)
+{
+  _status = WL_CONNECTED;
+  return true;
+}
+
+bool WiFiClass::softAP(const char *ssid, const char *, int, int, int)
+{
+  _ssid = ssid;
+  _status = WL_CONNECTED;
+  return true;
+}
+
+bool WiFiClass::softAPConfig(IPAddress, IPAddress, IPAddress)
+{
+  return true;
+}
+
+IPAddress WiFiClass::softAPIP(void)
+{
+  return IPAddress(127, 0, 0, 1);
+}
+
+IPAddress WiFiClass::localIP(void)
+{
+  return IPAddress(127, 0, 0, 1);
+}
+
+IPAddress WiFiClass::gatewayIP(void)
+{
+  return IPAddress(127, 0, 0, 1);
+}
+
+IPAddress WiFiClass::subnetMask(void)
+{
+  return IPAddress(255, 0, 0, 0);
+}
+
+int32_t WiFiClass::RSSI(void)
+{
+  return (_status == WL_CONNECTED) ? -50 : 0;
+}
+
+String WiFiClass::macAddress(void)
+{
+  return String("00:00:00:00:00:00");
+}
+
+bool WiFiClass::setHostname(const char *name)
+{
+  _hostname = name;
+  return true;
+}
+
+#endif // #if !defined(ARDUINO)
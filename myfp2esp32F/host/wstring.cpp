@@ -0,0 +1,369 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST STRING CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host/wstring.cpp
+// The Arduino String for host builds
+// ----------------------------------------------------------------------
+
+#if !defined(ARDUINO)
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "WString.h"
+
+
+// ----------------------------------------------------------------------
+// NUMBERS
+// ----------------------------------------------------------------------
+// unsigned value in base 2 - 36, lower case as the Arduino core
+static std::string wstring_utoa(unsigned long long value, unsigned char base)
+{
+  if ( (base < 2) || (base > 36) )
+  {
+    base = 10;
+  }
+  char buf[72];
+  int pos = sizeof(buf) - 1;
+  buf[pos] = 0;
+  do
+  {
+    int digit = value % base;
+    buf[--pos] = (digit < 10) ? ('0' + digit) : ('a' + digit - 10);
+    value /= base;
+  } while ( value != 0 );
+  return std::string(&buf[pos]);
+}
+
+// a negative value is signed in base 10, in other bases it is the two's complement
+static std::string wstring_ltoa(long long value, unsigned char base, unsigned int bits)
+{
+  if ( base == 10 )
+  {
+    return (value < 0) ? "-" + wstring_utoa(-(unsigned long long) value, 10) : wstring_utoa(value, 10);
+  }
+  unsigned long long mask = (bits >= 64) ? ~0ULL : ((1ULL << bits) - 1);
+  return wstring_utoa((unsigned long long) value & mask, base);
+}
+
+static std::string wstring_dtostr(double value, unsigned int decimalPlaces)
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+  return std::string(buf);
+}
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+String::String(const char *s)
+{
+  if ( s != NULL )
+  {
+    _s = s;
+  }
+}
+
+String::String(char c) : _s(1, c)
+{
+}
+
+String::String(unsigned char value, unsigned char base) : _s(wstring_utoa(value, base))
+{
+}
+
+String::String(int value, unsigned char base) : _s(wstring_ltoa(value, base, sizeof(int) * 8))
+{
+}
+
+String::String(unsigned int value, unsigned char base) : _s(wstring_utoa(value, base))
+{
+}
+
+String::String(long value, unsigned char base) : _s(wstring_ltoa(value, base, sizeof(long) * 8))
+{
+}
+
+String::String(unsigned long value, unsigned char base) : _s(wstring_utoa(value, base))
+{
+}
+
+String::String(long long value, unsigned char base) : _s(wstring_ltoa(value, base, 64))
+{
+}
+
+String::String(unsigned long long value, unsigned char base) : _s(wstring_utoa(value, base))
+{
+}
+
+String::String(float value, unsigned int decimalPlaces) : _s(wstring_dtostr(value, decimalPlaces))
+{
+}
+
+String::String(double value, unsigned int decimalPlaces) : _s(wstring_dtostr(value, decimalPlaces))
+{
+}
+
+String &String::operator=(const char *s)
+{
+  _s = (s == NULL) ? "" : s;
+  return *this;
+}
+
+bool String::concat(const char *s)
+{
+  if ( s == NULL )
+  {
+    return false;
+  }
+  _s += s;
+  return true;
+}
+
+bool String::concat(const char *s, unsigned int length)
+{
+  if ( s == NULL )
+  {
+    return false;
+  }
+  _s.append(s, length);
+  return true;
+}
+
+int String::compareTo(const String &s) const
+{
+  return _s.compare(s._s);
+}
+
+bool String::equals(const char *s) const
+{
+  return _s == ((s == NULL) ? "" : s);
+}
+
+bool String::equalsIgnoreCase(const String &s) const
+{
+  return (_s.size() == s._s.size()) && (strcasecmp(_s.c_str(), s._s.c_str()) == 0);
+}
+
+bool String::startsWith(const String &s) const
+{
+  return startsWith(s, 0);
+}
+
+bool String::startsWith(const String &s, unsigned int offset) const
+{
+  return (offset <= _s.size()) && (_s.compare(offset, s._s.size(), s._s) == 0) && ((offset + s._s.size()) <= _s.size());
+}
+
+bool String::endsWith(const String &s) const
+{
+  return (s._s.size() <= _s.size()) && (_s.compare(_s.size() - s._s.size(), s._s.size(), s._s) == 0);
+}
+
+char String::charAt(unsigned int index) const
+{
+  return (index < _s.size()) ? _s[index] : 0;
+}
+
+void String::setCharAt(unsigned int index, char c)
+{
+  if ( index < _s.size() )
+  {
+    _s[index] = c;
+  }
+}
+
+char &String::operator[](unsigned int index)
+{
+  static char dummy;
+  if ( index >= _s.size() )
+  {
+    dummy = 0;
+    return dummy;
+  }
+  return _s[index];
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+{
+  if ( (buf == NULL) || (bufsize == 0) )
+  {
+    return;
+  }
+  if ( index >= _s.size() )
+  {
+    buf[0] = 0;
+    return;
+  }
+  size_t n = _s.size() - index;
+  n = (n > (bufsize - 1)) ? (bufsize - 1) : n;
+  memcpy(buf, _s.data() + index, n);
+  buf[n] = 0;
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+  size_t pos = _s.find(c, from);
+  return (pos == std::string::npos) ? -1 : (int) pos;
+}
+
+int String::indexOf(const String &s, unsigned int from) const
+{
+  size_t pos = _s.find(s._s, from);
+  return (pos == std::string::npos) ? -1 : (int) pos;
+}
+
+int String::lastIndexOf(char c) const
+{
+  size_t pos = _s.rfind(c);
+  return (pos == std::string::npos) ? -1 : (int) pos;
+}
+
+int String::lastIndexOf(char c, unsigned int from) const
+{
+  size_t pos = _s.rfind(c, from);
+  return (pos == std::string::npos) ? -1 : (int) pos;
+}
+
+int String::lastIndexOf(const String &s) const
+{
+  size_t pos = _s.rfind(s._s);
+  return (pos == std::string::npos) ? -1 : (int) pos;
+}
+
+String String::substring(unsigned int left) const
+{
+  return (left >= _s.size()) ? String() : String(_s.substr(left));
+}
+
+// the arguments may be in either order, as the Arduino core
+String String::substring(unsigned int left, unsigned int right) const
+{
+  if ( left > right )
+  {
+    unsigned int t = left;
+    left = right;
+    right = t;
+  }
+  right = (right > _s.size()) ? _s.size() : right;
+  return (left >= right) ? String() : String(_s.substr(left, right - left));
+}
+
+void String::replace(char find, char with)
+{
+  for (size_t i = 0; i < _s.size(); i++)
+  {
+    if ( _s[i] == find )
+    {
+      _s[i] = with;
+    }
+  }
+}
+
+void String::replace(const String &find, const String &with)
+{
+  if ( find._s.empty() )
+  {
+    return;
+  }
+  size_t pos = 0;
+  while ( (pos = _s.find(find._s, pos)) != std::string::npos )
+  {
+    _s.replace(pos, find._s.size(), with._s);
+    pos += with._s.size();
+  }
+}
+
+void String::remove(unsigned int index)
+{
+  if ( index < _s.size() )
+  {
+    _s.erase(index);
+  }
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+  if ( index < _s.size() )
+  {
+    _s.erase(index, count);
+  }
+}
+
+void String::toLowerCase(void)
+{
+  for (size_t i = 0; i < _s.size(); i++)
+  {
+    _s[i] = tolower((unsigned char) _s[i]);
+  }
+}
+
+void String::toUpperCase(void)
+{
+  for (size_t i = 0; i < _s.size(); i++)
+  {
+    _s[i] = toupper((unsigned char) _s[i]);
+  }
+}
+
+void String::trim(void)
+{
+  size_t begin = 0;
+  size_t end = _s.size();
+  while ( (begin < end) && isspace((unsigned char) _s[begin]) )
+  {
+    begin++;
+  }
+  while ( (end > begin) && isspace((unsigned char) _s[end - 1]) )
+  {
+    end--;
+  }
+  _s = _s.substr(begin, end - begin);
+}
+
+long String::toInt(void) const
+{
+  return atol(_s.c_str());
+}
+
+float String::toFloat(void) const
+{
+  return (float) atof(_s.c_str());
+}
+
+double String::toDouble(void) const
+{
+  return atof(_s.c_str());
+}
+
+
+// ----------------------------------------------------------------------
+// CONCATENATION
+// ----------------------------------------------------------------------
+String operator+(const String &lhs, const String &rhs)
+{
+  String s(lhs);
+  s.concat(rhs);
+  return s;
+}
+
+String operator+(const String &lhs, const char *rhs)
+{
+  String s(lhs);
+  s.concat(rhs);
+  return s;
+}
+
+String operator+(const char *lhs, const String &rhs)
+{
+  String s(lhs);
+  s.concat(rhs);
+  return s;
+}
+
+#endif // #if !defined(ARDUINO)
@@ -0,0 +1,242 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOT PATH BENCHMARK
+// © Copyright Robert Brown 2014-2022. All Rights Reserved.
+// hot_bench.cpp
+// Timing of the reply formatting, page templating and json functions
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "file_system.h"
+#include "hot_bench.h"
+
+#include "controller_data.h"
+extern CONTROLLER_DATA *ControllerData;
+
+#include "tcpip_server.h"
+extern TCPIP_SERVER *tcpipsrvr;
+
+#include "ascom_server.h"
+extern ASCOM_SERVER *ascomsrvr;
+
+#include "web_server.h"
+extern WEB_SERVER *websrvr;
+
+#include "power_manager.h"
+extern POWER_MANAGER *powermgr;
+
+extern bool filesystemloaded;
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define HOTBENCH_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  HOTBENCH_PRINT
+#define HOTBENCH_print(...)   Serial.print(__VA_ARGS__)
+#define HOTBENCH_println(...) Serial.println(__VA_ARGS__)
+#else
+#define HOTBENCH_print(...)
+#define HOTBENCH_println(...)
+#endif
+
+
+// ----------------------------------------------------------------------
+// CASES
+// ----------------------------------------------------------------------
+// build_reply() is called with client -1, send_reply() ignores it, so
+// only the formatting is timed
+static volatile uint32_t hb_sink;             // keeps the results live
+
+static void hb_ftoa(void)
+{
+  char buff[16];
+  tcpipsrvr->ftoa(buff, 21.4375, 3);
+  hb_sink += buff[0];
+}
+
+static void hb_reply_float(void)
+{
+  tcpipsrvr->build_reply('Z', 21.4375f, 3, -1);
+}
+
+static void hb_reply_long(void)
+{
+  tcpipsrvr->build_reply('P', 123456L, -1);
+}
+
+static void hb_reply_string(void)
+{
+  tcpipsrvr->build_reply('F', String("myFP2ESP32"), -1);
+}
+
+static void hb_addclientinfo(void)
+{
+  String str = ascomsrvr->addclientinfo("{\"Value\":123456,");
+  hb_sink += str.length();
+}
+
+static void hb_template(void)
+{
+  String pg;
+  pg.reserve(6400);
+  websrvr->build_index(pg);
+  hb_sink += pg.length();
+}
+
+static void hb_cntlrjson(void)
+{
+  String str = ControllerData->get_cntlrconfig_json();
+  hb_sink += str.length();
+}
+
+static void hb_boardjson(void)
+{
+  String str = ControllerData->get_boardconfig_json();
+  hb_sink += str.length();
+}
+
+struct hb_case
+{
+  const char *name;
+  void      (*run)(void);
+  int        ops;
+};
+
+static const hb_case hb_cases[] =
+{
+  { "ftoa",          hb_ftoa,          1000 },
+  { "reply_float",   hb_reply_float,   1000 },
+  { "reply_long",    hb_reply_long,    1000 },
+  { "reply_string",  hb_reply_string,  1000 },
+  { "addclientinfo", hb_addclientinfo, 200 },
+  { "template",      hb_template,      10 },
+  { "cntlrjson",     hb_cntlrjson,     20 },
+  { "boardjson",     hb_boardjson,     20 },
+};
+#define HOTBENCH_CASES    (sizeof(hb_cases) / sizeof(hb_cases[0]))
+
+
+// ----------------------------------------------------------------------
+// time one case, one untimed run first so caches and pages are loaded
+// ns per op and heap bytes held per op
+// ----------------------------------------------------------------------
+static void hb_time(const hb_case &c, uint32_t mhz, uint32_t &ns, int32_t &bytes)
+{
+  c.run();
+  uint32_t heap = ESP.getFreeHeap();
+  uint32_t start = ESP.getCycleCount();
+  for (int i = 0; i < c.ops; i++)
+  {
+    c.run();
+  }
+  uint32_t cycles = ESP.getCycleCount() - start;
+  bytes = ((int32_t) heap - (int32_t) ESP.getFreeHeap()) / c.ops;
+  ns = (uint32_t) (((uint64_t) cycles * 1000) / ((uint64_t) mhz * c.ops));
+}
+
+// ----------------------------------------------------------------------
+// read the ns of a case from the baseline, 0 if not found
+// ----------------------------------------------------------------------
+static uint32_t hb_baseline(const String &baseline, const char *name)
+{
+  String key = String(name) + " ";
+  int pos = baseline.startsWith(key) ? 0 : baseline.indexOf("\n" + key);
+  if ( pos < 0 )
+  {
+    return 0;
+  }
+  pos += (pos == 0) ? key.length() : key.length() + 1;
+  return baseline.substring(pos, baseline.indexOf(' ', pos)).toInt();
+}
+
+static bool hb_ready(void)
+{
+  return (tcpipsrvr != NULL) && (ascomsrvr != NULL) && (websrvr != NULL) && (ControllerData != NULL);
+}
+
+// ----------------------------------------------------------------------
+// String hot_benchmark(void);
+// change is the % difference from the baseline, + is slower
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String hot_benchmark(void)
+{
+  if ( hb_ready() == false )
+  {
+    return "{ \"error\":\"servers not created\" }";
+  }
+  String baseline = "";
+  if ( (filesystemloaded == true) && FILESYS.exists(HOTBENCH_BASELINE) )
+  {
+    File file = FILESYS.open(HOTBENCH_BASELINE, "r");
+    baseline = file.readString();
+    file.close();
+  }
+
+  powermgr->activity();                       // full clock, wake() would time the next move from here
+  uint32_t mhz = ESP.getCpuFreqMHz();
+  String jsonstr = "{ \"mhz\":" + String(mhz) + ", \"baseline\":" + String((baseline != "") ? "true" : "false") + ", \"cases\":[";
+  for (unsigned int i = 0; i < HOTBENCH_CASES; i++)
+  {
+    uint32_t ns;
+    int32_t  bytes;
+    hb_time(hb_cases[i], mhz, ns, bytes);
+    HOTBENCH_print("hb: ");
+    HOTBENCH_print(hb_cases[i].name);
+    HOTBENCH_print(" ");
+    HOTBENCH_println(ns);
+    jsonstr += (i == 0) ? " " : ", ";
+    jsonstr += "{ \"name\":\"" + String(hb_cases[i].name) + "\", \"ops\":" + String(hb_cases[i].ops) \
+               + ", \"ns\":" + String(ns) + ", \"bytes\":" + String(bytes);
+    uint32_t base = hb_baseline(baseline, hb_cases[i].name);
+    if ( base != 0 )
+    {
+      int32_t change = (int32_t) ((((int64_t) ns - base) * 100) / base);
+      jsonstr += ", \"base_ns\":" + String(base) + ", \"change\":" + String(change);
+    }
+    jsonstr += " }";
+  }
+  jsonstr += " ] }";
+  return jsonstr;
+}
+
+// ----------------------------------------------------------------------
+// bool hot_benchmark_baseline(void);
+// ----------------------------------------------------------------------
+bool hot_benchmark_baseline(void)
+{
+  if ( (hb_ready() == false) || (filesystemloaded == false) )
+  {
+    return false;
+  }
+  powermgr->activity();                       // full clock for the timing
+  uint32_t mhz = ESP.getCpuFreqMHz();
+  String baseline = "";
+  for (unsigned int i = 0; i < HOTBENCH_CASES; i++)
+  {
+    uint32_t ns;
+    int32_t  bytes;
+    hb_time(hb_cases[i], mhz, ns, bytes);
+    baseline += String(hb_cases[i].name) + " " + String(ns) + " " + String(bytes) + "\n";
+  }
+  File file = FILESYS.open(HOTBENCH_BASELINE, "w");
+  if ( !file )
+  {
+    ERROR_println("hb: unable to write baseline");
+    return false;
+  }
+  file.print(baseline);
+  file.close();
+  return true;
+}
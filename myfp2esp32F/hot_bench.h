@@ -0,0 +1,36 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOT PATH BENCHMARK DEFINITIONS
+// © Copyright Robert Brown 2014-2022. All Rights Reserved.
+// hot_bench.h
+// ----------------------------------------------------------------------
+
+#if !defined(_hot_bench_h_)
+#define _hot_bench_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define HOTBENCH_BASELINE   "/hotbench.txt"   // stored results, one case per line, name ns bytes
+
+
+// ----------------------------------------------------------------------
+// SUPPORT FUNCTIONS
+// ----------------------------------------------------------------------
+// time the string building hot paths with the cpu cycle counter, each
+// case is compared with the stored baseline if there is one
+// Returns a json string - used by Management Server
+String hot_benchmark(void);
+
+// run the benchmark and store the results as the baseline
+bool hot_benchmark_baseline(void);
+
+
+
+#endif // #if !defined(_hot_bench_h_)
@@ -86,6 +86,22 @@ decode_results results;
 // ----------------------------------------------------------------------
 
 
+// ----------------------------------------------------------------------
+// IR TASK
+// decodes the receiver every IR_DECODETIME, so key events are time
+// stamped when they arrive and not when loop() gets to them
+// ----------------------------------------------------------------------
+void ir_task(void *param)
+{
+  IR_REMOTE *ir = (IR_REMOTE *) param;
+  for (;;)
+  {
+    ir->decode();
+    vTaskDelay(pdMS_TO_TICKS(IR_DECODETIME));
+  }
+}
+
+
 // ----------------------------------------------------------------------
 // IRREMOTE Class
 // ----------------------------------------------------------------------
@@ -108,6 +124,7 @@ bool IR_REMOTE::start(void)
     irrecv = new IRrecv(_pin);
     irrecv->enableIRIn();                            // start the IR
     this->_loaded = true;
+    xTaskCreatePinnedToCore(ir_task, "irremote", IR_TASKSTACK, this, IR_TASKPRIORITY, &_task, IR_TASKCORE);
     return true;
   }
   else
@@ -117,106 +134,243 @@ bool IR_REMOTE::start(void)
   }
 }
 
+// ----------------------------------------------------------------------
+// decode and queue a key event, KEY_REPEAT becomes a repeat of the last key
+// ir task
+// ----------------------------------------------------------------------
+void IR_REMOTE::decode(void)
+{
+  if ( irrecv->decode(&results) )
+  {
+    uint32_t ms = millis();
+    bool repeat = false;
+    long code;
+    if ( results.value == KEY_REPEAT )
+    {
+      code = _lastcode;
+      repeat = true;
+    }
+    else
+    {
+      code = results.value;
+      _lastcode = code;
+    }
+    irrecv->resume();                                // Receive the next value
+    if ( code != 0 )
+    {
+      push(code, ms, repeat);
+    }
+  }
+}
+
+// the event is written before the index is moved, so update() never
+// reads a part written event
+bool IR_REMOTE::push(long code, uint32_t ms, bool repeat)
+{
+  uint32_t head = _head;
+  if ( (head - _tail) >= IR_QUEUESIZE )
+  {
+    _dropped++;
+    return false;
+  }
+  ir_event &ev = _queue[head % IR_QUEUESIZE];
+  ev.code   = code;
+  ev.ms     = ms;
+  ev.repeat = repeat;
+  __sync_synchronize();
+  _head = head + 1;
+  return true;
+}
+
+bool IR_REMOTE::pop(ir_event &ev)
+{
+  uint32_t tail = _tail;
+  if ( tail == _head )
+  {
+    return false;
+  }
+  __sync_synchronize();
+  ev = _queue[tail % IR_QUEUESIZE];
+  __sync_synchronize();
+  _tail = tail + 1;
+  return true;
+}
+
+// ----------------------------------------------------------------------
+// jog step of a key event, 0 if not a jog key
+// a held key doubles its step every IR_ACCELTIME, and the step is scaled
+// by the time since the last repeat, so the jog rate does not depend on
+// the remote repeat rate or on repeats that were missed
+// ----------------------------------------------------------------------
+long IR_REMOTE::jogstep(const ir_event &ev)
+{
+  long step;
+  switch ( ev.code )
+  {
+    case IR_IN1:
+      step = -1;
+      break;
+    case IR_OUT1:
+      step = 1;
+      break;
+    case IR_IN10:
+      step = -10;
+      break;
+    case IR_OUT10:
+      step = 10;
+      break;
+    case IR_IN50:
+      step = -50;
+      break;
+    case IR_OUT50:
+      step = 50;
+      break;
+    case IR_IN100:
+      step = -100;
+      break;
+    case IR_OUT100:
+      step = 100;
+      break;
+    default:
+      _holdcode = 0;
+      return 0;
+  }
+
+  uint32_t gap = ev.ms - _holdlast;
+  _holdlast = ev.ms;
+  if ( (ev.repeat == false) || (ev.code != _holdcode) || (gap > IR_HOLDGAP) )
+  {
+    // a new press
+    _holdcode  = ev.code;
+    _holdstart = ev.ms;
+    return step;
+  }
+  uint32_t doublings = (ev.ms - _holdstart) / IR_ACCELTIME;
+  doublings = (doublings > IR_MAXDOUBLINGS) ? IR_MAXDOUBLINGS : doublings;
+  long held = (step * (1L << doublings) * (long) gap) / IR_REPEATTIME;
+  return (held == 0) ? step : held;
+}
+
+// move the target by the jog steps of one update
+void IR_REMOTE::apply(long delta)
+{
+  if ( delta == 0 )
+  {
+    return;
+  }
+  long newpos = ftargetPosition + delta;
+  newpos = (newpos < 0 ) ? 0 : newpos;
+  newpos = (newpos > (long) ControllerData->get_maxstep()) ? ControllerData->get_maxstep() : newpos;
+  ftargetPosition = newpos;
+  _updates++;
+}
+
+// ----------------------------------------------------------------------
+// drain the key events, called from loop()
+// jog steps are added up and applied as one target change, any other key
+// applies the steps before it first
+// ----------------------------------------------------------------------
 void IR_REMOTE::update()
 {
   IRREMOTE_println("IRRemote update");
-  if ( this->_loaded == V_RUNNING )
+  if ( this->_loaded != V_RUNNING )
+  {
+    return;
+  }
+
+  uint32_t depth = _head - _tail;
+  _depth_max = (depth > _depth_max) ? depth : _depth_max;
+
+  uint32_t now = millis();
+  long delta = 0;
+  int  jogs = 0;
+  ir_event ev;
+  while ( pop(ev) )
   {
-    // check IR
-    if (irrecv->decode(&results))
+    _events++;
+    _repeats += (ev.repeat == true) ? 1 : 0;
+    uint32_t latency = now - ev.ms;
+    _latency_max = (latency > _latency_max) ? latency : _latency_max;
+
+    long step = jogstep(ev);
+    if ( step != 0 )
     {
-      int adjpos = 0;
-      static long lastcode;
-      if ( results.value == KEY_REPEAT )
-      {
-        results.value = lastcode;                   // repeat last code
-      }
-      else
-      {
-        lastcode = results.value;
-      }
-      if ( (isMoving == 1) && (lastcode == IR_HALT))
-      {
-        portENTER_CRITICAL(&halt_alertMux);
-        halt_alert = true;
-        portEXIT_CRITICAL(&halt_alertMux);
-      }
-      else
-      {
-        switch ( lastcode )
-        {
-          case IR_SLOW:
-            ControllerData->set_motorspeed(SLOW);
-            break;
-          case IR_MEDIUM:
-            ControllerData->set_motorspeed(MED);
-            break;
-          case IR_FAST:
-            ControllerData->set_motorspeed(FAST);
-            break;
-          case IR_IN1:
-            adjpos = -1;
-            break;
-          case IR_OUT1:
-            adjpos = 1;
-            break;
-          case IR_IN10:
-            adjpos = -10;
-            break;
-          case IR_OUT10:
-            adjpos = 10;
-            break;
-          case IR_IN50:
-            adjpos = -50;
-            break;
-          case IR_OUT50:
-            adjpos = 50;
-            break;
-          case IR_IN100:
-            adjpos = -100;
-            break;
-          case IR_OUT100:
-            adjpos = 100;
-            break;
-          case IR_SETPOSZERO:                         // 0 RESET POSITION TO 0
-            adjpos = 0;
-            ftargetPosition = 0;
-            driverboard->setposition(0);
-            ControllerData->set_fposition(0);
-            break;
-          case IR_PRESET0:
-            ftargetPosition = ControllerData->get_focuserpreset(0);
-            break;
-          case IR_PRESET1:
-            ftargetPosition = ControllerData->get_focuserpreset(1);
-            break;
-          case IR_PRESET2:
-            ftargetPosition = ControllerData->get_focuserpreset(2);
-            break;
-          case IR_PRESET3:
-            ftargetPosition = ControllerData->get_focuserpreset(3);
-            break;
-          case IR_PRESET4:
-            ftargetPosition = ControllerData->get_focuserpreset(4);
-            break;
-        } // switch(lastcode)
-      } // if ( (isMoving == 1) && (lastcode == IR_HALT))
-      irrecv->resume();                              // Receive the next value
-      long newpos;
-      if ( adjpos < 0 )
-      {
-        newpos = ControllerData->get_fposition() + adjpos;
-        newpos = (newpos < 0 ) ? 0 : newpos;
-        ftargetPosition = newpos;
-      }
-      else if ( adjpos > 0)
-      {
-        newpos = ControllerData->get_fposition() + adjpos;
-        newpos = (newpos > ControllerData->get_maxstep()) ? ControllerData->get_maxstep() : newpos;
-        ftargetPosition = newpos;
-      }
+      delta += step;
+      jogs++;
+      continue;
     }
+
+    if ( (isMoving == 1) && (ev.code == IR_HALT) )
+    {
+      // a halt cancels the jog steps before it
+      delta = 0;
+      portENTER_CRITICAL(&halt_alertMux);
+      halt_alert = true;
+      portEXIT_CRITICAL(&halt_alertMux);
+      continue;
+    }
+
+    apply(delta);
+    delta = 0;
+    switch ( ev.code )
+    {
+      case IR_SLOW:
+        ControllerData->set_motorspeed(SLOW);
+        break;
+      case IR_MEDIUM:
+        ControllerData->set_motorspeed(MED);
+        break;
+      case IR_FAST:
+        ControllerData->set_motorspeed(FAST);
+        break;
+      case IR_SETPOSZERO:                         // 0 RESET POSITION TO 0
+        ftargetPosition = 0;
+        driverboard->setposition(0);
+        ControllerData->set_fposition(0);
+        break;
+      case IR_PRESET0:
+        ftargetPosition = ControllerData->get_focuserpreset(0);
+        break;
+      case IR_PRESET1:
+        ftargetPosition = ControllerData->get_focuserpreset(1);
+        break;
+      case IR_PRESET2:
+        ftargetPosition = ControllerData->get_focuserpreset(2);
+        break;
+      case IR_PRESET3:
+        ftargetPosition = ControllerData->get_focuserpreset(3);
+        break;
+      case IR_PRESET4:
+        ftargetPosition = ControllerData->get_focuserpreset(4);
+        break;
+    } // switch(ev.code)
   }
+  apply(delta);
+  _coalesced += (jogs > 1) ? (jogs - 1) : 0;
+}
+
+// ----------------------------------------------------------------------
+// key events, queue depth and decode to applied latency
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String IR_REMOTE::get_stats(void)
+{
+  String jsonstr = "{ \"events\":" + String(_events) + ", \"repeats\":" + String(_repeats) \
+                   + ", \"dropped\":" + String(_dropped) + ", \"updates\":" + String(_updates) \
+                   + ", \"coalesced\":" + String(_coalesced) + ", \"depth_max\":" + String(_depth_max) \
+                   + ", \"latency_max\":" + String(_latency_max) + " }";
+  return jsonstr;
+}
+
+void IR_REMOTE::reset_stats(void)
+{
+  _dropped     = 0;
+  _events      = 0;
+  _repeats     = 0;
+  _updates     = 0;
+  _coalesced   = 0;
+  _depth_max   = 0;
+  _latency_max = 0;
 }
 
 #endif // #ifdef ENABLE_INFRAREDREMOTE
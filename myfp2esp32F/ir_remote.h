@@ -13,21 +13,81 @@
 // ----------------------------------------------------------------------
 // Includes
 // ----------------------------------------------------------------------
+#include <Arduino.h>
+
+
+// ----------------------------------------------------------------------
+// Defines
+// ----------------------------------------------------------------------
+#define IR_QUEUESIZE      16              // key events, power of 2
+#define IR_DECODETIME     5               // ms between decodes in the ir task
+#define IR_TASKSTACK      3072
+#define IR_TASKPRIORITY   1
+#define IR_TASKCORE       0               // loop() runs on core 1
+#define IR_REPEATTIME     108             // ms, nominal NEC repeat interval
+#define IR_HOLDGAP        250             // ms, a repeat later than this starts a new hold
+#define IR_ACCELTIME      500             // ms, the jog step doubles each time the key is held this long
+#define IR_MAXDOUBLINGS   5               // jog step is at most 32 times the key step
+
+
+// ----------------------------------------------------------------------
+// Key event
+// ----------------------------------------------------------------------
+struct ir_event
+{
+  long     code;                          // key code, repeats carry the code of the held key
+  uint32_t ms;                            // millis() when decoded
+  bool     repeat;
+};
 
 
 // ----------------------------------------------------------------------
 // IRREMOTE Class
 // ----------------------------------------------------------------------
+// A task decodes the receiver and pushes timestamped key events into a
+// single producer, single consumer queue. update() in loop() drains the
+// queue, the jog keys accelerate while held, using the time stamps, and
+// all the jog steps in the queue are applied as one target change.
 class IR_REMOTE
 {
   public:
     IR_REMOTE();
     bool start();
     void update(void);
+    void decode(void);                    // ir task, decode and queue a key event
+
+    String get_stats(void);
+    void reset_stats(void);
     
   private:
+    bool push(long, uint32_t, bool);
+    bool pop(ir_event &);
+    long jogstep(const ir_event &);
+    void apply(long);
+
     int _pin;
     bool _loaded;
+    TaskHandle_t _task = NULL;
+
+    // queue, _head is only written by the ir task and _tail by update()
+    ir_event          _queue[IR_QUEUESIZE];
+    volatile uint32_t _head = 0;
+    volatile uint32_t _tail = 0;
+    long              _lastcode = 0;      // ir task, the code a repeat repeats
+
+    // hold, update()
+    long     _holdcode = 0;
+    uint32_t _holdstart = 0;
+    uint32_t _holdlast = 0;
+
+    // stats
+    volatile uint32_t _dropped = 0;       // queue full
+    uint32_t _events = 0;
+    uint32_t _repeats = 0;
+    uint32_t _updates = 0;                // target changes by jog keys
+    uint32_t _coalesced = 0;              // jog events merged into another target change
+    uint32_t _depth_max = 0;
+    uint32_t _latency_max = 0;            // ms, decode to applied
 };
 
 
@@ -0,0 +1,160 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 JOG CURVE CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// jog_curve.cpp
+// Joystick sample to jog rate and step delay, no Arduino calls
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <stdlib.h>
+#include "jog_curve.h"
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+JOG_CURVE::JOG_CURVE(void)
+{
+
+}
+
+// ----------------------------------------------------------------------
+// find the center and noise, if the stick is not near the expected
+// center the defaults are used
+// ----------------------------------------------------------------------
+bool JOG_CURVE::calibrate(const int *samples, int count)
+{
+  bool ok = false;
+  int32_t total = 0;
+  int lo = JMAXVALUE;
+  int hi = JMINVALUE;
+  for (int i = 0; i < count; i++)
+  {
+    total += samples[i];
+    lo = (samples[i] < lo) ? samples[i] : lo;
+    hi = (samples[i] > hi) ? samples[i] : hi;
+  }
+  int center = (count > 0) ? (total / count) : JZEROPOINT;
+  _noise = (count > 0) ? (hi - lo) : 0;
+  if ( (count == 0) || (abs(center - JZEROPOINT) > JOG_CALRANGE) )
+  {
+    _center   = JZEROPOINT;
+    _deadzone = JTHRESHOLD;
+  }
+  else
+  {
+    _center   = center;
+    _deadzone = _noise * JOG_NOISEMARGIN;
+    _deadzone = (_deadzone < JOG_DEADZONEMIN) ? JOG_DEADZONEMIN : _deadzone;
+    ok = true;
+  }
+  _filtered = (int32_t) _center << JOG_FILTER;
+  _primed = true;
+  _rate = 0;
+  return ok;
+}
+
+// ----------------------------------------------------------------------
+// filter a sample and return the rate
+// once jogging, the rate only returns to 0 inside 3/4 of the deadzone
+// ----------------------------------------------------------------------
+int JOG_CURVE::filter(int sample)
+{
+  if ( _primed == false )
+  {
+    _filtered = (int32_t) sample << JOG_FILTER;
+    _primed = true;
+  }
+  _filtered += sample - (_filtered >> JOG_FILTER);
+  _samples++;
+
+  int deflection = (_filtered >> JOG_FILTER) - _center;
+  int deadzone = (_rate == 0) ? _deadzone : (_deadzone * 3) / 4;
+  int span = (deflection > 0) ? (JMAXVALUE - _center) : (_center - JMINVALUE);
+  int r = rate(deflection, deadzone, span);
+  if ( (_rate == 0) && (r != 0) )
+  {
+    _jogs++;
+  }
+  _rate = r;
+  return r;
+}
+
+// ----------------------------------------------------------------------
+// deflection to rate, 0 inside the deadzone then JOG_MINRATE to
+// JOG_SCALE with the square of the deflection
+// ----------------------------------------------------------------------
+int JOG_CURVE::rate(int deflection, int deadzone, int span)
+{
+  int mag = abs(deflection);
+  if ( (mag <= deadzone) || (span <= deadzone) )
+  {
+    return 0;
+  }
+  int32_t n = ((int32_t) (mag - deadzone) * JOG_SCALE) / (span - deadzone);
+  n = (n > JOG_SCALE) ? JOG_SCALE : n;
+  int32_t r = JOG_MINRATE + (((n * n) / JOG_SCALE) * (JOG_SCALE - JOG_MINRATE)) / JOG_SCALE;
+  return (deflection < 0) ? -r : r;
+}
+
+// ----------------------------------------------------------------------
+// step delay of a jog, the fastest step delay at JOG_SCALE, 0 if not jogging
+// ----------------------------------------------------------------------
+unsigned long JOG_CURVE::stepdelay(unsigned long fastest, int rate)
+{
+  if ( rate == 0 )
+  {
+    return 0;
+  }
+  return (fastest * JOG_SCALE) / abs(rate);
+}
+
+// ignore small changes so the move timer is not rewritten every sample
+bool JOG_CURVE::retime(unsigned long current, unsigned long next)
+{
+  unsigned long change = (next > current) ? (next - current) : (current - next);
+  return (current == 0) || (change > (current / JOG_RETIME));
+}
+
+int JOG_CURVE::get_center(void)
+{
+  return _center;
+}
+
+int JOG_CURVE::get_deadzone(void)
+{
+  return _deadzone;
+}
+
+int JOG_CURVE::get_noise(void)
+{
+  return _noise;
+}
+
+int JOG_CURVE::get_filtered(void)
+{
+  return _filtered >> JOG_FILTER;
+}
+
+int JOG_CURVE::get_rate(void)
+{
+  return _rate;
+}
+
+uint32_t JOG_CURVE::get_samples(void)
+{
+  return _samples;
+}
+
+uint32_t JOG_CURVE::get_jogs(void)
+{
+  return _jogs;
+}
+
+void JOG_CURVE::reset_stats(void)
+{
+  _samples = 0;
+  _jogs    = 0;
+}
@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 JOG CURVE CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// jog_curve.h
+// ----------------------------------------------------------------------
+
+#if !defined(_jog_curve_h_)
+#define _jog_curve_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+// no Arduino calls, so the curve can be built and tested on a host
+#include <stdint.h>
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define JZEROPOINT        1837            // value read when joystick is centered, used if calibration fails
+#define JTHRESHOLD        300             // deadzone used if calibration fails
+#define JMAXVALUE         4095            // maximum value reading of joystick
+#define JMINVALUE         0               // minimum value reading of joystick
+
+#define JOG_FILTER        2               // low pass, each sample moves the output 1/(2^JOG_FILTER) of the way
+#define JOG_CALRANGE      600             // center must be within this of JZEROPOINT
+#define JOG_DEADZONEMIN   80              // smallest deadzone either side of center
+#define JOG_NOISEMARGIN   3               // deadzone is at least this times the calibration noise
+#define JOG_SCALE         1000            // rate is permille of the fastest step rate
+#define JOG_MINRATE       20              // rate just outside the deadzone
+#define JOG_RETIME        32              // a new step delay is used if it differs by more than 1/JOG_RETIME
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// Joystick samples to a jog rate, and a jog rate to a step delay. The
+// center and deadzone come from samples taken with the stick centered.
+// Each sample goes through a low pass filter. Outside the deadzone the
+// rate rises with the square of the deflection, from JOG_MINRATE to
+// JOG_SCALE at full deflection, so small movements give fine control.
+// The deadzone has hysteresis so noise at its edge does not start and
+// stop the motor. JOG_ENGINE does the adc reads.
+class JOG_CURVE
+{
+  public:
+    JOG_CURVE(void);
+
+    bool calibrate(const int *, int);     // samples with the stick centered, false if not centered and the defaults are used
+    int  filter(int);                     // filter a sample, returns the signed rate
+    static int rate(int, int, int);       // deflection, deadzone, span, returns the signed rate
+    static unsigned long stepdelay(unsigned long, int);       // fastest step delay us, rate, returns the jog step delay
+    static bool retime(unsigned long, unsigned long);         // current step delay, new step delay, true if the new one is used
+
+    int  get_center(void);
+    int  get_deadzone(void);
+    int  get_noise(void);
+    int  get_filtered(void);
+    int  get_rate(void);
+    uint32_t get_samples(void);
+    uint32_t get_jogs(void);
+    void reset_stats(void);
+
+  private:
+    int  _center = JZEROPOINT;
+    int  _deadzone = JTHRESHOLD;
+    int  _noise = 0;                      // calibration, max - min
+    int32_t _filtered = 0;                // filter output << JOG_FILTER
+    bool _primed = false;
+    int  _rate = 0;
+    // stats
+    uint32_t _samples = 0;
+    uint32_t _jogs = 0;                   // starts from the deadzone
+};
+
+
+
+#endif // #if !defined(_jog_curve_h_)
@@ -0,0 +1,114 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 JOG ENGINE CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// jog_engine.cpp
+// Joystick axis to jog rate
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "jog_engine.h"
+#include "hal.h"                              // adc
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define JOG_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  JOG_PRINT
+#define JOG_print(...)   Serial.print(__VA_ARGS__)
+#define JOG_println(...) Serial.println(__VA_ARGS__)
+#else
+#define JOG_print(...)
+#define JOG_println(...)
+#endif
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+JOG_ENGINE::JOG_ENGINE(void)
+{
+
+}
+
+// ----------------------------------------------------------------------
+// find the center and noise, if the stick is not near the expected
+// center the defaults are used
+// ----------------------------------------------------------------------
+void JOG_ENGINE::begin(int pin)
+{
+  _pin = pin;
+  int samples[JOG_CALSAMPLES];
+  for (int i = 0; i < JOG_CALSAMPLES; i++)
+  {
+    samples[i] = read();
+    delay(1);
+  }
+  if ( _curve.calibrate(samples, JOG_CALSAMPLES) == false )
+  {
+    ERROR_println("jog: calibration error, joystick not centered");
+  }
+  JOG_print("jog: center ");
+  JOG_print(_curve.get_center());
+  JOG_print(" deadzone ");
+  JOG_println(_curve.get_deadzone());
+}
+
+// average of JOG_OVERSAMPLE reads
+int JOG_ENGINE::read(void)
+{
+  int32_t total = 0;
+  for (int i = 0; i < JOG_OVERSAMPLE; i++)
+  {
+    total += hal_analogread(_pin);
+  }
+  return total / JOG_OVERSAMPLE;
+}
+
+int JOG_ENGINE::update(void)
+{
+  if ( _pin == -1 )
+  {
+    return 0;
+  }
+  unsigned long start = micros();
+  int r = update(read());
+  uint32_t us = micros() - start;
+  _us_max = (us > _us_max) ? us : _us_max;
+  return r;
+}
+
+int JOG_ENGINE::update(int sample)
+{
+  return _curve.filter(sample);
+}
+
+// ----------------------------------------------------------------------
+// calibration, filter output and rate
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String JOG_ENGINE::get_stats(void)
+{
+  String jsonstr = "{ \"center\":" + String(_curve.get_center()) + ", \"deadzone\":" + String(_curve.get_deadzone()) \
+                   + ", \"noise\":" + String(_curve.get_noise()) + ", \"filtered\":" + String(_curve.get_filtered()) \
+                   + ", \"rate\":" + String(_curve.get_rate()) + ", \"samples\":" + String(_curve.get_samples()) \
+                   + ", \"jogs\":" + String(_curve.get_jogs()) + ", \"us_max\":" + String(_us_max) + " }";
+  return jsonstr;
+}
+
+void JOG_ENGINE::reset_stats(void)
+{
+  _curve.reset_stats();
+  _us_max = 0;
+}
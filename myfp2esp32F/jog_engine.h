@@ -0,0 +1,55 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 JOG ENGINE CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// jog_engine.h
+// ----------------------------------------------------------------------
+
+#if !defined(_jog_engine_h_)
+#define _jog_engine_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "jog_curve.h"                        // center, deadzone, filter and rate
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define JOG_OVERSAMPLE    16              // adc reads averaged for each sample
+#define JOG_CALSAMPLES    32              // samples taken at start to find the center and noise
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// Reads a joystick axis and maps it to a jog rate. Each sample is the
+// average of JOG_OVERSAMPLE adc reads. The center and deadzone are
+// measured when the joystick is enabled. The filter and the rate curve
+// are in JOG_CURVE.
+class JOG_ENGINE
+{
+  public:
+    JOG_ENGINE(void);
+
+    void begin(int);                      // adc pin, stick must be centered
+    int  update(void);                    // read and filter, returns the signed rate
+    int  update(int);                     // filter a raw value, returns the signed rate
+
+    String get_stats(void);
+    void reset_stats(void);
+
+  private:
+    int  read(void);
+
+    int  _pin = -1;
+    JOG_CURVE _curve;
+    // stats
+    uint32_t _us_max = 0;                 // sample and filter time
+};
+
+
+
+#endif // #if !defined(_jog_engine_h_)
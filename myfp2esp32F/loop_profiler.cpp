@@ -0,0 +1,100 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 LOOP PROFILER CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// loop_profiler.cpp
+// Latency histograms for the sections of loop()
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "loop_profiler.h"
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+LOOP_PROFILER::LOOP_PROFILER(void)
+{
+  set_mhz(ESP.getCpuFreqMHz());
+}
+
+void LOOP_PROFILER::set_mhz(uint32_t mhz)
+{
+  if ( mhz == 0 )
+  {
+    return;
+  }
+  _mhz = mhz;
+  _nspercycle = (1000UL << 16) / mhz;
+}
+
+// ----------------------------------------------------------------------
+// register a section
+// ----------------------------------------------------------------------
+int LOOP_PROFILER::add(const char *name)
+{
+  if ( _count >= PROF_MAXSECTIONS )
+  {
+    ERROR_print("lp: add section error, no free section: ");
+    ERROR_println(name);
+    return PROF_NOSECTION;
+  }
+  prof_section &s = _sections[_count];
+  memset(&s, 0, sizeof(s));
+  s.name = name;
+  return _count++;
+}
+
+// ----------------------------------------------------------------------
+// upper bound in us of the bucket holding the given fraction of counts
+// ----------------------------------------------------------------------
+float LOOP_PROFILER::percentile(prof_section &s, float fraction)
+{
+  uint32_t target = (uint32_t) (s.count * fraction);
+  uint32_t sum = 0;
+  for (int i = 0; i < PROF_BUCKETS; i++)
+  {
+    sum += s.hist[i];
+    if ( sum > target )
+    {
+      // the top bucket bound is limited to the largest time seen
+      uint64_t bound = ((uint64_t) 2 << i) - 1;
+      bound = (bound > s.max) ? s.max : bound;
+      return (float) bound / 1000.0;
+    }
+  }
+  return (float) s.max / 1000.0;
+}
+
+// ----------------------------------------------------------------------
+// count, p50, p99, max and avg in us of each section
+// Returns a json string - used by Management Server and TCPIP Server
+// ----------------------------------------------------------------------
+String LOOP_PROFILER::get_stats(void)
+{
+  String jsonstr = "{ \"mhz\":" + String(_mhz) + ", \"sections\":[";
+  for (int i = 0; i < _count; i++)
+  {
+    prof_section &s = _sections[i];
+    uint32_t count = (s.count == 0) ? 1 : s.count;
+    jsonstr += (i == 0) ? " " : ", ";
+    jsonstr += "{ \"name\":\"" + String(s.name) + "\", \"count\":" + String(s.count) \
+               + ", \"p50\":" + String(percentile(s, 0.50), 1) + ", \"p99\":" + String(percentile(s, 0.99), 1) \
+               + ", \"max\":" + String((float) s.max / 1000.0, 1) + ", \"avg\":" + String((float) (s.total / count) / 1000.0, 1) + " }";
+  }
+  jsonstr += " ] }";
+  return jsonstr;
+}
+
+void LOOP_PROFILER::reset_stats(void)
+{
+  for (int i = 0; i < _count; i++)
+  {
+    const char *name = _sections[i].name;
+    memset(&_sections[i], 0, sizeof(prof_section));
+    _sections[i].name = name;
+  }
+}
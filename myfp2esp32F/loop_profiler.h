@@ -0,0 +1,90 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 LOOP PROFILER CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// loop_profiler.h
+// ----------------------------------------------------------------------
+
+#if !defined(_loop_profiler_h_)
+#define _loop_profiler_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define PROF_MAXSECTIONS  16
+#define PROF_BUCKETS      32              // bucket n holds times of 2^n to 2^(n+1)-1 ns
+#define PROF_NOSECTION    -1
+
+
+// ----------------------------------------------------------------------
+// SECTION
+// ----------------------------------------------------------------------
+struct prof_section
+{
+  const char *name;
+  uint32_t   count;
+  uint32_t   max;                         // ns
+  uint64_t   total;                       // ns
+  uint32_t   hist[PROF_BUCKETS];
+};
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// Times sections of loop() with the cpu cycle counter. Each section keeps
+// a log2 histogram, so recording a time is a count leading zeros and an
+// increment, and can be left enabled. p50 and p99 are reported as the
+// upper bound of the bucket they fall in. The cycles are converted to ns
+// when recorded with the clock at that time, the power manager calls
+// set_mhz() when it changes the cpu clock.
+class LOOP_PROFILER
+{
+  public:
+    LOOP_PROFILER(void);
+
+    int  add(const char *);               // register a section, returns the section id or PROF_NOSECTION
+    void set_mhz(uint32_t);               // cpu clock changed
+
+    inline uint32_t start(void)
+    {
+      return ESP.getCycleCount();
+    }
+
+    inline void stop(int id, uint32_t start)
+    {
+      uint32_t cycles = ESP.getCycleCount() - start;
+      if ( (id < 0) || (id >= _count) )
+      {
+        return;
+      }
+      uint64_t scaled = ((uint64_t) cycles * _nspercycle) >> 16;
+      uint32_t ns = (scaled > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t) scaled;
+      prof_section &s = _sections[id];
+      s.hist[(ns == 0) ? 0 : 31 - __builtin_clz(ns)]++;
+      s.count++;
+      s.total += ns;
+      s.max = (ns > s.max) ? ns : s.max;
+    }
+
+    String get_stats(void);
+    void reset_stats(void);
+
+  private:
+    float percentile(prof_section &, float);
+
+    prof_section _sections[PROF_MAXSECTIONS];
+    int          _count = 0;
+    uint32_t     _mhz = 240;
+    uint32_t     _nspercycle = (1000UL << 16) / 240;   // ns per cycle, 16.16 fixed point
+};
+
+
+
+#endif // #if !defined(_loop_profiler_h_)
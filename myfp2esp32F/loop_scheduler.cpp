@@ -0,0 +1,211 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 LOOP SCHEDULER CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// loop_scheduler.cpp
+// Polling of pushbuttons, joysticks, infrared remote and the servers
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "loop_scheduler.h"
+#include "loop_profiler.h"
+extern LOOP_PROFILER *looprof;
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define LOOPSCHED_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  LOOPSCHED_PRINT
+#define LOOPSCHED_print(...)   Serial.print(__VA_ARGS__)
+#define LOOPSCHED_println(...) Serial.println(__VA_ARGS__)
+#else
+#define LOOPSCHED_print(...)
+#define LOOPSCHED_println(...)
+#endif
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+LOOP_SCHEDULER::LOOP_SCHEDULER(void)
+{
+
+}
+
+// ----------------------------------------------------------------------
+// register a job, the job stays in its slot, _order is kept in priority
+// order so the id returned stays valid
+// ----------------------------------------------------------------------
+int LOOP_SCHEDULER::add(const char *name, poll_callback callback, byte priority, uint32_t interval_min, uint32_t interval_max, uint32_t budget)
+{
+  if ( _count >= LOOPSCHED_MAXJOBS )
+  {
+    ERROR_print("ls: add job error, no free job: ");
+    ERROR_println(name);
+    return LOOPSCHED_NOJOB;
+  }
+  int id = _count;
+  int i = _count;
+  while ( (i > 0) && (_jobs[_order[i - 1]].priority > priority) )
+  {
+    _order[i] = _order[i - 1];
+    i--;
+  }
+  _order[i] = id;
+  poll_job &job = _jobs[id];
+  memset(&job, 0, sizeof(job));
+  job.name         = name;
+  job.callback     = callback;
+  job.priority     = priority;
+  job.interval_min = interval_min;
+  job.interval_max = (interval_max < interval_min) ? interval_min : interval_max;
+  job.interval     = interval_min;
+  job.budget       = budget;
+  job.last         = micros();
+  job.section      = looprof->add(name);
+  job.enabled      = true;
+  _count++;
+  LOOPSCHED_print("ls: add job ");
+  LOOPSCHED_println(name);
+  return id;
+}
+
+bool LOOP_SCHEDULER::enable(int id, bool state)
+{
+  if ( (id < 0) || (id >= _count) )
+  {
+    return false;
+  }
+  _jobs[id].enabled = state;
+  _jobs[id].last = micros();
+  return true;
+}
+
+bool LOOP_SCHEDULER::set_period(int id, uint32_t interval_min, uint32_t interval_max)
+{
+  if ( (id < 0) || (id >= _count) )
+  {
+    return false;
+  }
+  poll_job &job = _jobs[id];
+  job.interval_min = interval_min;
+  job.interval_max = (interval_max < interval_min) ? interval_min : interval_max;
+  job.interval     = interval_min;
+  return true;
+}
+
+// ----------------------------------------------------------------------
+// run the jobs which are due
+// ----------------------------------------------------------------------
+bool LOOP_SCHEDULER::run(void)
+{
+  uint32_t passstart = micros();
+  bool passactive = false;
+
+  for (int i = 0; i < _count; i++)
+  {
+    poll_job &job = _jobs[_order[i]];
+    if ( job.enabled == false )
+    {
+      continue;
+    }
+    uint32_t now = micros();
+    uint32_t elapsed = now - job.last;
+    if ( elapsed < job.interval )
+    {
+      continue;
+    }
+    uint32_t late = elapsed - job.interval;
+
+    // slice used, put off the job to the next pass unless it would be
+    // over its budget, the highest priority job is never put off
+    if ( (i > 0) && ((now - passstart) > LOOPSCHED_SLICE) && (late < job.budget) )
+    {
+      job.deferred++;
+      continue;
+    }
+
+    uint32_t cycles = looprof->start();
+    bool active = job.callback();
+    looprof->stop(job.section, cycles);
+    uint32_t exec = micros() - now;
+    job.last = now;
+
+    job.runs++;
+    job.exec_total += exec;
+    job.exec_max = (exec > job.exec_max) ? exec : job.exec_max;
+    job.late_max = (late > job.late_max) ? late : job.late_max;
+    if ( late > job.budget )
+    {
+      job.overruns++;
+    }
+
+    // a long poll means a request was handled, even if the job does not report it
+    if ( (active == true) || (exec > LOOPSCHED_ACTIVE) )
+    {
+      job.active++;
+      job.interval = job.interval_min;
+      passactive = true;
+    }
+    else if ( job.interval < job.interval_max )
+    {
+      job.interval = ((job.interval * 2) > job.interval_max) ? job.interval_max : job.interval * 2;
+    }
+  }
+
+  uint32_t pass = micros() - passstart;
+  _pass_max = (pass > _pass_max) ? pass : _pass_max;
+  _passes++;
+  return passactive;
+}
+
+// ----------------------------------------------------------------------
+// polls, activity, service time and lateness of each job, times in us
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String LOOP_SCHEDULER::get_stats(void)
+{
+  String jsonstr = "{ \"passes\":" + String(_passes) + ", \"pass_max\":" + String(_pass_max) + ", \"jobs\":[";
+  for (int i = 0; i < _count; i++)
+  {
+    poll_job &job = _jobs[_order[i]];
+    uint32_t runs = (job.runs == 0) ? 1 : job.runs;
+    jsonstr += (i == 0) ? " " : ", ";
+    jsonstr += "{ \"name\":\"" + String(job.name) + "\", \"id\":" + String(_order[i]) \
+               + ", \"enabled\":" + String((job.enabled == true) ? "true" : "false") \
+               + ", \"priority\":" + String(job.priority) \
+               + ", \"interval\":" + String(job.interval) + ", \"runs\":" + String(job.runs) \
+               + ", \"active\":" + String(job.active) + ", \"exec_max\":" + String(job.exec_max) \
+               + ", \"exec_avg\":" + String(job.exec_total / runs) + ", \"late_max\":" + String(job.late_max) \
+               + ", \"overruns\":" + String(job.overruns) + ", \"deferred\":" + String(job.deferred) + " }";
+  }
+  jsonstr += " ] }";
+  return jsonstr;
+}
+
+void LOOP_SCHEDULER::reset_stats(void)
+{
+  for (int i = 0; i < _count; i++)
+  {
+    _jobs[i].runs       = 0;
+    _jobs[i].active     = 0;
+    _jobs[i].exec_max   = 0;
+    _jobs[i].exec_total = 0;
+    _jobs[i].late_max   = 0;
+    _jobs[i].overruns   = 0;
+    _jobs[i].deferred   = 0;
+  }
+  _passes   = 0;
+  _pass_max = 0;
+}
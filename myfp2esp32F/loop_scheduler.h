@@ -0,0 +1,88 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 LOOP SCHEDULER CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// loop_scheduler.h
+// ----------------------------------------------------------------------
+
+#if !defined(_loop_scheduler_h_)
+#define _loop_scheduler_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define LOOPSCHED_MAXJOBS   10
+#define LOOPSCHED_SLICE     3000          // us, once a pass has run this long only overdue jobs are run
+#define LOOPSCHED_ACTIVE    1000          // us, a poll which takes longer than this did some work
+#define LOOPSCHED_NOJOB     -1
+
+// a poll job returns true if it did some work [client request, key press]
+typedef bool (*poll_callback)(void);
+
+
+// ----------------------------------------------------------------------
+// JOB
+// ----------------------------------------------------------------------
+struct poll_job
+{
+  const char    *name;
+  poll_callback callback;
+  byte          priority;                 // 0 is highest
+  uint32_t      interval;                 // us, current time between polls
+  uint32_t      interval_min;             // us, polled at this rate while active
+  uint32_t      interval_max;             // us, idle jobs back off to this rate, same as min for a fixed rate
+  uint32_t      budget;                   // us, latest a poll can be after it is due
+  uint32_t      last;                     // micros() of the last poll
+  int           section;                  // loop profiler section
+  bool          enabled;
+  // stats
+  uint32_t      runs;
+  uint32_t      active;                   // polls which did some work
+  uint32_t      exec_max;                 // us in the callback
+  uint32_t      exec_total;
+  uint32_t      late_max;                 // us after the poll was due
+  uint32_t      overruns;                 // polls later than the budget
+  uint32_t      deferred;                 // passes the poll was due but put off by higher priority jobs
+};
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// Cooperative scheduler for the polled jobs in loop(), input devices and
+// servers. Jobs are run in priority order when due. Once a pass has used
+// its time slice, lower priority jobs are put off to the next pass unless
+// they would miss their latency budget. Adaptive jobs are polled at
+// interval_min while active and back off towards interval_max when idle.
+class LOOP_SCHEDULER
+{
+  public:
+    LOOP_SCHEDULER(void);
+
+    // register a job, name, callback, priority, interval min us, interval max us, budget us
+    // returns the job id, it does not change when later jobs are added
+    int  add(const char *, poll_callback, byte, uint32_t, uint32_t, uint32_t);
+    bool run(void);                       // call from loop(), returns true if a job was active
+    bool enable(int, bool);               // job id, state
+    bool set_period(int, uint32_t, uint32_t);   // job id, interval min us, interval max us
+
+    String get_stats(void);
+    void reset_stats(void);
+
+  private:
+    poll_job _jobs[LOOPSCHED_MAXJOBS];    // indexed by job id, in the order added
+    int      _order[LOOPSCHED_MAXJOBS];   // job ids in priority order
+    int      _count = 0;
+    uint32_t _passes = 0;
+    uint32_t _pass_max = 0;               // us, longest pass
+};
+
+
+
+#endif // #if !defined(_loop_scheduler_h_)
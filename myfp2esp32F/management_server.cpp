@@ -12,7 +12,20 @@
 #include <Arduino.h>
 #include "controller_config.h"            // includes boarddefs.h and controller_defines.h
 #include <ArduinoJson.h>                  // Benoit Blanchon https://github.com/bblanchon/ArduinoJson
-#include "SPIFFS.h"
+#include "file_system.h"
+#include "task_scheduler.h"
+#include "loop_scheduler.h"
+#include "loop_profiler.h"
+#include "step_recorder.h"
+#include "power_manager.h"
+#include "jog_engine.h"
+#include "push_buttons.h"
+#include "tcp_trace.h"
+#include "focuser_channel.h"
+#include "stall_monitor.h"
+#include "tmc_uart.h"
+#include "tmc_tuner.h"
+#include "hot_bench.h"
 #include <WebServer.h>
 
 
@@ -107,9 +120,18 @@ extern WEB_SERVER *websrvr;
 extern bool display_start(void);
 extern void display_stop();
 extern void display_clear();
+extern String display_get_stats(void);
+extern void display_reset_stats(void);
 extern byte display_status;
 
 
+// ----------------------------------------------------------------------
+// IRREMOTE IS OPTIONAL : USE HELPER FUNCTIONS
+// ----------------------------------------------------------------------
+extern String irremote_get_stats(void);
+extern void irremote_reset_stats(void);
+
+
 // ----------------------------------------------------------------------
 // DUCKDNS IS OPTIONAL : USE HELPER FUNCTIONS
 // ----------------------------------------------------------------------
@@ -122,6 +144,7 @@ extern byte display_status;
 extern void reboot_esp32(int);
 extern long getrssi(void);
 extern void get_systemuptime(void);       // system uptime days:hours:minutes
+extern String get_boottimeline(void);     // boot phase timeline, json
 
 extern const char *OTAName;               // the username and password for the ElegantOTA service
 extern const char *OTAPassword;
@@ -144,10 +167,19 @@ extern int  staticip;
 
 extern bool filesystemloaded;                   // flag indicator for spiffs usage, rather than use SPIFFS.begin() test
 
-extern volatile unsigned int park_maxcount;     // 120s subject to ControllerData->get_parktime()
-extern volatile unsigned int display_maxcount;  // 4s   subject to ControllerData->get_displaypagetime(), default 4 seconds
-extern portMUX_TYPE displaytimeMux;
-extern portMUX_TYPE parkMux;
+// task scheduler
+extern TASK_SCHEDULER *tasksched;
+extern LOOP_SCHEDULER *loopsched;
+extern LOOP_PROFILER *looprof;
+extern STEP_RECORDER *steprec;
+extern POWER_MANAGER *powermgr;
+extern JOG_ENGINE *jogengine;
+extern PUSH_BUTTONS *pbinput;
+extern TCP_TRACE *tcptrace;
+extern FOCUSER_CHANNEL *focuser2;
+extern STALL_MONITOR *stallmon;
+extern TMC_UART *tmcuart;
+extern TMC_TUNER *tmctuner;
 
 // Service states
 extern byte duckdns_status;
@@ -628,6 +660,16 @@ void ms_saveconfig(void)
   mngsrvr->saveconfig();
 }
 
+void ms_steptrace(void)
+{
+  mngsrvr->steptrace();
+}
+
+void ms_tcptrace(void)
+{
+  mngsrvr->sendtcptrace();
+}
+
 //void ms_reboot()
 //{
 //  mngsrvr->reboot();
@@ -709,6 +751,8 @@ bool MANAGEMENT_SERVER::start(unsigned long port)
   mserver->on("/rssi", HTTP_GET, ms_rssi);
   mserver->on("/uri",  ms_geturi);
   mserver->on("/save", ms_saveconfig);
+  mserver->on("/steptrace", ms_steptrace);
+  mserver->on("/tcptrace", ms_tcptrace);
   // not found
   mserver->onNotFound( []()
   {
@@ -776,9 +820,9 @@ bool MANAGEMENT_SERVER::handlefileread(String path)
     path += "index.html";                                 // if a folder is requested, send the index file
   }
   String contentType = get_contenttype(path);             // get the MIME type
-  if ( SPIFFS.exists(path) )                              // if the file exists
+  if ( FILESYS.exists(path) )                              // if the file exists
   {
-    File file = SPIFFS.open(path, "r");                   // open it
+    File file = FILESYS.open(path, "r");                   // open it
     mserver->streamFile(file, contentType);               // and send it to the client
     file.close();                                         // then close the file again
     return true;
@@ -1245,9 +1289,9 @@ void MANAGEMENT_SERVER::getadmin1(void)
     }
   } // end of post handler
 
-  if ( SPIFFS.exists("/admin1.html"))
+  if ( FILESYS.exists("/admin1.html"))
   {
-    File file = SPIFFS.open("/admin1.html", "r");
+    File file = FILESYS.open("/admin1.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -1470,9 +1514,9 @@ void MANAGEMENT_SERVER::getadmin2(void)
 
   } // end of post handler
 
-  if ( SPIFFS.exists("/admin2.html"))
+  if ( FILESYS.exists("/admin2.html"))
   {
-    File file = SPIFFS.open("/admin2.html", "r");
+    File file = FILESYS.open("/admin2.html", "r");
     AdminPg = file.readString();
     file.close();
     AdminPg.replace("%PGT%", devicename);
@@ -1673,10 +1717,6 @@ void MANAGEMENT_SERVER::getadmin3(void)
       pt = (pt <  30) ?   30 : pt;
       pt = (pt > 300) ? 300 : pt;
       ControllerData->set_parktime(pt);
-      // update park_maxcount
-      portENTER_CRITICAL(&parkMux);
-      park_maxcount = pt * 10;                         // convert to timeslices
-      portEXIT_CRITICAL(&parkMux);
     }
 
     // reverse direction rdst on off
@@ -1719,12 +1759,12 @@ void MANAGEMENT_SERVER::getadmin3(void)
     }
   } // end of post handler
 
-  if ( SPIFFS.exists("/admin3.html"))
+  if ( FILESYS.exists("/admin3.html"))
   {
     String msg;
     String tmp;
 
-    File file = SPIFFS.open("/admin3.html", "r");
+    File file = FILESYS.open("/admin3.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -1930,9 +1970,9 @@ void MANAGEMENT_SERVER::getadmin4(void)
 
   } // end of post handler
 
-  if ( SPIFFS.exists("/admin4.html"))
+  if ( FILESYS.exists("/admin4.html"))
   {
-    File file = SPIFFS.open("/admin4.html", "r");
+    File file = FILESYS.open("/admin4.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -2151,9 +2191,9 @@ void MANAGEMENT_SERVER::getadmin5(void)
     }
   } // end of post handler
 
-  if ( SPIFFS.exists("/admin5.html"))
+  if ( FILESYS.exists("/admin5.html"))
   {
-    File file = SPIFFS.open("/admin5.html", "r");
+    File file = FILESYS.open("/admin5.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -2388,9 +2428,9 @@ void MANAGEMENT_SERVER::getadmin6(void)
     }
   } // end of post handler
 
-  if ( SPIFFS.exists("/admin6.html"))
+  if ( FILESYS.exists("/admin6.html"))
   {
-    File file = SPIFFS.open("/admin6.html", "r");
+    File file = FILESYS.open("/admin6.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -2588,10 +2628,6 @@ void MANAGEMENT_SERVER::getadmin7(void)
         pgtime = (pgtime < V_DISPLAYPAGETIMEMIN) ? V_DISPLAYPAGETIMEMIN : pgtime;
         pgtime = (pgtime > V_DISPLAYPAGETIMEMAX) ? V_DISPLAYPAGETIMEMAX : pgtime;
         ControllerData->set_displaypagetime(pgtime);
-        // update display_maxcount
-        portENTER_CRITICAL(&displaytimeMux);
-        display_maxcount = pgtime * 10;                         // convert to timeslices
-        portEXIT_CRITICAL(&displaytimeMux);
       }
     }
 
@@ -2696,9 +2732,9 @@ void MANAGEMENT_SERVER::getadmin7(void)
     }
   } // end of post handler
 
-  if ( SPIFFS.exists("/admin7.html"))
+  if ( FILESYS.exists("/admin7.html"))
   {
-    File file = SPIFFS.open("/admin7.html", "r");
+    File file = FILESYS.open("/admin7.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -2992,9 +3028,9 @@ void MANAGEMENT_SERVER::getadmin8(void)
 
 Get_Handler:
 
-  if ( SPIFFS.exists("/admin8.html"))
+  if ( FILESYS.exists("/admin8.html"))
   {
-    File file = SPIFFS.open("/admin8.html", "r");
+    File file = FILESYS.open("/admin8.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -3322,9 +3358,9 @@ void MANAGEMENT_SERVER::getadmin9(void)
     }
   } // end of post handler
 
-  if ( SPIFFS.exists("/admin9.html"))
+  if ( FILESYS.exists("/admin9.html"))
   {
-    File file = SPIFFS.open("/admin9.html", "r");
+    File file = FILESYS.open("/admin9.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -3487,10 +3523,10 @@ void MANAGEMENT_SERVER::post_deletefile()
     }
 
     // load the deleteok.html file
-    if ( SPIFFS.exists("/deleteok.html"))
+    if ( FILESYS.exists("/deleteok.html"))
     {
       // open file for read
-      File file = SPIFFS.open("/deleteok.html", "r");
+      File file = FILESYS.open("/deleteok.html", "r");
       // read contents into string
       AdminPg = file.readString();
       file.close();
@@ -3517,9 +3553,9 @@ void MANAGEMENT_SERVER::post_deletefile()
       get_systemuptime();
       AdminPg.replace("%SUT%", systemuptime);
 
-      if ( SPIFFS.exists(df))
+      if ( FILESYS.exists(df))
       {
-        if ( SPIFFS.remove(df))
+        if ( FILESYS.remove(df))
         {
           AdminPg.replace("%STA%", "deleted.");
         }
@@ -3533,7 +3569,7 @@ void MANAGEMENT_SERVER::post_deletefile()
         AdminPg.replace("%STA%", "does not exist.");
       }
     }
-    else // if ( SPIFFS.exists("/deleteok.html"))
+    else // if ( FILESYS.exists("/deleteok.html"))
     {
       ERROR_println("spiffs file deleteok.html did not exist");
       AdminPg = "<html><head><title>Management Server</title></head><body><p>deleteok.html not found</p><p><form action=\"/\" method=\"GET\"><input type=\"submit\" value=\"HOMEPAGE\"></form></p></body></html>";
@@ -3567,9 +3603,9 @@ void MANAGEMENT_SERVER::get_deletefile()
 
   MNGTSRVR_println("get /delete");
 
-  if ( SPIFFS.exists("/delete.html") )
+  if ( FILESYS.exists("/delete.html") )
   {
-    File file = SPIFFS.open("/delete.html", "r");
+    File file = FILESYS.open("/delete.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -3621,7 +3657,7 @@ void MANAGEMENT_SERVER::get_filelist_short(void)
 
   // format looks like [] array of {"type":"file","name":"admin2.html"}
   // example code taken from FSBrowser
-  File root = SPIFFS.open(path);
+  File root = FILESYS.open(path);
   path = String();
 
   String output = "";
@@ -3663,7 +3699,7 @@ void MANAGEMENT_SERVER::get_filelist_long(void)
     return;
   }
 
-  File root = SPIFFS.open(path);
+  File root = FILESYS.open(path);
   path = String();
 
   String output = "{[";
@@ -3714,12 +3750,12 @@ void MANAGEMENT_SERVER::get_notfound(void)
 
     // get type of file
     String contenttype = get_contenttype(p);        // get the MIME type
-    if ( SPIFFS.exists( p ) )
+    if ( FILESYS.exists( p ) )
     {
       MNGTSRVR_print("File: ");
       MNGTSRVR_print(p);
       MNGTSRVR_println(" exists");
-      File file = SPIFFS.open(p, "r");
+      File file = FILESYS.open(p, "r");
       AdminPg = file.readString();
       file.close();
       if ( AdminPg[0] == '{' )
@@ -3741,10 +3777,10 @@ void MANAGEMENT_SERVER::get_notfound(void)
     else
     {
       // file definately does not exist, so use notfound html file
-      if ( SPIFFS.exists("/adminnotfound.html"))
+      if ( FILESYS.exists("/adminnotfound.html"))
       {
         // open file for read
-        File file = SPIFFS.open("/adminnotfound.html", "r");
+        File file = FILESYS.open("/adminnotfound.html", "r");
         // read contents into string
         AdminPg = file.readString();
         file.close();
@@ -3818,10 +3854,10 @@ void MANAGEMENT_SERVER::saveconfig(void)
     String AdminPg;
     AdminPg.reserve(3000);                                    // 300 		2047
 
-    if ( SPIFFS.exists("/configsaved.html"))
+    if ( FILESYS.exists("/configsaved.html"))
     {
       // open file for read
-      File file = SPIFFS.open("/configsaved.html", "r");
+      File file = FILESYS.open("/configsaved.html", "r");
       // read contents into string
       AdminPg = file.readString();
       file.close();
@@ -3863,10 +3899,10 @@ void MANAGEMENT_SERVER::saveconfig(void)
     String AdminPg;
     AdminPg.reserve(3000);                                    // 300 		2049
 
-    if ( SPIFFS.exists("/confignotsaved.html"))
+    if ( FILESYS.exists("/confignotsaved.html"))
     {
       // open file for read
-      File file = SPIFFS.open("/confignotsaved.html", "r");
+      File file = FILESYS.open("/confignotsaved.html", "r");
       // read contents into string
       AdminPg = file.readString();
       file.close();
@@ -3921,9 +3957,9 @@ void MANAGEMENT_SERVER::upload_file(void)
 
   MNGTSRVR_println("get /upload");
 
-  if ( SPIFFS.exists("/upload.html"))
+  if ( FILESYS.exists("/upload.html"))
   {
-    File file = SPIFFS.open("/upload.html", "r");
+    File file = FILESYS.open("/upload.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -3998,7 +4034,7 @@ void MANAGEMENT_SERVER::post_uploadfile(void)
     }
     MNGTSRVR_print("handleFileUpload Name: ");
     MNGTSRVR_println(filename);
-    _fsUploadFile = SPIFFS.open(filename, "w");
+    _fsUploadFile = FILESYS.open(filename, "w");
     filename = String();
   }
   else if (upload.status == UPLOAD_FILE_WRITE)
@@ -4043,9 +4079,9 @@ void MANAGEMENT_SERVER::success(void)
 
   MNGTSRVR_println("get /success");
 
-  if ( SPIFFS.exists("/success.html"))
+  if ( FILESYS.exists("/success.html"))
   {
-    File file = SPIFFS.open("/success.html", "r");
+    File file = FILESYS.open("/success.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -4098,9 +4134,9 @@ void MANAGEMENT_SERVER::fail(void)
 
   MNGTSRVR_println("get /fail");
 
-  if ( SPIFFS.exists("/fail.html"))
+  if ( FILESYS.exists("/fail.html"))
   {
-    File file = SPIFFS.open("/fail.html", "r");
+    File file = FILESYS.open("/fail.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -4156,9 +4192,9 @@ void MANAGEMENT_SERVER::handlecmds(void)
   String AdminPg;
   AdminPg.reserve(7000);				// 300 		6756
 
-  if ( SPIFFS.exists("/cmds.html"))
+  if ( FILESYS.exists("/cmds.html"))
   {
-    File file = SPIFFS.open("/cmds.html", "r");
+    File file = FILESYS.open("/cmds.html", "r");
     AdminPg = file.readString();
     file.close();
 
@@ -4244,17 +4280,46 @@ void MANAGEMENT_SERVER::handleget(void)
   // get?boardconfig=
   else if ( mserver->argName(0) == "boardconfig" )
   {
-    // Problem: this is the file. If var was just set then after 30s it
-    // is written to file. We are not reading from cache
-    File bfile = SPIFFS.open("/board_config.jsn", "r");
-    if (!bfile)
+    // config is held as a binary image, export the cached values as json
+    jsonstr = ControllerData->get_boardconfig_json();
+    send_json(jsonstr);
+    return;
+  }
+  // get?boottime=
+  else if ( mserver->argName(0) == "boottime" )
+  {
+    // boot timeline, the time each boot phase ended and its duration
+    jsonstr = get_boottimeline();
+    send_json(jsonstr);
+    return;
+  }
+  // get?cfgloadtime=
+  else if ( mserver->argName(0) == "cfgloadtime" )
+  {
+    // compare json and binary config load times
+    jsonstr = ControllerData->ConfigLoadBenchmark();
+    send_json(jsonstr);
+    return;
+  }
+  // get?cfgsavestats=
+  else if ( mserver->argName(0) == "cfgsavestats" )
+  {
+    // save count and bytes written for each config image
+    jsonstr = ControllerData->get_cfgsave_stats();
+    send_json(jsonstr);
+    return;
+  }
+  // get?fsbench=
+  else if ( mserver->argName(0) == "fsbench" )
+  {
+    // file system timings, writes scratch files so not while moving
+    if ( isMoving == true )
     {
-      jsonstr = "{ \"err\":\"unable to read file\" }";
+      jsonstr = "{ \"fsbench\":\"focuser moving\" }";
     }
     else
     {
-      jsonstr = bfile.readString();
-      bfile.close();
+      jsonstr = fs_benchmark();
     }
     send_json(jsonstr);
     return;
@@ -4276,18 +4341,8 @@ void MANAGEMENT_SERVER::handleget(void)
   // get?cntlrconfig=
   else if ( mserver->argName(0) == "cntlrconfig" )
   {
-    // Problem: this is the file. If var was just set then after 30s it
-    // is written to file. We are not reading from cache
-    File bfile = SPIFFS.open("/cntlr_config.jsn", "r");
-    if (!bfile)
-    {
-      jsonstr = "{ \"err\":\"unable to read file\" }";
-    }
-    else
-    {
-      jsonstr = bfile.readString();
-      bfile.close();
-    }
+    // config is held as a binary image, export the cached values as json
+    jsonstr = ControllerData->get_cntlrconfig_json();
     send_json(jsonstr);
     return;
   }
@@ -4313,6 +4368,14 @@ void MANAGEMENT_SERVER::handleget(void)
     send_json(jsonstr);
     return;
   }
+  // get?displaystats=
+  else if ( mserver->argName(0) == "displaystats" )
+  {
+    // bytes sent and time per display refresh
+    jsonstr = display_get_stats();
+    send_json(jsonstr);
+    return;
+  }
   // get?fixedstepmode=
   else if ( mserver->argName(0) == "fixedstepmode" )
   {
@@ -4320,6 +4383,14 @@ void MANAGEMENT_SERVER::handleget(void)
     send_json(jsonstr);
     return;
   }
+  // get?focuser2=
+  else if ( mserver->argName(0) == "focuser2" )
+  {
+    // position and moves of the second focuser
+    jsonstr = (focuser2 != NULL) ? focuser2->get_stats() : "{ \"focuser2\":\"not enabled\" }";
+    send_json(jsonstr);
+    return;
+  }
   // get?hpsw=
   else if ( mserver->argName(0) == "hpsw" )
   {
@@ -4342,6 +4413,29 @@ void MANAGEMENT_SERVER::handleget(void)
     send_json(jsonstr);
     return;
   }
+  // get?hotbench=
+  else if ( mserver->argName(0) == "hotbench" )
+  {
+    // ns per op of the reply, template and json functions
+    if ( isMoving == true )
+    {
+      jsonstr = "{ \"hotbench\":\"focuser moving\" }";
+    }
+    else
+    {
+      jsonstr = hot_benchmark();
+    }
+    send_json(jsonstr);
+    return;
+  }
+  // get?irstats=
+  else if ( mserver->argName(0) == "irstats" )
+  {
+    // infra red key events, queue depth and latency
+    jsonstr = irremote_get_stats();
+    send_json(jsonstr);
+    return;
+  }
   // get?ismoving=
   else if ( mserver->argName(0) == "ismoving" )
   {
@@ -4349,6 +4443,14 @@ void MANAGEMENT_SERVER::handleget(void)
     send_json(jsonstr);
     return;
   }
+  // get?jog=
+  else if ( mserver->argName(0) == "jog" )
+  {
+    // joystick calibration, filtered axis value and jog rate
+    jsonstr = jogengine->get_stats();
+    send_json(jsonstr);
+    return;
+  }
   // get?leds=
   else if ( mserver->argName(0) == "leds" )
   {
@@ -4371,6 +4473,22 @@ void MANAGEMENT_SERVER::handleget(void)
     send_json(jsonstr);
     return;
   }
+  // get?loopprofile=
+  else if ( mserver->argName(0) == "loopprofile" )
+  {
+    // p50, p99 and max time of each section of loop()
+    jsonstr = looprof->get_stats();
+    send_json(jsonstr);
+    return;
+  }
+  // get?loopstats=
+  else if ( mserver->argName(0) == "loopstats" )
+  {
+    // poll rate, activity, service time and lateness of the loop scheduler jobs
+    jsonstr = loopsched->get_stats();
+    send_json(jsonstr);
+    return;
+  }
   // get?motorspeed=
   else if ( mserver->argName(0) == "motorspeed" )
   {
@@ -4393,6 +4511,14 @@ void MANAGEMENT_SERVER::handleget(void)
     send_json(jsonstr);
     return;
   }
+  // get?pbstats=
+  else if ( mserver->argName(0) == "pbstats" )
+  {
+    // pushbutton jog curve, edges, presses, holds and rejected bounces
+    jsonstr = pbinput->get_stats();
+    send_json(jsonstr);
+    return;
+  }
   // get?position=
   else if ( mserver->argName(0) == "position" )
   {
@@ -4402,6 +4528,14 @@ void MANAGEMENT_SERVER::handleget(void)
     send_json(jsonstr);
     return;
   }
+  // get?power=
+  else if ( mserver->argName(0) == "power" )
+  {
+    // power save state, time in low power and wake to first step latency
+    jsonstr = powermgr->get_stats();
+    send_json(jsonstr);
+    return;
+  }
   // get?reverse=
   else if ( mserver->argName(0) == "reverse" )
   {
@@ -4424,6 +4558,14 @@ void MANAGEMENT_SERVER::handleget(void)
     send_json(jsonstr);
     return;
   }
+  // get?steprec=
+  else if ( mserver->argName(0) == "steprec" )
+  {
+    // step interval jitter of the last recorded move
+    jsonstr = steprec->get_stats();
+    send_json(jsonstr);
+    return;
+  }
   // get?stepmode=
   else if ( mserver->argName(0) == "stepmode" )
   {
@@ -4431,6 +4573,30 @@ void MANAGEMENT_SERVER::handleget(void)
     send_json(jsonstr);
     return;
   }
+  // get?stallmon=
+  else if ( mserver->argName(0) == "stallmon" )
+  {
+    // live StallGuard4 baselines, stalls and calibration
+    jsonstr = stallmon->get_stats();
+    send_json(jsonstr);
+    return;
+  }
+  // get?tmcuart=
+  else if ( mserver->argName(0) == "tmcuart" )
+  {
+    // tmc driver writes, skipped writes, reads and uart errors
+    jsonstr = tmcuart->get_stats();
+    send_json(jsonstr);
+    return;
+  }
+  // get?tmctuner=
+  else if ( mserver->argName(0) == "tmctuner" )
+  {
+    // chopper switch speed, hold current, CoolStep and DRV_STATUS temperature flags
+    jsonstr = tmctuner->get_stats();
+    send_json(jsonstr);
+    return;
+  }
   // get?stallguard=
   else if ( mserver->argName(0) == "stallguard" )
   {
@@ -4481,6 +4647,14 @@ void MANAGEMENT_SERVER::handleget(void)
     send_json(jsonstr);
     return;
   }
+  // get?taskstats=
+  else if ( mserver->argName(0) == "taskstats" )
+  {
+    // run count, lateness and execution time of the task scheduler jobs
+    jsonstr = tasksched->get_stats();
+    send_json(jsonstr);
+    return;
+  }
   // get?tcpipserver=
   else if ( mserver->argName(0) == "tcpipserver" )
   {
@@ -4505,6 +4679,14 @@ void MANAGEMENT_SERVER::handleget(void)
     send_json(jsonstr);
     return;
   }
+  // get?tcptrace=
+  else if ( mserver->argName(0) == "tcptrace" )
+  {
+    // capture state of the tcp/ip server trace
+    jsonstr = tcptrace->get_stats();
+    send_json(jsonstr);
+    return;
+  }
   // get?tmc2209current=
   else if ( mserver->argName(0) == "tmc2209current" )
   {
@@ -4630,6 +4812,22 @@ void MANAGEMENT_SERVER::handleset(void)
     return;
   }
 
+  // cntlrconfig, import a controller config json (as exported by get?cntlrconfig)
+  va = mserver->arg("cntlrconfig");
+  if ( va != "" )
+  {
+    if ( ControllerData->ImportCntlrConfigJson(va) == true )
+    {
+      jsonstr = "{ \"cntlrconfig\":\"imported\" }";
+    }
+    else
+    {
+      jsonstr = "{ \"cntlrconfig\":\"error\" }";
+    }
+    send_json(jsonstr);
+    return;
+  }
+
   // coilpower
   va = mserver->arg("coilpower");
   if ( va != "" )
@@ -4705,6 +4903,19 @@ void MANAGEMENT_SERVER::handleset(void)
     return;
   }
 
+  // display refresh stats, set?displaystats=reset
+  va = mserver->arg("displaystats");
+  if ( va != "" )
+  {
+    if ( va == "reset" )
+    {
+      display_reset_stats();
+    }
+    jsonstr = "{ \"displaystats\":\"" + va + "\" }";
+    send_json(jsonstr);
+    return;
+  }
+
   // fixedstepmode for uln2003, l298n, l293d-mini etc
   va = mserver->arg("fixedstepmode");
   if ( va != "" )
@@ -4772,6 +4983,59 @@ void MANAGEMENT_SERVER::handleset(void)
     return;
   }
 
+  // hot path benchmark, set?hotbench=baseline stores the results to compare with
+  va = mserver->arg("hotbench");
+  if ( va != "" )
+  {
+    if ( va == "baseline" )
+    {
+      if ( isMoving == true )
+      {
+        jsonstr = "{ \"hotbench\":\"focuser moving\" }";
+      }
+      else if ( hot_benchmark_baseline() == true )
+      {
+        jsonstr = "{ \"hotbench\":\"baseline\" }";
+      }
+      else
+      {
+        jsonstr = "{ \"error\":\"baseline not saved\" }";
+      }
+    }
+    else
+    {
+      jsonstr = "{ \"error\":\"unknown\" }";
+    }
+    send_json(jsonstr);
+    return;
+  }
+
+  // infra red remote stats, set?irstats=reset
+  va = mserver->arg("irstats");
+  if ( va != "" )
+  {
+    if ( va == "reset" )
+    {
+      irremote_reset_stats();
+    }
+    jsonstr = "{ \"irstats\":\"" + va + "\" }";
+    send_json(jsonstr);
+    return;
+  }
+
+  // joystick jog stats, set?jog=reset
+  va = mserver->arg("jog");
+  if ( va != "" )
+  {
+    if ( va == "reset" )
+    {
+      jogengine->reset_stats();
+    }
+    jsonstr = "{ \"jog\":\"" + va + "\" }";
+    send_json(jsonstr);
+    return;
+  }
+
   // leds in out enable
   va = mserver->arg("leds");
   if ( va != "" )
@@ -4822,6 +5086,32 @@ void MANAGEMENT_SERVER::handleset(void)
     return;
   }
 
+  // loop profiler histograms, set?loopprofile=reset
+  va = mserver->arg("loopprofile");
+  if ( va != "" )
+  {
+    if ( va == "reset" )
+    {
+      looprof->reset_stats();
+    }
+    jsonstr = "{ \"loopprofile\":\"" + va + "\" }";
+    send_json(jsonstr);
+    return;
+  }
+
+  // loop scheduler stats, set?loopstats=reset
+  va = mserver->arg("loopstats");
+  if ( va != "" )
+  {
+    if ( va == "reset" )
+    {
+      loopsched->reset_stats();
+    }
+    jsonstr = "{ \"loopstats\":\"" + va + "\" }";
+    send_json(jsonstr);
+    return;
+  }
+
   // motorspeed
   va = mserver->arg("motorspeed");
   if ( va != "" )
@@ -4892,15 +5182,44 @@ void MANAGEMENT_SERVER::handleset(void)
     pt = (pt <   0) ?   0 : pt;
     pt = (pt > 600) ? 600 : pt;
     ControllerData->set_parktime(pt);
-    // update park_maxcount
-    portENTER_CRITICAL(&parkMux);
-    park_maxcount = pt * 10;                         // convert to timeslices
-    portEXIT_CRITICAL(&parkMux);
     jsonstr = "{ \"parktime\":" + String(pt) + " }";
     send_json(jsonstr);
     return;
   }
 
+  // pushbutton jog curve, set?pbjogmin=20 permille at the start of a hold
+  va = mserver->arg("pbjogmin");
+  if ( va != "" )
+  {
+    pbinput->set_curve(va.toInt(), pbinput->get_ramptime());
+    jsonstr = "{ \"pbjogmin\":" + String(pbinput->get_jogmin()) + " }";
+    send_json(jsonstr);
+    return;
+  }
+
+  // pushbutton jog curve, set?pbramptime=3000 ms to the full jog rate
+  va = mserver->arg("pbramptime");
+  if ( va != "" )
+  {
+    pbinput->set_curve(pbinput->get_jogmin(), va.toInt());
+    jsonstr = "{ \"pbramptime\":" + String(pbinput->get_ramptime()) + " }";
+    send_json(jsonstr);
+    return;
+  }
+
+  // pushbutton stats, set?pbstats=reset
+  va = mserver->arg("pbstats");
+  if ( va != "" )
+  {
+    if ( va == "reset" )
+    {
+      pbinput->reset_stats();
+    }
+    jsonstr = "{ \"pbstats\":\"" + va + "\" }";
+    send_json(jsonstr);
+    return;
+  }
+
   // position - does not move focuser
   va = mserver->arg("position");
   if ( va != "" )
@@ -4916,6 +5235,27 @@ void MANAGEMENT_SERVER::handleset(void)
     return;
   }
 
+  // power save, set?powersave=on|off, set?powersave=reset clears the stats
+  va = mserver->arg("powersave");
+  if ( va != "" )
+  {
+    if ( va == "on" )
+    {
+      powermgr->set_enable(true);
+    }
+    else if ( va == "off" )
+    {
+      powermgr->set_enable(false);
+    }
+    else if ( va == "reset" )
+    {
+      powermgr->reset_stats();
+    }
+    jsonstr = "{ \"powersave\":\"" + va + "\" }";
+    send_json(jsonstr);
+    return;
+  }
+
   // reverse direction
   va = mserver->arg("reverse");
   if ( va != "" )
@@ -5001,6 +5341,143 @@ void MANAGEMENT_SERVER::handleset(void)
     return;
   }
 
+  // stall monitor, set?stallmon=on|off|calibrate|rehome|trust|reset
+  va = mserver->arg("stallmon");
+  if ( va != "" )
+  {
+    if ( va == "on" )
+    {
+      stallmon->set_enable(true);
+    }
+    else if ( va == "off" )
+    {
+      stallmon->set_enable(false);
+    }
+    else if ( va == "calibrate" )
+    {
+      if ( stallmon->calibrate() == false )
+      {
+        send_json("{ \"stallmon\":\"moving or not a TMC2209\" }");
+        return;
+      }
+    }
+    else if ( va == "rehome" )
+    {
+      stallmon->rehome();
+    }
+    else if ( va == "trust" )
+    {
+      stallmon->set_trusted();
+    }
+    else if ( va == "reset" )
+    {
+      stallmon->reset_stats();
+    }
+    jsonstr = stallmon->get_stats();
+    send_json(jsonstr);
+    return;
+  }
+
+  // tmc uart stats, set?tmcuart=reset
+  va = mserver->arg("tmcuart");
+  if ( va != "" )
+  {
+    if ( va == "reset" )
+    {
+      tmcuart->reset_stats();
+    }
+    jsonstr = tmcuart->get_stats();
+    send_json(jsonstr);
+    return;
+  }
+
+  // tmc tuner, set?tmctuner=on|off|reset
+  va = mserver->arg("tmctuner");
+  if ( va != "" )
+  {
+    if ( va == "on" )
+    {
+      tmctuner->set_enable(true);
+    }
+    else if ( va == "off" )
+    {
+      tmctuner->set_enable(false);
+    }
+    else if ( va == "reset" )
+    {
+      tmctuner->reset_stats();
+    }
+    jsonstr = tmctuner->get_stats();
+    send_json(jsonstr);
+    return;
+  }
+
+  // tmc tuner, steps per second above which SpreadCycle is used, 0 is StealthChop only
+  va = mserver->arg("tmcswitch");
+  if ( va != "" )
+  {
+    jsonstr = (tmctuner->set_switchsps(va.toInt()) == true) ? tmctuner->get_stats() : "{ \"tmcswitch\":\"range 0-20000\" }";
+    send_json(jsonstr);
+    return;
+  }
+
+  // tmc tuner, idle hold current % of the run current
+  va = mserver->arg("tmchold");
+  if ( va != "" )
+  {
+    jsonstr = (tmctuner->set_holdpct(va.toInt()) == true) ? tmctuner->get_stats() : "{ \"tmchold\":\"range 0-100\" }";
+    send_json(jsonstr);
+    return;
+  }
+
+  // tmc tuner, ms after a move before the hold current is reduced
+  va = mserver->arg("tmcholddelay");
+  if ( va != "" )
+  {
+    jsonstr = (tmctuner->set_holddelay(va.toInt()) == true) ? tmctuner->get_stats() : "{ \"tmcholddelay\":\"range 0-600000\" }";
+    send_json(jsonstr);
+    return;
+  }
+
+  // tmc tuner, CoolStep semin [0 is off] and semax
+  va = mserver->arg("tmcsemin");
+  if ( va != "" )
+  {
+    jsonstr = (tmctuner->set_semin(va.toInt()) == true) ? tmctuner->get_stats() : "{ \"tmcsemin\":\"range 0-15\" }";
+    send_json(jsonstr);
+    return;
+  }
+  va = mserver->arg("tmcsemax");
+  if ( va != "" )
+  {
+    jsonstr = (tmctuner->set_semax(va.toInt()) == true) ? tmctuner->get_stats() : "{ \"tmcsemax\":\"range 0-15\" }";
+    send_json(jsonstr);
+    return;
+  }
+
+  // step interval recorder, set?steprec=arm records the next move
+  va = mserver->arg("steprec");
+  if ( va != "" )
+  {
+    if ( va == "arm" )
+    {
+      if ( steprec->arm() == true )
+      {
+        jsonstr = "{ \"steprec\":\"armed\" }";
+      }
+      else
+      {
+        jsonstr = "{ \"error\":\"not armed\" }";
+      }
+    }
+    else
+    {
+      jsonstr = "{ \"error\":\"unknown\" }";
+    }
+    send_json(jsonstr);
+    return;
+  }
+
   // stepmode
   va = mserver->arg("stepmode");
   if ( va != "" )
@@ -5013,6 +5490,19 @@ void MANAGEMENT_SERVER::handleset(void)
     return;
   }
 
+  // task scheduler stats, set?taskstats=reset
+  va = mserver->arg("taskstats");
+  if ( va != "" )
+  {
+    if ( va == "reset" )
+    {
+      tasksched->reset_stats();
+    }
+    jsonstr = "{ \"taskstats\":\"" + va + "\" }";
+    send_json(jsonstr);
+    return;
+  }
+
   // tcpip server
   va = mserver->arg("tcpipserver");
   if ( va != "" )
@@ -5054,6 +5544,34 @@ void MANAGEMENT_SERVER::handleset(void)
     return;
   }
 
+  // tcp/ip server trace, set?tcptrace=start|stop, download from /tcptrace
+  va = mserver->arg("tcptrace");
+  if ( va != "" )
+  {
+    if ( va == "start" )
+    {
+      if ( tcptrace->start() == true )
+      {
+        jsonstr = "{ \"tcptrace\":\"capturing\" }";
+      }
+      else
+      {
+        jsonstr = "{ \"error\":\"not started\" }";
+      }
+    }
+    else if ( va == "stop" )
+    {
+      tcptrace->stop();
+      jsonstr = "{ \"tcptrace\":\"stopped\" }";
+    }
+    else
+    {
+      jsonstr = "{ \"error\":\"unknown\" }";
+    }
+    send_json(jsonstr);
+    return;
+  }
+
   va = mserver->arg("tcpipport");
   if ( va != "" )
   {
@@ -5244,6 +5762,75 @@ void MANAGEMENT_SERVER::rssi(void)
 }
 
 
+// ----------------------------------------------------------------------
+// void steptrace(void);
+// download the step intervals of the last recorded move as csv
+// ----------------------------------------------------------------------
+void MANAGEMENT_SERVER::steptrace(void)
+{
+  if ( this->_loaded == false )
+  {
+    not_loaded();
+    return;
+  }
+  if ( steprec->get_active() == true )
+  {
+    send_json("{ \"error\":\"recording\" }");
+    return;
+  }
+
+  // sent in blocks, the trace can be STEPREC_SIZE lines
+  int count = steprec->get_tracecount();
+  uint32_t mhz = steprec->get_mhz();
+  mserver->sendHeader("Content-Disposition", "attachment; filename=steptrace.csv");
+  mserver->setContentLength(CONTENT_LENGTH_UNKNOWN);
+  mserver->send(NORMALWEBPAGE, "text/csv", "step,cycles,us\n");
+  String block = "";
+  for (int i = 0; i < count; i++)
+  {
+    uint32_t cycles = steprec->get_trace(i);
+    block += String(i) + "," + String(cycles) + "," + String((float) cycles / mhz, 2) + "\n";
+    if ( (i % 64) == 63 )
+    {
+      mserver->sendContent(block);
+      block = "";
+    }
+  }
+  if ( block != "" )
+  {
+    mserver->sendContent(block);
+  }
+  mserver->sendContent("");
+}
+
+// ----------------------------------------------------------------------
+// void sendtcptrace(void);
+// send the tcp/ip server trace file, stop the capture first
+// ----------------------------------------------------------------------
+void MANAGEMENT_SERVER::sendtcptrace(void)
+{
+  if ( this->_loaded == false )
+  {
+    not_loaded();
+    return;
+  }
+  if ( tcptrace->get_active() == true )
+  {
+    send_json("{ \"error\":\"capturing\" }");
+    return;
+  }
+  if ( (filesystemloaded == false) || (FILESYS.exists(TCPTRACE_FILE) == false) )
+  {
+    send_json("{ \"error\":\"no trace\" }");
+    return;
+  }
+  File file = FILESYS.open(TCPTRACE_FILE, "r");
+  mserver->sendHeader("Content-Disposition", "attachment; filename=tcptrace.bin");
+  mserver->streamFile(file, "application/octet-stream");
+  file.close();
+}
+
+
 // ----------------------------------------------------------------------
 // void reboot(void);
 // reboot controller
@@ -5360,20 +5947,20 @@ void MANAGEMENT_SERVER::brdedit()
       MNGTSRVR_println(brdfile);
 
       // if board file exists then remove it
-      if ( SPIFFS.exists(brdfile))
+      if ( FILESYS.exists(brdfile))
       {
         // delete existing custom file
         MNGTSRVR_print("ms: brd ");
         MNGTSRVR_print(brdfile);
         MNGTSRVR_println(" file exists, deleting old file");
-        SPIFFS.remove(brdfile);
+        FILESYS.remove(brdfile);
       }
 
       // now write the board config file
       MNGTSRVR_print("ms: update board file ");
       MNGTSRVR_print(brdfile);
       MNGTSRVR_println(" with new data");
-      File bfile = SPIFFS.open(brdfile, "w");
+      File bfile = FILESYS.open(brdfile, "w");
       if (!bfile)
       {
         ERROR_print("ms: brdsave error: file not opened for writing: ");
@@ -5410,9 +5997,9 @@ void MANAGEMENT_SERVER::brdedit()
   }
 
   // get handler
-  if ( SPIFFS.exists("/brdedit.html"))
+  if ( FILESYS.exists("/brdedit.html"))
   {
-    File file = SPIFFS.open("/brdedit.html", "r");
+    File file = FILESYS.open("/brdedit.html", "r");
     AdminPg = file.readString();
     file.close();
 
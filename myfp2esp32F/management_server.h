@@ -10,7 +10,7 @@
 // ----------------------------------------------------------------------
 #include <Arduino.h>
 #include <ArduinoJson.h>                                // Benoit Blanchon https://github.com/bblanchon/ArduinoJson
-#include "SPIFFS.h"
+#include "file_system.h"
 #include <WebServer.h>
 
 
@@ -64,6 +64,8 @@ class MANAGEMENT_SERVER
     void rssi(void);
     void reboot(void);
     void saveconfig(void);
+    void steptrace(void);
+    void sendtcptrace(void);
 
   private:
     bool check_access(void);
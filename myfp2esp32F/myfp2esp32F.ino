@@ -120,7 +120,7 @@
 #include <WiFi.h>
 #include <SPI.h>
 #include <FS.h>
-#include <SPIFFS.h>
+#include "file_system.h"
 #include <Wire.h>
 
 #include <esp_task_wdt.h>                     // use esp32 watch dog timer (WDT)
@@ -156,7 +156,7 @@ extern char myPASSWORD_1[];
 
 
 // ----------------------------------------------------------------------
-// DRIVER BOARD [uses Timer0]
+// DRIVER BOARD [move timer is timer1, timer0 is focuser2, timer2 is the task scheduler]
 // Default Configuration: Included
 // ----------------------------------------------------------------------
 #include "driver_board.h"
@@ -166,6 +166,10 @@ int myboardnumber   = DRVBRD;                 // define in controller_config.h
 int myfixedstepmode = FIXEDSTEPMODE;          // define in controller_config.h
 int mystepsperrev   = STEPSPERREVOLUTION;     // define in controller_config.h
 
+// step interval recorder for the move timer isr, off until armed
+#include "step_recorder.h"
+STEP_RECORDER *steprec;
+
 
 // ----------------------------------------------------------------------
 // IN-OUT LEDS
@@ -179,6 +183,9 @@ int mystepsperrev   = STEPSPERREVOLUTION;     // define in controller_config.h
 // Default Configuration: Included
 // ----------------------------------------------------------------------
 // Loaded with DriverBoard
+// debounced button events and hold to jog, used by the driver board
+#include "push_buttons.h"
+PUSH_BUTTONS *pbinput;
 
 
 // ----------------------------------------------------------------------
@@ -186,6 +193,9 @@ int mystepsperrev   = STEPSPERREVOLUTION;     // define in controller_config.h
 // Default Configuration: Included
 // ----------------------------------------------------------------------
 // Loaded with DriverBoard
+// axis filter and jog rate, used by the driver board
+#include "jog_engine.h"
+JOG_ENGINE *jogengine;
 
 
 // ----------------------------------------------------------------------
@@ -212,6 +222,10 @@ ASCOM_SERVER *ascomsrvr;
 #include "tcpip_server.h"                     // do not change or move
 TCPIP_SERVER *tcpipsrvr;
 
+// capture of tcp/ip server traffic, off until started
+#include "tcp_trace.h"
+TCP_TRACE *tcptrace;
+
 
 // ----------------------------------------------------------------------
 // WEB SERVER
@@ -243,6 +257,15 @@ TEXT_DISPLAY *mydisplay;
 #include "display_graphics.h"
 GRAPHIC_DISPLAY *mydisplay;
 #endif
+#if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
+// the display task renders from a copy of the focuser state, loop() only
+// fills in the state and notifies the task, it never waits on I2C
+#include "display_state.h"
+display_state     dstate;                     // written by loop(), copied by the display task
+portMUX_TYPE      dstateMux = portMUX_INITIALIZER_UNLOCKED;
+SemaphoreHandle_t displayLock = NULL;         // held while writing to the display
+TaskHandle_t      displaytask = NULL;
+#endif
 
 
 // ----------------------------------------------------------------------
@@ -325,27 +348,73 @@ byte websrvr_status;                          // V_STOPPED
 // There is no pushbutton state and inout-led state as they are in Driverboard
 
 // ----------------------------------------------------------------------
-// Task timer [timer1]
-// handles state machine for options (display, temp probe, park, config saves)
-// ----------------------------------------------------------------------
-#include "tasktimer.h"
-extern volatile int update_temp_flag;
-extern volatile int update_display_flag;
-extern volatile int update_park_flag;
-extern volatile int save_board_flag;          // save board_config.jsn
-extern volatile int save_cntlr_flag;          // save cntlr_config.jsn
-extern volatile int save_var_flag;            // save cntlr_var.jsn
-extern volatile int update_wifi_flag;         // check wifi connection - applicable to Station Mode only
-extern volatile unsigned int park_maxcount;   // 30s  subject to ControllerData->get_parktime()
-extern volatile unsigned int display_maxcount; // 4.5s subject to ControllerData->get_displaypagetime(), default 4500 milliseconds
-extern portMUX_TYPE boardMux;
-extern portMUX_TYPE cntlrMux;
-extern portMUX_TYPE varMux;
-extern portMUX_TYPE wifiMux;
-extern portMUX_TYPE tempMux;
-extern portMUX_TYPE displayMux;               // for the flag, now its time to update page on display
-extern portMUX_TYPE displaytimeMux;           // for updating the actual time delay value display_maxcount
-extern portMUX_TYPE parkMux;
+// TASK SCHEDULER [timer2]
+// jobs for display, temp probe, park, config saves and wifi check
+// ----------------------------------------------------------------------
+#include "task_scheduler.h"
+TASK_SCHEDULER *tasksched;
+int job_display;
+int job_park;
+int job_temp;
+int job_wifi;
+
+// ----------------------------------------------------------------------
+// LOOP SCHEDULER
+// polled jobs for input devices and servers, run from loop()
+// ----------------------------------------------------------------------
+#include "loop_scheduler.h"
+LOOP_SCHEDULER *loopsched;
+
+// ----------------------------------------------------------------------
+// LOOP PROFILER
+// time spent in each section of loop(), the loop scheduler jobs are
+// added as sections when registered
+// ----------------------------------------------------------------------
+#include "loop_profiler.h"
+LOOP_PROFILER *looprof;
+int prof_loop;
+int prof_tasksched;
+int prof_focuser;
+int prof_saveconfig;
+int prof_display;
+
+// ----------------------------------------------------------------------
+// POWER MANAGER
+// reduced cpu clock and modem sleep while parked
+// ----------------------------------------------------------------------
+#include "power_manager.h"
+POWER_MANAGER *powermgr;
+
+// ----------------------------------------------------------------------
+// STALL MONITOR
+// TMC2209 StallGuard4 sampling while moving
+// ----------------------------------------------------------------------
+#include "stall_monitor.h"
+STALL_MONITOR *stallmon;
+
+// ----------------------------------------------------------------------
+// TMC UART
+// TMC2209/TMC2225 settings cache and uart task
+// ----------------------------------------------------------------------
+#include "tmc_uart.h"
+TMC_UART *tmcuart;
+
+// ----------------------------------------------------------------------
+// TMC TUNER
+// TMC2209/TMC2225 chopper mode, CoolStep and idle hold current
+// ----------------------------------------------------------------------
+#include "tmc_tuner.h"
+TMC_TUNER *tmctuner;
+
+// ----------------------------------------------------------------------
+// SECOND FOCUSER
+// a step/dir driver with its own move timer, NULL if not enabled
+// ----------------------------------------------------------------------
+#include "focuser_channel.h"
+FOCUSER_CHANNEL *focuser2 = NULL;
+#if defined(ENABLE_FOCUSER2)
+#include "defines/focuser2_defines.h"
+#endif
 
 // Mutex's required for focuser halt and move
 volatile bool timerSemaphore = false;                           // move completed=true, still moving or not moving = false;
@@ -359,6 +428,7 @@ portMUX_TYPE  halt_alertMux = portMUX_INITIALIZER_UNLOCKED;     // protects halt
 long  ftargetPosition;                        // target position
 bool  isMoving;                               // is the motor currently moving (true / false)
 float temp;                                   // the last temperature read
+bool  Parked = true;                          // focuser is parked
 int   update_delay_after_move_flag;           // when set to 1, indicates the flag has been set, default = 0, disabled = -1
 enum  Display_Types displaytype;              // None, text, graphics
 
@@ -371,6 +441,33 @@ char systemuptime[12];                        // ddd:hh:mm
 IPAddress ESP32IPAddress;
 IPAddress myIP;
 
+// BOOT TIMELINE
+// each boot phase is time stamped (micros since reset) when it ends,
+// the deferred phases are run from loop() once the controller is idle
+#define BOOT_MAXPHASES      24
+#define BOOT_DEFERDELAY     2000              // ms after setup() ends before the deferred phases start
+enum Boot_Deferred { Boot_WebPages, Boot_DuckDNS, Boot_Done };
+const char    *boot_phase_name[BOOT_MAXPHASES];
+unsigned long boot_phase_time[BOOT_MAXPHASES];
+byte          boot_phase_count = 0;
+byte          boot_deferred_state = Boot_WebPages;
+
+// PROTOTYPES
+// the Arduino IDE adds these, a host build compiles the ino as C++
+bool duckdns_start();
+bool poll_input(void);
+bool poll_irremote(void);
+bool poll_tcpipsrvr(void);
+bool poll_ascomsrvr(void);
+bool poll_mngsrvr(void);
+bool poll_websrvr(void);
+bool poll_alpaca(void);
+bool poll_stallmon(void);
+bool poll_tmctuner(void);
+bool poll_focuser2(void);
+void driverboard_start(void);
+bool focuser_update(void);
+
 
 // ----------------------------------------------------------------------
 // PARK, DISPLAY, COILPOWER INTERACTION
@@ -414,6 +511,106 @@ void fmemcpy( char *target, char *source, int i)
   *dest = 0x00;
 }
 
+// ----------------------------------------------------------------------
+// void boot_mark(const char *);
+// time stamp the end of a boot phase, and report it on the serial port
+// ----------------------------------------------------------------------
+void boot_mark(const char *phase)
+{
+  unsigned long now = micros();
+  unsigned long last = (boot_phase_count == 0) ? 0 : boot_phase_time[boot_phase_count - 1];
+
+  if ( boot_phase_count < BOOT_MAXPHASES )
+  {
+    boot_phase_name[boot_phase_count] = phase;
+    boot_phase_time[boot_phase_count] = now;
+    boot_phase_count++;
+  }
+  boot_msg_print("Boot: ");
+  boot_msg_print(phase);
+  boot_msg_print(" ");
+  boot_msg_print(now - last);
+  boot_msg_print("us, at ");
+  boot_msg_print(now / 1000);
+  boot_msg_println("ms");
+}
+
+// ----------------------------------------------------------------------
+// String get_boottimeline(void);
+// boot phases as a json string, the time (ms since reset) each phase
+// ended and its duration (ms) - used by Management Server
+// ----------------------------------------------------------------------
+String get_boottimeline(void)
+{
+  String jsonstr = "{ \"boot\":[";
+  unsigned long last = 0;
+
+  for (int i = 0; i < boot_phase_count; i++)
+  {
+    if ( i != 0 )
+    {
+      jsonstr += ", ";
+    }
+    jsonstr += "{ \"phase\":\"" + String(boot_phase_name[i]) + "\", \"at\":" + String(boot_phase_time[i] / 1000.0, 1) \
+               + ", \"dur\":" + String((boot_phase_time[i] - last) / 1000.0, 1) + " }";
+    last = boot_phase_time[i];
+  }
+  jsonstr += "], \"deferred\":\"";
+  jsonstr += (boot_deferred_state == Boot_Done) ? "done" : "pending";
+  jsonstr += "\" }";
+  return jsonstr;
+}
+
+// ----------------------------------------------------------------------
+// void boot_deferred(void);
+// start the services which are not needed to move the focuser, the web
+// page cache and duckdns, in the background after boot. Called from
+// loop() when the focuser is idle, runs one phase per call
+// ----------------------------------------------------------------------
+void boot_deferred(void)
+{
+  if ( boot_deferred_state == Boot_Done )
+  {
+    return;
+  }
+  // wait a little after setup() to let the first clients connect
+  if ( (boot_phase_count != 0) && ((micros() - boot_phase_time[boot_phase_count - 1]) < (BOOT_DEFERDELAY * 1000UL)) )
+  {
+    return;
+  }
+
+  switch ( boot_deferred_state )
+  {
+    case Boot_WebPages:
+      if ( websrvr_status == V_RUNNING )
+      {
+        websrvr->cachepages();
+        boot_mark("webpages");
+      }
+      boot_deferred_state = Boot_DuckDNS;
+      break;
+
+    case Boot_DuckDNS:
+      // Dependancy: WiFi has to be up and running before starting service
+      if ( ControllerData->get_duckdns_enable() == V_ENABLED )
+      {
+        boot_msg_println("Start DUCKDNS");
+        // call helper, if not defined then helper will return false;
+        if ( duckdns_start() == false )
+        {
+          ERROR_println("duckdns_start() error");
+        }
+        boot_mark("duckdns");
+      }
+      boot_deferred_state = Boot_Done;
+      break;
+
+    default:
+      boot_deferred_state = Boot_Done;
+      break;
+  }
+}
+
 // ----------------------------------------------------------------------
 // bool init_display(void);
 // initialise display vars and create pointer to the display class
@@ -426,17 +623,128 @@ bool display_init()
 #if defined(ENABLE_TEXTDISPLAY)
   displaytype = Type_Text;
   mydisplay = new TEXT_DISPLAY(OLED_ADDR);
-  return true;
 #endif
 #if defined(ENABLE_GRAPHICDISPLAY)
   displaytype = Type_Graphic;
   mydisplay = new GRAPHIC_DISPLAY(OLED_ADDR);
-  return true;
 #endif
+  displayLock = xSemaphoreCreateMutex();
+  xTaskCreatePinnedToCore(display_task, "display", DISPLAYTASKSTACK, NULL, DISPLAYTASKPRIORITY, &displaytask, DISPLAYTASKCORE);
+  return true;
 #endif // #if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
   return false;
 }
 
+#if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
+// ----------------------------------------------------------------------
+// void display_task(void *);
+// Waits for a notification from loop(), copies the display state and
+// writes to the display. Start and stop hold displayLock, so the display
+// is not deleted while the task is using it
+// ----------------------------------------------------------------------
+void display_task(void *param)
+{
+  display_state ds;
+  uint32_t bits;
+  for (;;)
+  {
+    xTaskNotifyWait(0, ULONG_MAX, &bits, portMAX_DELAY);
+    portENTER_CRITICAL(&dstateMux);
+    ds = dstate;
+    portEXIT_CRITICAL(&dstateMux);
+
+    xSemaphoreTake(displayLock, portMAX_DELAY);
+    if ( display_status == V_RUNNING )
+    {
+      if ( bits & DISPLAY_NOTIFY_OFF )
+      {
+        mydisplay->off();
+      }
+      if ( bits & DISPLAY_NOTIFY_ON )
+      {
+        mydisplay->on();
+      }
+      if ( bits & DISPLAY_NOTIFY_PAGE )
+      {
+        mydisplay->update(ds);
+      }
+      else if ( bits & DISPLAY_NOTIFY_POSITION )
+      {
+        mydisplay->update_position(ds);
+      }
+    }
+    xSemaphoreGive(displayLock);
+  }
+}
+
+// ----------------------------------------------------------------------
+// void display_snapshot(void);
+// Copy the focuser state for the display task
+// ----------------------------------------------------------------------
+void display_snapshot(void)
+{
+  display_state ds;
+  ds.position          = driverboard->getposition();
+  ds.target            = ftargetPosition;
+  ds.ismoving          = isMoving;
+  ds.temp              = temp;
+  ds.tempmode          = ControllerData->get_tempmode();
+  ds.maxstep           = ControllerData->get_maxstep();
+  ds.motorspeed        = ControllerData->get_motorspeed();
+  ds.stepmode          = ControllerData->get_brdstepmode();
+  ds.direction         = ControllerData->get_focuserdirection();
+  ds.coilpower         = ControllerData->get_coilpower_enable();
+  ds.reverse           = ControllerData->get_reverse_enable();
+  ds.backlash_in       = ControllerData->get_backlash_in_enable();
+  ds.backlash_out      = ControllerData->get_backlash_out_enable();
+  ds.backlashsteps_in  = ControllerData->get_backlashsteps_in();
+  ds.backlashsteps_out = ControllerData->get_backlashsteps_out();
+  ds.stepsize          = ControllerData->get_stepsize();
+  ds.stepsize_enable   = ControllerData->get_stepsize_enable();
+  ds.hpsw_enable       = ControllerData->get_hpswitch_enable();
+  ds.inoutled_enable   = ControllerData->get_inoutled_enable();
+  ds.inoutledmode      = ControllerData->get_inoutledmode();
+  ds.pushbuttons       = driverboard->get_pushbuttons_loaded();
+  ds.tempprobe         = tempprobe->get_state();
+  ds.tempcomp_enable   = ControllerData->get_tempcomp_enable();
+  ds.tempcoefficient   = ControllerData->get_tempcoefficient();
+  ds.tcdirection       = ControllerData->get_tcdirection();
+  for (int i = 0; i < 6; i++)
+  {
+    ds.presets[i] = ControllerData->get_focuserpreset(i);
+  }
+  ds.pagetime          = ControllerData->get_displaypagetime();
+  ds.updateonmove      = ControllerData->get_displayupdateonmove();
+  strlcpy(ds.pageoption, ControllerData->get_displaypageoption().c_str(), sizeof(ds.pageoption));
+  ds.clients           = tcpipsrvr->get_clients();
+  ds.ota               = ota_status;
+  ds.ascomsrvr         = ascomsrvr_status;
+  ds.mngsrvr           = mngsrvr_status;
+  ds.tcpipsrvr         = tcpipsrvr_status;
+  ds.websrvr           = websrvr_status;
+  ds.ascomport         = ControllerData->get_ascomsrvr_port();
+  ds.mngport           = ControllerData->get_mngsrvr_port();
+  ds.tcpipport         = ControllerData->get_tcpipsrvr_port();
+  ds.webport           = ControllerData->get_websrvr_port();
+
+  portENTER_CRITICAL(&dstateMux);
+  dstate = ds;
+  portEXIT_CRITICAL(&dstateMux);
+}
+
+// ----------------------------------------------------------------------
+// void display_notify(uint32_t);
+// Post work to the display task, does not wait
+// ----------------------------------------------------------------------
+void display_notify(uint32_t bits)
+{
+  if ( displaytask != NULL )
+  {
+    xTaskNotify(displaytask, bits, eSetBits);
+  }
+}
+#endif // #if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
+
 // ----------------------------------------------------------------------
 // bool display_start(void);
 // Display start
@@ -452,30 +760,27 @@ bool display_start(void)
 
   DEBUG_println("helper display_start: display_status = Stopped");
 
-  portENTER_CRITICAL(&displayMux);             // display_status has to be stopped to get here
-  update_display_flag = -1;
-  portEXIT_CRITICAL(&displayMux);
+  tasksched->stop(job_display);               // display_status has to be stopped to get here
 
 #if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
   if ( ControllerData->get_display_enable() == V_ENABLED) // only start the display if is enabled in ControllerData
   {
     DEBUG_println("helper display_start: start display");
-    if ( mydisplay->start() != true )         // attempt to start the display
+    xSemaphoreTake(displayLock, portMAX_DELAY);
+    bool started = mydisplay->start();        // attempt to start the display
+    xSemaphoreGive(displayLock);
+    if ( started != true )
     {
       DEBUG_println("helper display_start: display failed to start");
       display_status = V_STOPPED;             // display did not start
-      portENTER_CRITICAL(&displayMux);
-      update_display_flag = -1;
-      portEXIT_CRITICAL(&displayMux);
+      tasksched->stop(job_display);
       return false;
     }
     else
     {
       DEBUG_println("helper display_start: display started");
       display_status = V_RUNNING;
-      portENTER_CRITICAL(&displayMux);
-      update_display_flag = 0;
-      portEXIT_CRITICAL(&displayMux);
+      tasksched->restart(job_display);
       return true;
     }
   }
@@ -494,11 +799,11 @@ bool display_start(void)
 void display_stop(void)
 {
 #if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
-  portENTER_CRITICAL(&displayMux);
-  update_display_flag = -1;
-  portEXIT_CRITICAL(&displayMux);
+  tasksched->stop(job_display);
+  xSemaphoreTake(displayLock, portMAX_DELAY); // wait for the display task to finish
   mydisplay->stop();                          // stop the display
   display_status = V_STOPPED;
+  xSemaphoreGive(displayLock);
 #endif // #if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
 }
 
@@ -515,7 +820,36 @@ void display_update()
     DEBUG_println("helper: display_update: oled_off: update ignored");
     return;
   }
-  mydisplay->update();
+  uint32_t cycles = looprof->start();
+  display_snapshot();
+  display_notify(DISPLAY_NOTIFY_PAGE);
+  looprof->stop(prof_display, cycles);
+#endif
+}
+
+// ----------------------------------------------------------------------
+// String display_get_stats(void);
+// Bytes sent and time per display refresh
+// helper, optional
+// ----------------------------------------------------------------------
+String display_get_stats(void)
+{
+#if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
+  if ( display_status == V_RUNNING )
+  {
+    return mydisplay->get_stats();
+  }
+#endif
+  return "{ \"error\":\"display not running\" }";
+}
+
+void display_reset_stats(void)
+{
+#if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
+  if ( display_status == V_RUNNING )
+  {
+    mydisplay->reset_stats();
+  }
 #endif
 }
 
@@ -536,7 +870,12 @@ void display_update_position(long fposition)
   // if update position when moving enabled, then update position
   if ( ControllerData->get_displayupdateonmove() == V_ENABLED)
   {
-    mydisplay->update_position(fposition);
+    portENTER_CRITICAL(&dstateMux);
+    dstate.position = fposition;
+    dstate.target   = ftargetPosition;
+    dstate.ismoving = isMoving;
+    portEXIT_CRITICAL(&dstateMux);
+    display_notify(DISPLAY_NOTIFY_POSITION);
   }
 #endif
 }
@@ -549,7 +888,7 @@ void display_update_position(long fposition)
 void display_off()
 {
 #if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
-  mydisplay->off();
+  display_notify(DISPLAY_NOTIFY_OFF);
 #endif
 }
 
@@ -561,19 +900,23 @@ void display_off()
 void display_on()
 {
 #if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
-  mydisplay->on();
+  display_notify(DISPLAY_NOTIFY_ON);
 #endif
 }
 
 // ----------------------------------------------------------------------
 // void display_clear(void);
 // Turn display clear
+// waits for the display task, only used by the management server before
+// the display is stopped
 // helper, optional
 // ----------------------------------------------------------------------
 void display_clear()
 {
 #if defined(ENABLE_TEXTDISPLAY) || defined(ENABLE_GRAPHICDISPLAY)
+  xSemaphoreTake(displayLock, portMAX_DELAY);
   mydisplay->clear();
+  xSemaphoreGive(displayLock);
 #endif
 }
 
@@ -601,7 +944,7 @@ bool irremote_init()
 // ----------------------------------------------------------------------
 bool irremote_start(void)
 {
-#if defined(ENABLE_NFRAREDREMOTE)
+#if defined(ENABLE_INFRAREDREMOTE)
   if ( irremote_status == V_RUNNING )
   {
     return true;                              // already started
@@ -614,7 +957,7 @@ bool irremote_start(void)
 
 // ----------------------------------------------------------------------
 // bool irremote_update(void);
-// Read Infra red Remote
+// Apply the key events from the Infra red Remote
 // helper, optional
 // ----------------------------------------------------------------------
 void irremote_update(void)
@@ -628,6 +971,93 @@ void irremote_update(void)
 #endif
 }
 
+// ----------------------------------------------------------------------
+// String irremote_get_stats(void);
+// Key events, queue depth and latency
+// helper, optional
+// ----------------------------------------------------------------------
+String irremote_get_stats(void)
+{
+#if defined(ENABLE_INFRAREDREMOTE)
+  if ( irremote_status == V_RUNNING )
+  {
+    return irremote->get_stats();
+  }
+#endif
+  return "{ \"error\":\"irremote not running\" }";
+}
+
+void irremote_reset_stats(void)
+{
+#if defined(ENABLE_INFRAREDREMOTE)
+  if ( irremote_status == V_RUNNING )
+  {
+    irremote->reset_stats();
+  }
+#endif
+}
+
+
+// ----------------------------------------------------------------------
+// void park_focuser(void);
+// Park time has expired after a move, release coil power (if coil power
+// is not enabled) and turn off the display
+// task scheduler job
+// ----------------------------------------------------------------------
+void park_focuser(void)
+{
+  // park can be enabled or disabled (management server)
+  // if park is not enabled, state of coilpower and display are not altered
+  if ( (isMoving == true) || (ControllerData->get_park_enable() == false) )
+  {
+    return;
+  }
+  DEBUG_println("helper: park time expired: parking now");
+  Parked = true;
+
+  // handle coil power
+  // Coil Power Status ON  - Controller does move, coil power remains on
+  // Coil Power Status OFF - Controller enables coil power, moves motor, after park time releases power to motor
+  if ( ControllerData->get_coilpower_enable() == V_NOTENABLED )
+  {
+    driverboard->releasemotor();
+    DEBUG_println("helper: park: coilpower=released");
+  }
+
+  // turn off display
+  oled_state = oled_off;
+}
+
+
+// ----------------------------------------------------------------------
+// void temp_update(void);
+// Read temp AND check Temperature Compensation
+// task scheduler job
+// ----------------------------------------------------------------------
+void temp_update(void)
+{
+  if ( tempprobe->get_state() == V_RUNNING )
+  {
+    temp = tempprobe->update();
+  }
+}
+
+
+// ----------------------------------------------------------------------
+// void wifi_check(void);
+// Reconnect if the WiFi connection has been lost [STATIONMODE]
+// task scheduler job
+// ----------------------------------------------------------------------
+void wifi_check(void)
+{
+  if ( (myfp2esp32mode == STATIONMODE) && (WiFi.status() != WL_CONNECTED) )
+  {
+    ERROR_println("WiFi not connected: attempt reconnect");
+    WiFi.disconnect();
+    WiFi.reconnect();
+  }
+}
+
 
 // ----------------------------------------------------------------------
 // bool duckdns_start(void);
@@ -699,7 +1129,7 @@ bool readwificonfig(char *xSSID, char *xPASSWORD, char *ySSID, char *yPASSWORD)
   if (!filesystemloaded) {
     return false;
   }
-  File f = SPIFFS.open(filename, "r");
+  File f = FILESYS.open(filename, "r");
   if (f) {
     String fdata = f.readString();
     f.close();
@@ -822,23 +1252,14 @@ void load_vars()
   halt_alert = false;
   isMoving = false;
   update_delay_after_move_flag = -1;
-  update_wifi_flag = 0;
-  
+
   // ascom server
   ascomsrvr_status = V_STOPPED;
 
-  // Controller Data
-  save_cntlr_flag = -1;
-  save_var_flag   = -1;
-  save_board_flag = -1;
-
   // display
   oled_state  = oled_on;
   displaytype = Type_None;
   display_status = V_STOPPED;
-  portENTER_CRITICAL(&displayMux);
-  update_display_flag = -1;
-  portEXIT_CRITICAL(&displayMux);
 
   // duckdns
   duckdns_status = V_STOPPED;
@@ -852,16 +1273,12 @@ void load_vars()
   // ota
   ota_status = V_STOPPED;
 
-  // park
-  update_park_flag = -1;
-
   // tcpip server
   tcpipsrvr_status = V_STOPPED;
 
   // temperature probe
   temp = 20.0;
   ControllerData->set_tcavailable(V_NOTENABLED);
-  update_temp_flag = -1;
 
   // webserver
   websrvr_status = V_STOPPED;
@@ -888,6 +1305,30 @@ void load_vars()
 }
 
 
+//-------------------------------------------------
+// void driverboard_start(void);
+// Create the driver board and the motion objects it uses, in the order
+// they depend on each other. ControllerData must be loaded first
+//-------------------------------------------------
+void driverboard_start(void)
+{
+  // ensure targetposition will be same as focuser position
+  // else after loading driverboard focuser will start moving immediately
+  ftargetPosition = ControllerData->get_fposition();
+  steprec = new STEP_RECORDER();              // used by the move timer isr
+  powermgr = new POWER_MANAGER();             // used by the move timer isr
+  tmcuart = new TMC_UART();                   // used by the driver board
+  tmctuner = new TMC_TUNER();                 // used by initmove()
+  stallmon = new STALL_MONITOR();             // used by initmove()
+  stallmon->begin();
+  jogengine = new JOG_ENGINE();               // used by the driver board joysticks
+  pbinput = new PUSH_BUTTONS();               // used by the driver board pushbuttons
+  driverboard = new DRIVER_BOARD();
+  driverboard->start(ControllerData->get_fposition());
+  tmctuner->begin();                          // after the tmc driver is set up
+}
+
+
 //-------------------------------------------------
 // void setup(void)
 //-------------------------------------------------
@@ -902,13 +1343,28 @@ void setup()
 
   boot_msg_println("Serial started");
   filesystemloaded = false;
+  boot_mark("serial");
 
   //-------------------------------------------------
   // READ FOCUSER CONFIGURATION SETTINGS FROM CONFIG FILES
   //-------------------------------------------------
   // create pointer to the class and start
   boot_msg_println("ControllerData start");
+  looprof = new LOOP_PROFILER();
+  prof_loop       = looprof->add("loop");
+  prof_tasksched  = looprof->add("tasksched");
+  prof_focuser    = looprof->add("focuser");
+  prof_saveconfig = looprof->add("saveconfig");
+  prof_display    = looprof->add("display");
+  tasksched = new TASK_SCHEDULER();           // ControllerData registers its save jobs
   ControllerData = new CONTROLLER_DATA();
+  boot_mark("config");
+
+  // the jobs are armed when each device or service starts
+  job_display = tasksched->add("display", display_update, ControllerData->get_displaypagetime() * 1000, SCHED_PERIODIC);
+  job_park    = tasksched->add("park", park_focuser, ControllerData->get_parktime() * 1000, SCHED_ONESHOT);
+  job_temp    = tasksched->add("temp", temp_update, DEFAULTTEMPREFRESHTIME, SCHED_PERIODIC);
+  job_wifi    = tasksched->add("wifi", wifi_check, DEFAULTWIFICHECKTIME, SCHED_PERIODIC);
 
 
   //-------------------------------------------------
@@ -916,6 +1372,7 @@ void setup()
   //-------------------------------------------------
   boot_msg_println("Set vars and load cached vars");
   load_vars();
+  boot_mark("vars");
 
 
   //-------------------------------------------------
@@ -926,44 +1383,116 @@ void setup()
 
 
   //-------------------------------------------------
-  // WIFICONFIG READ
-  // read mySSID, myPASSWORD from file if file exists, otherwise use defaults
+  // SETUP DRIVER BOARD
+  // Motor and position are ready first, before the WiFi connect
   //-------------------------------------------------
-  readwificonfig(mySSID, myPASSWORD, mySSID_1, myPASSWORD_1);
+  boot_msg_print("Load driver board ");
+  boot_msg_println(DRVBRD);
+  driverboard_start();
+#if defined(ENABLE_FOCUSER2)
+  boot_msg_println("Load focuser2");
+  focuser2 = new FOCUSER_CHANNEL(1, FOCUSER2_TIMER, &focuser2_isr);
+  if ( focuser2->begin(FOCUSER2_STEPPIN, FOCUSER2_DIRPIN, FOCUSER2_ENABLEPIN, FOCUSER2_MAXSTEP, FOCUSER2_STEPDELAY, FOCUSER2_REVERSE, FOCUSER2_COILPOWER) == false )
+  {
+    delete focuser2;
+    focuser2 = NULL;
+  }
+#endif
 
+  // Range checks for safety reasons
+  ControllerData->set_brdstepmode((ControllerData->get_brdstepmode() < 1 ) ? 1 : ControllerData->get_brdstepmode());
+  ControllerData->set_coilpower_enable((ControllerData->get_coilpower_enable() >= 1) ?  1 : 0);
+  ControllerData->set_reverse_enable((ControllerData->get_reverse_enable() >= 1) ?  1 : 0);
+  int pgtime = ControllerData->get_displaypagetime();
+  pgtime = (pgtime < V_DISPLAYPAGETIMEMIN) ? V_DISPLAYPAGETIMEMIN : pgtime;
+  pgtime = (pgtime > V_DISPLAYPAGETIMEMAX) ? V_DISPLAYPAGETIMEMAX : pgtime;
+  ControllerData->set_displaypagetime(pgtime);
+  ControllerData->set_maxstep((ControllerData->get_maxstep() < FOCUSERLOWERLIMIT) ? FOCUSERLOWERLIMIT : ControllerData->get_maxstep());
+  ControllerData->set_stepsize((float)(ControllerData->get_stepsize() < 0.0 ) ? 0 : ControllerData->get_stepsize());
+  ControllerData->set_stepsize((float)(ControllerData->get_stepsize() > MAXIMUMSTEPSIZE ) ? MAXIMUMSTEPSIZE : ControllerData->get_stepsize());
 
-  //-------------------------------------------------
-  // ACCESSPOINTMODE START
-  //-------------------------------------------------
-  if (myfp2esp32mode == ACCESSPOINT)
+  // Set coilpower
+  if (ControllerData->get_coilpower_enable() == V_NOTENABLED)
   {
-    boot_msg_println("Load accesspoint");
-    WiFi.config(ip, dns, gateway, subnet);
-    WiFi.mode(WIFI_AP);
-    WiFi.softAP(mySSID, myPASSWORD);
+    boot_msg_println("setup: coilpower OFF");
+    driverboard->releasemotor();
+  }
+  else
+  {
+    boot_msg_println("setup: coilpower ON");
+    driverboard->enablemotor();
   }
 
+  // ensure driverboard position is same as setupData
+  // set focuser position in DriverBoard
+  driverboard->setposition(ControllerData->get_fposition());
+  boot_mark("driverboard");
+
 
   //-------------------------------------------------
-  // STATIONMODE START
-  // Setup Stationmode, as a station connecting to an existing wifi network
+  // SETUP IN-OUT LEDS
+  // Included by default
+  // Default state:  NotEnabled: Stopped
   //-------------------------------------------------
-  if (myfp2esp32mode == STATIONMODE)
-  {
-    boot_msg_println("Load station mode");
-    WiFi.mode(WIFI_STA);                      // log on to LAN
-    if (staticip == STATICIP)                 // if staticip then set this up before starting
-    {
-      DEBUG_println("Use static ip");
-      WiFi.config(ip, dns, gateway, subnet);
-      delay(50);
-    }
+  // Now part of DriverBoard, and initialised/enabled/stopped there
 
-    // attempt to connect using mySSID and myPASSWORD
-    WiFi.begin(mySSID, myPASSWORD);
-    delay(1000);
-    for (int attempts = 0; WiFi.status() != WL_CONNECTED; attempts++)
-    {
+
+  //-------------------------------------------------
+  // SETUP PUSHBUTTONS
+  // active high when pressed
+  // Included by default
+  // Default state:  NotEnabled: Stopped
+  //-------------------------------------------------
+  // Now part of DriverBoard, and initialised/enabled/stopped there
+
+
+  //-------------------------------------------------
+  // SETUP JOYSTICKS
+  // Included by default
+  // Default state:  NotEnabled: Stopped
+  //-------------------------------------------------
+  // Now part of DriverBoard, and initialised/enabled/stopped there
+
+
+  //-------------------------------------------------
+  // WIFICONFIG READ
+  // read mySSID, myPASSWORD from file if file exists, otherwise use defaults
+  //-------------------------------------------------
+  readwificonfig(mySSID, myPASSWORD, mySSID_1, myPASSWORD_1);
+
+
+  //-------------------------------------------------
+  // ACCESSPOINTMODE START
+  //-------------------------------------------------
+  if (myfp2esp32mode == ACCESSPOINT)
+  {
+    boot_msg_println("Load accesspoint");
+    WiFi.config(ip, dns, gateway, subnet);
+    WiFi.mode(WIFI_AP);
+    WiFi.softAP(mySSID, myPASSWORD);
+  }
+
+
+  //-------------------------------------------------
+  // STATIONMODE START
+  // Setup Stationmode, as a station connecting to an existing wifi network
+  //-------------------------------------------------
+  if (myfp2esp32mode == STATIONMODE)
+  {
+    boot_msg_println("Load station mode");
+    WiFi.mode(WIFI_STA);                      // log on to LAN
+    if (staticip == STATICIP)                 // if staticip then set this up before starting
+    {
+      DEBUG_println("Use static ip");
+      WiFi.config(ip, dns, gateway, subnet);
+      delay(50);
+    }
+
+    // attempt to connect using mySSID and myPASSWORD
+    WiFi.begin(mySSID, myPASSWORD);
+    delay(1000);
+    for (int attempts = 0; WiFi.status() != WL_CONNECTED; attempts++)
+    {
       delay(500);
       if (attempts > 9)                       // if this attempt is 10 or more tries
       {
@@ -1008,6 +1537,7 @@ void setup()
 
   DEBUG_print("Hostname ");
   DEBUG_println(WiFi.getHostname());
+  boot_mark("wifi");
 
 
   //-------------------------------------------------
@@ -1018,68 +1548,82 @@ void setup()
 
 
   //-------------------------------------------------
-  // SETUP DRIVER BOARD
+  // TCP/IP SERVER START
+  // TCP/IP and ASCOM servers come up next, so clients can connect
+  // Dependancy: WiFi has to be up and running before starting TCP/IP server
+  // Default state:  Enabled: Started
   //-------------------------------------------------
-  boot_msg_print("Load driver board ");
-  boot_msg_println(DRVBRD);
-  // ensure targetposition will be same as focuser position
-  // else after loading driverboard focuser will start moving immediately
-  ftargetPosition = ControllerData->get_fposition();
-  driverboard = new DRIVER_BOARD();
-  driverboard->start(ControllerData->get_fposition());
-
-  // Range checks for safety reasons
-  ControllerData->set_brdstepmode((ControllerData->get_brdstepmode() < 1 ) ? 1 : ControllerData->get_brdstepmode());
-  ControllerData->set_coilpower_enable((ControllerData->get_coilpower_enable() >= 1) ?  1 : 0);
-  ControllerData->set_reverse_enable((ControllerData->get_reverse_enable() >= 1) ?  1 : 0);
-  int pgtime = ControllerData->get_displaypagetime();
-  pgtime = (pgtime < V_DISPLAYPAGETIMEMIN) ? V_DISPLAYPAGETIMEMIN : pgtime;
-  pgtime = (pgtime > V_DISPLAYPAGETIMEMAX) ? V_DISPLAYPAGETIMEMAX : pgtime;
-  ControllerData->set_displaypagetime(pgtime);
-  ControllerData->set_maxstep((ControllerData->get_maxstep() < FOCUSERLOWERLIMIT) ? FOCUSERLOWERLIMIT : ControllerData->get_maxstep());
-  ControllerData->set_stepsize((float)(ControllerData->get_stepsize() < 0.0 ) ? 0 : ControllerData->get_stepsize());
-  ControllerData->set_stepsize((float)(ControllerData->get_stepsize() > MAXIMUMSTEPSIZE ) ? MAXIMUMSTEPSIZE : ControllerData->get_stepsize());
-
-  // Set coilpower
-  if (ControllerData->get_coilpower_enable() == V_NOTENABLED)
-  {
-    boot_msg_println("setup: coilpower OFF");
-    driverboard->releasemotor();
-  }
-  else
+  // create pointer to class
+  tcptrace = new TCP_TRACE();
+  tcpipsrvr = new TCPIP_SERVER();
+  // check if tcpip server is to be started at boot time
+  if ( ControllerData->get_tcpipsrvr_enable() == V_ENABLED)
   {
-    boot_msg_println("setup: coilpower ON");
-    driverboard->enablemotor();
+    boot_msg_println("Start TCPIP Server");
+    tcpipsrvr_status = tcpipsrvr->start(ControllerData->get_tcpipsrvr_port());
+    if ( tcpipsrvr_status != V_RUNNING )
+    {
+      ERROR_println("tcpip server start error");
+    }
   }
-
-  // ensure driverboard position is same as setupData
-  // set focuser position in DriverBoard
-  driverboard->setposition(ControllerData->get_fposition());
+  boot_mark("tcpipserver");
 
 
   //-------------------------------------------------
-  // SETUP IN-OUT LEDS
-  // Included by default
+  // ASCOM ALPACA SERVER START
+  // Dependancy: WiFi must be running before starting server
+  // Manage via Management Server
   // Default state:  NotEnabled: Stopped
   //-------------------------------------------------
-  // Now part of DriverBoard, and initialised/enabled/stopped there
+  // create the pointer to the class
+  ascomsrvr = new ASCOM_SERVER();
+  // check if ascom server is to be started at boot time
+  if ( ControllerData->get_ascomsrvr_enable() == V_ENABLED)
+  {
+    boot_msg_println("Start ascom alpaca server");
+    ascomsrvr_status = ascomsrvr->start();
+    if ( ascomsrvr_status != V_RUNNING )
+    {
+      ERROR_println("ascomserver start() error");
+    }
+  }
+  boot_mark("ascomserver");
 
 
   //-------------------------------------------------
-  // SETUP PUSHBUTTONS
-  // active high when pressed
-  // Included by default
-  // Default state:  NotEnabled: Stopped
+  // MANAGEMENT SERVER START
+  // Dependancy: WiFi has to be up and running before starting
+  // Default state:  Enabled: Started
   //-------------------------------------------------
-  // Now part of DriverBoard, and initialised/enabled/stopped there
+  // create pointer to class
+  mngsrvr = new MANAGEMENT_SERVER();
+  // check if management server is to be started at boot time
+  if ( ControllerData->get_mngsrvr_enable() == V_ENABLED)
+  {
+    boot_msg_println("management server enabled");
+    boot_msg_println("starting management server");
+    mngsrvr_status = mngsrvr->start(ControllerData->get_mngsrvr_port());
+    if ( mngsrvr_status != V_RUNNING )
+    {
+      ERROR_println("Management server start() error");
+    }
+  }
+  else
+  {
+    DEBUG_println("management server is NOT enabled");
+    DEBUG_println("management server will now be enabled, but not started");
+    ControllerData->set_mngsrvr_enable(V_ENABLED);
+  }
+  boot_mark("mngtserver");
 
 
   //-------------------------------------------------
-  // SETUP JOYSTICKS
-  // Included by default
+  // OTA UPDATES
+  // Dependancy: WiFi and Management Server
+  // Optional, managed by Management Server
   // Default state:  NotEnabled: Stopped
   //-------------------------------------------------
-  // Now part of DriverBoard, and initialised/enabled/stopped there
+  // OTA if enabled, will be started by Management Server
 
 
   //-------------------------------------------------
@@ -1087,6 +1631,7 @@ void setup()
   //-------------------------------------------------
   boot_msg_println("Start I2C");
   Wire.begin(I2CDATAPIN, I2CCLKPIN);          // pins defined in controller_defines.h
+  boot_mark("i2c");
 
 
   //-------------------------------------------------
@@ -1103,6 +1648,7 @@ void setup()
       ERROR_println("displaystart() error");
     }
   }
+  boot_mark("display");
 
 
   //-------------------------------------------------
@@ -1120,6 +1666,7 @@ void setup()
       ERROR_println("irremote_start() error");
     }
   }
+  boot_mark("irremote");
 
 
   //-------------------------------------------------
@@ -1128,17 +1675,7 @@ void setup()
   // Optional, use helper function
   // Default state:  NotEnabled: Stopped
   //-------------------------------------------------
-  // check if duckdns is loaded at boot time
-  if ( ControllerData->get_duckdns_enable() == V_ENABLED )
-  {
-    boot_msg_println("Start DUCKDNS");
-    // call helper, if not defined then helper will return false;
-    duckdns_status = duckdns_start();
-    if ( duckdns_status != V_RUNNING )
-    {
-      ERROR_println("duckdns_start() error");
-    }
-  }
+  // duckdns is started in the background after boot, see boot_deferred()
 
 
   //-------------------------------------------------
@@ -1162,7 +1699,6 @@ void setup()
       DEBUG_println("boot: Start temperature probe");
       if ( tempprobe->start() == true )
       {
-        update_temp_flag = 0;
         temp = tempprobe->read();
       }
       else
@@ -1179,79 +1715,7 @@ void setup()
   {
     DEBUG_println("boot: tempprobe init failed");
   }
-
-  //-------------------------------------------------
-  // ASCOM ALPACA SERVER START
-  // Dependancy: WiFi must be running before starting server
-  // Manage via Management Server
-  // Default state:  NotEnabled: Stopped
-  //-------------------------------------------------
-  // create the pointer to the class
-  ascomsrvr = new ASCOM_SERVER();
-  // check if ascom server is to be started at boot time
-  if ( ControllerData->get_ascomsrvr_enable() == V_ENABLED)
-  {
-    boot_msg_println("Start ascom alpaca server");
-    ascomsrvr_status = ascomsrvr->start();
-    if ( ascomsrvr_status != V_RUNNING )
-    {
-      ERROR_println("ascomserver start() error");
-    }
-  }
-
-
-  //-------------------------------------------------
-  // OTA UPDATES
-  // Dependancy: WiFi and Management Server
-  // Optional, managed by Management Server
-  // Default state:  NotEnabled: Stopped
-  //-------------------------------------------------
-  // OTA if enabled, will be started by Management Server
-
-
-  //-------------------------------------------------
-  // MANAGEMENT SERVER START
-  // Dependancy: WiFi has to be up and running before starting
-  // Default state:  Enabled: Started
-  //-------------------------------------------------
-  // create pointer to class
-  mngsrvr = new MANAGEMENT_SERVER();
-  // check if management server is to be started at boot time
-  if ( ControllerData->get_mngsrvr_enable() == V_ENABLED)
-  {
-    boot_msg_println("management server enabled");
-    boot_msg_println("starting management server");
-    mngsrvr_status = mngsrvr->start(ControllerData->get_mngsrvr_port());
-    if ( mngsrvr_status != V_RUNNING )
-    {
-      ERROR_println("Management server start() error");
-    }
-  }
-  else
-  {
-    DEBUG_println("management server is NOT enabled");
-    DEBUG_println("management server will now be enabled, but not started");
-    ControllerData->set_mngsrvr_enable(V_ENABLED);
-  }
-
-
-  //-------------------------------------------------
-  // TCP/IP SERVER START
-  // Dependancy: WiFi has to be up and running before starting TCP/IP server
-  // Default state:  Enabled: Started
-  //-------------------------------------------------
-  // create pointer to class
-  tcpipsrvr = new TCPIP_SERVER();
-  // check if tcpip server is to be started at boot time
-  if ( ControllerData->get_tcpipsrvr_enable() == V_ENABLED)
-  {
-    boot_msg_println("Start TCPIP Server");
-    tcpipsrvr_status = tcpipsrvr->start(ControllerData->get_tcpipsrvr_port());
-    if ( tcpipsrvr_status != V_RUNNING )
-    {
-      ERROR_println("tcpip server start error");
-    }
-  }
+  boot_mark("tempprobe");
 
   //-------------------------------------------------
   // WEBSERVER START
@@ -1270,14 +1734,51 @@ void setup()
       ERROR_println("web server start() error");
     }
   }
+  boot_mark("webserver");
 
 
   //-------------------------------------------------
-  // TASK TIMER START
+  // TASK SCHEDULER START
   // Should be the last to start
   //-------------------------------------------------
-  boot_msg_println("Start task timer");
-  init_task_timer();
+  boot_msg_println("Start task scheduler");
+  // temp_update() only reads a running probe, so a probe started later
+  // by the management server is also updated
+  tasksched->start(job_temp);
+  if ( myfp2esp32mode == STATIONMODE )
+  {
+    tasksched->start(job_wifi);
+  }
+  tasksched->begin();
+  boot_mark("tasksched");
+
+  //-------------------------------------------------
+  // LOOP SCHEDULER START
+  // priority, interval min us, interval max us, latency budget us
+  // input is polled at a fixed rate, servers back off when idle
+  //-------------------------------------------------
+  boot_msg_println("Start loop scheduler");
+  loopsched = new LOOP_SCHEDULER();
+  loopsched->add("input", poll_input, 0, 10000, 10000, 5000);
+  loopsched->add("irremote", poll_irremote, 1, 20000, 20000, 10000);
+  loopsched->add("tcpip", poll_tcpipsrvr, 2, 2000, 50000, 20000);
+  loopsched->add("ascom", poll_ascomsrvr, 3, 5000, 100000, 50000);
+  loopsched->add("management", poll_mngsrvr, 4, 5000, 100000, 50000);
+  loopsched->add("web", poll_websrvr, 4, 5000, 100000, 50000);
+  loopsched->add("alpaca", poll_alpaca, 5, 100000, 100000, 200000);
+  if ( (ControllerData->get_brdnumber() == PRO2ESP32TMC2209) || (ControllerData->get_brdnumber() == PRO2ESP32TMC2209P) )
+  {
+    loopsched->add("stallmon", poll_stallmon, 1, STALLMON_INTERVAL, STALLMON_INTERVAL, 10000);
+  }
+  if ( (ControllerData->get_brdnumber() == PRO2ESP32TMC2225) || (ControllerData->get_brdnumber() == PRO2ESP32TMC2209) || (ControllerData->get_brdnumber() == PRO2ESP32TMC2209P) )
+  {
+    loopsched->add("tmctuner", poll_tmctuner, 1, TMCTUNER_INTERVAL, TMCTUNER_INTERVAL, 10000);
+  }
+  if ( focuser2 != NULL )
+  {
+    loopsched->add("focuser2", poll_focuser2, 1, 10000, 10000, 5000);
+  }
+  boot_mark("loopsched");
 
 
   //-------------------------------------------------
@@ -1286,155 +1787,125 @@ void setup()
   esp_task_wdt_init(WDT_TIMEOUT, true);       // enable panic reboot, dump registers, serial output - exception decoder
   esp_task_wdt_add(NULL);                     // add code to watch dog timer
 
-  // Try to prevent WiFi power save mode
+  // Try to prevent WiFi power save mode, the power manager allows it when parked
   WiFi.setSleep(false);
+#if defined(ENABLE_POWERSAVE)
+  powermgr->begin(true);
+#else
+  powermgr->begin(false);
+#endif
   
   reboot_start = false;                       // we have finished the reboot now
 
+  boot_mark("ready");
   boot_msg_println("Setup done, controller is ready");
 }
 
 // ----------------------------------------------------------------------
-// void check_options();
-// handle all device checks and updates
+// LOOP SCHEDULER JOBS
+// Polled from loop() by the loop scheduler, return true if there was
+// some activity. The web based servers do not report activity, the loop
+// scheduler treats a long poll as active instead.
 // ----------------------------------------------------------------------
-void check_options()
+bool poll_input(void)
 {
-  static Option_States OptionState = Option_pushbtn_joystick;
-  static int o_mux;                           // mutex for option states
-
-  // Option state engine
-  switch (OptionState)
+  // these are mutually exclusive, so use if else
+  if ( driverboard->get_pushbuttons_loaded() == true )
   {
-    case Option_pushbtn_joystick:
-      // these are mutually exclusive, so use if else
-      if ( driverboard->get_pushbuttons_loaded() == true )
-      {
-        driverboard->update_pushbuttons();
-      }
-      else if ( driverboard->get_joystick1_loaded() == true )
-      {
-        driverboard->update_joystick1();
-      }
-      else if ( driverboard->get_joystick2_loaded() == true )
-      {
-        driverboard->update_joystick2();
-      }
-      OptionState = Option_IRRemote;
-      break;
+    return driverboard->update_pushbuttons();
+  }
+  else if ( driverboard->get_joystick1_loaded() == true )
+  {
+    driverboard->update_joystick1();
+  }
+  else if ( driverboard->get_joystick2_loaded() == true )
+  {
+    driverboard->update_joystick2();
+  }
+  return false;
+}
 
-    case Option_IRRemote:
-      // use helpers because optional
-      irremote_update();
-      OptionState = Option_Display;
-      break;
+bool poll_irremote(void)
+{
+  // use helpers because optional
+  irremote_update();
+  return false;
+}
 
-    case Option_Display:
-      if ( display_status == V_RUNNING )
-      {
-        // display is optional so need to use helper
-        portENTER_CRITICAL(&displayMux);
-        o_mux = update_display_flag;
-        portEXIT_CRITICAL(&displayMux);
-        if ( o_mux == 1 )
-        {
-          portENTER_CRITICAL(&displayMux);
-          update_display_flag = 0;
-          portEXIT_CRITICAL(&displayMux);
-          // use helper
-          display_update();
-        }
-      }
-      OptionState = Option_Temperature;
-      break;
+bool poll_ascomsrvr(void)
+{
+  ascomsrvr->loop();                          // clients
+  return false;
+}
 
-    case Option_Temperature:
-      if ( tempprobe->get_state() == V_RUNNING )
-      {
-        portENTER_CRITICAL(&tempMux);
-        o_mux = update_temp_flag;
-        portEXIT_CRITICAL(&tempMux);
-        if ( o_mux == 1 )
-        {
-          portENTER_CRITICAL(&tempMux);
-          update_temp_flag = 0;
-          portEXIT_CRITICAL(&tempMux);
-          // read temp AND check Temperature Compensation
-          temp = tempprobe->update();
-        }
-      }
-      OptionState = Option_WiFi;
-      break;
+bool poll_alpaca(void)
+{
+  ascomsrvr->check_alpaca();                  // discovery
+  return false;
+}
 
-    case Option_WiFi:
-      // wifi connect check
-      portENTER_CRITICAL(&wifiMux);
-      o_mux = update_wifi_flag;
-      portEXIT_CRITICAL(&wifiMux);
-      if ( o_mux == 1)
-      {
-        if ( myfp2esp32mode == STATIONMODE )
-        {
-          if ( WiFi.status() != WL_CONNECTED )
-          {
-            ERROR_println("WiFi not connected: attempt reconnect");
-            WiFi.disconnect();
-            WiFi.reconnect();
-          }
-        }
-        update_wifi_flag = 0;
-      }
-      OptionState = Option_pushbtn_joystick;
-      break;
+bool poll_mngsrvr(void)
+{
+  mngsrvr->loop(Parked);
+  return false;
+}
 
-    default:
-      OptionState = Option_pushbtn_joystick;
-      break;
-  }
+bool poll_tcpipsrvr(void)
+{
+  return tcpipsrvr->loop(Parked);
 }
 
-void loop()
+bool poll_websrvr(void)
+{
+  websrvr->loop(Parked);
+  return false;
+}
+
+bool poll_stallmon(void)
+{
+  return stallmon->update();
+}
+
+bool poll_tmctuner(void)
+{
+  return tmctuner->update();
+}
+
+bool poll_focuser2(void)
+{
+  return focuser2->update();
+}
+
+// ----------------------------------------------------------------------
+// bool focuser_update(void);
+// Focuser state engine, called from loop(). Moves the focuser to
+// ftargetPosition through backlash, the move timer, the home position
+// switch and delay after move. Returns true if the focuser is stationary
+// ----------------------------------------------------------------------
+bool focuser_update(void)
 {
   static Focuser_States FocuserState = State_Idle;
   static uint32_t backlash_count = 0;
   static bool     DirOfTravel = (bool) ControllerData->get_focuserdirection();
-  static bool     Parked = true;              // focuser is parked
   static uint32_t TimeStampdelayaftermove = 0;
   static bool     tms = false;                // timersemaphore, used by movetimer
   static uint8_t  updatecount = 0;
   static uint32_t steps = 0;
   static uint32_t damcounter = 0;
-  static int t_mux;                           // mutex for focuser states
   static int stepstaken = 0;                  // used in finding Home Position Switch
   static bool hpswstate  = false;
 
-  esp_task_wdt_reset();                       // watch dog timer reset
-
-  // handle all the server loop checks, for new client or client requests
+  bool stationary = false;
 
-  // check ascom server for new clients
-  ascomsrvr->loop();                          // clients
-  ascomsrvr->check_alpaca();                  // discovery
-
-  // check management server for new clients
-  mngsrvr->loop(Parked);
-
-  // check TCPIP Server for new clients
-  tcpipsrvr->loop(Parked);
-
-  // check Web Server for new clients
-  websrvr->loop(Parked);
-
-  check_options();
-
-  // Focuser state engine
   switch (FocuserState)
   {
     case State_Idle:
       if (driverboard->getposition() != ftargetPosition)
       {
         // prepare to move focuser
+        powermgr->wake();                     // full clock before the move
         Parked = false;
+        tasksched->stop(job_park);
         oled_state = oled_on;
         isMoving = true;
         driverboard->enablemotor();
@@ -1449,59 +1920,15 @@ void loop()
       {
         // focuser stationary, isMoving is false
         isMoving = false;
+        stationary = true;
 
         // focuser stationary. isMoving is 0
+        uint32_t savecycles = looprof->start();
         if (ControllerData->SaveConfiguration(driverboard->getposition(), DirOfTravel)) // save config if needed
         {
           DEBUG_println("config saved");
         }
-
-        // park can be enabled or disabled (management server)
-        // park controls coil power off and display off after elapsed 30s following a move
-        // if park is enabled, 30s after a move ends, coilpower(if enabled) and display get turned off
-        // if park is not enabled, state of coilpower and display are not altered
-
-        // check if parking is enabled
-        if ( ControllerData->get_park_enable() == true )
-        {
-          // parking is enabled in ControllerData
-          // state_delayaftermove sets Parked false and sets park flag to 0
-          if (Parked == false)
-          {
-            // check parked flag state for 1 (means park time delay is expired)
-            portENTER_CRITICAL(&parkMux);
-            t_mux = update_park_flag;
-            portEXIT_CRITICAL(&parkMux);
-            if ( t_mux == 1 )
-            {
-              // 30s wait is over, disable park flag
-              // set flag to -1 so task timer no longer counts this flag
-              portENTER_CRITICAL(&parkMux);
-              update_park_flag = -1;
-              portEXIT_CRITICAL(&parkMux);
-              DEBUG_println("loop: park 30s expired: parking now");
-
-              // park focuser if parking is enabled
-              Parked = true;
-              DEBUG_println("loop: Parked=True");
-
-              // handle coil power
-              // Coil Power Status ON  - Controller does move, coil power remains on
-              // Coil Power Status OFF - Controller enables coil power, moves motor, after 30s elapsed releases power to motor
-              if ( ControllerData->get_coilpower_enable() == V_NOTENABLED )
-              {
-                driverboard->releasemotor();
-                DEBUG_println("loop: coilpower=released");
-              }
-
-              // turn off display
-              oled_state = oled_off;
-
-              // focuser is parked, coil power off, display off
-
-            }
-          }
-        }
+        looprof->stop(prof_saveconfig, savecycles);
       }
       break;
 
@@ -1685,6 +2112,7 @@ void loop()
           ftargetPosition = 0;
           driverboard->setposition(0);
           ControllerData->set_fposition(0);
+          stallmon->homed();                            // position is known again
           // check if display home position messages is enabled
           if ( ControllerData->get_hpswitch_enable() == V_ENABLED )
           {
@@ -1835,10 +2263,8 @@ void loop()
       // is parking enabled in controller?
       if ( ControllerData->get_park_enable() == true )
       {
-        DEBUG_println("State_EndMove: park is enabled, set update_park_flag 0 to start the count");
-        portENTER_CRITICAL(&parkMux);
-        update_park_flag = 0;
-        portEXIT_CRITICAL(&parkMux);
+        DEBUG_println("State_EndMove: park is enabled, start the park time");
+        tasksched->restart(job_park);
       }
       FocuserState = State_Idle;
       break;
@@ -1847,4 +2273,37 @@ void loop()
       FocuserState = State_Idle;
       break;
   }
+  return stationary;
+}
+
+void loop()
+{
+  esp_task_wdt_reset();                       // watch dog timer reset
+  uint32_t loopcycles = looprof->start();
+
+  // pushbuttons, joysticks, infrared remote, and server checks for new
+  // clients or client requests, activity leaves low power
+  if ( loopsched->run() == true )
+  {
+    powermgr->activity();
+  }
+
+  // display, temp probe, park, config saves and wifi check
+  uint32_t cycles = looprof->start();
+  tasksched->run();
+  looprof->stop(prof_tasksched, cycles);
+
+  cycles = looprof->start();
+
+  // Focuser state engine, start the deferred services (web page cache,
+  // duckdns) after boot when the focuser is stationary
+  if ( focuser_update() == true )
+  {
+    boot_deferred();
+  }
+  looprof->stop(prof_focuser, cycles);
+  looprof->stop(prof_loop, loopcycles);
+
+  // enters low power when parked and idle, yields in low power
+  powermgr->update(Parked && ((focuser2 == NULL) || (focuser2->get_ismoving() == false)));
 } // end Loop()
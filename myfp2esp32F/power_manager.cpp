@@ -0,0 +1,183 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 POWER MANAGER CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// power_manager.cpp
+// Reduced cpu clock and modem sleep while parked
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include <WiFi.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "power_manager.h"
+
+#include "loop_profiler.h"
+extern LOOP_PROFILER *looprof;
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define POWER_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  POWER_PRINT
+#define POWER_print(...)   Serial.print(__VA_ARGS__)
+#define POWER_println(...) Serial.println(__VA_ARGS__)
+#else
+#define POWER_print(...)
+#define POWER_println(...)
+#endif
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+POWER_MANAGER::POWER_MANAGER(void)
+{
+
+}
+
+void POWER_MANAGER::begin(bool enable)
+{
+  _fullmhz = getCpuFrequencyMhz();
+  _lastactivity = millis();
+  _enable = enable;
+  POWER_print("pm: full clock ");
+  POWER_println(_fullmhz);
+}
+
+void POWER_MANAGER::set_enable(bool enable)
+{
+  if ( enable == false )
+  {
+    exit_lowpower();
+  }
+  _lastactivity = millis();
+  _enable = enable;
+}
+
+bool POWER_MANAGER::get_enable(void)
+{
+  return _enable;
+}
+
+bool POWER_MANAGER::get_lowpower(void)
+{
+  return _lowpower;
+}
+
+// ----------------------------------------------------------------------
+// enter low power when parked and idle, in low power yield to the idle task
+// ----------------------------------------------------------------------
+void POWER_MANAGER::update(bool parked)
+{
+  if ( _lowpower == true )
+  {
+    vTaskDelay(POWER_IDLEDELAY / portTICK_PERIOD_MS);
+    return;
+  }
+  if ( (_enable == true) && (parked == true) && ((millis() - _lastactivity) > POWER_IDLETIME) )
+  {
+    enter_lowpower();
+  }
+}
+
+void POWER_MANAGER::activity(void)
+{
+  _lastactivity = millis();
+  exit_lowpower();
+}
+
+// ----------------------------------------------------------------------
+// a move is about to start, the latency is measured to the first step
+// ----------------------------------------------------------------------
+void POWER_MANAGER::wake(void)
+{
+  _fromlow = _lowpower;
+  _wakeus  = micros();
+  _measure = true;
+  activity();
+}
+
+void IRAM_ATTR POWER_MANAGER::step(void)
+{
+  if ( _measure == false )
+  {
+    return;
+  }
+  _measure = false;
+  uint32_t latency = micros() - _wakeus;
+  _move_last = latency;
+  if ( _fromlow == true )
+  {
+    _wake_last = latency;
+    _wake_max = (latency > _wake_max) ? latency : _wake_max;
+    _wake_total += latency;
+    _wakes++;
+  }
+}
+
+void POWER_MANAGER::enter_lowpower(void)
+{
+  POWER_println("pm: enter low power");
+  setCpuFrequencyMhz(POWER_LOWMHZ);
+  looprof->set_mhz(POWER_LOWMHZ);             // cycles are converted to time when recorded
+  WiFi.setSleep(true);                        // modem sleep between DTIM beacons
+  _lowstart = millis();
+  _entries++;
+  _lowpower = true;
+}
+
+void POWER_MANAGER::exit_lowpower(void)
+{
+  if ( _lowpower == false )
+  {
+    return;
+  }
+  unsigned long start = micros();
+  setCpuFrequencyMhz(_fullmhz);
+  _switch_us = micros() - start;
+  looprof->set_mhz(_fullmhz);
+  WiFi.setSleep(false);
+  _lowtime += millis() - _lowstart;
+  _lowpower = false;
+  POWER_println("pm: exit low power");
+}
+
+// ----------------------------------------------------------------------
+// low power time and wake to first step latency in us
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String POWER_MANAGER::get_stats(void)
+{
+  unsigned long lowtime = _lowtime + ((_lowpower == true) ? (millis() - _lowstart) : 0);
+  uint32_t wakes = (_wakes == 0) ? 1 : _wakes;
+  String jsonstr = "{ \"enable\":" + String(_enable) + ", \"lowpower\":" + String(_lowpower) \
+                   + ", \"mhz\":" + String(getCpuFrequencyMhz()) + ", \"entries\":" + String(_entries) \
+                   + ", \"lowtime\":" + String(lowtime) + ", \"switch\":" + String(_switch_us) \
+                   + ", \"move_last\":" + String(_move_last) + ", \"wakes\":" + String(_wakes) \
+                   + ", \"wake_last\":" + String(_wake_last) + ", \"wake_max\":" + String(_wake_max) \
+                   + ", \"wake_avg\":" + String(_wake_total / wakes) + " }";
+  return jsonstr;
+}
+
+void POWER_MANAGER::reset_stats(void)
+{
+  _entries    = 0;
+  _lowtime    = 0;
+  _lowstart   = millis();
+  _switch_us  = 0;
+  _move_last  = 0;
+  _wake_last  = 0;
+  _wake_max   = 0;
+  _wake_total = 0;
+  _wakes      = 0;
+}
@@ -0,0 +1,77 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 POWER MANAGER CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// power_manager.h
+// ----------------------------------------------------------------------
+
+#if !defined(_power_manager_h_)
+#define _power_manager_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define POWER_LOWMHZ      80              // lowest cpu clock that WiFi supports, APB stays at 80MHz so hw timers are not affected
+#define POWER_IDLETIME    10000           // ms, parked with no activity before entering low power
+#define POWER_IDLEDELAY   2               // ms, loop() yields to the idle task for this long each pass in low power
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// When the focuser is parked and there has been no network or input
+// activity for POWER_IDLETIME, the cpu clock is reduced, WiFi modem sleep
+// is allowed and loop() yields each pass so the idle task can wait for an
+// interrupt. Activity or the start of a move returns to full clock. Moves
+// only run at full clock, so the step pulse timing in the driver board
+// is unchanged.
+class POWER_MANAGER
+{
+  public:
+    POWER_MANAGER(void);
+
+    void begin(bool);                     // enable state, records the full cpu clock
+    void set_enable(bool);
+    bool get_enable(void);
+    bool get_lowpower(void);
+
+    void update(bool);                    // call each loop() pass with the park state
+    void activity(void);                  // network or input activity
+    void wake(void);                      // full clock, call before a move starts
+    void IRAM_ATTR step(void);            // first step of a move, called from the isr
+
+    String get_stats(void);
+    void reset_stats(void);
+
+  private:
+    void enter_lowpower(void);
+    void exit_lowpower(void);
+
+    bool     _enable = false;
+    bool     _lowpower = false;
+    uint32_t _fullmhz = 240;
+    unsigned long _lastactivity = 0;      // millis()
+    unsigned long _lowstart = 0;          // millis() low power was entered
+    // stats
+    uint32_t _entries = 0;
+    unsigned long _lowtime = 0;           // ms in low power, completed periods
+    uint32_t _switch_us = 0;              // time to restore the full clock
+    volatile bool     _measure = false;   // waiting for the first step
+    volatile bool     _fromlow = false;   // the move woke from low power
+    volatile uint32_t _wakeus = 0;        // micros() at wake()
+    volatile uint32_t _move_last = 0;     // us, wake to first step of the last move
+    volatile uint32_t _wake_last = 0;     // us, wake to first step, moves from low power
+    volatile uint32_t _wake_max = 0;
+    volatile uint32_t _wake_total = 0;
+    volatile uint32_t _wakes = 0;
+};
+
+
+
+#endif // #if !defined(_power_manager_h_)
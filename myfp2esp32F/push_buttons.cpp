@@ -0,0 +1,296 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 PUSH BUTTONS CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// push_buttons.cpp
+// Interrupt captured, debounced push buttons with hold to jog
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "push_buttons.h"
+#include "hal.h"                              // gpio
+#include "jog_engine.h"                       // JOG_SCALE
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define PB_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  PB_PRINT
+#define PB_print(...)   Serial.print(__VA_ARGS__)
+#define PB_println(...) Serial.println(__VA_ARGS__)
+#else
+#define PB_print(...)
+#define PB_println(...)
+#endif
+
+
+// ----------------------------------------------------------------------
+// CONTROLLER CONFIG DATA
+// ----------------------------------------------------------------------
+#include "controller_data.h"
+extern CONTROLLER_DATA *ControllerData;
+
+
+// ----------------------------------------------------------------------
+// DRIVER BOARD
+// ----------------------------------------------------------------------
+#include "driver_board.h"
+extern DRIVER_BOARD *driverboard;
+
+
+// ----------------------------------------------------------------------
+// EXTERNS
+// ----------------------------------------------------------------------
+extern long ftargetPosition;
+extern PUSH_BUTTONS *pbinput;
+
+
+// ----------------------------------------------------------------------
+// DATA AND ISR
+// ----------------------------------------------------------------------
+portMUX_TYPE pbMux = portMUX_INITIALIZER_UNLOCKED;           // protects the edge data
+
+// This must be outside of class
+void IRAM_ATTR pb1_isr()
+{
+  pbinput->edge(0);
+}
+
+void IRAM_ATTR pb2_isr()
+{
+  pbinput->edge(1);
+}
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+PUSH_BUTTONS::PUSH_BUTTONS(void)
+{
+
+}
+
+void PUSH_BUTTONS::begin(int pb1pin, int pb2pin)
+{
+  _pins[0] = pb1pin;
+  _pins[1] = pb2pin;
+  for (int i = 0; i < PB_BUTTONS; i++)
+  {
+    // PB are active high - pins are low by virtue of pull down resistors through J16 and J17 jumpers
+    hal_pinmode(_pins[i], INPUT);
+    _state[i] = (hal_digitalread(_pins[i]) == 1);
+    _pending[i] = false;
+  }
+  _holding = false;
+  attachInterrupt(_pins[0], pb1_isr, CHANGE);
+  attachInterrupt(_pins[1], pb2_isr, CHANGE);
+  PB_println("pb: started");
+}
+
+void PUSH_BUTTONS::end(void)
+{
+  for (int i = 0; i < PB_BUTTONS; i++)
+  {
+    if ( _pins[i] != -1 )
+    {
+      detachInterrupt(_pins[i]);
+    }
+  }
+  if ( _holding == true )
+  {
+    driverboard->jog(0);
+    _holding = false;
+  }
+}
+
+// ----------------------------------------------------------------------
+// pin change, the first edge of a burst is the time of the change
+// ----------------------------------------------------------------------
+void IRAM_ATTR PUSH_BUTTONS::edge(int button)
+{
+  uint32_t ms = millis();
+  portENTER_CRITICAL_ISR(&pbMux);
+  if ( _pending[button] == false )
+  {
+    _firstedge[button] = ms;
+    _pending[button] = true;
+  }
+  _lastedge[button] = ms;
+  _edges++;
+  portEXIT_CRITICAL_ISR(&pbMux);
+}
+
+// ----------------------------------------------------------------------
+// accept a change once the pin has settled
+// ----------------------------------------------------------------------
+pb_event PUSH_BUTTONS::check(int button, unsigned long now)
+{
+  bool pending;
+  uint32_t first;
+  uint32_t last;
+  portENTER_CRITICAL(&pbMux);
+  pending = _pending[button];
+  first   = _firstedge[button];
+  last    = _lastedge[button];
+  portEXIT_CRITICAL(&pbMux);
+
+  if ( (pending == false) || ((now - last) < PB_DEBOUNCE) )
+  {
+    return pb_none;
+  }
+  portENTER_CRITICAL(&pbMux);
+  // an edge after the read above starts a new burst
+  if ( _lastedge[button] == last )
+  {
+    _pending[button] = false;
+  }
+  portEXIT_CRITICAL(&pbMux);
+
+  bool state = (hal_digitalread(_pins[button]) == 1);
+  if ( state == _state[button] )
+  {
+    _rejected++;
+    return pb_none;
+  }
+  _state[button] = state;
+  uint32_t latency = now - first;
+  _latency_max = (latency > _latency_max) ? latency : _latency_max;
+  if ( state == true )
+  {
+    _pressed[button] = first;
+    _presses++;
+    return pb_press;
+  }
+  return pb_release;
+}
+
+// ----------------------------------------------------------------------
+// process the buttons, call from loop()
+// ----------------------------------------------------------------------
+pb_event PUSH_BUTTONS::update(void)
+{
+  unsigned long now = millis();
+  pb_event last = pb_none;
+
+  for (int i = 0; i < PB_BUTTONS; i++)
+  {
+    pb_event ev = check(i, now);
+    if ( ev == pb_press )
+    {
+      if ( _holding == true )
+      {
+        // second button while jogging, stop
+        driverboard->jog(0);
+        _holding = false;
+        continue;
+      }
+      long newpos = ftargetPosition + ((i == 0) ? -ControllerData->get_pushbutton_steps() : ControllerData->get_pushbutton_steps());
+      // an unsigned long range is 0 to 4,294,967,295
+      // when an unsigned long decrements from 0-1 it goes to largest +ve value, ie 4,294,967,295
+      // which would in likely be much much greater than maxstep
+      newpos = (newpos < 0 ) ? 0 : newpos;
+      newpos = (newpos > (long) ControllerData->get_maxstep()) ? ControllerData->get_maxstep() : newpos;
+      ftargetPosition = newpos;
+      last = ev;
+    }
+    else if ( ev == pb_release )
+    {
+      if ( (_holding == true) && (_holdbutton == i) )
+      {
+        driverboard->jog(0);
+        _holding = false;
+      }
+      last = ev;
+    }
+  }
+
+  // a held button jogs, the rate follows the time held
+  for (int i = 0; i < PB_BUTTONS; i++)
+  {
+    if ( (_state[i] == false) || ((_holding == true) && (_holdbutton != i)) )
+    {
+      continue;
+    }
+    unsigned long held = now - _pressed[i];
+    if ( held < PB_HOLDTIME )
+    {
+      continue;
+    }
+    if ( (_holding == false) && (_state[1 - i] == false) )
+    {
+      _holding = true;
+      _holdbutton = i;
+      _holds++;
+      last = pb_hold;
+    }
+    if ( _holding == true )
+    {
+      int r = rate(held - PB_HOLDTIME);
+      driverboard->jog((i == 0) ? -r : r);
+    }
+  }
+  return last;
+}
+
+// ----------------------------------------------------------------------
+// jog rate for the time into a hold, minimum to full with the square of
+// the time, permille
+// ----------------------------------------------------------------------
+int PUSH_BUTTONS::rate(unsigned long ms)
+{
+  if ( (_ramptime == 0) || (ms >= _ramptime) )
+  {
+    return JOG_SCALE;
+  }
+  uint32_t n = (ms * JOG_SCALE) / _ramptime;
+  return _jogmin + (((n * n) / JOG_SCALE) * (JOG_SCALE - _jogmin)) / JOG_SCALE;
+}
+
+void PUSH_BUTTONS::set_curve(int jogmin, unsigned long ramptime)
+{
+  _jogmin   = (jogmin < 1) ? 1 : ((jogmin > JOG_SCALE) ? JOG_SCALE : jogmin);
+  _ramptime = (ramptime > PB_RAMPMAX) ? PB_RAMPMAX : ramptime;
+}
+
+int PUSH_BUTTONS::get_jogmin(void)
+{
+  return _jogmin;
+}
+
+unsigned long PUSH_BUTTONS::get_ramptime(void)
+{
+  return _ramptime;
+}
+
+// ----------------------------------------------------------------------
+// edges, accepted presses and holds, rejected bounces and latency
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String PUSH_BUTTONS::get_stats(void)
+{
+  String jsonstr = "{ \"jogmin\":" + String(_jogmin) + ", \"ramptime\":" + String(_ramptime) \
+                   + ", \"edges\":" + String(_edges) + ", \"presses\":" + String(_presses) \
+                   + ", \"holds\":" + String(_holds) + ", \"rejected\":" + String(_rejected) \
+                   + ", \"latency_max\":" + String(_latency_max) + " }";
+  return jsonstr;
+}
+
+void PUSH_BUTTONS::reset_stats(void)
+{
+  _edges       = 0;
+  _presses     = 0;
+  _holds       = 0;
+  _rejected    = 0;
+  _latency_max = 0;
+}
@@ -0,0 +1,83 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 PUSH BUTTONS CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// push_buttons.h
+// ----------------------------------------------------------------------
+
+#if !defined(_push_buttons_h_)
+#define _push_buttons_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define PB_BUTTONS        2               // pb1 moves in, pb2 moves out
+#define PB_DEBOUNCE       20              // ms, a pin must be stable this long before a change is accepted
+#define PB_HOLDTIME       500             // ms, pressed this long becomes a hold and starts a jog
+#define PB_JOGMIN         20              // jog rate at the start of a hold, permille of the fastest step rate
+#define PB_RAMPTIME       3000            // ms, hold time to reach the full jog rate
+#define PB_RAMPMAX        60000           // ms, longest ramp time that can be set
+
+enum pb_event { pb_none, pb_press, pb_hold, pb_release };
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// Pin changes are captured by interrupt and time stamped. update() runs
+// from loop() and accepts a change once the pin has been stable for
+// PB_DEBOUNCE, giving press, hold and release events. A press moves the
+// target by the pushbutton steps. A hold jogs the motor, the rate rises
+// from the jog minimum to the full rate over the ramp time with the
+// square of the time held, and release halts the jog. Times come from
+// the interrupt time stamps, so the jog does not depend on how often
+// loop() gets to the buttons.
+class PUSH_BUTTONS
+{
+  public:
+    PUSH_BUTTONS(void);
+
+    void begin(int, int);                 // pb1 and pb2 pins, attaches the interrupts
+    void end(void);                       // detaches the interrupts
+    pb_event update(void);                // call from loop(), returns the last event
+    void IRAM_ATTR edge(int);             // called by the pin isr
+
+    void set_curve(int, unsigned long);   // jog minimum permille, ramp time ms
+    int  get_jogmin(void);
+    unsigned long get_ramptime(void);
+    int  rate(unsigned long);             // jog rate after being held for ms
+
+    String get_stats(void);
+    void reset_stats(void);
+
+  private:
+    pb_event check(int, unsigned long);
+
+    int  _pins[PB_BUTTONS] = { -1, -1 };
+    bool _state[PB_BUTTONS] = { false, false };       // debounced, true is pressed
+    unsigned long _pressed[PB_BUTTONS] = { 0, 0 };    // millis() of the press
+    bool _holding = false;
+    int  _holdbutton = 0;
+    int  _jogmin = PB_JOGMIN;
+    unsigned long _ramptime = PB_RAMPTIME;
+    // written by the isr
+    volatile bool     _pending[PB_BUTTONS] = { false, false };
+    volatile uint32_t _firstedge[PB_BUTTONS] = { 0, 0 };   // millis() of the first edge of a change
+    volatile uint32_t _lastedge[PB_BUTTONS] = { 0, 0 };    // millis() of the latest edge
+    volatile uint32_t _edges = 0;
+    // stats
+    uint32_t _presses = 0;
+    uint32_t _holds = 0;
+    uint32_t _rejected = 0;               // edge bursts which settled back to the same state
+    uint32_t _latency_max = 0;            // ms, first edge to the event
+};
+
+
+
+#endif // #if !defined(_push_buttons_h_)
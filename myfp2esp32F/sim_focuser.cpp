@@ -0,0 +1,240 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 SIMULATED FOCUSER CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// sim_focuser.cpp
+// Host only, motor and drawtube model for the HAL
+// ----------------------------------------------------------------------
+
+#if !defined(ARDUINO)
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include "hal.h"
+#include "sim_focuser.h"
+
+
+// ----------------------------------------------------------------------
+// DATA AND HOOK
+// ----------------------------------------------------------------------
+static SIM_FOCUSER *sim_active = NULL;    // focuser which receives the pin writes
+
+static void sim_onwrite(int pin, int level)
+{
+  if ( sim_active != NULL )
+  {
+    sim_active->pin(pin, level);
+  }
+}
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+SIM_FOCUSER::SIM_FOCUSER(void)
+{
+  sim_config cfg = { -1, -1, -1, -1, false, false, 1, 0, 0, 0, 0, 1000, 0 };
+  _cfg = cfg;
+}
+
+// ----------------------------------------------------------------------
+// reset the model to the configuration and hook the pin writes
+// ----------------------------------------------------------------------
+void SIM_FOCUSER::begin(const sim_config &cfg)
+{
+  _cfg          = cfg;
+  _cfg.stepmode = (_cfg.stepmode < 1) ? 1 : _cfg.stepmode;
+  _cfg.backlash = (_cfg.backlash < 0) ? 0 : _cfg.backlash;
+  _stepstate = hal_digitalread(_cfg.steppin);
+  _dirstate  = hal_digitalread(_cfg.dirpin);
+  _enabled   = (_cfg.enablepin < 0) ? true : (hal_digitalread(_cfg.enablepin) == 0);
+  _motor     = _cfg.startposition;
+  _tube      = _cfg.startposition;
+  _havestep  = false;
+  _sgresult  = SIM_SGMAX;
+  _stalled   = false;
+  reset_stats();
+  update_pins();
+  sim_active = this;
+  _running   = true;
+  hal_host_onwrite(&sim_onwrite);
+}
+
+void SIM_FOCUSER::end(void)
+{
+  if ( sim_active == this )
+  {
+    hal_host_onwrite(NULL);
+    sim_active = NULL;
+  }
+  _running = false;
+}
+
+// ----------------------------------------------------------------------
+// a step is taken on the rising edge of the step pin, enable is active low
+// ----------------------------------------------------------------------
+void SIM_FOCUSER::pin(int pin, int level)
+{
+  if ( _running == false )
+  {
+    return;
+  }
+  if ( pin == _cfg.dirpin )
+  {
+    _dirstate = level;
+  }
+  else if ( pin == _cfg.enablepin )
+  {
+    _enabled = (level == 0);
+  }
+  else if ( pin == _cfg.steppin )
+  {
+    if ( (level != 0) && (_stepstate == 0) )
+    {
+      step();
+    }
+    _stepstate = level;
+  }
+}
+
+void SIM_FOCUSER::step(void)
+{
+  uint64_t now = hal_host_clock();
+  uint32_t rate = 0;                      // full steps per second
+  if ( _havestep == true )
+  {
+    uint64_t gap = now - _laststep;
+    gap = (gap == 0) ? 1 : gap;
+    rate = (uint32_t) (1000000ULL / (gap * (uint64_t) _cfg.stepmode));
+  }
+  _first    = (_steps == 0) ? (uint32_t) now : _first;
+  _last     = (uint32_t) now;
+  _laststep = now;
+  _havestep = true;
+  _steps++;
+
+  bool out = (_dirstate != 0) ? !_cfg.reverse : _cfg.reverse;
+  bool blocked = (out == false) && ((_motor - _tube) == 0) && (_tube <= _cfg.minposition);
+
+  // load falls linearly to the floor at the pull-out rate, against the
+  // hard stop or past pull-out the rotor slips and the reading is 0
+  if ( (_enabled == false) || blocked || ((_cfg.pullout != 0) && (rate > _cfg.pullout)) )
+  {
+    _sgresult = (_enabled == false) ? SIM_SGMAX : 0;
+    _lost++;
+  }
+  else
+  {
+    uint32_t pullout = (_cfg.pullout == 0) ? 1 : _cfg.pullout;
+    _sgresult = SIM_SGMAX - (int) (((uint64_t) (SIM_SGMAX - SIM_SGFLOOR) * rate) / pullout);
+    if ( out == true )
+    {
+      // take up the slack before the drawtube moves
+      _motor++;
+      if ( (_motor - _tube) > _cfg.backlash )
+      {
+        _tube++;
+      }
+    }
+    else
+    {
+      _motor--;
+      if ( _motor < _tube )
+      {
+        _tube--;
+      }
+    }
+  }
+  _stalled = (_cfg.sgthrs != 0) && (_sgresult < (2 * _cfg.sgthrs));
+  update_pins();
+}
+
+// ----------------------------------------------------------------------
+// the home switch uses the internal pullup so is low when closed, the
+// DIAG output is high on a stall
+// ----------------------------------------------------------------------
+void SIM_FOCUSER::update_pins(void)
+{
+  if ( _cfg.hpswpin < 0 )
+  {
+    return;
+  }
+  if ( _cfg.diag == true )
+  {
+    hal_host_setpin(_cfg.hpswpin, _stalled ? 1 : 0);
+  }
+  else
+  {
+    hal_host_setpin(_cfg.hpswpin, home() ? 0 : 1);
+  }
+}
+
+long SIM_FOCUSER::motor(void)
+{
+  return _motor;
+}
+
+long SIM_FOCUSER::position(void)
+{
+  return _tube;
+}
+
+long SIM_FOCUSER::slack(void)
+{
+  return _motor - _tube;
+}
+
+bool SIM_FOCUSER::home(void)
+{
+  return _tube <= _cfg.homeposition;
+}
+
+bool SIM_FOCUSER::stalled(void)
+{
+  return _stalled;
+}
+
+int SIM_FOCUSER::stallguard(void)
+{
+  return _sgresult;
+}
+
+void SIM_FOCUSER::set_sgthrs(uint8_t sgthrs)
+{
+  _cfg.sgthrs = sgthrs;
+}
+
+void SIM_FOCUSER::set_pullout(uint32_t pullout)
+{
+  _cfg.pullout = pullout;
+}
+
+uint32_t SIM_FOCUSER::steps(void)
+{
+  return _steps;
+}
+
+uint32_t SIM_FOCUSER::lost(void)
+{
+  return _lost;
+}
+
+uint32_t SIM_FOCUSER::first_step(void)
+{
+  return _first;
+}
+
+uint32_t SIM_FOCUSER::last_step(void)
+{
+  return _last;
+}
+
+void SIM_FOCUSER::reset_stats(void)
+{
+  _steps = 0;
+  _lost  = 0;
+  _first = 0;
+  _last  = 0;
+}
+
+#endif // #if !defined(ARDUINO)
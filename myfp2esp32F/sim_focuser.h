@@ -0,0 +1,106 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 SIMULATED FOCUSER CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// sim_focuser.h
+// ----------------------------------------------------------------------
+
+#if !defined(_sim_focuser_h_)
+#define _sim_focuser_h_
+
+#if !defined(ARDUINO)
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include "hal.h"
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define SIM_SGMAX         510             // SG_RESULT with no load
+#define SIM_SGFLOOR       40              // SG_RESULT at the pull-out rate
+
+
+// ----------------------------------------------------------------------
+// CONFIGURATION
+// ----------------------------------------------------------------------
+// positions are in steps at the configured step mode
+struct sim_config
+{
+  int      steppin;
+  int      dirpin;
+  int      enablepin;                     // -1 if the board has no enable pin
+  int      hpswpin;                       // -1 if no home switch or diag pin
+  bool     reverse;                       // dir pin high moves in
+  bool     diag;                          // hpswpin is the TMC2209 DIAG output, high on a stall
+  int      stepmode;                      // microsteps per full step
+  long     startposition;                 // drawtube position at reset
+  long     backlash;                      // lost motion on a change of direction
+  long     homeposition;                  // switch is closed at and below this position
+  long     minposition;                   // hard stop, the drawtube cannot go below this
+  uint32_t pullout;                       // full steps per second, faster steps are lost
+  uint8_t  sgthrs;                        // TMC2209 SGTHRS, stall if SG_RESULT < 2 * sgthrs
+};
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// Host only model of the motor and drawtube, driven by the step and dir
+// pulses written through the HAL. The motor takes up the backlash before
+// the drawtube moves, steps faster than the pull-out rate or against the
+// hard stop are lost, and the home switch / DIAG pin is driven from the
+// drawtube position and StallGuard reading. No random terms are used so
+// a run gives the same result every time.
+class SIM_FOCUSER
+{
+  public:
+    SIM_FOCUSER(void);
+    void begin(const sim_config &);       // hooks the HAL pin writes
+    void end(void);
+
+    void pin(int, int);                   // called by the HAL on a pin write
+
+    long motor(void);                     // steps taken by the motor
+    long position(void);                  // drawtube position
+    long slack(void);                     // motor ahead of the drawtube, 0 to backlash, 0 after moving in
+    bool home(void);                      // home switch closed
+    bool stalled(void);
+    int  stallguard(void);                // SG_RESULT of the last step
+    void set_sgthrs(uint8_t);
+    void set_pullout(uint32_t);
+
+    uint32_t steps(void);                 // step pulses seen
+    uint32_t lost(void);                  // pulses which did not move the motor
+    uint32_t first_step(void);            // us, time of the first and last pulse
+    uint32_t last_step(void);
+    void reset_stats(void);
+
+  private:
+    void step(void);
+    void update_pins(void);
+
+    sim_config _cfg;
+    bool     _running = false;
+    int      _stepstate = 0;
+    int      _dirstate = 0;
+    bool     _enabled = true;
+    long     _motor = 0;
+    long     _tube = 0;
+    uint64_t _laststep = 0;               // clock of the last pulse
+    bool     _havestep = false;
+    int      _sgresult = SIM_SGMAX;
+    bool     _stalled = false;
+    // stats
+    uint32_t _steps = 0;
+    uint32_t _lost = 0;
+    uint32_t _first = 0;
+    uint32_t _last = 0;
+};
+
+
+
+#endif // #if !defined(ARDUINO)
+
+#endif // #if !defined(_sim_focuser_h_)
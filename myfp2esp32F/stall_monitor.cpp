@@ -0,0 +1,440 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 STALL MONITOR CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// stall_monitor.cpp
+// StallGuard4 sampling, stall detection, re-home and SGTHRS calibration
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "file_system.h"
+#include "stall_monitor.h"
+
+#include "controller_data.h"
+extern CONTROLLER_DATA *ControllerData;
+
+#include "driver_board.h"
+extern DRIVER_BOARD *driverboard;
+
+#include "tmc_tuner.h"
+extern TMC_TUNER *tmctuner;
+
+extern bool filesystemloaded;
+extern long ftargetPosition;
+extern bool isMoving;
+extern volatile bool halt_alert;
+extern portMUX_TYPE  halt_alertMux;
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define STALLMON_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  STALLMON_PRINT
+#define STALLMON_print(...)   Serial.print(__VA_ARGS__)
+#define STALLMON_println(...) Serial.println(__VA_ARGS__)
+#else
+#define STALLMON_print(...)
+#define STALLMON_println(...)
+#endif
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+STALL_MONITOR::STALL_MONITOR(void)
+{
+
+}
+
+void STALL_MONITOR::begin(void)
+{
+  if ( load() == true )
+  {
+    STALLMON_println("stallmon: calibration loaded");
+  }
+}
+
+// ----------------------------------------------------------------------
+// called every STALLMON_INTERVAL, the uart is only read while moving
+// ----------------------------------------------------------------------
+bool STALL_MONITOR::update(void)
+{
+  // a new move
+  if ( (isMoving == true) && (_moving == false) )
+  {
+    _movesamples = 0;
+    _low = 0;
+  }
+  // end of a re-home move, homed() was not called so the switch was not found
+  if ( (isMoving == false) && (_moving == true) && (_rehoming == true) )
+  {
+    _rehoming = false;
+    _rehomefails++;
+    ERROR_println("stallmon: re-home did not find the home position switch");
+  }
+  _moving = isMoving;
+
+  if ( _calstate != Cal_Idle )
+  {
+    cal_update();
+  }
+  else if ( (isMoving == false) && (_rehomepending == true) )
+  {
+    // move in far enough to reach the switch from where the motor really is,
+    // the switch stops the move and sets the position to 0
+    _rehomepending = false;
+    _rehoming = true;
+    driverboard->setposition(driverboard->getposition() + STALLMON_REHOMEMARGIN);
+    ftargetPosition = 0;
+    STALLMON_println("stallmon: re-home");
+    return false;
+  }
+
+  if ( isMoving == false )
+  {
+    return false;
+  }
+  // SG_RESULT is not valid in SpreadCycle
+  int sg = driverboard->get_sgresult();
+  if ( (sg < 0) || (tmctuner->get_spreadcycle() == true) )
+  {
+    return false;
+  }
+  sample(sg, driverboard->getposition());
+  return true;
+}
+
+// ----------------------------------------------------------------------
+// the start of a move is skipped, the motor is still settling. A move to
+// 0 is a home move where a stall is expected
+// ----------------------------------------------------------------------
+void STALL_MONITOR::sample(int sg, long pos)
+{
+  _samples++;
+  _lastsg = sg;
+  _movesamples++;
+  if ( _movesamples <= STALLMON_SETTLE )
+  {
+    return;
+  }
+  if ( _calstate == Cal_Moving )
+  {
+    _calmin = ((_calcount == 0) || (sg < _calmin)) ? sg : _calmin;
+    _calsum += sg;
+    _calcount++;
+    return;
+  }
+  if ( (_enable == false) || (_calstate != Cal_Idle) || (ftargetPosition == 0) )
+  {
+    return;
+  }
+
+  byte speed = ControllerData->get_motorspeed();
+  speed = (speed >= STALLMON_SPEEDS) ? STALLMON_SPEEDS - 1 : speed;
+  if ( (_basecount[speed] >= STALLMON_MINBASE) && (sg < ((_base[speed] * STALLMON_STALLPCT) / 100)) )
+  {
+    if ( _low == 0 )
+    {
+      _lowpos = pos;
+    }
+    _low++;
+    if ( _low == STALLMON_CONFIRM )
+    {
+      stall(pos);
+    }
+    return;
+  }
+  _low = 0;
+  // learn, the first samples are averaged then a moving average
+  _basecount[speed]++;
+  if ( _basecount[speed] <= STALLMON_LEARN )
+  {
+    _base[speed] += (sg - _base[speed]) / _basecount[speed];
+  }
+  else
+  {
+    _base[speed] += (sg - _base[speed]) / STALLMON_LEARN;
+  }
+}
+
+void STALL_MONITOR::stall(long pos)
+{
+  _stalls++;
+  _trusted = false;
+  _lost += (pos > _lowpos) ? (pos - _lowpos) : (_lowpos - pos);
+  ERROR_print("stallmon: stall at ");
+  ERROR_println(pos);
+  portENTER_CRITICAL(&halt_alertMux);
+  halt_alert = true;
+  portEXIT_CRITICAL(&halt_alertMux);
+  if ( ControllerData->get_hpswitch_enable() == V_ENABLED )
+  {
+    _rehomepending = true;
+  }
+}
+
+// ----------------------------------------------------------------------
+// calibration, a move out and back at each speed with SGTHRS 0. The
+// lowest SG_RESULT of the free running move out sets SGTHRS, the stall
+// output is set when SG_RESULT is below twice SGTHRS
+// ----------------------------------------------------------------------
+bool STALL_MONITOR::calibrate(void)
+{
+  if ( (isMoving == true) || (_calstate != Cal_Idle) )
+  {
+    return false;
+  }
+  if ( (ControllerData->get_brdnumber() != PRO2ESP32TMC2209) && (ControllerData->get_brdnumber() != PRO2ESP32TMC2209P) )
+  {
+    return false;
+  }
+  _calsaved = ControllerData->get_motorspeed();
+  _calspeed = 0;
+  _calskipped = 0;
+  _calresult = "running";
+  _calstate = Cal_Start;
+  STALLMON_println("stallmon: calibrate");
+  return true;
+}
+
+void STALL_MONITOR::cal_update(void)
+{
+  switch ( _calstate )
+  {
+    case Cal_Start:
+      if ( isMoving == true )
+      {
+        break;
+      }
+      ControllerData->set_motorspeed(_calspeed);
+      _calhome = driverboard->getposition();
+      _calmin = 0;
+      _calsum = 0;
+      _calcount = 0;
+      _calseen = false;
+      // out unless too close to maxstep
+      if ( (_calhome + STALLMON_CALSTEPS) <= (long) ControllerData->get_maxstep() )
+      {
+        ftargetPosition = _calhome + STALLMON_CALSTEPS;
+      }
+      else
+      {
+        ftargetPosition = (_calhome > STALLMON_CALSTEPS) ? _calhome - STALLMON_CALSTEPS : 1;
+      }
+      _calstate = Cal_Moving;
+      break;
+
+    case Cal_Moving:
+      _calseen = (isMoving == true) ? true : _calseen;
+      if ( (_calseen == true) && (isMoving == false) )
+      {
+        // a speed without samples keeps its previous values, the
+        // focuser still returns home before the next speed
+        if ( _calcount == 0 )
+        {
+          _calskipped++;
+          STALLMON_print("stallmon: speed ");
+          STALLMON_print(_calspeed);
+          STALLMON_println(" no samples");
+        }
+        else
+        {
+          int thrs = ((_calmin * STALLMON_CALMARGIN) / 100) / 2;
+          _sgthrs[_calspeed] = (thrs < 1) ? 1 : ((thrs > 255) ? 255 : thrs);
+          _base[_calspeed] = (float) _calsum / _calcount;
+          _basecount[_calspeed] = STALLMON_MINBASE;
+          STALLMON_print("stallmon: speed ");
+          STALLMON_print(_calspeed);
+          STALLMON_print(" sgthrs ");
+          STALLMON_println(_sgthrs[_calspeed]);
+        }
+        ftargetPosition = _calhome;
+        _calseen = false;
+        _calstate = Cal_Return;
+      }
+      break;
+
+    case Cal_Return:
+      _calseen = (isMoving == true) ? true : _calseen;
+      if ( (_calseen == true) && (isMoving == false) )
+      {
+        _calspeed++;
+        if ( _calspeed < STALLMON_SPEEDS )
+        {
+          _calstate = Cal_Start;
+          break;
+        }
+        if ( _calskipped == 0 )
+        {
+          _calresult = "ok";
+        }
+        else
+        {
+          _calresult = (_calskipped == STALLMON_SPEEDS) ? String("no samples") : "no samples at " + String(_calskipped) + " speeds";
+        }
+        _calstate = Cal_Done;
+      }
+      break;
+
+    case Cal_Done:
+    default:
+      cal_finish();
+      break;
+  }
+}
+
+void STALL_MONITOR::cal_finish(void)
+{
+  ControllerData->set_motorspeed(_calsaved);
+  _calstate = Cal_Idle;
+  // save the speeds which were calibrated
+  if ( _calskipped < STALLMON_SPEEDS )
+  {
+    save();
+  }
+  STALLMON_print("stallmon: calibrate ");
+  STALLMON_println(_calresult);
+}
+
+// ----------------------------------------------------------------------
+// used by initmove(), SGTHRS is 0 while calibrating so DIAG is not set
+// ----------------------------------------------------------------------
+byte STALL_MONITOR::get_sgthrs(byte speed, byte sgval)
+{
+  if ( _calstate != Cal_Idle )
+  {
+    return 0;
+  }
+  if ( (speed < STALLMON_SPEEDS) && (_sgthrs[speed] != 0) )
+  {
+    return _sgthrs[speed];
+  }
+  return sgval;
+}
+
+void STALL_MONITOR::rehome(void)
+{
+  if ( ControllerData->get_hpswitch_enable() == V_ENABLED )
+  {
+    _rehomepending = true;
+  }
+}
+
+void STALL_MONITOR::homed(void)
+{
+  if ( _rehoming == true )
+  {
+    _homes++;
+  }
+  _rehoming = false;
+  _trusted = true;
+}
+
+void STALL_MONITOR::set_enable(bool enable)
+{
+  _enable = enable;
+  _low = 0;
+}
+
+void STALL_MONITOR::set_trusted(void)
+{
+  _trusted = true;
+}
+
+bool STALL_MONITOR::get_enable(void)
+{
+  return _enable;
+}
+
+bool STALL_MONITOR::get_trusted(void)
+{
+  return _trusted;
+}
+
+void STALL_MONITOR::reset_stats(void)
+{
+  _samples = 0;
+  _stalls = 0;
+  _lost = 0;
+  _homes = 0;
+  _rehomefails = 0;
+}
+
+// ----------------------------------------------------------------------
+// baseline, calibrated SGTHRS and stalls for each speed
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String STALL_MONITOR::get_stats(void)
+{
+  String jsonstr = "{ \"enable\":" + String((_enable == true) ? "true" : "false") \
+                   + ", \"trusted\":" + String((_trusted == true) ? "true" : "false") \
+                   + ", \"rehoming\":" + String(((_rehoming == true) || (_rehomepending == true)) ? "true" : "false") \
+                   + ", \"calibrate\":\"" + ((_calstate != Cal_Idle) ? String("running") : _calresult) + "\", \"speeds\":[";
+  for (int i = 0; i < STALLMON_SPEEDS; i++)
+  {
+    jsonstr += (i == 0) ? " " : ", ";
+    jsonstr += "{ \"base\":" + String((int) _base[i]) + ", \"samples\":" + String(_basecount[i]) \
+               + ", \"sgthrs\":" + String(_sgthrs[i]) + " }";
+  }
+  jsonstr += " ], \"sg\":" + String(_lastsg) + ", \"samples\":" + String(_samples) \
+             + ", \"stalls\":" + String(_stalls) + ", \"lost\":" + String(_lost) \
+             + ", \"homes\":" + String(_homes) + ", \"rehomefails\":" + String(_rehomefails) + " }";
+  return jsonstr;
+}
+
+// ----------------------------------------------------------------------
+// calibration file, one line per speed, sgthrs base
+// ----------------------------------------------------------------------
+bool STALL_MONITOR::load(void)
+{
+  if ( (filesystemloaded == false) || (FILESYS.exists(STALLMON_FILE) == false) )
+  {
+    return false;
+  }
+  File file = FILESYS.open(STALLMON_FILE, "r");
+  for (int i = 0; i < STALLMON_SPEEDS; i++)
+  {
+    String line = file.readStringUntil('\n');
+    int sp = line.indexOf(' ');
+    if ( sp < 0 )
+    {
+      break;
+    }
+    _sgthrs[i] = (byte) line.substring(0, sp).toInt();
+    _base[i] = line.substring(sp + 1).toFloat();
+    _basecount[i] = (_sgthrs[i] != 0) ? STALLMON_MINBASE : 0;
+  }
+  file.close();
+  return true;
+}
+
+bool STALL_MONITOR::save(void)
+{
+  if ( filesystemloaded == false )
+  {
+    return false;
+  }
+  File file = FILESYS.open(STALLMON_FILE, "w");
+  if ( !file )
+  {
+    ERROR_println("stallmon: unable to save calibration");
+    return false;
+  }
+  for (int i = 0; i < STALLMON_SPEEDS; i++)
+  {
+    file.print(String(_sgthrs[i]) + " " + String((int) _base[i]) + "\n");
+  }
+  file.close();
+  return true;
+}
@@ -0,0 +1,104 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 STALL MONITOR CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// stall_monitor.h
+// ----------------------------------------------------------------------
+
+#if !defined(_stall_monitor_h_)
+#define _stall_monitor_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define STALLMON_INTERVAL     20000       // us between SG_RESULT reads while moving, at most 50 uart reads a second
+#define STALLMON_SPEEDS       3           // motor speeds slow, medium, fast
+#define STALLMON_SETTLE       5           // samples ignored at the start of a move
+#define STALLMON_MINBASE      20          // samples at a speed before its baseline is used
+#define STALLMON_LEARN        16          // baseline is a moving average over about this many samples
+#define STALLMON_STALLPCT     40          // a sample below this % of the baseline is low
+#define STALLMON_CONFIRM      3           // consecutive low samples that are a stall
+#define STALLMON_REHOMEMARGIN 2000        // extra steps in on a re-home, covers the lost steps
+#define STALLMON_CALSTEPS     2000        // steps in each calibration move
+#define STALLMON_CALMARGIN    80          // DIAG is set at this % of the lowest free running SG_RESULT
+#define STALLMON_FILE         "/stallmon.txt"
+
+enum Stallmon_Cal { Cal_Idle, Cal_Start, Cal_Moving, Cal_Return, Cal_Done };
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// Samples SG_RESULT of a TMC2209 while the focuser moves, from a loop
+// scheduler job, never from the isr. A baseline is learnt for each motor
+// speed, a sample well below the baseline is a stall. On a stall the move
+// is halted, the position is no longer trusted and, if a home position
+// switch is in use, the focuser is re-homed. calibrate() makes a free
+// running move at each speed and sets the SGTHRS used at that speed.
+class STALL_MONITOR
+{
+  public:
+    STALL_MONITOR(void);
+
+    void begin(void);                     // loads the calibration
+    bool update(void);                    // loop scheduler job, true if a sample was taken
+    bool calibrate(void);                 // start a calibration, false if moving or not a TMC2209
+    void rehome(void);                    // re-home when the focuser is next idle
+    void homed(void);                     // the home position switch was found
+    void set_enable(bool);
+    void set_trusted(void);               // position checked by the user
+    void reset_stats(void);
+
+    byte get_sgthrs(byte, byte);          // SGTHRS for a motor speed, else the value passed
+    bool get_enable(void);
+    bool get_trusted(void);
+    String get_stats(void);
+
+  private:
+    void sample(int, long);
+    void stall(long);
+    void cal_update(void);
+    void cal_finish(void);
+    bool load(void);
+    bool save(void);
+
+    bool  _enable = true;
+    bool  _trusted = true;                // position matches the motor
+    bool  _moving = false;                // isMoving when last updated
+    int   _movesamples = 0;
+    int   _low = 0;                       // consecutive low samples
+    long  _lowpos = 0;                    // position at the first low sample
+    bool  _rehomepending = false;
+    bool  _rehoming = false;
+    float _base[STALLMON_SPEEDS] = { 0 };
+    uint32_t _basecount[STALLMON_SPEEDS] = { 0 };
+    byte  _sgthrs[STALLMON_SPEEDS] = { 0 };   // 0 is not calibrated
+    // calibration
+    enum Stallmon_Cal _calstate = Cal_Idle;
+    byte  _calspeed = 0;
+    byte  _calskipped = 0;                // speeds without samples
+    byte  _calsaved = 0;                  // motor speed before the calibration
+    long  _calhome = 0;
+    bool  _calseen = false;               // the move has started
+    int   _calmin = 0;
+    uint32_t _calsum = 0;
+    uint32_t _calcount = 0;
+    String _calresult = "none";
+    // stats
+    uint32_t _samples = 0;
+    uint32_t _stalls = 0;
+    uint32_t _lost = 0;                   // steps made while low, an estimate of the steps lost
+    uint32_t _homes = 0;
+    uint32_t _rehomefails = 0;
+    int   _lastsg = -1;
+};
+
+
+
+#endif // #if !defined(_stall_monitor_h_)
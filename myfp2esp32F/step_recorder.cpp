@@ -0,0 +1,222 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 STEP RECORDER CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// step_recorder.cpp
+// Step interval jitter of the move timer isr
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "step_recorder.h"
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define STEPREC_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  STEPREC_PRINT
+#define STEPREC_print(...)   Serial.print(__VA_ARGS__)
+#define STEPREC_println(...) Serial.println(__VA_ARGS__)
+#else
+#define STEPREC_print(...)
+#define STEPREC_println(...)
+#endif
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+STEP_RECORDER::STEP_RECORDER(void)
+{
+  memset(_hist_late, 0, sizeof(_hist_late));
+  memset(_hist_early, 0, sizeof(_hist_early));
+}
+
+// ----------------------------------------------------------------------
+// record the next move, cannot be armed during a move
+// ----------------------------------------------------------------------
+bool STEP_RECORDER::arm(void)
+{
+  if ( _active == true )
+  {
+    return false;
+  }
+  if ( _trace == NULL )
+  {
+    _trace = new uint32_t[STEPREC_SIZE];
+    if ( _trace == NULL )
+    {
+      ERROR_println("sr: no memory for trace");
+      return false;
+    }
+  }
+  STEPREC_println("sr: armed");
+  _armed = true;
+  return true;
+}
+
+// ----------------------------------------------------------------------
+// called before the move timer is started
+// ----------------------------------------------------------------------
+void STEP_RECORDER::begin(unsigned long interval)
+{
+  if ( _armed == false )
+  {
+    return;
+  }
+  _armed     = false;
+  _mhz       = ESP.getCpuFreqMHz();
+  _expected  = interval * _mhz;
+  _late      = _expected + (_expected / 100) * STEPREC_LATE;
+  // the deviation limit follows the step interval, slow steps have large deviations
+  uint64_t clamp = (uint64_t) _expected * STEPREC_CLAMPX;
+  clamp      = (clamp < STEPREC_CLAMP) ? STEPREC_CLAMP : clamp;
+  _clamp     = (clamp > 0x7FFFFFFF) ? 0x7FFFFFFF : (uint32_t) clamp;
+  _shift     = 0;
+  while ( (_clamp >> _shift) >= (1UL << STEPREC_DEVBITS) )
+  {
+    _shift++;
+  }
+  _head      = 0;
+  _steps     = 0;
+  _min       = 0xFFFFFFFF;
+  _max       = 0;
+  _latesteps = 0;
+  _clipped   = 0;
+  _sumdev    = 0;
+  _sumsq     = 0;
+  memset(_hist_late, 0, sizeof(_hist_late));
+  memset(_hist_early, 0, sizeof(_hist_early));
+  _last      = ESP.getCycleCount();
+  STEPREC_print("sr: begin, interval us ");
+  STEPREC_println(interval);
+  _active    = true;
+}
+
+void STEP_RECORDER::end(void)
+{
+  if ( _active == true )
+  {
+    _active = false;
+    STEPREC_print("sr: end, steps ");
+    STEPREC_println(_steps);
+  }
+}
+
+// ----------------------------------------------------------------------
+// called from the move timer isr after each step
+// the first interval includes the time to start the move timer
+// ----------------------------------------------------------------------
+void IRAM_ATTR STEP_RECORDER::step(void)
+{
+  if ( _active == false )
+  {
+    return;
+  }
+  uint32_t now = ESP.getCycleCount();
+  uint32_t interval = now - _last;
+  _last = now;
+
+  _trace[_head] = interval;
+  _head = (_head + 1) % STEPREC_SIZE;
+  _steps++;
+  _min = (interval < _min) ? interval : _min;
+  _max = (interval > _max) ? interval : _max;
+  if ( interval > _late )
+  {
+    _latesteps++;
+  }
+
+  int32_t dev = (int32_t) (interval - _expected);
+  uint32_t us = ((dev < 0) ? -dev : dev) / _mhz;
+  int bucket = (us == 0) ? 0 : 32 - __builtin_clz(us);
+  bucket = (bucket >= STEPREC_BUCKETS) ? STEPREC_BUCKETS - 1 : bucket;
+  if ( dev < 0 )
+  {
+    _hist_early[bucket]++;
+  }
+  else
+  {
+    _hist_late[bucket]++;
+  }
+
+  if ( (dev > (int32_t) _clamp) || (dev < -(int32_t) _clamp) )
+  {
+    _clipped++;
+    dev = (dev > 0) ? (int32_t) _clamp : -(int32_t) _clamp;
+  }
+  dev = dev >> _shift;
+  _sumdev += dev;
+  _sumsq  += (uint64_t) ((int64_t) dev * dev);
+}
+
+bool STEP_RECORDER::get_active(void)
+{
+  return _active;
+}
+
+int STEP_RECORDER::get_tracecount(void)
+{
+  return (_steps < STEPREC_SIZE) ? _steps : STEPREC_SIZE;
+}
+
+uint32_t STEP_RECORDER::get_trace(int i)
+{
+  if ( (_trace == NULL) || (i < 0) || (i >= get_tracecount()) )
+  {
+    return 0;
+  }
+  uint32_t oldest = (_steps < STEPREC_SIZE) ? 0 : _head;
+  return _trace[(oldest + i) % STEPREC_SIZE];
+}
+
+uint32_t STEP_RECORDER::get_mhz(void)
+{
+  return _mhz;
+}
+
+// ----------------------------------------------------------------------
+// interval min, max, mean and stddev in us, late steps and the histograms
+// of the deviation from the programmed interval
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String STEP_RECORDER::get_stats(void)
+{
+  uint32_t steps = (_steps == 0) ? 1 : _steps;
+  float mhz  = (float) _mhz;
+  float scale = (float) (1UL << _shift);
+  float mean = (float) _sumdev / steps;
+  float var  = ((float) _sumsq / steps) - (mean * mean);
+  float sd   = ((var > 0) ? sqrt(var) : 0.0) * scale;
+  mean = mean * scale;
+
+  String jsonstr = "{ \"armed\":" + String(_armed) + ", \"active\":" + String(_active) \
+                   + ", \"programmed\":" + String(_expected / mhz, 2) + ", \"steps\":" + String(_steps) \
+                   + ", \"min\":" + String(((_steps == 0) ? 0 : _min) / mhz, 2) + ", \"max\":" + String(_max / mhz, 2) \
+                   + ", \"mean\":" + String((_expected + mean) / mhz, 2) + ", \"stddev\":" + String(sd / mhz, 2) \
+                   + ", \"late\":" + String(_latesteps) + ", \"clipped\":" + String(_clipped) \
+                   + ", \"clamp\":" + String(_clamp / mhz, 2) + ", \"late_hist\":[";
+  for (int i = 0; i < STEPREC_BUCKETS; i++)
+  {
+    jsonstr += (i == 0) ? "" : ",";
+    jsonstr += String(_hist_late[i]);
+  }
+  jsonstr += "], \"early_hist\":[";
+  for (int i = 0; i < STEPREC_BUCKETS; i++)
+  {
+    jsonstr += (i == 0) ? "" : ",";
+    jsonstr += String(_hist_early[i]);
+  }
+  jsonstr += "] }";
+  return jsonstr;
+}
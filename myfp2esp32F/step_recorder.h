@@ -0,0 +1,77 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 STEP RECORDER CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// step_recorder.h
+// ----------------------------------------------------------------------
+
+#if !defined(_step_recorder_h_)
+#define _step_recorder_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define STEPREC_SIZE      1024            // step intervals kept in the trace, the last steps of a move
+#define STEPREC_BUCKETS   16              // bucket 0 is < 1us from the programmed interval, bucket n is 2^(n-1) to 2^n-1 us
+#define STEPREC_LATE      10              // a step is late if its interval is this % longer than programmed
+#define STEPREC_CLAMP     0x100000        // cycles, smallest limit of a deviation used for the mean and stddev
+#define STEPREC_CLAMPX    4               // the limit is this many programmed intervals, for slow steps
+#define STEPREC_DEVBITS   22              // deviations are scaled down to this many bits, keeps the sum of squares in range
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// Records the interval between steps in the move timer isr with the cpu
+// cycle counter, and compares it to the programmed step interval. Off by
+// default, arm() records the next move only. step() is called from the
+// isr so only integer maths is used there, the trace buffer is allocated
+// the first time the recorder is armed.
+class STEP_RECORDER
+{
+  public:
+    STEP_RECORDER(void);
+
+    bool arm(void);                       // record the next move
+    void begin(unsigned long);            // move started, programmed step interval in us
+    void end(void);                       // move finished
+    void IRAM_ATTR step(void);            // a step was made, called from the isr
+
+    bool get_active(void);
+    int  get_tracecount(void);
+    uint32_t get_trace(int);              // interval in cycles, 0 is the oldest
+    uint32_t get_mhz(void);
+    String get_stats(void);
+
+  private:
+    uint32_t *_trace = NULL;
+    volatile bool _armed = false;
+    volatile bool _active = false;
+    uint32_t _mhz = 240;
+    uint32_t _expected = 0;               // programmed interval, cycles
+    uint32_t _late = 0;                   // cycles, intervals above this are late
+    uint32_t _last = 0;                   // cycle count of the last step
+    uint32_t _head = 0;                   // next trace entry
+    // stats
+    uint32_t _steps = 0;                  // intervals recorded
+    uint32_t _min = 0;
+    uint32_t _max = 0;
+    uint32_t _latesteps = 0;
+    uint32_t _clipped = 0;                // deviations above the limit
+    uint32_t _clamp = STEPREC_CLAMP;      // cycles
+    int      _shift = 0;                  // deviations are summed >> _shift
+    int64_t  _sumdev = 0;                 // cycles from the programmed interval
+    uint64_t _sumsq = 0;
+    uint32_t _hist_late[STEPREC_BUCKETS];
+    uint32_t _hist_early[STEPREC_BUCKETS];
+};
+
+
+
+#endif // #if !defined(_step_recorder_h_)
@@ -0,0 +1,327 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 TASK SCHEDULER CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// task_scheduler.cpp
+// Periodic and one-shot jobs for park, temperature, display, config
+// saves and wifi, uses hw timer 2
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "task_scheduler.h"
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define TASKSCHED_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  TASKSCHED_PRINT
+#define TASKSCHED_print(...)   Serial.print(__VA_ARGS__)
+#define TASKSCHED_println(...) Serial.println(__VA_ARGS__)
+#else
+#define TASKSCHED_print(...)
+#define TASKSCHED_println(...)
+#endif
+
+
+// ----------------------------------------------------------------------
+// DATA AND ISR
+// ----------------------------------------------------------------------
+volatile bool sched_due = false;                               // set by the isr, the wheel has a job to run
+portMUX_TYPE  schedMux  = portMUX_INITIALIZER_UNLOCKED;        // protects sched_due
+
+void IRAM_ATTR sched_isr(void)
+{
+  portENTER_CRITICAL_ISR(&schedMux);
+  sched_due = true;
+  portEXIT_CRITICAL_ISR(&schedMux);
+}
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+TASK_SCHEDULER::TASK_SCHEDULER(void)
+{
+  for (int i = 0; i < SCHED_SLOTS; i++)
+  {
+    _slots[i] = SCHED_NOJOB;
+  }
+  _lastms = millis();
+}
+
+// ----------------------------------------------------------------------
+// start the wakeup timer, one shot with 1us resolution
+// ----------------------------------------------------------------------
+void TASK_SCHEDULER::begin(void)
+{
+  TASKSCHED_println("Task scheduler started");
+  _timer = hal_timer_attach(SCHED_TIMER, &sched_isr);
+  _tick = now();
+  program();
+}
+
+// ----------------------------------------------------------------------
+// register a job, period in ms
+// ----------------------------------------------------------------------
+int TASK_SCHEDULER::add(const char *name, sched_callback callback, unsigned long period, bool periodic)
+{
+  if ( _count >= SCHED_MAXJOBS )
+  {
+    ERROR_print("ts: add job error, no free job: ");
+    ERROR_println(name);
+    return SCHED_NOJOB;
+  }
+  sched_job &job = _jobs[_count];
+  memset(&job, 0, sizeof(job));
+  job.name     = name;
+  job.callback = callback;
+  job.periodic = periodic;
+  job.next     = SCHED_NOJOB;
+  _count++;
+  set_period(_count - 1, period);
+  TASKSCHED_print("ts: add job ");
+  TASKSCHED_println(name);
+  return _count - 1;
+}
+
+void TASK_SCHEDULER::start(int id)
+{
+  if ( (id >= 0) && (id < _count) && (_jobs[id].armed == false) )
+  {
+    arm(id, now() + _jobs[id].period);
+  }
+}
+
+void TASK_SCHEDULER::start(int id, unsigned long delay)
+{
+  if ( (id >= 0) && (id < _count) && (_jobs[id].armed == false) )
+  {
+    uint32_t ticks = delay / SCHED_TICK;
+    arm(id, now() + ((ticks == 0) ? 1 : ticks));
+  }
+}
+
+void TASK_SCHEDULER::restart(int id)
+{
+  if ( (id >= 0) && (id < _count) )
+  {
+    unlink(id);
+    arm(id, now() + _jobs[id].period);
+  }
+}
+
+void TASK_SCHEDULER::stop(int id)
+{
+  if ( (id >= 0) && (id < _count) && (_jobs[id].armed == true) )
+  {
+    unlink(id);
+    program();
+  }
+}
+
+bool TASK_SCHEDULER::armed(int id)
+{
+  return (id >= 0) && (id < _count) && (_jobs[id].armed == true);
+}
+
+void TASK_SCHEDULER::set_period(int id, unsigned long period)
+{
+  if ( (id >= 0) && (id < _count) )
+  {
+    uint32_t ticks = period / SCHED_TICK;
+    _jobs[id].period = (ticks == 0) ? 1 : ticks;
+  }
+}
+
+// ----------------------------------------------------------------------
+// call the expired jobs, does nothing until the hw timer has fired
+// ----------------------------------------------------------------------
+void TASK_SCHEDULER::run(void)
+{
+  bool due;
+  portENTER_CRITICAL(&schedMux);
+  due = sched_due;
+  sched_due = false;
+  portEXIT_CRITICAL(&schedMux);
+  if ( due == false )
+  {
+    return;
+  }
+  _programmed = false;
+
+  // walk the slots from the last tick processed to now, if more than
+  // one revolution has passed every slot is checked once
+  uint32_t t = now();
+  uint32_t steps = t - _tick;
+  steps = (steps > SCHED_SLOTS) ? SCHED_SLOTS : steps;
+  int fired[SCHED_MAXJOBS];
+  int nfired = 0;
+  for (uint32_t i = 1; i <= steps; i++)
+  {
+    int id = _slots[(_tick + i) % SCHED_SLOTS];
+    while ( id != SCHED_NOJOB )
+    {
+      int next = _jobs[id].next;
+      // jobs in later revolutions stay in the slot
+      if ( (int32_t) (_jobs[id].expires - t) <= 0 )
+      {
+        unlink(id);
+        fired[nfired++] = id;
+      }
+      id = next;
+    }
+  }
+  _tick = t;
+
+  for (int i = 0; i < nfired; i++)
+  {
+    sched_job &job = _jobs[fired[i]];
+    uint32_t deadline = job.expires;
+    if ( job.periodic == true )
+    {
+      // rearm before the call so the callback can stop the job, runs
+      // which were missed are skipped
+      uint32_t next = deadline + job.period;
+      arm(fired[i], ((int32_t) (next - t) > 0) ? next : t + job.period);
+    }
+    uint32_t late = (now() - deadline) * SCHED_TICK;
+    unsigned long start = micros();
+    job.callback();
+    uint32_t exec = micros() - start;
+
+    job.runs++;
+    job.late_total += late;
+    job.late_max = (late > job.late_max) ? late : job.late_max;
+    job.exec_total += exec;
+    job.exec_max = (exec > job.exec_max) ? exec : job.exec_max;
+  }
+  program();
+}
+
+// ----------------------------------------------------------------------
+// ticks since boot, millis() wrap is handled by the unsigned difference
+// ----------------------------------------------------------------------
+uint32_t TASK_SCHEDULER::now(void)
+{
+  uint32_t elapsed = (millis() - _lastms) / SCHED_TICK;
+  _clock  += elapsed;
+  _lastms += elapsed * SCHED_TICK;
+  return _clock;
+}
+
+// ----------------------------------------------------------------------
+// put the job in the wheel slot of its deadline
+// ----------------------------------------------------------------------
+void TASK_SCHEDULER::arm(int id, uint32_t expires)
+{
+  sched_job &job = _jobs[id];
+  int slot = expires % SCHED_SLOTS;
+  job.expires = expires;
+  job.armed   = true;
+  job.next    = _slots[slot];
+  _slots[slot] = id;
+  // reprogram if this deadline is earlier than the current wakeup
+  if ( (_programmed == false) || ((int32_t) (expires - _wakeup) < 0) )
+  {
+    program();
+  }
+}
+
+void TASK_SCHEDULER::unlink(int id)
+{
+  sched_job &job = _jobs[id];
+  if ( job.armed == false )
+  {
+    return;
+  }
+  int *link = &_slots[job.expires % SCHED_SLOTS];
+  while ( *link != SCHED_NOJOB )
+  {
+    if ( *link == id )
+    {
+      *link = job.next;
+      break;
+    }
+    link = &_jobs[*link].next;
+  }
+  job.next  = SCHED_NOJOB;
+  job.armed = false;
+}
+
+// ----------------------------------------------------------------------
+// program the hw timer for the earliest deadline, off if no job is armed
+// ----------------------------------------------------------------------
+void TASK_SCHEDULER::program(void)
+{
+  if ( _timer == NULL )
+  {
+    return;
+  }
+  bool found = false;
+  uint32_t next = 0;
+  for (int i = 0; i < _count; i++)
+  {
+    if ( (_jobs[i].armed == true) && ((found == false) || ((int32_t) (_jobs[i].expires - next) < 0)) )
+    {
+      next = _jobs[i].expires;
+      found = true;
+    }
+  }
+
+  hal_timer_disarm(_timer);
+  _programmed = found;
+  if ( found == false )
+  {
+    return;
+  }
+  uint32_t t = now();
+  uint32_t ticks = ((int32_t) (next - t) > 0) ? (next - t) : 1;
+  // less the part of the current tick which has passed
+  uint64_t us = (uint64_t) ticks * SCHED_TICK * 1000 - (millis() - _lastms) * 1000;
+  _wakeup = next;
+  hal_timer_alarm(_timer, us);
+}
+
+// ----------------------------------------------------------------------
+// run count, lateness [ms] and execution time [us] of each job
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String TASK_SCHEDULER::get_stats(void)
+{
+  String jsonstr = "{ \"tick\":" + String(SCHED_TICK) + ", \"jobs\":[";
+  for (int i = 0; i < _count; i++)
+  {
+    sched_job &job = _jobs[i];
+    uint32_t runs = (job.runs == 0) ? 1 : job.runs;
+    jsonstr += (i == 0) ? " " : ", ";
+    jsonstr += "{ \"name\":\"" + String(job.name) + "\", \"armed\":" + String(job.armed) \
+               + ", \"period\":" + String(job.period * SCHED_TICK) + ", \"runs\":" + String(job.runs) \
+               + ", \"late_max\":" + String(job.late_max) + ", \"late_avg\":" + String(job.late_total / runs) \
+               + ", \"exec_max\":" + String(job.exec_max) + ", \"exec_avg\":" + String(job.exec_total / runs) + " }";
+  }
+  jsonstr += " ] }";
+  return jsonstr;
+}
+
+void TASK_SCHEDULER::reset_stats(void)
+{
+  for (int i = 0; i < _count; i++)
+  {
+    _jobs[i].runs       = 0;
+    _jobs[i].late_max   = 0;
+    _jobs[i].late_total = 0;
+    _jobs[i].exec_max   = 0;
+    _jobs[i].exec_total = 0;
+  }
+}
@@ -0,0 +1,99 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 TASK SCHEDULER CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// task_scheduler.h
+// ----------------------------------------------------------------------
+
+#if !defined(_task_scheduler_h_)
+#define _task_scheduler_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "hal.h"
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define SCHED_TIMER       2               // hw timer used for the wakeup
+#define SCHED_TICK        10              // wheel resolution in milliseconds
+#define SCHED_SLOTS       128             // wheel size, 1.28s per revolution
+#define SCHED_MAXJOBS     16
+#define SCHED_NOJOB       -1
+
+#define SCHED_ONESHOT     false
+#define SCHED_PERIODIC    true
+
+typedef void (*sched_callback)(void);
+
+
+// ----------------------------------------------------------------------
+// JOB
+// ----------------------------------------------------------------------
+struct sched_job
+{
+  const char     *name;
+  sched_callback callback;
+  uint32_t       period;                  // ticks
+  uint32_t       expires;                 // deadline, tick
+  bool           periodic;
+  bool           armed;
+  int            next;                    // next job in the same wheel slot
+  // stats
+  uint32_t       runs;
+  uint32_t       late_max;                // ms after the deadline that the job ran
+  uint32_t       late_total;
+  uint32_t       exec_max;                // us in the callback
+  uint32_t       exec_total;
+};
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// Jobs are held in a timer wheel. The hw timer is programmed for the
+// next deadline only, and is off when no job is armed. The isr marks the
+// wheel as due, run() in loop() then calls the expired jobs.
+class TASK_SCHEDULER
+{
+  public:
+    TASK_SCHEDULER(void);
+    void begin(void);                     // start the wakeup timer
+
+    // register a job, returns the job id or SCHED_NOJOB
+    int  add(const char *, sched_callback, unsigned long, bool);
+    void start(int);                      // arm with the job period, no change if already armed
+    void start(int, unsigned long);       // arm, deadline is ms from now, no change if already armed
+    void restart(int);                    // arm with the job period, a new deadline if already armed
+    void stop(int);
+    bool armed(int);
+    void set_period(int, unsigned long);  // ms, used from the next time the job is armed
+
+    void run(void);                       // call expired jobs, call from loop()
+
+    String get_stats(void);
+    void reset_stats(void);
+
+  private:
+    uint32_t now(void);
+    void arm(int, uint32_t);
+    void unlink(int);
+    void program(void);
+
+    hal_timer_t *_timer = NULL;
+    sched_job _jobs[SCHED_MAXJOBS];
+    int       _slots[SCHED_SLOTS];
+    int       _count = 0;
+    uint32_t  _clock = 0;                 // ticks since boot
+    uint32_t  _lastms = 0;                // millis() at _clock
+    uint32_t  _tick = 0;                  // wheel position, last tick processed
+    uint32_t  _wakeup = 0;                // tick the hw timer is programmed for
+    bool      _programmed = false;
+};
+
+
+
+#endif // #if !defined(_task_scheduler_h_)
@@ -0,0 +1,195 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 TCP TRACE CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// tcp_trace.cpp
+// Capture of tcp/ip server commands and replies, see tools/tcp_replay.py
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "file_system.h"
+#include "tcp_trace.h"
+
+extern bool filesystemloaded;
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define TCPTRACE_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  TCPTRACE_PRINT
+#define TCPTRACE_print(...)   Serial.print(__VA_ARGS__)
+#define TCPTRACE_println(...) Serial.println(__VA_ARGS__)
+#else
+#define TCPTRACE_print(...)
+#define TCPTRACE_println(...)
+#endif
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+TCP_TRACE::TCP_TRACE(void)
+{
+
+}
+
+// ----------------------------------------------------------------------
+// the ram buffer is allocated the first time a capture is started
+// ----------------------------------------------------------------------
+bool TCP_TRACE::start(void)
+{
+  if ( _active == true )
+  {
+    return true;
+  }
+  if ( filesystemloaded == false )
+  {
+    ERROR_println("tcptrace: start error, file system not loaded");
+    return false;
+  }
+  if ( _buff == NULL )
+  {
+    _buff = (byte *) malloc(TCPTRACE_BUFSIZE);
+    if ( _buff == NULL )
+    {
+      ERROR_println("tcptrace: start error, no memory");
+      return false;
+    }
+  }
+  if ( FILESYS.exists(TCPTRACE_FILE) )
+  {
+    FILESYS.remove(TCPTRACE_FILE);
+  }
+  _file = FILESYS.open(TCPTRACE_FILE, "w");
+  if ( !_file )
+  {
+    ERROR_println("tcptrace: start error, cannot create file");
+    return false;
+  }
+  _records   = 0;
+  _bytes     = 0;
+  _flushes   = 0;
+  _flush_max = 0;
+  _full      = false;
+  memcpy(_buff, TCPTRACE_MAGIC, 4);
+  _buff[4]   = TCPTRACE_VERSION;
+  _used      = 5;
+  _active    = true;
+  TCPTRACE_println("tcptrace: started");
+  return true;
+}
+
+void TCP_TRACE::stop(void)
+{
+  if ( _active == false )
+  {
+    return;
+  }
+  flush();
+  _file.close();
+  _active = false;
+  TCPTRACE_println("tcptrace: stopped");
+}
+
+bool TCP_TRACE::get_active(void)
+{
+  return _active;
+}
+
+void TCP_TRACE::command(int clientnum, const char *data, int len)
+{
+  record(TCPTRACE_COMMAND, clientnum, data, len);
+}
+
+void TCP_TRACE::reply(int clientnum, const char *data)
+{
+  record(TCPTRACE_REPLY, clientnum, data, strlen(data));
+}
+
+void TCP_TRACE::done(int clientnum, uint32_t service, int32_t heap)
+{
+  byte data[8];
+  memcpy(&data[0], &service, 4);
+  memcpy(&data[4], &heap, 4);
+  record(TCPTRACE_DONE, clientnum, (const char *) data, 8);
+}
+
+// ----------------------------------------------------------------------
+// append a record, the buffer is written to the file first if it would
+// not fit
+// ----------------------------------------------------------------------
+void TCP_TRACE::record(char kind, int clientnum, const char *data, int len)
+{
+  if ( _active == false )
+  {
+    return;
+  }
+  uint32_t now = micros();
+  len = (len > TCPTRACE_MAXDATA) ? TCPTRACE_MAXDATA : len;
+  if ( (_used + 7 + len) > TCPTRACE_BUFSIZE )
+  {
+    flush();
+    if ( _active == false )
+    {
+      return;
+    }
+  }
+  byte *p = &_buff[_used];
+  memcpy(p, &now, 4);
+  p[4] = kind;
+  p[5] = clientnum;
+  p[6] = len;
+  memcpy(&p[7], data, len);
+  _used += 7 + len;
+  _records++;
+}
+
+void TCP_TRACE::flush(void)
+{
+  if ( _used == 0 )
+  {
+    return;
+  }
+  if ( (_bytes + _used) > TCPTRACE_MAXFILE )
+  {
+    // keep the file to the limit, the records in the buffer are dropped
+    _used = 0;
+    _full = true;
+    _file.close();
+    _active = false;
+    TCPTRACE_println("tcptrace: file full, stopped");
+    return;
+  }
+  uint32_t start = micros();
+  _file.write(_buff, _used);
+  _file.flush();
+  uint32_t t = micros() - start;
+  _flush_max = (t > _flush_max) ? t : _flush_max;
+  _bytes += _used;
+  _used = 0;
+  _flushes++;
+}
+
+// ----------------------------------------------------------------------
+// capture state, records and file writes, times in us
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String TCP_TRACE::get_stats(void)
+{
+  String state = (_active == true) ? "capturing" : ((_full == true) ? "full" : "stopped");
+  String jsonstr = "{ \"state\":\"" + state + "\", \"records\":" + String(_records) \
+                   + ", \"bytes\":" + String(_bytes + _used) + ", \"maxbytes\":" + String(TCPTRACE_MAXFILE) \
+                   + ", \"flushes\":" + String(_flushes) + ", \"flush_max\":" + String(_flush_max) + " }";
+  return jsonstr;
+}
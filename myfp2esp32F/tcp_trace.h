@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 TCP TRACE CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// tcp_trace.h
+// ----------------------------------------------------------------------
+
+#if !defined(_tcp_trace_h_)
+#define _tcp_trace_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "file_system.h"
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define TCPTRACE_FILE       "/tcptrace.bin"
+#define TCPTRACE_MAGIC      "MFPT"
+#define TCPTRACE_VERSION    1
+#define TCPTRACE_BUFSIZE    4096          // bytes held in ram, written to the file when full
+#define TCPTRACE_MAXFILE    524288        // bytes, capture stops at this file size
+#define TCPTRACE_MAXDATA    255           // bytes of a command or reply kept
+
+// record kinds
+#define TCPTRACE_COMMAND    'C'           // data is the command received
+#define TCPTRACE_REPLY      'R'           // data is the reply sent
+#define TCPTRACE_DONE       'D'           // data is uint32 service us, int32 heap used
+
+// File layout, little endian
+//   header  magic[4] version[1]
+//   record  us[4] kind[1] client[1] length[1] data[length]
+// us is micros() at the record and wraps every 71 minutes, the time
+// between two records is the unsigned difference.
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// Capture of the tcp/ip server traffic to a binary trace file. Records
+// are put in a ram buffer which is appended to the file when full, so
+// the file is only written from loop(). Off by default.
+class TCP_TRACE
+{
+  public:
+    TCP_TRACE(void);
+
+    bool start(void);                     // remove the last trace and start a capture
+    void stop(void);
+    bool get_active(void);
+
+    void command(int, const char *, int); // client, data, length
+    void reply(int, const char *);        // client, data
+    void done(int, uint32_t, int32_t);    // client, service us, heap used
+
+    String get_stats(void);
+
+  private:
+    void record(char, int, const char *, int);
+    void flush(void);
+
+    File     _file;
+    byte    *_buff = NULL;
+    int      _used = 0;
+    bool     _active = false;
+    bool     _full = false;               // stopped at TCPTRACE_MAXFILE
+    // stats
+    uint32_t _records = 0;
+    uint32_t _bytes = 0;                  // written to the file, including the header
+    uint32_t _flushes = 0;
+    uint32_t _flush_max = 0;              // us
+};
+
+
+
+#endif // #if !defined(_tcp_trace_h_)
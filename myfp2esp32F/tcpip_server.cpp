@@ -16,7 +16,7 @@
 #include <Arduino.h>
 #include <WiFiServer.h>
 #include <WiFiClient.h>
-#include "SPIFFS.h"
+#include "file_system.h"
 #include <SPI.h>
 
 #include "controller_defines.h"
@@ -58,6 +58,10 @@ extern DRIVER_BOARD *driverboard;
 #include "temp_probe.h"
 extern TEMP_PROBE *tempprobe;
 
+// loop profiler
+#include "loop_profiler.h"
+extern LOOP_PROFILER *looprof;
+
 // ASCOM server
 #include "ascom_server.h"
 extern ASCOM_SERVER *ascomsrvr;
@@ -70,15 +74,19 @@ extern MANAGEMENT_SERVER *mngsrvr;
 #include "web_server.h"
 extern WEB_SERVER *websrvr;
 
+// tcp trace
+#include "tcp_trace.h"
+extern TCP_TRACE *tcptrace;
+
+// second focuser
+#include "focuser_channel.h"
+extern FOCUSER_CHANNEL *focuser2;
+
 #include "tcpip_server.h"
 
 extern byte ascomsrvr_status;
 extern byte mngsrvr_status;
 extern byte websrvr_status;
-extern volatile unsigned int park_maxcount;
-extern volatile unsigned int display_maxcount;
-extern portMUX_TYPE parkMux;
-extern portMUX_TYPE displaytimeMux;
 
 
 // ----------------------------------------------------------------------
@@ -185,15 +193,19 @@ void TCPIP_SERVER::stop(void)
 }
 
 // ----------------------------------------------------------------------
-// void loop(void);
+// bool loop(bool);
 // Checks for any new clients or existing client requests
+// Returns true if a command was received, a connected client that sends
+// nothing is not activity
 // ----------------------------------------------------------------------
-void TCPIP_SERVER::loop(bool parkstate)
+bool TCPIP_SERVER::loop(bool parkstate)
 {
+  bool received = false;
+
   // avoid a crash
   if ( this->_loaded == false )
   {
-    return;
+    return received;
   }
 
   this->_parked = parkstate;
@@ -239,7 +251,19 @@ void TCPIP_SERVER::loop(bool parkstate)
         {
           while (_myclients[lp]->available())                 // if client has send request
           {
-            process_command(lp);                              // process request and send client number
+            received = true;
+            if ( tcptrace->get_active() == true )
+            {
+              // service time and heap used by the command
+              uint32_t heap = ESP.getFreeHeap();
+              unsigned long start = micros();
+              process_command(lp);
+              tcptrace->done(lp, micros() - start, (int32_t) (heap - ESP.getFreeHeap()));
+            }
+            else
+            {
+              process_command(lp);                            // process request and send client number
+            }
           }
         }
         else
@@ -257,6 +281,7 @@ void TCPIP_SERVER::loop(bool parkstate)
       } // if ( myclientsfreeslot[lp] == true )
     } // for ( int lp = 0; lp < MAXCONNECTIONS; lp++ )
   } // if ( totalclients > 0 )
+  return received;
 }
 
 bool TCPIP_SERVER::get_clients(void)
@@ -301,9 +326,15 @@ char * TCPIP_SERVER::ftoa(char *a, double f, int precision)
 
 void TCPIP_SERVER::send_reply(const char *str, int clientnum)
 {
+  // no client, used by the benchmarks to time the formatting only
+  if ( (clientnum < 0) || (clientnum >= MAXCONNECTIONS) || (_myclients[clientnum] == NULL) )
+  {
+    return;
+  }
   if ( _myclients[clientnum]->connected() )                          // if client is still connected
   {
     _myclients[clientnum]->print(str);                               // send reply
+    tcptrace->reply(clientnum, str);                                 // does nothing unless capturing
   }
 }
 
@@ -367,6 +398,92 @@ void TCPIP_SERVER::nullarg( int cmdval )
   ERROR_println(cmdval);
 }
 
+// ----------------------------------------------------------------------
+// commands for focuser channel 1, the receive string has had the channel
+// address removed. The move, position and motor settings commands are
+// supported, the reply to other commands or a channel which is not
+// loaded is ENOTSUPPORTED# or ENOCHANNEL#
+// ----------------------------------------------------------------------
+void TCPIP_SERVER::process_channel(int channel, String &receiveString, int clientnum)
+{
+  if ( (channel != 1) || (focuser2 == NULL) )
+  {
+    TCPSRVR_print("tcp: no channel ");
+    TCPSRVR_println(channel);
+    build_reply('E', "NOCHANNEL", clientnum);
+    return;
+  }
+  String cmdstr = receiveString.substring(1, 3);
+  String WorkString = receiveString.substring(3, receiveString.length() - 1);
+  switch ( cmdstr.toInt() )
+  {
+    case 0: // myFP2 get focuser position
+      build_reply('P', focuser2->get_position(), clientnum);
+      break;
+    case 1: // myFP2 ismoving
+      build_reply('I', (focuser2->get_ismoving() == true) ? 1 : 0, clientnum);
+      break;
+    case 5: // myFP2 Set new target position to xxxxxx (and focuser initiates immediate move to xxxxxx)
+      focuser2->move(WorkString.toInt());
+      break;
+    case 7: // myFP2 Set maxsteps
+      {
+        long tmppos = WorkString.toInt();
+        tmppos = (tmppos > FOCUSERUPPERLIMIT) ? FOCUSERUPPERLIMIT : tmppos;
+        tmppos = (tmppos < FOCUSERLOWERLIMIT) ? FOCUSERLOWERLIMIT : tmppos;
+        focuser2->set_maxstep(tmppos);        // not less than the focuser position
+      }
+      break;
+    case 8: // myFP2 get maxStep
+      build_reply('M', focuser2->get_maxstep(), clientnum);
+      break;
+    case 10: // myFP2 get maxIncrement
+      build_reply('Y', focuser2->get_maxstep(), clientnum);
+      break;
+    case 11: // myFP2 get coil power enable
+      build_reply('O', (focuser2->get_coilpower() == true) ? 1 : 0, clientnum);
+      break;
+    case 12: // myFP2 set coil power enable
+      focuser2->set_coilpower(WorkString.toInt() == 1);
+      break;
+    case 13: // myFP2 get reverse direction setting, 00 off, 01 on
+      build_reply('R', (focuser2->get_reverse() == true) ? 1 : 0, clientnum);
+      break;
+    case 14: // myFP2 set reverse direction, ignored if moving
+      focuser2->set_reverse(WorkString.toInt() == 1);
+      break;
+    case 27: // myFP2 stop a move - like a Halt
+      focuser2->halt();
+      break;
+    case 28: // myFP2 home the motor to position 0
+      focuser2->move(0);
+      break;
+    case 31: // myFP2 set focuser position
+      focuser2->set_position(WorkString.toInt());
+      break;
+    case 39: // myFP2 get the new motor position (target) XXXXXX
+      build_reply('N', focuser2->get_target(), clientnum);
+      break;
+    case 55: // myFP2 get motorspeed delay
+      build_reply('0', focuser2->get_stepdelay(), clientnum);
+      break;
+    case 56: // myFP2 set motorspeed delay
+      {
+        long newdelay = WorkString.toInt();
+        newdelay = (newdelay < 1000) ? 1000 : newdelay;     // ensure it is not too low
+        focuser2->set_stepdelay(newdelay);
+      }
+      break;
+    case 64: // myFP2 move a specified number of steps
+      focuser2->move_steps(WorkString.toInt());
+      break;
+    default:
+      TCPSRVR_println("tcp: channel command not supported " + cmdstr);
+      build_reply('E', "NOTSUPPORTED", clientnum);
+      break;
+  }
+}
+
 void TCPIP_SERVER::process_command(int clientnum)
 {
   static byte joggingstate = 0;               // myfp2 compatibility
@@ -381,6 +498,20 @@ void TCPIP_SERVER::process_command(int clientnum)
   String drvbrd = ControllerData->get_brdname();
   receiveString = _myclients[clientnum]->readStringUntil(_EOFSTR);  // read until terminator
   receiveString = receiveString + '#' + "";
+  tcptrace->command(clientnum, receiveString.c_str(), receiveString.length());
+
+  // channel address, :@nxx# is command xx for focuser channel n, channel 0
+  // is the driver board so :@0xx# is the same as :xx#
+  if ( (receiveString[1] == '@') && (receiveString.length() > 4) )
+  {
+    int channel = receiveString[2] - '0';
+    receiveString = ":" + receiveString.substring(3);
+    if ( channel != 0 )
+    {
+      process_channel(channel, receiveString, clientnum);
+      return;
+    }
+  }
 
   String cmdstr = receiveString.substring(1, 3);
 
@@ -621,10 +752,6 @@ void TCPIP_SERVER::process_command(int clientnum)
       paramvalue = ( paramvalue < V_DISPLAYPAGETIMEMIN ) ? V_DISPLAYPAGETIMEMIN : paramvalue;
       paramvalue = ( paramvalue > V_DISPLAYPAGETIMEMAX ) ? V_DISPLAYPAGETIMEMAX : paramvalue;
       ControllerData->set_displaypagetime(paramvalue);
-      // update display_maxcount
-      portENTER_CRITICAL(&displaytimeMux);
-      display_maxcount = paramvalue * 10;                         // convert to timeslices
-      portEXIT_CRITICAL(&displaytimeMux);
       break;
     case 36: // myFP2 set display writing state, 0 = write not allowed, 1 = write text allowed
       // :360#    None    Blank the Display
@@ -737,10 +864,6 @@ void TCPIP_SERVER::process_command(int clientnum)
         paramvalue = (paramvalue < 30) ? 30 : paramvalue;
         paramvalue = (paramvalue > 300 ) ? 300 : paramvalue;
         ControllerData->set_parktime(paramvalue);
-        // update park_maxcount
-        portENTER_CRITICAL(&parkMux);
-        park_maxcount = paramvalue * 10;                         // convert to timeslices
-        portEXIT_CRITICAL(&parkMux);
       }
       break;
     case 61: // myFP2 set update of position on oled when moving (0=disable, 1=enable)
@@ -951,10 +1074,18 @@ void TCPIP_SERVER::process_command(int clientnum)
       build_reply('n', delayeddisplayupdatestatus, clientnum);
       break;
 
-    case 96: // not used
+    case 96: // myFP2ESP32 get loop profile, p50, p99 and max time of each section of loop() as json
+      {
+        String pdata = looprof->get_stats();
+        int len = pdata.length();
+        char pd[len + 3];
+        snprintf(pd, len + 3, "%c%s%c", '$', pdata.c_str(), _EOFSTR);
+        send_reply(pd, clientnum);
+      }
       break;
 
-    case 97: // not used
+    case 97: // myFP2ESP32 reset loop profile
+      looprof->reset_stats();
       break;
 
     case 98: // myFP2ESP32 get network strength dbm
@@ -1202,34 +1333,17 @@ void TCPIP_SERVER::process_command(int clientnum)
       }
       break;
 
-    case 118: // myFP2ESP32 get cntlr_config.jsn
+    case 118: // myFP2ESP32 get cntlr_config
       {
-        if ( SPIFFS.exists("/cntlr_config.jsn") == false )
-        {
-          send_reply("tcp: cntlr_config.jsn not found", clientnum);
-        }
-        else
-        {
-          // file exists so open it
-          File dfile = SPIFFS.open("/cntlr_config.jsn", "r");
-          if (!dfile)
-          {
-            send_reply("tcp: B8: cntlr_config.jsn not found", clientnum);
-          }
-          else
-          {
-            String cdata = dfile.readString();
-            dfile.close();
-            TCPSRVR_print("tcp: B8: cntlr_config = ");
-            TCPSRVR_println(cdata);
-            int len = cdata.length();
-            char cd[len + 2];
-            snprintf(cd, len + 2, "%c%s%c", '$', cdata, _EOFSTR);
-            send_reply(cd, clientnum);
-          }
-        }
+        // config is held as a binary image, export the cached values as json
+        String cdata = ControllerData->get_cntlrconfig_json();
+        TCPSRVR_print("tcp: B8: cntlr_config = ");
+        TCPSRVR_println(cdata);
+        int len = cdata.length();
+        char cd[len + 3];
+        snprintf(cd, len + 3, "%c%s%c", '$', cdata.c_str(), _EOFSTR);
+        send_reply(cd, clientnum);
       }
-      send_reply("tcp: B8: error", clientnum);
       break;
 
     case 119: // myFP2ESP32 get coil power state :B9#
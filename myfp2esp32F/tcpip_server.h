@@ -24,7 +24,7 @@ class TCPIP_SERVER
 
     bool start(unsigned long);                // start the tcp/ip server
     void stop(void);                          // top the tcp/ip server
-    void loop(bool);                          // check for new client and manage existing clients
+    bool loop(bool);                          // check for new client and manage existing clients, true if a command was received
 
     bool get_clients();
     void not_loaded(void);
@@ -47,6 +47,7 @@ class TCPIP_SERVER
   private:
     void nullarg(int);
     void process_command(int);
+    void process_channel(int, String &, int);
 
     WiFiServer *_myserver;
     WiFiClient *_myclients[MAXCONNECTIONS] = { NULL };  // 4 connections allowed
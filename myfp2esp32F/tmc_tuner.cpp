@@ -0,0 +1,462 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 TMC TUNER CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// tmc_tuner.cpp
+// StealthChop/SpreadCycle switch speed, CoolStep, idle hold current and
+// DRV_STATUS telemetry for the TMC driver boards
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "file_system.h"
+#include "tmc_uart.h"
+#include "tmc_tuner.h"
+
+#include "controller_data.h"
+extern CONTROLLER_DATA *ControllerData;
+
+extern TMC_UART *tmcuart;
+extern TMC_TUNER *tmctuner;
+
+extern bool filesystemloaded;
+extern bool isMoving;
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define TMCTUNER_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  TMCTUNER_PRINT
+#define TMCTUNER_print(...)   Serial.print(__VA_ARGS__)
+#define TMCTUNER_println(...) Serial.println(__VA_ARGS__)
+#else
+#define TMCTUNER_print(...)
+#define TMCTUNER_println(...)
+#endif
+
+// DRV_STATUS bits, the same on the TMC2208/TMC2225 and TMC2209
+#define DRV_OTPW        0x00000001UL      // over temperature pre-warning
+#define DRV_OT          0x00000002UL      // over temperature, driver shut down
+#define DRV_T120        0x00000100UL
+#define DRV_T143        0x00000200UL
+#define DRV_T150        0x00000400UL
+#define DRV_T157        0x00000800UL
+#define DRV_CSSHIFT     16                // CS_ACTUAL, 5 bits
+#define DRV_STEALTH     0x40000000UL
+#define DRV_STST        0x80000000UL      // standstill
+
+
+// ----------------------------------------------------------------------
+// DRV_STATUS READ
+// This must be outside of class, runs in the tmc uart task
+// ----------------------------------------------------------------------
+void tmctuner_status(byte reg, uint32_t value, bool ok)
+{
+  tmctuner->status(value, ok);
+}
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+TMC_TUNER::TMC_TUNER(void)
+{
+
+}
+
+void TMC_TUNER::begin(void)
+{
+#if (DRVBRD == PRO2ESP32TMC2225) || (DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P)
+  _tmc = true;
+#endif
+  if ( _tmc == false )
+  {
+    return;
+  }
+  if ( load() == true )
+  {
+    TMCTUNER_println("tmctuner: settings loaded");
+  }
+  _idlestart = millis();
+  if ( _enable == true )
+  {
+    apply();
+  }
+}
+
+// ----------------------------------------------------------------------
+// called every TMCTUNER_INTERVAL, reduces the hold current when idle
+// and reads DRV_STATUS
+// ----------------------------------------------------------------------
+bool TMC_TUNER::update(void)
+{
+  if ( (_tmc == false) || (_enable == false) )
+  {
+    return false;
+  }
+  bool queued = false;
+  // end of a move
+  if ( (isMoving == false) && (_moving == true) )
+  {
+    _idlestart = millis();
+  }
+  _moving = isMoving;
+
+  if ( (_moving == false) && (_hold == Hold_Full) )
+  {
+    // reduce the hold current early if the driver is getting hot
+    portENTER_CRITICAL(&_mux);
+    bool hot = (_statusok == true) && ((_drvstatus & DRV_OTPW) != 0);
+    portEXIT_CRITICAL(&_mux);
+    if ( (hot == true) || ((millis() - _idlestart) >= (unsigned long) _holddelay) )
+    {
+      hold(Hold_Reduced);
+      queued = true;
+    }
+  }
+
+  if ( (millis() - _lastread) >= TMCTUNER_STATUSTIME )
+  {
+    _lastread = millis();
+    tmcuart->read(Tmc_DrvStatus, tmctuner_status);
+  }
+  return queued;
+}
+
+// ----------------------------------------------------------------------
+// a move with a StallGuard home position switch that can reach home
+// stays in StealthChop, the stall output does not work in SpreadCycle
+// true if that move changed TPWMTHRS, it has to be written before the move
+// ----------------------------------------------------------------------
+bool TMC_TUNER::startmove(unsigned long stepdelay, bool mdir)
+{
+  if ( (_tmc == false) || (_enable == false) )
+  {
+    return false;
+  }
+  _moves++;
+  _movedelay = stepdelay;
+  _stealthonly = (mdir == moving_in) && (ControllerData->get_stallguard_state() == Use_Stallguard) \
+                 && ((ControllerData->get_brdnumber() == PRO2ESP32TMC2209) || (ControllerData->get_brdnumber() == PRO2ESP32TMC2209P));
+  _spread = (_stealthonly == false) && (_switchsps > 0) && (stepdelay > 0) && ((stepdelay * _switchsps) < 1000000UL);
+  if ( _spread == true )
+  {
+    _spreadmoves++;
+  }
+  bool changed = tmcuart->set(Tmc_Tpwmthrs, (_stealthonly == true) ? 0 : calc_tpwmthrs());
+  hold(Hold_Full);
+  _moving = true;
+  return (changed == true) && (_stealthonly == true);
+}
+
+// ----------------------------------------------------------------------
+// DRV_STATUS, CS_ACTUAL is only kept while the motor turns
+// ----------------------------------------------------------------------
+void TMC_TUNER::status(uint32_t value, bool ok)
+{
+  portENTER_CRITICAL(&_mux);
+  if ( ok == false )
+  {
+    _statusfails++;
+    portEXIT_CRITICAL(&_mux);
+    return;
+  }
+  _statusreads++;
+  _statusok = true;
+  _drvstatus = value;
+  _otpw += ((value & DRV_OTPW) != 0) ? 1 : 0;
+  _ot += ((value & DRV_OT) != 0) ? 1 : 0;
+  int level = ((value & DRV_T157) != 0) ? 157 : ((value & DRV_T150) != 0) ? 150 : ((value & DRV_T143) != 0) ? 143 : ((value & DRV_T120) != 0) ? 120 : 0;
+  _templevel = (level > _templevel) ? level : _templevel;
+  if ( (value & DRV_STST) == 0 )
+  {
+    byte cs = (value >> DRV_CSSHIFT) & 0x1F;
+    _cssum += cs;
+    _cscount++;
+    _csmin = (cs < _csmin) ? cs : _csmin;
+    _csmax = (cs > _csmax) ? cs : _csmax;
+  }
+  portEXIT_CRITICAL(&_mux);
+}
+
+// ----------------------------------------------------------------------
+// write all settings, when off the values set by init_tmc2209() and
+// rms_current() are restored
+// ----------------------------------------------------------------------
+void TMC_TUNER::apply(void)
+{
+  if ( _tmc == false )
+  {
+    return;
+  }
+  if ( _enable == true )
+  {
+    tmcuart->set(Tmc_SpreadCycle, 0);               // StealthChop, SpreadCycle above TPWMTHRS
+    tmcuart->set(Tmc_Tpwmthrs, calc_tpwmthrs());
+    tmcuart->set(Tmc_Semin, _semin);
+    tmcuart->set(Tmc_Semax, _semax);
+    tmcuart->set(Tmc_Seup, TMCTUNER_SEUP);
+    tmcuart->set(Tmc_Sedn, TMCTUNER_SEDN);
+    tmcuart->set(Tmc_HoldPct, (_hold == Hold_Full) ? 100 : _holdpct);
+  }
+  else
+  {
+    tmcuart->set(Tmc_Tpwmthrs, 0);
+    tmcuart->set(Tmc_Semin, 0);
+    tmcuart->set(Tmc_HoldPct, TMCTUNER_LIBHOLDPCT);
+  }
+}
+
+// ----------------------------------------------------------------------
+// TPWMTHRS is compared with TSTEP, the clocks between 1/256 steps, so
+// it depends on the step mode: TPWMTHRS = FCLK * stepmode / (256 * sps)
+// ----------------------------------------------------------------------
+uint32_t TMC_TUNER::calc_tpwmthrs(void)
+{
+  if ( _switchsps <= 0 )
+  {
+    return 0;
+  }
+  uint64_t thrs = ((uint64_t) TMCTUNER_FCLK * ControllerData->get_brdstepmode()) / (256ULL * _switchsps);
+  return (thrs > 0xFFFFF) ? 0xFFFFF : (uint32_t) thrs;       // 20 bit
+}
+
+void TMC_TUNER::hold(Tmctuner_Hold newhold)
+{
+  if ( (newhold == Hold_Reduced) && (_hold != Hold_Reduced) )
+  {
+    _reductions++;
+    _reducedstart = millis();
+  }
+  else if ( (newhold == Hold_Full) && (_hold == Hold_Reduced) )
+  {
+    _reducedtime += millis() - _reducedstart;
+  }
+  _hold = newhold;
+  tmcuart->set(Tmc_HoldPct, (_hold == Hold_Full) ? 100 : _holdpct);
+}
+
+void TMC_TUNER::set_enable(bool enable)
+{
+  if ( (_tmc == false) || (enable == _enable) )
+  {
+    return;
+  }
+  if ( _hold == Hold_Reduced )
+  {
+    hold(Hold_Full);
+  }
+  _enable = enable;
+  _idlestart = millis();
+  apply();
+  save();
+}
+
+bool TMC_TUNER::set_switchsps(long sps)
+{
+  // above 20000 TPWMTHRS is 0 at full steps
+  if ( (sps < 0) || (sps > 20000) )
+  {
+    return false;
+  }
+  _switchsps = sps;
+  if ( (_enable == true) && (isMoving == false) )
+  {
+    tmcuart->set(Tmc_Tpwmthrs, calc_tpwmthrs());
+  }
+  save();
+  return true;
+}
+
+bool TMC_TUNER::set_holdpct(int pct)
+{
+  if ( (pct < 0) || (pct > 100) )
+  {
+    return false;
+  }
+  _holdpct = pct;
+  if ( (_enable == true) && (_hold == Hold_Reduced) )
+  {
+    tmcuart->set(Tmc_HoldPct, _holdpct);
+  }
+  save();
+  return true;
+}
+
+bool TMC_TUNER::set_holddelay(long ms)
+{
+  if ( (ms < 0) || (ms > 600000) )
+  {
+    return false;
+  }
+  _holddelay = ms;
+  save();
+  return true;
+}
+
+bool TMC_TUNER::set_semin(int semin)
+{
+  if ( (semin < 0) || (semin > 15) )
+  {
+    return false;
+  }
+  _semin = semin;
+  if ( _enable == true )
+  {
+    tmcuart->set(Tmc_Semin, _semin);
+  }
+  save();
+  return true;
+}
+
+bool TMC_TUNER::set_semax(int semax)
+{
+  if ( (semax < 0) || (semax > 15) )
+  {
+    return false;
+  }
+  _semax = semax;
+  if ( _enable == true )
+  {
+    tmcuart->set(Tmc_Semax, _semax);
+  }
+  save();
+  return true;
+}
+
+bool TMC_TUNER::get_enable(void)
+{
+  return _enable;
+}
+
+bool TMC_TUNER::get_spreadcycle(void)
+{
+  return (_enable == true) && (_spread == true);
+}
+
+void TMC_TUNER::reset_stats(void)
+{
+  _moves = 0;
+  _spreadmoves = 0;
+  _reductions = 0;
+  _reducedtime = 0;
+  _reducedstart = millis();
+  portENTER_CRITICAL(&_mux);
+  _statusreads = 0;
+  _statusfails = 0;
+  _otpw = 0;
+  _ot = 0;
+  _templevel = 0;
+  _cssum = 0;
+  _cscount = 0;
+  _csmin = 31;
+  _csmax = 0;
+  portEXIT_CRITICAL(&_mux);
+}
+
+// ----------------------------------------------------------------------
+// settings, hold state and DRV_STATUS temperature and current telemetry
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String TMC_TUNER::get_stats(void)
+{
+  portENTER_CRITICAL(&_mux);
+  uint32_t drv = _drvstatus;
+  bool ok = _statusok;
+  uint32_t reads = _statusreads;
+  uint32_t fails = _statusfails;
+  uint32_t otpw = _otpw;
+  uint32_t ot = _ot;
+  int templevel = _templevel;
+  uint32_t csavg = (_cscount == 0) ? 0 : _cssum / _cscount;
+  byte csmin = (_cscount == 0) ? 0 : _csmin;
+  byte csmax = _csmax;
+  portEXIT_CRITICAL(&_mux);
+
+  unsigned long reducedtime = _reducedtime + ((_hold == Hold_Reduced) ? (millis() - _reducedstart) : 0);
+  int temp = ((drv & DRV_T157) != 0) ? 157 : ((drv & DRV_T150) != 0) ? 150 : ((drv & DRV_T143) != 0) ? 143 : ((drv & DRV_T120) != 0) ? 120 : 0;
+  String jsonstr = "{ \"tmc\":" + String((_tmc == true) ? "true" : "false") \
+                   + ", \"enable\":" + String((_enable == true) ? "true" : "false") \
+                   + ", \"switchsps\":" + String(_switchsps) + ", \"tpwmthrs\":" + String((_tmc == true) ? calc_tpwmthrs() : 0) \
+                   + ", \"holdpct\":" + String(_holdpct) + ", \"holddelay\":" + String(_holddelay) \
+                   + ", \"semin\":" + String(_semin) + ", \"semax\":" + String(_semax) \
+                   + ", \"hold\":\"" + String((_hold == Hold_Full) ? "full" : "reduced") + "\"" \
+                   + ", \"spreadcycle\":" + String((get_spreadcycle() == true) ? "true" : "false") \
+                   + ", \"stepdelay\":" + String(_movedelay) + ", \"moves\":" + String(_moves) \
+                   + ", \"spreadmoves\":" + String(_spreadmoves) + ", \"reductions\":" + String(_reductions) \
+                   + ", \"reducedtime\":" + String(reducedtime) \
+                   + ", \"status\":" + String((ok == true) ? "true" : "false") \
+                   + ", \"stealth\":" + String(((drv & DRV_STEALTH) != 0) ? "true" : "false") \
+                   + ", \"standstill\":" + String(((drv & DRV_STST) != 0) ? "true" : "false") \
+                   + ", \"otpw\":" + String(((drv & DRV_OTPW) != 0) ? "true" : "false") \
+                   + ", \"ot\":" + String(((drv & DRV_OT) != 0) ? "true" : "false") \
+                   + ", \"temp\":" + String(temp) + ", \"tempmax\":" + String(templevel) \
+                   + ", \"cs\":" + String((drv >> DRV_CSSHIFT) & 0x1F) + ", \"csavg\":" + String(csavg) \
+                   + ", \"csmin\":" + String(csmin) + ", \"csmax\":" + String(csmax) \
+                   + ", \"otpwcount\":" + String(otpw) + ", \"otcount\":" + String(ot) \
+                   + ", \"reads\":" + String(reads) + ", \"readfails\":" + String(fails) + " }";
+  return jsonstr;
+}
+
+// ----------------------------------------------------------------------
+// settings file, one line
+// enable switchsps holdpct holddelay semin semax
+// ----------------------------------------------------------------------
+bool TMC_TUNER::load(void)
+{
+  if ( (filesystemloaded == false) || (FILESYS.exists(TMCTUNER_FILE) == false) )
+  {
+    return false;
+  }
+  File file = FILESYS.open(TMCTUNER_FILE, "r");
+  String line = file.readStringUntil('\n');
+  file.close();
+  long v[6];
+  int start = 0;
+  for (int i = 0; i < 6; i++)
+  {
+    int sp = line.indexOf(' ', start);
+    if ( (sp < 0) && (i < 5) )
+    {
+      ERROR_println("tmctuner: settings file error");
+      return false;
+    }
+    v[i] = line.substring(start, (sp < 0) ? line.length() : sp).toInt();
+    start = sp + 1;
+  }
+  _enable = (v[0] != 0);
+  _switchsps = (v[1] < 0) ? TMCTUNER_SWITCHSPS : v[1];
+  _holdpct = ((v[2] < 0) || (v[2] > 100)) ? TMCTUNER_HOLDPCT : v[2];
+  _holddelay = (v[3] < 0) ? TMCTUNER_HOLDDELAY : v[3];
+  _semin = ((v[4] < 0) || (v[4] > 15)) ? TMCTUNER_SEMIN : v[4];
+  _semax = ((v[5] < 0) || (v[5] > 15)) ? TMCTUNER_SEMAX : v[5];
+  return true;
+}
+
+bool TMC_TUNER::save(void)
+{
+  if ( filesystemloaded == false )
+  {
+    return false;
+  }
+  File file = FILESYS.open(TMCTUNER_FILE, "w");
+  if ( !file )
+  {
+    ERROR_println("tmctuner: unable to save settings");
+    return false;
+  }
+  file.print(String((_enable == true) ? 1 : 0) + " " + String(_switchsps) + " " + String(_holdpct) + " " \
+             + String(_holddelay) + " " + String(_semin) + " " + String(_semax) + "\n");
+  file.close();
+  return true;
+}
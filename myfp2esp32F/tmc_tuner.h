@@ -0,0 +1,119 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 TMC TUNER CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// tmc_tuner.h
+// ----------------------------------------------------------------------
+
+#if !defined(_tmc_tuner_h_)
+#define _tmc_tuner_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define TMCTUNER_INTERVAL     100000      // us between updates
+#define TMCTUNER_STATUSTIME   500         // ms between DRV_STATUS reads
+#define TMCTUNER_FCLK         12000000    // internal clock of the TMC22xx, TSTEP and TPWMTHRS are in clocks per 1/256 step
+#define TMCTUNER_SWITCHSPS    800         // steps per second above which SpreadCycle is used, 0 is StealthChop only
+#define TMCTUNER_HOLDPCT      30          // idle hold current, % of the run current
+#define TMCTUNER_HOLDDELAY    2000        // ms after a move before the hold current is reduced
+#define TMCTUNER_SEMIN        5           // CoolStep, 0 is off, SG_RESULT below SEMIN*32 raises the current
+#define TMCTUNER_SEMAX        2           // CoolStep, SG_RESULT above (SEMIN+SEMAX+1)*32 lowers the current
+#define TMCTUNER_SEUP         1           // CoolStep, current increment 1 2 4 8
+#define TMCTUNER_SEDN         0           // CoolStep, SG_RESULT samples per decrement 32 8 2 1
+#define TMCTUNER_LIBHOLDPCT   50          // hold current set by rms_current(), used when the tuner is off
+#define TMCTUNER_FILE         "/tmctuner.txt"
+
+enum Tmctuner_Hold { Hold_Full, Hold_Reduced };
+
+void tmctuner_status(byte, uint32_t, bool);   // DRV_STATUS read callback, runs in the tmc uart task
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// Speed and load dependant settings of the TMC2209/TMC2225, written
+// through the TMC_UART cache. TPWMTHRS is set so the driver uses
+// StealthChop below the switch speed and SpreadCycle above it. CoolStep
+// [TMC2209] lowers the run current when the load is low. After a move
+// the motor holds at the run current, HOLDDELAY later IHOLD is reduced to
+// HOLDPCT of it, the next move restores it. The coil power and park
+// settings still decide if the motor is released.
+// StallGuard4 only works in StealthChop, so moves in, when StallGuard is
+// the home position switch, stay in StealthChop, and SG_RESULT is not
+// used above the switch speed.
+// DRV_STATUS is read as a motor temperature proxy, the driver and motor
+// share the heat of the coil current.
+class TMC_TUNER
+{
+  public:
+    TMC_TUNER(void);
+
+    void begin(void);                     // loads the settings, call after the driver board has started
+    bool update(void);                    // loop scheduler job, true if a setting was queued
+    bool startmove(unsigned long, bool);  // step delay us, direction, called by initmove(), true if a StallGuard setting was queued
+    void status(uint32_t, bool);          // DRV_STATUS, from tmctuner_status()
+
+    void set_enable(bool);
+    bool set_switchsps(long);             // false if out of range
+    bool set_holdpct(int);
+    bool set_holddelay(long);
+    bool set_semin(int);                  // 0 is CoolStep off
+    bool set_semax(int);
+    void reset_stats(void);
+
+    bool get_enable(void);
+    bool get_spreadcycle(void);           // the move is above the switch speed
+    String get_stats(void);
+
+  private:
+    void apply(void);
+    uint32_t calc_tpwmthrs(void);
+    void hold(Tmctuner_Hold);
+    bool load(void);
+    bool save(void);
+
+    bool  _tmc = false;                   // a TMC board
+    bool  _enable = false;
+    long  _switchsps = TMCTUNER_SWITCHSPS;
+    int   _holdpct = TMCTUNER_HOLDPCT;
+    long  _holddelay = TMCTUNER_HOLDDELAY;
+    int   _semin = TMCTUNER_SEMIN;
+    int   _semax = TMCTUNER_SEMAX;
+    bool  _moving = false;                // isMoving when last updated
+    bool  _spread = false;
+    bool  _stealthonly = false;           // the move needs StallGuard
+    unsigned long _movedelay = 0;         // us step delay of the move
+    unsigned long _idlestart = 0;         // millis() the last move ended
+    unsigned long _lastread = 0;          // millis() of the last DRV_STATUS read
+    enum Tmctuner_Hold _hold = Hold_Full;
+    unsigned long _reducedstart = 0;      // millis() the hold current was reduced
+    // DRV_STATUS, written by the tmc uart task
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    uint32_t _drvstatus = 0;
+    bool     _statusok = false;
+    uint32_t _statusreads = 0;
+    uint32_t _statusfails = 0;
+    uint32_t _otpw = 0;                   // reads with the pre-warning set
+    uint32_t _ot = 0;                     // reads with the driver shut down
+    int      _templevel = 0;              // highest temperature flag seen, 0 120 143 150 157
+    uint32_t _cssum = 0;                  // CS_ACTUAL while moving
+    uint32_t _cscount = 0;
+    byte     _csmin = 31;
+    byte     _csmax = 0;
+    // stats
+    uint32_t _moves = 0;
+    uint32_t _spreadmoves = 0;
+    uint32_t _reductions = 0;
+    unsigned long _reducedtime = 0;       // ms at the reduced hold current, completed periods
+};
+
+
+
+#endif // #if !defined(_tmc_tuner_h_)
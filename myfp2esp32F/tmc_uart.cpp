@@ -0,0 +1,424 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 TMC UART CLASS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// tmc_uart.cpp
+// Shadow cache and background uart task for the TMC2209/TMC2225
+// ----------------------------------------------------------------------
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+#include "tmc_uart.h"
+
+
+// -----------------------------------------------------------------------
+// DEBUGGING
+// -----------------------------------------------------------------------
+// DO NOT ENABLE DEBUGGING INFORMATION.
+
+// Remove comment to enable messages to Serial port
+//#define TMCUART_PRINT       1
+
+// -----------------------------------------------------------------------
+// DO NOT CHANGE
+// -----------------------------------------------------------------------
+#ifdef  TMCUART_PRINT
+#define TMCUART_print(...)   Serial.print(__VA_ARGS__)
+#define TMCUART_println(...) Serial.println(__VA_ARGS__)
+#else
+#define TMCUART_print(...)
+#define TMCUART_println(...)
+#endif
+
+struct tmc_readreq
+{
+  byte         reg;
+  tmc_callback cb;
+};
+
+
+// ----------------------------------------------------------------------
+// TMC UART TASK
+// woken by set() and read(), else checks for work every TMCUART_IDLE
+// ----------------------------------------------------------------------
+void tmcuart_task(void *param)
+{
+  TMC_UART *tmc = (TMC_UART *) param;
+  for (;;)
+  {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TMCUART_IDLE));
+    tmc->run();
+  }
+}
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+TMC_UART::TMC_UART(void)
+{
+
+}
+
+// ----------------------------------------------------------------------
+// settings made before begin() are written when the task starts
+// a restarted driver board passes its new driver, the task keeps running
+// ----------------------------------------------------------------------
+bool TMC_UART::begin(TMC2208Stepper *drv, TMC2209Stepper *drv9)
+{
+  if ( drv == NULL )
+  {
+    return false;
+  }
+  _drv = drv;
+  _drv9 = drv9;
+  if ( _task != NULL )
+  {
+    xTaskNotifyGive(_task);
+    return true;
+  }
+  _reads = xQueueCreate(TMCUART_READQUEUE, sizeof(tmc_readreq));
+  if ( _reads == NULL )
+  {
+    ERROR_println("tmcuart: begin error, no memory");
+    return false;
+  }
+  xTaskCreatePinnedToCore(tmcuart_task, "tmcuart", TMCUART_TASKSTACK, this, TMCUART_TASKPRIORITY, &_task, TMCUART_TASKCORE);
+  TMCUART_println("tmcuart: started");
+  return true;
+}
+
+bool TMC_UART::set(Tmc_Settings s, uint32_t value)
+{
+  uint32_t bit = 1UL << s;
+  portENTER_CRITICAL(&_mux);
+  if ( ((_valid & bit) != 0) && (_value[s] == value) )
+  {
+    _skipped++;
+    portEXIT_CRITICAL(&_mux);
+    return false;
+  }
+  _value[s] = value;
+  _valid |= bit;
+  _dirty |= bit;
+  _queued++;
+  portEXIT_CRITICAL(&_mux);
+  if ( _task != NULL )
+  {
+    xTaskNotifyGive(_task);
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------
+// called from loop(), waits until the task has written every queued
+// setting, a failed batch is queued again so it waits until the timeout
+// ----------------------------------------------------------------------
+bool TMC_UART::flush(uint32_t timeout)
+{
+  if ( _task == NULL )
+  {
+    return false;
+  }
+  _flushes++;
+  unsigned long start = millis();
+  for (;;)
+  {
+    portENTER_CRITICAL(&_mux);
+    bool done = (_dirty == 0) && (_writing == false);
+    portEXIT_CRITICAL(&_mux);
+    if ( done == true )
+    {
+      return true;
+    }
+    if ( (millis() - start) >= timeout )
+    {
+      _flushfails++;
+      ERROR_println("tmcuart: flush timeout");
+      return false;
+    }
+    xTaskNotifyGive(_task);
+    delay(1);
+  }
+}
+
+uint32_t TMC_UART::get(Tmc_Settings s)
+{
+  portENTER_CRITICAL(&_mux);
+  uint32_t value = _value[s];
+  portEXIT_CRITICAL(&_mux);
+  return value;
+}
+
+bool TMC_UART::read(Tmc_Reads reg, tmc_callback cb)
+{
+  if ( _reads == NULL )
+  {
+    return false;
+  }
+  tmc_readreq req = { (byte) reg, cb };
+  if ( xQueueSend(_reads, &req, 0) != pdTRUE )
+  {
+    _readsfull++;
+    return false;
+  }
+  xTaskNotifyGive(_task);
+  return true;
+}
+
+int32_t TMC_UART::get_read(Tmc_Reads reg)
+{
+  portENTER_CRITICAL(&_mux);
+  int32_t value = _result[reg];
+  portEXIT_CRITICAL(&_mux);
+  return value;
+}
+
+// ----------------------------------------------------------------------
+// uart task, the writes waiting then the reads
+// ----------------------------------------------------------------------
+void TMC_UART::run(void)
+{
+  uint32_t values[Tmc_Count];
+  portENTER_CRITICAL(&_mux);
+  uint32_t dirty = _dirty;
+  _dirty = 0;
+  _writing = (dirty != 0);
+  // rms_current() sets IHOLD to half of IRUN, the hold % is written again after it
+  if ( ((dirty & (1UL << Tmc_Current)) != 0) && ((_valid & (1UL << Tmc_HoldPct)) != 0) )
+  {
+    dirty |= (1UL << Tmc_HoldPct);
+  }
+  memcpy(values, _value, sizeof(values));
+  portEXIT_CRITICAL(&_mux);
+  if ( dirty != 0 )
+  {
+    bool ok = write_batch(dirty, values);
+    portENTER_CRITICAL(&_mux);
+    if ( ok == false )
+    {
+      // the driver may not hold the shadow values, written again next time the task runs
+      _dirty |= dirty;
+    }
+    _writing = false;
+    portEXIT_CRITICAL(&_mux);
+  }
+
+  tmc_readreq req;
+  while ( xQueueReceive(_reads, &req, 0) == pdTRUE )
+  {
+    uint32_t value = 0;
+    bool ok = read_reg(req.reg, value);
+    portENTER_CRITICAL(&_mux);
+    _result[req.reg] = (ok == true) ? (int32_t) value : -1;
+    portEXIT_CRITICAL(&_mux);
+    _readsdone++;
+    if ( req.cb != NULL )
+    {
+      req.cb(req.reg, value, ok);
+    }
+  }
+}
+
+// ----------------------------------------------------------------------
+// IFCNT counts the write datagrams the driver accepted, each setting is
+// at least one write so a count lower than the settings written means a
+// write was lost and the batch is written again
+// false if every attempt failed
+// ----------------------------------------------------------------------
+bool TMC_UART::write_batch(uint32_t dirty, uint32_t *values)
+{
+#if defined(TMCUART_DRIVER)
+  uint32_t start = micros();
+  uint32_t count = 0;
+  for (int s = 0; s < Tmc_Count; s++)
+  {
+    count += ((dirty >> s) & 1);
+  }
+  for (int attempt = 0; attempt <= TMCUART_RETRIES; attempt++)
+  {
+    _drv->CRCerror = false;
+    uint8_t before = _drv->IFCNT();
+    bool counted = (_drv->CRCerror == false);
+    for (int s = 0; s < Tmc_Count; s++)
+    {
+      if ( (dirty & (1UL << s)) != 0 )
+      {
+        apply(s, values[s]);
+      }
+    }
+    _drv->CRCerror = false;
+    uint8_t after = _drv->IFCNT();
+    counted = counted && (_drv->CRCerror == false);
+    if ( counted == false )
+    {
+      _crcerrors++;
+    }
+    else if ( (uint8_t) (after - before) >= count )
+    {
+      _writes += count;
+      _batches++;
+      uint32_t t = micros() - start;
+      _batch_max = (t > _batch_max) ? t : _batch_max;
+      return true;
+    }
+    if ( attempt < TMCUART_RETRIES )
+    {
+      _retries++;
+    }
+  }
+  _writefails++;
+  ERROR_println("tmcuart: write failed");
+  return false;
+#else
+  return true;
+#endif // #if defined(TMCUART_DRIVER)
+}
+
+void TMC_UART::apply(int s, uint32_t value)
+{
+#if defined(TMCUART_DRIVER)
+  switch ( s )
+  {
+    case Tmc_Microsteps:
+      _drv->microsteps(value);
+      break;
+    case Tmc_Current:
+      _drv->rms_current(value);
+      break;
+    case Tmc_Toff:
+      _drv->toff(value);
+      break;
+    case Tmc_Tbl:
+      _drv->tbl(value);
+      break;
+    case Tmc_Hend:
+      _drv->hysteresis_end(value);
+      break;
+    case Tmc_Hstrt:
+      _drv->hysteresis_start(value);
+      break;
+    case Tmc_Semin:
+      if ( _drv9 != NULL )
+      {
+        _drv9->semin(value);
+      }
+      break;
+    case Tmc_Tcoolthrs:
+      if ( _drv9 != NULL )
+      {
+        _drv9->TCOOLTHRS(value);
+      }
+      break;
+    case Tmc_Sgthrs:
+      if ( _drv9 != NULL )
+      {
+        _drv9->SGTHRS(value);
+      }
+      break;
+    case Tmc_SpreadCycle:
+      _drv->en_spreadCycle(value != 0);
+      break;
+    case Tmc_Tpwmthrs:
+      _drv->TPWMTHRS(value);
+      break;
+    case Tmc_Semax:
+      if ( _drv9 != NULL )
+      {
+        _drv9->semax(value);
+      }
+      break;
+    case Tmc_Seup:
+      if ( _drv9 != NULL )
+      {
+        _drv9->seup(value);
+      }
+      break;
+    case Tmc_Sedn:
+      if ( _drv9 != NULL )
+      {
+        _drv9->sedn(value);
+      }
+      break;
+    case Tmc_HoldPct:
+      // % of the run current, irun() is the library copy of IHOLD_IRUN, it does not use the uart
+      _drv->ihold((_drv->irun() * value) / 100);
+      break;
+  }
+#endif // #if defined(TMCUART_DRIVER)
+}
+
+// ----------------------------------------------------------------------
+// the library sets CRCerror when a reply fails its crc
+// ----------------------------------------------------------------------
+bool TMC_UART::read_reg(byte reg, uint32_t &value)
+{
+#if defined(TMCUART_DRIVER)
+  for (int attempt = 0; attempt <= TMCUART_RETRIES; attempt++)
+  {
+    _drv->CRCerror = false;
+    switch ( reg )
+    {
+      case Tmc_SgResult:
+        value = (_drv9 != NULL) ? _drv9->SG_RESULT() : 0;
+        break;
+      case Tmc_DrvStatus:
+        value = _drv->DRV_STATUS();
+        break;
+      case Tmc_Tstep:
+        value = _drv->TSTEP();
+        break;
+      case Tmc_CsActual:
+        value = _drv->cs_actual();
+        break;
+    }
+    if ( _drv->CRCerror == false )
+    {
+      return true;
+    }
+    _crcerrors++;
+    if ( attempt < TMCUART_RETRIES )
+    {
+      _retries++;
+    }
+  }
+  _readfails++;
+#endif // #if defined(TMCUART_DRIVER)
+  return false;
+}
+
+// ----------------------------------------------------------------------
+// writes queued, skipped and done, reads, crc failures and retries
+// Returns a json string - used by Management Server
+// ----------------------------------------------------------------------
+String TMC_UART::get_stats(void)
+{
+  String jsonstr = "{ \"running\":" + String((_task != NULL) ? "true" : "false") \
+                   + ", \"queued\":" + String(_queued) + ", \"skipped\":" + String(_skipped) \
+                   + ", \"writes\":" + String(_writes) + ", \"batches\":" + String(_batches) \
+                   + ", \"batch_max\":" + String(_batch_max) + ", \"reads\":" + String(_readsdone) \
+                   + ", \"readsfull\":" + String(_readsfull) + ", \"crcerrors\":" + String(_crcerrors) \
+                   + ", \"retries\":" + String(_retries) + ", \"writefails\":" + String(_writefails) \
+                   + ", \"readfails\":" + String(_readfails) + ", \"flushes\":" + String(_flushes) \
+                   + ", \"flushfails\":" + String(_flushfails) + " }";
+  return jsonstr;
+}
+
+void TMC_UART::reset_stats(void)
+{
+  _queued = 0;
+  _skipped = 0;
+  _writes = 0;
+  _batches = 0;
+  _readsdone = 0;
+  _readsfull = 0;
+  _crcerrors = 0;
+  _retries = 0;
+  _writefails = 0;
+  _readfails = 0;
+  _flushes = 0;
+  _flushfails = 0;
+  _batch_max = 0;
+}
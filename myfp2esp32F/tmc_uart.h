@@ -0,0 +1,111 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 TMC UART CLASS DEFINITIONS
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// tmc_uart.h
+// ----------------------------------------------------------------------
+
+#if !defined(_tmc_uart_h_)
+#define _tmc_uart_h_
+
+
+// ----------------------------------------------------------------------
+// INCLUDES
+// ----------------------------------------------------------------------
+#include <Arduino.h>
+#include "controller_config.h"                // includes boarddefs.h and controller_defines.h
+
+// the tmc library is only needed for the tmc driver boards
+#if (DRVBRD == PRO2ESP32TMC2225) || (DRVBRD == PRO2ESP32TMC2209 || DRVBRD == PRO2ESP32TMC2209P)
+#define TMCUART_DRIVER  1
+#include <TMCStepper.h>                       // tmc library https://github.com/teemuatlut/TMCStepper
+#else
+class TMC2208Stepper;
+class TMC2209Stepper;
+#endif
+
+
+// ----------------------------------------------------------------------
+// DEFINES
+// ----------------------------------------------------------------------
+#define TMCUART_TASKSTACK     3072
+#define TMCUART_TASKPRIORITY  2               // above the display task
+#define TMCUART_TASKCORE      0               // loop() runs on core 1
+#define TMCUART_IDLE          50              // ms the task waits for work
+#define TMCUART_READQUEUE     8               // reads waiting for the task
+#define TMCUART_RETRIES       2               // retries of a failed read or a batch of writes
+#define TMCUART_FLUSHTIME     20              // ms flush() waits for the writes
+
+// settings held in the shadow cache, each is one TMCStepper setter
+// written in this order, Tmc_HoldPct is after Tmc_Current as rms_current() also sets IHOLD
+enum Tmc_Settings { Tmc_Microsteps, Tmc_Current, Tmc_Toff, Tmc_Tbl, Tmc_Hend, Tmc_Hstrt,
+                    Tmc_Semin, Tmc_Tcoolthrs, Tmc_Sgthrs, Tmc_SpreadCycle, Tmc_Tpwmthrs,
+                    Tmc_Semax, Tmc_Seup, Tmc_Sedn, Tmc_HoldPct, Tmc_Count
+                  };
+
+// registers that can be read, SG_RESULT and TCOOLTHRS are TMC2209 only
+enum Tmc_Reads { Tmc_SgResult, Tmc_DrvStatus, Tmc_Tstep, Tmc_CsActual, Tmc_ReadCount };
+
+// called from the uart task when a read completes, keep it short
+typedef void (*tmc_callback)(byte, uint32_t, bool);   // Tmc_Reads, value, ok
+
+
+// ----------------------------------------------------------------------
+// CLASS
+// ----------------------------------------------------------------------
+// All uart traffic to the TMC driver is done by a task on core 0, the
+// callers do not wait. set() updates a shadow copy of the setting and
+// only queues a write if the value changed, the task writes all changed
+// settings as one batch and checks the batch with the IFCNT write
+// counter, a failed batch stays queued. read() queues a read, the value
+// is passed to the callback and kept for get_read(). flush() waits for
+// the queued writes, for settings that must be in the driver before a
+// move starts.
+class TMC_UART
+{
+  public:
+    TMC_UART(void);
+
+    bool begin(TMC2208Stepper *, TMC2209Stepper *);  // driver, same driver if a TMC2209 else NULL
+    bool set(Tmc_Settings, uint32_t);     // false if unchanged
+    bool flush(uint32_t);                 // wait ms for the queued writes, false on timeout
+    uint32_t get(Tmc_Settings);           // shadow value
+    bool read(Tmc_Reads, tmc_callback);   // false if the read queue is full, callback can be NULL
+    int32_t get_read(Tmc_Reads);          // last value read, -1 if none or the read failed
+    void run(void);                       // uart task
+    String get_stats(void);
+    void reset_stats(void);
+
+  private:
+    bool write_batch(uint32_t, uint32_t *);
+    void apply(int, uint32_t);
+    bool read_reg(byte, uint32_t &);
+
+    TMC2208Stepper *_drv = NULL;
+    TMC2209Stepper *_drv9 = NULL;
+    TaskHandle_t  _task = NULL;
+    QueueHandle_t _reads = NULL;
+    portMUX_TYPE  _mux = portMUX_INITIALIZER_UNLOCKED;   // protects the shadow and the results
+    uint32_t _value[Tmc_Count] = { 0 };
+    uint32_t _valid = 0;                  // bit per setting, value has been set
+    uint32_t _dirty = 0;                  // bit per setting, waiting to be written
+    bool     _writing = false;            // a batch is being written
+    int32_t  _result[Tmc_ReadCount] = { -1, -1, -1, -1 };
+    // stats
+    uint32_t _queued = 0;
+    uint32_t _skipped = 0;                // set() with the value already held
+    uint32_t _writes = 0;
+    uint32_t _batches = 0;
+    uint32_t _readsdone = 0;
+    uint32_t _readsfull = 0;              // read() with the queue full
+    uint32_t _crcerrors = 0;
+    uint32_t _retries = 0;
+    uint32_t _writefails = 0;
+    uint32_t _flushes = 0;
+    uint32_t _flushfails = 0;             // flush() timed out
+    uint32_t _readfails = 0;
+    uint32_t _batch_max = 0;              // us
+};
+
+
+
+#endif // #if !defined(_tmc_uart_h_)
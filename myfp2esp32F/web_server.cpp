@@ -16,7 +16,7 @@
 #include "controller_config.h"                          // includes boarddefs.h and controller_defines.h
 
 #include <WiFi.h>
-#include "SPIFFS.h"
+#include "file_system.h"
 #include <SPI.h>
 #include <WebServer.h>
 
@@ -336,14 +336,9 @@ bool WEB_SERVER::start(unsigned long port)
     wsget_notfound();
   });
 
-  if ( loadpages() == false )
-  {
-    // error could not load pages
-    // loading pages should come before _web_serv->begin()
-    ERROR_println("ws: loadpages(): error");
-    stop();
-    return false;
-  }
+  // the pages are not loaded here, so the web server does not delay the
+  // boot. They are cached in the background after boot, or on first use
+  this->_pagescached = false;
   _web_server->begin();
   this->_loaded = true;
   this->_state = true;
@@ -392,6 +387,23 @@ void WEB_SERVER::loop(bool parked)
   _web_server->handleClient();
 }
 
+// ----------------------------------------------------------------------
+// bool cachepages(void);
+// Load webserver pages into memory if not already cached
+// ----------------------------------------------------------------------
+bool WEB_SERVER::cachepages(void)
+{
+  if ( this->_pagescached == false )
+  {
+    this->_pagescached = loadpages();
+    if ( this->_pagescached == false )
+    {
+      ERROR_println("ws: loadpages(): error");
+    }
+  }
+  return this->_pagescached;
+}
+
 // ----------------------------------------------------------------------
 // bool loadpages(void);
 // Load webserver pages into memory
@@ -405,9 +417,9 @@ bool WEB_SERVER::loadpages(void)
     return false;
   }
 
-  if ( SPIFFS.exists("/index.html"))
+  if ( FILESYS.exists("/index.html"))
   {
-    File file = SPIFFS.open("/index.html", "r");
+    File file = FILESYS.open("/index.html", "r");
     this->_indexpg = file.readString() + "";
     file.close();
   }
@@ -418,9 +430,9 @@ bool WEB_SERVER::loadpages(void)
     return false;
   }
 
-  if ( SPIFFS.exists("/move.html"))
+  if ( FILESYS.exists("/move.html"))
   {
-    File file = SPIFFS.open("/move.html", "r");
+    File file = FILESYS.open("/move.html", "r");
     this->_movepg = file.readString() + "";
     file.close();
   }
@@ -431,9 +443,9 @@ bool WEB_SERVER::loadpages(void)
     return false;
   }
 
-  if ( SPIFFS.exists("/presets.html"))
+  if ( FILESYS.exists("/presets.html"))
   {
-    File file = SPIFFS.open("/presets.html", "r");
+    File file = FILESYS.open("/presets.html", "r");
     this->_presetspg = file.readString() + "";
     file.close();
   }
@@ -444,9 +456,9 @@ bool WEB_SERVER::loadpages(void)
     return false;
   }
 
-  if ( SPIFFS.exists("/notfound.html"))
+  if ( FILESYS.exists("/notfound.html"))
   {
-    File file = SPIFFS.open("/notfound.html", "r");
+    File file = FILESYS.open("/notfound.html", "r");
     this->_notfoundpg = file.readString() + "";
     file.close();
   }
@@ -663,7 +675,24 @@ void WEB_SERVER::get_index(void)
     // end of post
   }
 
+  build_index(WSpg);
+
+  WEBSRVR_print("/index ");
+  WEBSRVR_println(WSpg.length());
+  send_myheader();
+  send_mycontent(WSpg);
+}
+
+
+// ----------------------------------------------------------------------
+// fill in the index page template, also used by the benchmarks
+// ----------------------------------------------------------------------
+void WEB_SERVER::build_index(String &WSpg)
+{
+  String tmp;
+
   // make sure not to change the original template
+  cachepages();
   WSpg = this->_indexpg;
 
   WSpg.replace("%PGT%", devicename);
@@ -911,11 +940,6 @@ void WEB_SERVER::get_index(void)
   // add system uptime
   get_systemuptime();
   WSpg.replace("%SUT%", systemuptime);
-
-  WEBSRVR_print("/index ");
-  WEBSRVR_println(WSpg.length());
-  send_myheader();
-  send_mycontent(WSpg);
 }
 
 
@@ -1023,6 +1047,7 @@ void WEB_SERVER::get_move(void)
   }
   // end of move_post
 
+  cachepages();
   WSpg = this->_movepg;
 
   WSpg.replace("%PGT%", devicename);
@@ -1420,6 +1445,7 @@ void WEB_SERVER::get_presets(void)
     }
   } // end of presets post
 
+  cachepages();
   WSpg = this->_presetspg;
 
   WSpg.replace("%PGT%", devicename);
@@ -1502,7 +1528,8 @@ void WEB_SERVER::reload_webpages()
     return;
   }
 
-  if ( loadpages() == false )
+  this->_pagescached = loadpages();
+  if ( this->_pagescached == false )
   {
     ERROR_println("ws: Web pages reloaded into cache: ERROR");
   }
@@ -1612,6 +1639,7 @@ void WEB_SERVER::get_notfound(void)
     return;
   }
 
+  cachepages();
   WSpg = this->_notfoundpg;
 
   // process for dynamic data
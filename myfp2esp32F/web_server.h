@@ -14,7 +14,7 @@
 // ----------------------------------------------------------------------
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include "SPIFFS.h"
+#include "file_system.h"
 #include "WebServer.h"
 
 
@@ -39,9 +39,11 @@ class WEB_SERVER
     void get_presets(void);
     void post_presets(void);
     void get_index(void);
+    void build_index(String &);
     void get_move(void);
     void post_move(void);
     void reload_webpages(void);
+    bool cachepages(void);
         
     // xhtml
     void get_position(void);
@@ -67,6 +69,7 @@ class WEB_SERVER
     bool _loaded = false;
     bool _parked = true;
     bool _state = false;
+    bool _pagescached = false;      // pages are cached on first use or by boot_deferred()
     String _indexpg;
     String _movepg;
     String _presetspg;
@@ -0,0 +1,143 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 HOST FIRMWARE
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// host_main.cpp
+// ----------------------------------------------------------------------
+// Runs the controller firmware on the pc, not the ESP32. The files of
+// data/ are loaded into MemoryFS, then setup() and loop() run as on the
+// ESP32, with the HAL virtual clock kept in step with real time. The
+// servers listen on the pc [tcpip 2020, ascom 4040, management 6060,
+// web 80], so tools/tcp_replay.py and tools/alpaca_bench.py can be run
+// against 127.0.0.1.
+//
+// The motor is not connected, moves run on the move timer isr as on the
+// ESP32. There is no temperature probe, display, infra red remote or TMC
+// uart. ArduinoJson is the library installed for the Arduino IDE.
+//
+// Build and run from this folder
+//   g++ -std=gnu++17 -O1 -I../../myfp2esp32F/host -I../../myfp2esp32F -I<ArduinoJson>/src
+//       host_main.cpp ../../myfp2esp32F/*.cpp ../../myfp2esp32F/host/*.cpp
+//       -x c++ ../../myfp2esp32F/myfp2esp32F.ino -o myfp2esp32F_host
+//   ./myfp2esp32F_host [data folder, default ../../myfp2esp32F/data]
+// Ports below 1024 [the web server] need root, or change the port
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "Arduino.h"
+#include "hal.h"
+#include "file_system_memory.h"
+
+void setup(void);
+void loop(void);
+
+
+// ----------------------------------------------------------------------
+// SUPPORT
+// ----------------------------------------------------------------------
+// us since the process started
+static uint64_t host_realtime(void)
+{
+  static uint64_t start = 0;
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t now = ((uint64_t) ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+  if ( start == 0 )
+  {
+    start = now;
+  }
+  return now - start;
+}
+
+// copy a folder and its sub folders into MemoryFS, returns the number of files
+static int host_loaddir(const String &dir, const String &path)
+{
+  DIR *d = opendir(dir.c_str());
+  if ( d == NULL )
+  {
+    return -1;
+  }
+  int count = 0;
+  struct dirent *e;
+  while ( (e = readdir(d)) != NULL )
+  {
+    if ( e->d_name[0] == '.' )
+    {
+      continue;
+    }
+    String src = dir + "/" + e->d_name;
+    String dst = path + e->d_name;
+    struct stat st;
+    if ( stat(src.c_str(), &st) != 0 )
+    {
+      continue;
+    }
+    if ( S_ISDIR(st.st_mode) )
+    {
+      MemoryFS.mkdir(dst.c_str());
+      int n = host_loaddir(src, dst + "/");
+      count += (n > 0) ? n : 0;
+      continue;
+    }
+    FILE *in = fopen(src.c_str(), "rb");
+    File out = MemoryFS.open(dst.c_str(), "w");
+    if ( (in == NULL) || !out )
+    {
+      printf("host: unable to load %s\n", src.c_str());
+      if ( in != NULL )
+      {
+        fclose(in);
+      }
+      continue;
+    }
+    uint8_t buf[1024];
+    size_t n;
+    while ( (n = fread(buf, 1, sizeof(buf), in)) > 0 )
+    {
+      out.write(buf, n);
+    }
+    out.close();
+    fclose(in);
+    count++;
+  }
+  closedir(d);
+  return count;
+}
+
+
+// ----------------------------------------------------------------------
+// MAIN
+// ----------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  String datadir = (argc > 1) ? argv[1] : "../../myfp2esp32F/data";
+
+  setvbuf(stdout, NULL, _IOLBF, 0);         // Serial, so the log can be followed
+
+  hal_host_reset();
+  MemoryFS.begin();
+  int files = host_loaddir(datadir, "/");
+  if ( files < 0 )
+  {
+    printf("host: unable to open %s\n", datadir.c_str());
+    return 1;
+  }
+  printf("host: %d files loaded from %s, %u bytes\n", files, datadir.c_str(), (unsigned int) MemoryFS.usedBytes());
+
+  host_realtime();
+  setup();
+  for (;;)
+  {
+    // delay() moves the virtual clock on at once, real time catches up
+    uint64_t now = host_realtime();
+    if ( now > hal_host_clock() )
+    {
+      hal_host_advance(now - hal_host_clock());
+    }
+    loop();
+    usleep(100);
+  }
+  return 0;
+}
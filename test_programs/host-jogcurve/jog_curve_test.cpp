@@ -0,0 +1,224 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 JOG CURVE HOST TEST
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// jog_curve_test.cpp
+// ----------------------------------------------------------------------
+// Runs on the pc, not the ESP32. Feeds JOG_CURVE a synthetic joystick adc
+// trace and checks calibration, deadzone, rate curve, hysteresis and the
+// jog step delay. The noise is from a fixed seed so every run is the same.
+//
+// Build and run from this folder
+//   g++ -std=gnu++11 -Wall -I../../myfp2esp32F jog_curve_test.cpp ../../myfp2esp32F/jog_curve.cpp -o jog_curve_test
+//   ./jog_curve_test
+// Returns 0 if all checks pass
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "jog_curve.h"
+
+
+// ----------------------------------------------------------------------
+// CHECKS
+// ----------------------------------------------------------------------
+static int checks = 0;
+static int failures = 0;
+
+static void check(bool ok, const char *what, long value)
+{
+  checks++;
+  if ( ok == false )
+  {
+    failures++;
+    printf("FAIL %s [%ld]\n", what, value);
+  }
+}
+
+
+// ----------------------------------------------------------------------
+// SYNTHETIC ADC TRACE
+// ----------------------------------------------------------------------
+static uint32_t seed = 1;
+
+// noise of +- amplitude, linear congruential so the trace is repeatable
+static int noise(int amplitude)
+{
+  seed = (seed * 1103515245UL) + 12345UL;
+  int n = (int) ((seed >> 16) % (uint32_t) (2 * amplitude + 1));
+  return n - amplitude;
+}
+
+static int adc(int value, int amplitude)
+{
+  int v = value + noise(amplitude);
+  return (v < JMINVALUE) ? JMINVALUE : ((v > JMAXVALUE) ? JMAXVALUE : v);
+}
+
+static bool calibrate(JOG_CURVE &curve, int center, int amplitude)
+{
+  int samples[32];
+  for (int i = 0; i < 32; i++)
+  {
+    samples[i] = adc(center, amplitude);
+  }
+  return curve.calibrate(samples, 32);
+}
+
+
+// ----------------------------------------------------------------------
+// TESTS
+// ----------------------------------------------------------------------
+static void test_calibration(void)
+{
+  JOG_CURVE curve;
+  bool ok = calibrate(curve, 1900, 15);
+  check(ok == true, "calibration: centered stick accepted", ok);
+  check(abs(curve.get_center() - 1900) <= 15, "calibration: center", curve.get_center());
+  check(curve.get_noise() <= 30, "calibration: noise", curve.get_noise());
+  check(curve.get_deadzone() >= JOG_DEADZONEMIN, "calibration: deadzone minimum", curve.get_deadzone());
+  check(curve.get_deadzone() >= curve.get_noise() * JOG_NOISEMARGIN, "calibration: deadzone covers the noise", curve.get_deadzone());
+
+  JOG_CURVE noisy;
+  calibrate(noisy, 1900, 60);
+  check(noisy.get_deadzone() == noisy.get_noise() * JOG_NOISEMARGIN, "calibration: deadzone follows the noise", noisy.get_deadzone());
+
+  JOG_CURVE held;
+  ok = calibrate(held, JZEROPOINT + JOG_CALRANGE + 200, 10);
+  check(ok == false, "calibration: stick held over rejected", ok);
+  check(held.get_center() == JZEROPOINT, "calibration: default center", held.get_center());
+  check(held.get_deadzone() == JTHRESHOLD, "calibration: default deadzone", held.get_deadzone());
+}
+
+// noise around the center never jogs
+static void test_center(void)
+{
+  JOG_CURVE curve;
+  calibrate(curve, 1850, 20);
+  int moving = 0;
+  for (int i = 0; i < 2000; i++)
+  {
+    moving += (curve.filter(adc(1850, 20)) != 0);
+  }
+  check(moving == 0, "center: no rate from noise", moving);
+  check(curve.get_jogs() == 0, "center: no jogs", curve.get_jogs());
+  check(curve.get_samples() == 2000, "center: samples counted", curve.get_samples());
+}
+
+// stick pushed slowly to full out then held, then released
+static void test_ramp(void)
+{
+  JOG_CURVE curve;
+  calibrate(curve, 1850, 10);
+  int last = 0;
+  int first = 0;
+  bool falls = false;
+  for (int i = 0; i <= 400; i++)
+  {
+    int r = curve.filter(adc(1850 + ((JMAXVALUE - 1850) * i) / 400, 10));
+    first = ((first == 0) && (r != 0)) ? r : first;
+    // noise may move the filter output back a little, the rate follows it
+    falls = falls || (r < last - 10);
+    last = r;
+  }
+  check(first >= JOG_MINRATE, "ramp: starts at the minimum rate", first);
+  check(first < 100, "ramp: starts slow", first);
+  check(falls == false, "ramp: rate rises with the deflection", falls);
+  for (int i = 0; i < 20; i++)
+  {
+    last = curve.filter(adc(JMAXVALUE, 10));
+  }
+  // noise is clipped at the top of the adc range so the filter sits a little below it
+  check(last >= (JOG_SCALE * 99) / 100, "ramp: full deflection is full rate", last);
+  check(curve.get_jogs() == 1, "ramp: one jog", curve.get_jogs());
+
+  // released, the filter settles in a few samples
+  int settle = 0;
+  while ( (curve.filter(adc(1850, 10)) != 0) && (settle < 100) )
+  {
+    settle++;
+  }
+  check(settle < 20, "release: rate returns to 0", settle);
+}
+
+static void test_direction(void)
+{
+  JOG_CURVE curve;
+  calibrate(curve, 1850, 10);
+  int r = 0;
+  for (int i = 0; i < 20; i++)
+  {
+    r = curve.filter(adc(JMINVALUE, 10));
+  }
+  check(r <= -(JOG_SCALE * 99) / 100, "direction: full in is -full rate", r);
+}
+
+// stick held at the edge of the deadzone with noise, the jog starts once
+static void test_hysteresis(void)
+{
+  JOG_CURVE curve;
+  calibrate(curve, 1850, 10);
+  int edge = 1850 + curve.get_deadzone();
+  for (int i = 0; i < 1000; i++)
+  {
+    curve.filter(adc(edge, 12));
+  }
+  check(curve.get_jogs() <= 1, "hysteresis: noise at the edge starts one jog", curve.get_jogs());
+}
+
+// curve shape, square of the deflection
+static void test_rate(void)
+{
+  check(JOG_CURVE::rate(50, 100, 2000) == 0, "rate: inside the deadzone", JOG_CURVE::rate(50, 100, 2000));
+  check(JOG_CURVE::rate(2100, 100, 2000) == JOG_SCALE, "rate: beyond the span is limited", JOG_CURVE::rate(2100, 100, 2000));
+  int half = JOG_CURVE::rate(1050, 100, 2000);
+  check((half > 250) && (half < 275), "rate: half deflection is a quarter rate", half);
+  check(JOG_CURVE::rate(-1050, 100, 2000) == -half, "rate: symmetric", JOG_CURVE::rate(-1050, 100, 2000));
+  check(JOG_CURVE::rate(500, 600, 500) == 0, "rate: span inside the deadzone", JOG_CURVE::rate(500, 600, 500));
+}
+
+static void test_stepdelay(void)
+{
+  check(JOG_CURVE::stepdelay(1000, JOG_SCALE) == 1000, "stepdelay: full rate is the fastest delay", JOG_CURVE::stepdelay(1000, JOG_SCALE));
+  check(JOG_CURVE::stepdelay(1000, 500) == 2000, "stepdelay: half rate", JOG_CURVE::stepdelay(1000, 500));
+  check(JOG_CURVE::stepdelay(1000, -JOG_MINRATE) == 50000, "stepdelay: minimum rate in", JOG_CURVE::stepdelay(1000, -JOG_MINRATE));
+  check(JOG_CURVE::stepdelay(1000, 0) == 0, "stepdelay: stopped", JOG_CURVE::stepdelay(1000, 0));
+
+  check(JOG_CURVE::retime(0, 5000) == true, "retime: first delay", 0);
+  check(JOG_CURVE::retime(3200, 3250) == false, "retime: small change ignored", 50);
+  check(JOG_CURVE::retime(3200, 3400) == true, "retime: slower", 200);
+  check(JOG_CURVE::retime(3200, 3000) == true, "retime: faster", 200);
+
+  // the delays a ramp writes to the move timer
+  JOG_CURVE curve;
+  calibrate(curve, 1850, 10);
+  unsigned long current = 0;
+  int writes = 0;
+  for (int i = 0; i <= 420; i++)
+  {
+    int r = curve.filter(adc(1850 + ((JMAXVALUE - 1850) * ((i > 400) ? 400 : i)) / 400, 10));
+    unsigned long next = JOG_CURVE::stepdelay(1000, r);
+    if ( (r != 0) && (JOG_CURVE::retime(current, next) == true) )
+    {
+      current = next;
+      writes++;
+    }
+  }
+  check(current <= 1010 + (1010 / JOG_RETIME), "retime: ramp ends near the fastest delay", current);
+  check(writes < 200, "retime: fewer timer writes than samples", writes);
+}
+
+
+// ----------------------------------------------------------------------
+// MAIN
+// ----------------------------------------------------------------------
+int main(void)
+{
+  test_calibration();
+  test_center();
+  test_ramp();
+  test_direction();
+  test_hysteresis();
+  test_rate();
+  test_stepdelay();
+  printf("jog curve: %d checks, %d failed\n", checks, failures);
+  return (failures == 0) ? 0 : 1;
+}
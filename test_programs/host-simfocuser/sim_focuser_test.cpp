@@ -0,0 +1,444 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 SIMULATED FOCUSER HOST TEST
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// sim_focuser_test.cpp
+// ----------------------------------------------------------------------
+// Runs on the pc, not the ESP32. The firmware is linked as it is, moves
+// are made by setting ftargetPosition and calling focuser_update(), the
+// state engine of loop(), on the HAL virtual clock. SIM_FOCUSER is moved
+// by the step and dir pins written by DRIVER_BOARD, from the move timer
+// isr and the backlash and home switch steps. The checks are the final
+// position, backlash compensation, homing, halt, step loss, StallGuard
+// and move duration for each motor speed and step mode.
+//
+// CONTROLLER_DATA runs on the host MemoryFS, each rig starts from the
+// default configuration with a board from data/boards. setup() is not
+// called, so no servers are started. ArduinoJson is the library
+// installed for the Arduino IDE.
+//
+// Build and run from this folder
+//   g++ -std=gnu++17 -O1 -I../../myfp2esp32F/host -I../../myfp2esp32F -I<ArduinoJson>/src
+//       sim_focuser_test.cpp ../../myfp2esp32F/*.cpp ../../myfp2esp32F/host/*.cpp
+//       -x c++ ../../myfp2esp32F/myfp2esp32F.ino -o sim_focuser_test
+//   ./sim_focuser_test
+// Returns 0 if all checks pass
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Arduino.h"
+#include "hal.h"
+#include "file_system_memory.h"
+#include "controller_config.h"
+#include "controller_data.h"
+#include "driver_board.h"
+#include "task_scheduler.h"
+#include "loop_profiler.h"
+#include "sim_focuser.h"
+
+
+// ----------------------------------------------------------------------
+// FIRMWARE
+// ----------------------------------------------------------------------
+// myfp2esp32F.ino
+extern TASK_SCHEDULER     *tasksched;
+extern LOOP_PROFILER      *looprof;
+extern CONTROLLER_DATA    *ControllerData;
+extern DRIVER_BOARD       *driverboard;
+extern long               ftargetPosition;
+extern bool               isMoving;
+extern volatile bool      halt_alert;
+extern enum Display_Types displaytype;
+
+void driverboard_start(void);
+bool focuser_update(void);
+
+
+// ----------------------------------------------------------------------
+// BOARD
+// ----------------------------------------------------------------------
+// data/boards/44.jsn [DRV8825] and 57.jsn [TMC2209]
+#define T_DRV8825         "{ \"board\":\"PRO2ESP32DRV8825\",\"maxstepmode\":32,\"stepmode\":1,\"enpin\":14,\"steppin\":33,\"dirpin\":32,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":44,\"stepsrev\":-1,\"fixedsmode\":-1,\"brdpins\":[27,26,25,-1],\"msdelay\":4000 }"
+#define T_TMC2209         "{ \"board\":\"PRO2ES32PTMC2209\",\"maxstepmode\":256,\"stepmode\":4,\"enpin\":14,\"steppin\":33,\"dirpin\":32,\"temppin\":13,\"hpswpin\":4,\"inledpin\":18,\"outledpin\":19,\"pb1pin\":34,\"pb2pin\":35,\"irpin\":15,\"brdnum\":57,\"stepsrev\":-1,\"fixedsmode\":-1,\"brdpins\":[27,26,4,-1],\"msdelay\":1200 }"
+#define T_STEPPIN         33
+#define T_DIRPIN          32
+#define T_ENABLEPIN       14
+#define T_HPSWPIN         4
+#define T_DRV8825DELAY    4000
+#define T_TMC2209DELAY    1200
+#define T_ENABLEDELAY     1000              // enablemotor(), called by State_Idle, State_InitMove and initmove()
+
+#define T_POLL            100               // us between loop() calls
+#define T_MAXPOLLS        4000000           // a move which does not end is a fail
+
+
+// ----------------------------------------------------------------------
+// CHECKS
+// ----------------------------------------------------------------------
+static int checks = 0;
+static int failures = 0;
+
+static void check(bool ok, const char *what, long value)
+{
+  checks++;
+  if ( ok == false )
+  {
+    failures++;
+    printf("FAIL %s [%ld]\n", what, value);
+  }
+}
+
+
+// ----------------------------------------------------------------------
+// RIG
+// ----------------------------------------------------------------------
+static SIM_FOCUSER sim;
+
+static sim_config rig_config(void)
+{
+  sim_config cfg = { T_STEPPIN, T_DIRPIN, T_ENABLEPIN, T_HPSWPIN, false, false, 1, 0, 0, -1000000, -1000000, 0, 0 };
+  return cfg;
+}
+
+// the objects setup() creates for the focuser, with the controller at
+// position and the drawtube at cfg.startposition. The settings of the
+// board and the model are the same, the last move was moving in. The
+// objects of the last rig are left, the firmware never deletes them
+static void rig_begin(const char *board, const sim_config &cfg, long position)
+{
+  hal_host_reset();
+  MemoryFS.format();
+  displaytype = Type_None;
+  halt_alert = false;
+  tasksched = new TASK_SCHEDULER();
+  ControllerData = new CONTROLLER_DATA();
+  ControllerData->CreateBoardConfigfromjson(board);
+  ControllerData->set_brdstepmode(cfg.stepmode);
+  ControllerData->set_fposition(position);
+  ControllerData->set_focuserdirection(moving_in);
+  ControllerData->set_reverse_enable(cfg.reverse ? V_ENABLED : V_NOTENABLED);
+  ControllerData->set_hpswitch_enable((cfg.hpswpin >= 0) ? V_ENABLED : V_NOTENABLED);
+  ControllerData->set_stallguard_state(cfg.diag ? Use_Stallguard : Use_Physical_Switch);
+  driverboard_start();
+  sim.begin(cfg);
+}
+
+// loop(), the state engine is called every T_POLL us until the focuser
+// is at the target and stationary, returns the us taken
+static uint64_t move(long target)
+{
+  uint64_t start = hal_host_clock();
+  long polls = 0;
+  ftargetPosition = target;
+  do
+  {
+    hal_host_advance(T_POLL);
+    polls++;
+  } while ( (focuser_update() == false) && (polls < T_MAXPOLLS) );
+  check(polls < T_MAXPOLLS, "move: focuser stationary", target);
+  return hal_host_clock() - start;
+}
+
+static long position(void)
+{
+  return driverboard->getposition();
+}
+
+
+// ----------------------------------------------------------------------
+// TESTS
+// ----------------------------------------------------------------------
+static void test_position(void)
+{
+  sim_config cfg = rig_config();
+  cfg.startposition = 5000;
+  rig_begin(T_DRV8825, cfg, 5000);
+  move(6234);
+  check(sim.position() == 6234, "position: move out", sim.position());
+  check(position() == sim.position(), "position: controller agrees out", position());
+  move(2234);
+  check(sim.position() == 2234, "position: move in", sim.position());
+  check(position() == sim.position(), "position: controller agrees in", position());
+  check(sim.steps() == 5234, "position: steps seen", sim.steps());
+  check(sim.lost() == 0, "position: no lost steps", sim.lost());
+  check(isMoving == false, "position: not moving", isMoving);
+  check(ControllerData->get_fposition() == 2234, "position: saved position", ControllerData->get_fposition());
+
+  // reverse direction setting, the dir pin is inverted for both
+  cfg.reverse = true;
+  rig_begin(T_DRV8825, cfg, 5000);
+  move(5100);
+  check(sim.position() == 5100, "position: reverse move out", sim.position());
+  move(4900);
+  check(sim.position() == 4900, "position: reverse move in", sim.position());
+}
+
+static void test_backlash(void)
+{
+  const long bl = 30;
+  sim_config cfg = rig_config();
+  cfg.startposition = 5000;
+  cfg.backlash = bl;
+
+  // no compensation, the drawtube stops short by the backlash
+  rig_begin(T_DRV8825, cfg, 5000);
+  move(5500);
+  move(5300);
+  move(5500);
+  check(position() - sim.position() == bl, "backlash: uncompensated error", position() - sim.position());
+
+  // compensated, the backlash steps on a change of direction do not
+  // change the position and the drawtube ends at the target
+  rig_begin(T_DRV8825, cfg, 5000);
+  ControllerData->set_backlash_in_enable(V_ENABLED);
+  ControllerData->set_backlash_out_enable(V_ENABLED);
+  ControllerData->set_backlashsteps_in(bl);
+  ControllerData->set_backlashsteps_out(bl);
+  move(5500);
+  check(sim.position() == 5500, "backlash: compensated moving out", sim.position());
+  check(sim.steps() == 500 + bl, "backlash: steps out", sim.steps());
+  move(5300);
+  check(sim.position() == 5300, "backlash: compensated moving in", sim.position());
+  check(sim.slack() == 0, "backlash: slack taken up moving in", sim.slack());
+  move(5200);
+  check(sim.position() == 5200, "backlash: no backlash steps in the same direction", sim.position());
+  move(5500);
+  check(sim.position() == 5500, "backlash: compensated after a change of direction", sim.position());
+  check(sim.slack() == bl, "backlash: slack taken up moving out", sim.slack());
+  check(position() == 5500, "backlash: controller position", position());
+
+  // graphic display, moving out the backlash steps are full steps and
+  // the drawtube ends on a full step past the target. Moving in is the
+  // main direction, the backlash steps are used as they are
+  for (long sm = 2; sm <= 32; sm *= 2)
+  {
+    cfg.stepmode = (int) sm;
+    cfg.backlash = bl * sm;
+    cfg.startposition = 5000 * sm;
+    rig_begin(T_DRV8825, cfg, cfg.startposition);
+    displaytype = Type_Graphic;
+    ControllerData->set_backlash_in_enable(V_ENABLED);
+    ControllerData->set_backlash_out_enable(V_ENABLED);
+    ControllerData->set_backlashsteps_in(bl);
+    ControllerData->set_backlashsteps_out(bl);
+    move(position() + (500 * sm) + (sm / 2));
+    long error = sim.position() - position();
+    check((error > 0) && (error <= sm), "backlash: graphic moving out error", error);
+    check((sim.position() % sm) == 0, "backlash: graphic moving out ends on a full step", sim.position());
+    check(sim.slack() == bl * sm, "backlash: graphic slack taken up moving out", sim.slack());
+    uint32_t steps = sim.steps();
+    move(position() - (200 * sm));
+    check(sim.steps() - steps == (uint32_t) ((200 * sm) + bl), "backlash: graphic moving in steps", sim.steps() - steps);
+  }
+}
+
+static void test_homing(void)
+{
+  sim_config cfg = rig_config();
+  cfg.homeposition = 0;
+  cfg.minposition = -50;
+  cfg.startposition = 2880;
+
+  // the controller position has drifted 120 steps from the drawtube, the
+  // switch closes before the controller reaches 0
+  rig_begin(T_DRV8825, cfg, 3000);
+  move(0);
+  check(sim.home() == false, "homing: switch open after the home search", sim.position());
+  check(sim.position() == 1, "homing: one step out from the switch", sim.position());
+  check(position() == 0, "homing: position set at the switch", position());
+  check(ftargetPosition == 0, "homing: target set at the switch", ftargetPosition);
+  check(sim.steps() == 2881, "homing: steps in and out", sim.steps());
+  move(1000);
+  check(sim.position() - position() == 1, "homing: drift removed", sim.position() - position());
+
+  // the switch does not close at controller 0, the drawtube is left
+  // where it is
+  cfg.startposition = 3120;
+  rig_begin(T_DRV8825, cfg, 3000);
+  move(0);
+  check(sim.position() == 120, "homing: switch open at controller 0", sim.position());
+  check(position() == 0, "homing: controller at 0", position());
+
+  // the switch is closed at the start of a move in, hpsw_alert() is
+  // false moving out so the home search ends after one step
+  cfg.hpswpin = -1;
+  cfg.startposition = 100;
+  rig_begin(T_DRV8825, cfg, 100);
+  ControllerData->set_hpswitch_enable(V_ENABLED);
+  hal_host_setpin(T_HPSWPIN, 0);
+  move(50);
+  check(sim.steps() == 1, "homing: one step out with the switch closed", sim.steps());
+  check(position() == 0, "homing: position set with the switch closed", position());
+}
+
+static void test_halt(void)
+{
+  sim_config cfg = rig_config();
+  cfg.startposition = 1000;
+  rig_begin(T_DRV8825, cfg, 1000);
+  ftargetPosition = 6000;
+  while ( sim.position() < 1300 )
+  {
+    hal_host_advance(T_POLL);
+    focuser_update();
+  }
+  // halt, as the tcpip and web servers do
+  halt_alert = true;
+  move(ftargetPosition);
+  long at = sim.position();
+  check((at >= 1300) && (at <= 1301), "halt: steps before the halt", at);
+  check(position() == at, "halt: controller agrees", position());
+  check(ftargetPosition == at, "halt: target set to the position", ftargetPosition);
+  check(halt_alert == false, "halt: alert cleared", halt_alert);
+  hal_host_advance(100 * T_DRV8825DELAY);
+  check(sim.position() == at, "halt: no steps after", sim.position());
+}
+
+// every motor speed and step mode, DRV8825 and TMC2209 step delays
+static void test_duration(void)
+{
+  for (int board = 0; board < 2; board++)
+  {
+    for (int speed = 0; speed <= 2; speed++)
+    {
+      for (long sm = 1; sm <= 32; sm *= 2)
+      {
+        // get_stepdelay(), TMC boards divide the board delay by the step mode
+        uint32_t stepdelay = (board == 0) ? T_DRV8825DELAY : (T_TMC2209DELAY / sm);
+        // initmove(), slow is 3x and medium 2x the delay
+        stepdelay *= (speed == 0) ? 3 : ((speed == 1) ? 2 : 1);
+        long steps = 100 * sm;
+        sim_config cfg = rig_config();
+        cfg.stepmode = (int) sm;
+        cfg.pullout = 1000;
+        cfg.startposition = 0;
+        rig_begin((board == 0) ? T_DRV8825 : T_TMC2209, cfg, 0);
+        ControllerData->set_motorspeed(speed);
+        uint64_t start = hal_host_clock();
+        move(steps);
+        uint32_t duration = sim.last_step() - sim.first_step();
+        check(duration == (uint32_t) (steps - 1) * stepdelay, "duration: first to last step", duration);
+        check(sim.first_step() - start == (2 * T_POLL) + (3 * T_ENABLEDELAY) + stepdelay, "duration: first step", sim.first_step() - start);
+        check(sim.position() == steps, "duration: position", sim.position());
+        check(sim.lost() == 0, "duration: no lost steps below pull-out", sim.lost());
+      }
+    }
+  }
+}
+
+static void test_pullout(void)
+{
+  sim_config cfg = rig_config();
+  cfg.pullout = 500;
+  cfg.stepmode = 4;
+  // TMC2209 fast at 1/4 steps is 300us, 833 full steps per second
+  rig_begin(T_TMC2209, cfg, 0);
+  move(400);
+  check(sim.lost() == 399, "pullout: steps above pull-out are lost", sim.lost());
+  check(sim.position() == 1, "pullout: only the first step moved", sim.position());
+  check(position() - sim.position() == 399, "pullout: controller position is wrong", position() - sim.position());
+  // slow, 900us is 277 full steps per second
+  rig_begin(T_TMC2209, cfg, 0);
+  ControllerData->set_motorspeed(0);
+  move(400);
+  check(sim.lost() == 0, "pullout: slow move below pull-out", sim.lost());
+}
+
+static void test_stallguard(void)
+{
+  sim_config cfg = rig_config();
+  cfg.stepmode = 4;
+  cfg.pullout = 1000;
+  cfg.sgthrs = 30;                        // stall below 60
+  cfg.diag = true;
+  cfg.minposition = 0;
+  cfg.startposition = 400;
+
+  // SG_RESULT falls with speed
+  rig_begin(T_TMC2209, cfg, 400);
+  ControllerData->set_motorspeed(0);
+  move(450);
+  int slow = sim.stallguard();
+  ControllerData->set_motorspeed(2);
+  move(500);
+  int fast = sim.stallguard();
+  check((slow > fast) && (fast > SIM_SGFLOOR), "stallguard: reading falls with speed", slow - fast);
+  check(sim.stalled() == false, "stallguard: no stall while moving", sim.stalled());
+
+  // homing on the hard stop, the controller is 1000 steps out. The DIAG
+  // output ends the move, the home search step out follows at once so it
+  // is lost as well and the position is set to 0 at the stop
+  rig_begin(T_TMC2209, cfg, 1400);
+  move(0);
+  check(sim.stalled() == true, "stallguard: stalled", sim.stalled());
+  check(sim.position() == 0, "stallguard: at the hard stop", sim.position());
+  check(sim.lost() == 2, "stallguard: step lost against the stop and the step out", sim.lost());
+  check(sim.steps() == 402, "stallguard: steps to the stop and out", sim.steps());
+  check(position() == 0, "stallguard: position set at the stop", position());
+
+  // SGTHRS of 0 never stalls
+  cfg.sgthrs = 0;
+  rig_begin(T_TMC2209, cfg, 450);
+  move(0);
+  check(sim.stalled() == false, "stallguard: SGTHRS 0 is off", sim.stalled());
+  check(sim.lost() == 50, "stallguard: steps lost against the stop", sim.lost());
+}
+
+// the same run twice gives the same result
+static void run_sequence(long result[6])
+{
+  sim_config cfg = rig_config();
+  cfg.stepmode = 8;
+  cfg.backlash = 17;
+  cfg.pullout = 600;
+  cfg.sgthrs = 10;
+  cfg.startposition = 2000;
+  rig_begin(T_TMC2209, cfg, 2000);
+  ControllerData->set_motorspeed(2);
+  move(2800);
+  ControllerData->set_motorspeed(1);
+  move(2500);
+  ControllerData->set_motorspeed(0);
+  move(2800);
+  result[0] = sim.position();
+  result[1] = sim.motor();
+  result[2] = sim.lost();
+  result[3] = sim.stallguard();
+  result[4] = sim.first_step();
+  result[5] = sim.last_step();
+}
+
+static void test_repeat(void)
+{
+  long a[6];
+  long b[6];
+  run_sequence(a);
+  run_sequence(b);
+  bool same = true;
+  for (int i = 0; i < 6; i++)
+  {
+    same = same && (a[i] == b[i]);
+  }
+  check(same == true, "repeat: same result", a[0] - b[0]);
+  check(a[2] > 0, "repeat: sequence includes lost steps", a[2]);
+}
+
+
+// ----------------------------------------------------------------------
+// MAIN
+// ----------------------------------------------------------------------
+int main(void)
+{
+  MemoryFS.begin();
+  looprof = new LOOP_PROFILER();
+  test_position();
+  test_backlash();
+  test_homing();
+  test_halt();
+  test_duration();
+  test_pullout();
+  test_stallguard();
+  test_repeat();
+  sim.end();
+  printf("sim focuser: %d checks, %d failed\n", checks, failures);
+  return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+// ----------------------------------------------------------------------
+// myFP2ESP32 TASK SCHEDULER HOST TEST
+// © Copyright Robert Brown 2020-2022. All Rights Reserved.
+// task_scheduler_test.cpp
+// ----------------------------------------------------------------------
+// Runs on the pc, not the ESP32. Runs TASK_SCHEDULER on the HAL virtual
+// clock, its wakeup timer is the host timer 2, and checks the times the
+// periodic and one-shot jobs are called against their periods. loop()
+// is modelled by calling run() after each 1ms of the clock.
+//
+// Build and run from this folder
+//   g++ -std=gnu++17 -Wall -I../../myfp2esp32F/host -I../../myfp2esp32F task_scheduler_test.cpp
+//       ../../myfp2esp32F/task_scheduler.cpp ../../myfp2esp32F/hal.cpp ../../myfp2esp32F/host/arduino.cpp
+//       ../../myfp2esp32F/host/wstring.cpp ../../myfp2esp32F/host/stream.cpp -o task_scheduler_test
+//   ./task_scheduler_test
+// Returns 0 if all checks pass
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Arduino.h"
+#include "hal.h"
+#include "task_scheduler.h"
+
+
+// ----------------------------------------------------------------------
+// CHECKS
+// ----------------------------------------------------------------------
+static int checks = 0;
+static int failures = 0;
+
+static void check(bool ok, const char *what, long value)
+{
+  checks++;
+  if ( ok == false )
+  {
+    failures++;
+    printf("FAIL %s [%ld]\n", what, value);
+  }
+}
+
+
+// ----------------------------------------------------------------------
+// JOBS
+// ----------------------------------------------------------------------
+// each job records the ms of the clock when it is called
+#define T_MAXCALLS        64
+
+struct t_job
+{
+  int  id;
+  int  calls;
+  long at[T_MAXCALLS];
+};
+
+static TASK_SCHEDULER *ts;
+static t_job job_a, job_b, job_c, job_d, job_e;
+
+static void record(t_job &job)
+{
+  if ( job.calls < T_MAXCALLS )
+  {
+    job.at[job.calls] = (long) (hal_host_clock() / 1000);
+  }
+  job.calls++;
+}
+
+static void call_a(void)
+{
+  record(job_a);
+}
+
+static void call_b(void)
+{
+  record(job_b);
+}
+
+static void call_c(void)
+{
+  record(job_c);
+}
+
+static void call_d(void)
+{
+  record(job_d);
+}
+
+// stops itself on the third call
+static void call_e(void)
+{
+  record(job_e);
+  if ( job_e.calls == 3 )
+  {
+    ts->stop(job_e.id);
+  }
+}
+
+static void reset(void)
+{
+  hal_host_reset();
+  delete ts;
+  ts = new TASK_SCHEDULER();
+  job_a = job_b = job_c = job_d = job_e = t_job();
+}
+
+// advance the clock by ms, run() after each ms as loop() does
+static void run_for(long ms)
+{
+  for (long i = 0; i < ms; i++)
+  {
+    hal_host_advance(1000);
+    ts->run();
+  }
+}
+
+// call n of the job is at first + n * period, at most a tick late
+static void check_calls(t_job &job, const char *name, long first, long period, int expected)
+{
+  char what[64];
+  snprintf(what, sizeof(what), "%s: number of calls", name);
+  check(job.calls == expected, what, job.calls);
+  for (int n = 0; (n < job.calls) && (n < T_MAXCALLS); n++)
+  {
+    long late = job.at[n] - (first + (n * period));
+    snprintf(what, sizeof(what), "%s: call %d time", name, n);
+    check((late >= 0) && (late <= SCHED_TICK), what, job.at[n]);
+  }
+}
+
+
+// ----------------------------------------------------------------------
+// TESTS
+// ----------------------------------------------------------------------
+// periods shorter than, equal to a multiple of and longer than one turn
+// of the wheel
+static void test_periodic(void)
+{
+  reset();
+  job_a.id = ts->add("a", call_a, 100, SCHED_PERIODIC);
+  job_b.id = ts->add("b", call_b, 250, SCHED_PERIODIC);
+  job_c.id = ts->add("c", call_c, 1280, SCHED_PERIODIC);
+  job_d.id = ts->add("d", call_d, 2000, SCHED_PERIODIC);
+  check(job_a.id == 0, "periodic: first id", job_a.id);
+  check(job_d.id == 3, "periodic: last id", job_d.id);
+  ts->begin();
+  ts->start(job_a.id);
+  ts->start(job_b.id);
+  ts->start(job_c.id);
+  ts->start(job_d.id);
+  run_for(5005);
+
+  check_calls(job_a, "periodic 100ms", 100, 100, 50);
+  check_calls(job_b, "periodic 250ms", 250, 250, 20);
+  check_calls(job_c, "periodic 1280ms", 1280, 1280, 3);
+  check_calls(job_d, "periodic 2000ms", 2000, 2000, 2);
+  check(ts->armed(job_a.id) == true, "periodic: still armed", 0);
+}
+
+static void test_oneshot(void)
+{
+  reset();
+  job_a.id = ts->add("a", call_a, 300, SCHED_ONESHOT);
+  job_b.id = ts->add("b", call_b, 1000, SCHED_ONESHOT);
+  job_c.id = ts->add("c", call_c, 3000, SCHED_ONESHOT);
+  ts->begin();
+  ts->start(job_a.id);
+  ts->start(job_b.id, 50);                // deadline given in the call
+  ts->start(job_c.id);
+  run_for(4000);
+
+  check_calls(job_a, "one-shot 300ms", 300, 0, 1);
+  check_calls(job_b, "one-shot 50ms", 50, 0, 1);
+  check_calls(job_c, "one-shot 3000ms", 3000, 0, 1);
+  check(ts->armed(job_a.id) == false, "one-shot: disarmed after the call", 0);
+
+  // armed again, from the time of the start
+  ts->start(job_a.id);
+  run_for(1000);
+  check(job_a.calls == 2, "one-shot: second start calls", job_a.calls);
+  check(job_a.at[1] - 4000 == 300, "one-shot: second start time", job_a.at[1]);
+}
+
+static void test_stop_restart(void)
+{
+  reset();
+  job_a.id = ts->add("a", call_a, 200, SCHED_PERIODIC);
+  job_b.id = ts->add("b", call_b, 500, SCHED_ONESHOT);
+  job_e.id = ts->add("e", call_e, 100, SCHED_PERIODIC);
+  ts->begin();
+  ts->start(job_a.id);
+  ts->start(job_b.id);
+  ts->start(job_e.id);
+
+  // restart moves the deadline, start leaves an armed job as it is
+  run_for(300);
+  ts->restart(job_b.id);
+  ts->start(job_a.id);
+  run_for(1000);
+  check_calls(job_b, "restart one-shot", 800, 0, 1);
+  check(job_a.calls == 6, "start armed job: calls", job_a.calls);
+  check_calls(job_e, "stop from the callback", 100, 100, 3);
+
+  // a stopped job is not called, the timer is off with nothing armed
+  ts->stop(job_a.id);
+  run_for(1000);
+  check(job_a.calls == 6, "stop: calls", job_a.calls);
+  check(ts->armed(job_a.id) == false, "stop: armed", 0);
+
+  // a new period is used from the next start
+  ts->set_period(job_a.id, 50);
+  ts->start(job_a.id);
+  run_for(500);
+  check(job_a.calls == 16, "set_period: calls", job_a.calls);
+  check(job_a.at[6] - 2300 == 50, "set_period: first call", job_a.at[6]);
+}
+
+// loop() is late, the missed runs are one call and the period starts
+// again from it
+static void test_late_loop(void)
+{
+  reset();
+  job_a.id = ts->add("a", call_a, 100, SCHED_PERIODIC);
+  ts->begin();
+  ts->start(job_a.id);
+  run_for(150);
+  hal_host_advance(330000);               // loop() blocked for 330ms
+  ts->run();
+  run_for(200);
+  // 100, then once at 480 for 200 - 400, then 580, 680
+  check(job_a.calls == 4, "late loop: calls", job_a.calls);
+  check(job_a.at[1] == 480, "late loop: late call", job_a.at[1]);
+  check(job_a.at[2] == 580, "late loop: period from the late call", job_a.at[2]);
+  check(job_a.at[3] == 680, "late loop: next call", job_a.at[3]);
+}
+
+
+// ----------------------------------------------------------------------
+// MAIN
+// ----------------------------------------------------------------------
+int main(void)
+{
+  test_periodic();
+  test_oneshot();
+  test_stop_restart();
+  test_late_loop();
+
+  printf("task scheduler: %d checks, %d failed\n", checks, failures);
+  return (failures == 0) ? 0 : 1;
+}
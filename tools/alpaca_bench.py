@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+# ----------------------------------------------------------------------
+# myFP2ESP32 ASCOM ALPACA LOAD BENCHMARK
+# © Copyright Robert Brown 2014-2022. All Rights Reserved.
+# alpaca_bench.py
+# ----------------------------------------------------------------------
+# Runs several simulated Alpaca clients against the ASCOM server of a
+# controller and reports throughput, latency and errors [no reply, http
+# status, bad json, ErrorNumber not 0]. Replies are also checked against
+# the Alpaca api, ClientTransactionID echoed, ServerTransactionID present,
+# unique and increasing, keys named as the api reference; differences
+# are listed as conformance problems and do not count as errors.
+#
+#   python3 tools/alpaca_bench.py --host 192.168.4.1
+#   python3 tools/alpaca_bench.py --host 192.168.4.1 --clients nina=2,phd2=1 --duration 120
+#   python3 tools/alpaca_bench.py --host 192.168.4.1 --flat --nomove
+#
+# Clients
+#   nina       position and ismoving 1s, temperature 5s, autofocus move
+#              every 30s then ismoving at 200ms until stopped
+#   sgp        position, ismoving and temperature 2s, halt after some moves
+#   phd2       ismoving and position 250ms
+#   discovery  alpaca udp discovery every 5s
+#
+# The move client moves the focuser by up to --movesize steps either side
+# of the position at the start, use --nomove to only poll.
+# ----------------------------------------------------------------------
+
+import argparse
+import http.client
+import json
+import random
+import socket
+import sys
+import threading
+import time
+import urllib.parse
+
+DISCOVERY = b"alpacadiscovery1"
+BASE = "/api/v1/focuser/0/"
+
+
+class Results:
+    """Samples from all clients, shared between the client threads"""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.samples = {}                 # endpoint, list of latency us
+        self.errors = {}                  # endpoint, count
+        self.problems = {}                # description, count
+        self.conformance = {}             # description, count
+        self.transactions = []            # server transaction id, time the reply was received
+
+    def add(self, endpoint, us, error=None, stid=None, received=None, conformance=()):
+        with self.lock:
+            self.samples.setdefault(endpoint, []).append(us)
+            if error is not None:
+                self.errors[endpoint] = self.errors.get(endpoint, 0) + 1
+                self.problems[error] = self.problems.get(error, 0) + 1
+            if stid is not None:
+                self.transactions.append((received, stid))
+            for text in conformance:
+                self.conformance[text] = self.conformance.get(text, 0) + 1
+
+
+class Client(threading.Thread):
+    """One simulated client, with its own ClientID and connection"""
+
+    def __init__(self, kind, clientid, args, results, stop):
+        threading.Thread.__init__(self, daemon=True)
+        self.kind = kind
+        self.clientid = clientid
+        self.args = args
+        self.results = results
+        self.stop = stop
+        self.ctid = 0
+        self.conn = None
+        self.rand = random.Random(clientid)
+
+    def request(self, method, name, params=None):
+        """Returns the json reply or None on an error"""
+        self.ctid += 1
+        fields = {"ClientID": self.clientid, "ClientTransactionID": self.ctid}
+        fields.update(params or {})
+        query = urllib.parse.urlencode(fields)
+        path = BASE + name
+        body = None
+        headers = {"Accept": "application/json"}
+        if method == "GET":
+            path += "?" + query
+        else:
+            body = query
+            headers["Content-Type"] = "application/x-www-form-urlencoded"
+        start = time.monotonic()
+        try:
+            if self.conn is None:
+                self.conn = http.client.HTTPConnection(self.args.host, self.args.port, timeout=self.args.timeout)
+            self.conn.request(method, path, body, headers)
+            resp = self.conn.getresponse()
+            data = resp.read()
+        except (OSError, http.client.HTTPException) as e:
+            self.conn.close()
+            self.conn = None
+            self.results.add(name, (time.monotonic() - start) * 1e6, "%s: %s" % (name, type(e).__name__))
+            return None
+        received = time.monotonic()
+        us = (received - start) * 1e6
+        if resp.status != 200:
+            self.results.add(name, us, "%s: http %d" % (name, resp.status))
+            return None
+        try:
+            reply = json.loads(data)
+        except ValueError:
+            self.results.add(name, us, "%s: bad json" % name)
+            return None
+        # keys are looked up without case, the api names are checked below
+        keys = dict((k.lower(), k) for k in reply)
+        field = dict((k.lower(), v) for k, v in reply.items())
+        conformance = []
+        for key in ("ClientTransactionID", "ServerTransactionID", "ErrorNumber", "ErrorMessage") \
+                + (("Value",) if method == "GET" else ()):
+            if key.lower() not in keys:
+                conformance.append("%s: no %s" % (name, key))
+            elif keys[key.lower()] != key:
+                conformance.append("%s: %s named %s" % (name, key, keys[key.lower()]))
+        if "clienttransactionid" in field and field["clienttransactionid"] != self.ctid:
+            conformance.append("%s: ClientTransactionID not echoed" % name)
+        stid = field.get("servertransactionid")
+        stid = stid if isinstance(stid, int) else None
+        error = None
+        try:
+            errornumber = int(field.get("errornumber", 0))
+        except (TypeError, ValueError):
+            errornumber = -1
+        if errornumber != 0:
+            error = "%s: ErrorNumber %s %s" % (name, field.get("errornumber"), field.get("errormessage"))
+        elif method == "GET" and "value" not in field:
+            error = "%s: no value" % name
+        self.results.add(name, us, error, stid, received, conformance)
+        return field if error is None else None
+
+    def sleep(self, seconds):
+        if not self.args.flat:
+            self.stop.wait(seconds / self.args.rate)
+
+    def value(self, name):
+        reply = self.request("GET", name)
+        return None if reply is None else reply.get("value")
+
+    def move(self, home):
+        if self.args.nomove:
+            return
+        target = max(0, home + self.rand.randint(-self.args.movesize, self.args.movesize))
+        self.request("PUT", "move", {"Position": target})
+
+    def wait_move(self, poll):
+        deadline = time.monotonic() + 60
+        while not self.stop.is_set() and time.monotonic() < deadline:
+            if self.value("ismoving") is not True:
+                return
+            self.sleep(poll)
+
+    def run(self):
+        if self.kind == "discovery":
+            self.run_discovery()
+            return
+        self.request("PUT", "connected", {"Connected": "true"})
+        home = self.value("position") or 0
+        tick = 0
+        while not self.stop.is_set():
+            if self.kind == "nina":
+                self.value("position")
+                self.value("ismoving")
+                if tick % 5 == 0:
+                    self.value("temperature")
+                if tick % 30 == 29:
+                    self.move(home)
+                    self.wait_move(0.2)
+                self.sleep(1.0)
+            elif self.kind == "sgp":
+                self.value("position")
+                self.value("ismoving")
+                self.value("temperature")
+                if tick % 20 == 19:
+                    self.move(home)
+                    self.sleep(0.5)
+                    if tick % 40 == 39:
+                        self.request("PUT", "halt")
+                self.sleep(2.0)
+            else:
+                self.value("ismoving")
+                self.value("position")
+                self.sleep(0.25)
+            tick += 1
+        if self.conn is not None:
+            self.conn.close()
+
+    def run_discovery(self):
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.settimeout(self.args.timeout)
+        while not self.stop.is_set():
+            start = time.monotonic()
+            error = None
+            conformance = []
+            try:
+                sock.sendto(DISCOVERY, (self.args.host, self.args.discoveryport))
+                data, _ = sock.recvfrom(256)
+                reply = json.loads(data)
+                field = dict((k.lower(), v) for k, v in reply.items())
+                if field.get("alpacaport") != self.args.port:
+                    error = "discovery: wrong port"
+                elif "AlpacaPort" not in reply:
+                    conformance = ["discovery: AlpacaPort named %s" % list(reply)[0]]
+            except (OSError, ValueError, AttributeError) as e:
+                error = "discovery: %s" % type(e).__name__
+            self.results.add("discovery", (time.monotonic() - start) * 1e6, error, conformance=conformance)
+            self.sleep(5.0)
+        sock.close()
+
+
+def percentile(values, p):
+    values = sorted(values)
+    i = min(len(values) - 1, int(round(p / 100.0 * (len(values) - 1))))
+    return values[i]
+
+
+def report(results, elapsed):
+    total = sum(len(v) for v in results.samples.values())
+    errors = sum(results.errors.values())
+    print("%d requests in %.1f s, %.1f req/s, %d errors [%.2f%%]\n"
+          % (total, elapsed, total / elapsed, errors, 100.0 * errors / total if total else 0))
+    print("  %-12s%8s%8s%10s%10s%10s%10s" % ("endpoint", "count", "errors", "p50 ms", "p90 ms", "p99 ms", "max ms"))
+    for name in sorted(results.samples):
+        v = results.samples[name]
+        print("  %-12s%8d%8d%10.1f%10.1f%10.1f%10.1f"
+              % (name, len(v), results.errors.get(name, 0), percentile(v, 50) / 1e3,
+                 percentile(v, 90) / 1e3, percentile(v, 99) / 1e3, max(v) / 1e3))
+    print()
+
+    # requests are served one at a time, so in order of reply the server
+    # transaction ids should increase
+    ids = [stid for _, stid in sorted(results.transactions)]
+    repeats = len(ids) - len(set(ids))
+    backwards = sum(1 for a, b in zip(ids, ids[1:]) if b <= a)
+    print("ServerTransactionID: %d replies, %d repeated, %d not increasing" % (len(ids), repeats, backwards))
+    for title, table in (("errors", results.problems), ("conformance", results.conformance)):
+        if table:
+            print("\n" + title)
+            for text, count in sorted(table.items(), key=lambda x: -x[1]):
+                print("  %6d  %s" % (count, text))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="myFP2ESP32 ascom alpaca load benchmark")
+    parser.add_argument("--host", required=True)
+    parser.add_argument("--port", type=int, default=4040)
+    parser.add_argument("--discoveryport", type=int, default=32227)
+    parser.add_argument("--clients", default="nina=1,sgp=1,phd2=1,discovery=1", help="kind=count,...")
+    parser.add_argument("--duration", type=float, default=60.0, help="seconds")
+    parser.add_argument("--rate", type=float, default=1.0, help="poll rate multiplier")
+    parser.add_argument("--flat", action="store_true", help="no delay between requests")
+    parser.add_argument("--nomove", action="store_true", help="poll only, do not move the focuser")
+    parser.add_argument("--movesize", type=int, default=200, help="steps either side of the start position")
+    parser.add_argument("--timeout", type=float, default=5.0, help="seconds to wait for a reply")
+    args = parser.parse_args()
+
+    results = Results()
+    stop = threading.Event()
+    clients = []
+    clientid = 1
+    for item in args.clients.split(","):
+        kind, _, count = item.partition("=")
+        if kind not in ("nina", "sgp", "phd2", "discovery"):
+            sys.exit("unknown client %s" % kind)
+        for _ in range(int(count or 1)):
+            clients.append(Client(kind, clientid, args, results, stop))
+            clientid += 1
+
+    start = time.monotonic()
+    for c in clients:
+        c.start()
+    try:
+        stop.wait(args.duration)
+    except KeyboardInterrupt:
+        pass
+    stop.set()
+    for c in clients:
+        c.join(args.timeout + 1)
+    report(results, time.monotonic() - start)
+
+
+if __name__ == "__main__":
+    main()
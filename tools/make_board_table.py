@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+# ----------------------------------------------------------------------
+# myFP2ESP32 BOARD TABLE GENERATOR
+# © Copyright Robert Brown 2014-2022. All Rights Reserved.
+# make_board_table.py
+# ----------------------------------------------------------------------
+# Generates myfp2esp32F/board_table.h from myfp2esp32F/data/boards/*.jsn
+# Run this after adding or changing a board file, then rebuild
+#   python3 tools/make_board_table.py
+# ----------------------------------------------------------------------
+
+import glob
+import json
+import os
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BOARDS = os.path.join(ROOT, "myfp2esp32F", "data", "boards")
+OUTPUT = os.path.join(ROOT, "myfp2esp32F", "board_table.h")
+
+HEADER = """// ----------------------------------------------------------------------
+// myFP2ESP32 BOARD DEFINITION TABLE
+// © Copyright Robert Brown 2014-2022. All Rights Reserved.
+// board_table.h
+// ----------------------------------------------------------------------
+// GENERATED by tools/make_board_table.py from data/boards/*.jsn
+// DO NOT EDIT, change the board file and run the script again
+// ----------------------------------------------------------------------
+
+#if !defined(_board_table_h_)
+#define _board_table_h_
+
+
+// ----------------------------------------------------------------------
+// BOARD DESCRIPTOR
+// ----------------------------------------------------------------------
+// json is the original board file, a /boards/xx.jsn file which is the
+// same is not parsed, a file which differs overrides the table entry
+struct board_desc
+{
+  int brdnum;
+  const char *board;
+  int maxstepmode;
+  int stepmode;
+  int enpin;
+  int steppin;
+  int dirpin;
+  int temppin;
+  int hpswpin;
+  int inledpin;
+  int outledpin;
+  int pb1pin;
+  int pb2pin;
+  int irpin;
+  int stepsrev;
+  int fixedsmode;
+  int brdpins[4];
+  unsigned long msdelay;
+  const char *json;
+};
+
+
+// ----------------------------------------------------------------------
+// BOARD TABLE
+// ----------------------------------------------------------------------
+"""
+
+FOOTER = """
+constexpr int board_table_size = sizeof(board_table) / sizeof(board_table[0]);
+
+// index of brdnum in board_table, -1 if not found
+constexpr int board_table_index(int brdnum, int i = 0)
+{
+  return (i >= board_table_size) ? -1 : ((board_table[i].brdnum == brdnum) ? i : board_table_index(brdnum, i + 1));
+}
+
+
+
+#endif // #if !defined(_board_table_h_)
+"""
+
+FIELDS = ["maxstepmode", "stepmode", "enpin", "steppin", "dirpin", "temppin", "hpswpin",
+          "inledpin", "outledpin", "pb1pin", "pb2pin", "irpin", "stepsrev", "fixedsmode"]
+
+
+def c_string(text):
+    text = text.replace("\\", "\\\\").replace('"', '\\"')
+    return '"' + text.replace("\r", "\\r").replace("\n", "\\n") + '"'
+
+
+def main():
+    entries = []
+    for fname in glob.glob(os.path.join(BOARDS, "*.jsn")):
+        with open(fname, "r") as f:
+            text = f.read()
+        brd = json.loads(text)
+        entries.append((brd["brdnum"], os.path.basename(fname), brd, text))
+    entries.sort(key=lambda e: e[0])
+
+    lines = ["constexpr board_desc board_table[] =", "{"]
+    for brdnum, fname, brd, text in entries:
+        values = ", ".join(str(brd[k]) for k in FIELDS)
+        pins = ", ".join(str(p) for p in brd["brdpins"])
+        lines.append("  // " + fname)
+        lines.append("  { %d, %s, %s, { %s }, %d," % (brdnum, c_string(brd["board"]), values, pins, brd["msdelay"]))
+        lines.append("    " + c_string(text) + " },")
+    lines.append("};")
+
+    with open(OUTPUT, "w", newline="\n") as f:
+        f.write(HEADER + "\n".join(lines) + "\n" + FOOTER)
+    print("wrote %s, %d boards" % (OUTPUT, len(entries)))
+
+
+if __name__ == "__main__":
+    main()
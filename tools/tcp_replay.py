@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+# ----------------------------------------------------------------------
+# myFP2ESP32 TCP TRACE REPLAY
+# © Copyright Robert Brown 2014-2022. All Rights Reserved.
+# tcp_replay.py
+# ----------------------------------------------------------------------
+# Reads a trace captured by the tcp/ip server [set?tcptrace=start, then
+# set?tcptrace=stop and download http://<controller>:6060/tcptrace]
+#
+# Summary of the capture, service time and heap used on the controller
+#   python3 tools/tcp_replay.py tcptrace.bin
+#
+# Replay the commands to a controller, at the captured pace or flat out
+#   python3 tools/tcp_replay.py tcptrace.bin --host 192.168.4.1
+#   python3 tools/tcp_replay.py tcptrace.bin --host 192.168.4.1 --flat
+#
+# Move commands in the trace will move the focuser.
+# ----------------------------------------------------------------------
+
+import argparse
+import socket
+import struct
+import sys
+import time
+
+MAGIC = b"MFPT"
+VERSION = 1
+COMMAND = ord("C")
+REPLY = ord("R")
+DONE = ord("D")
+WRAP = 1 << 32
+
+
+def read_trace(path):
+    """Returns a list of commands, each a dict of time [us from the first
+    record], client, data, replies and the service time and heap used
+    recorded by the controller"""
+    with open(path, "rb") as f:
+        raw = f.read()
+    if raw[0:4] != MAGIC or raw[4] != VERSION:
+        sys.exit("%s: not a version %d trace" % (path, VERSION))
+    commands = []
+    pending = {}
+    clock = 0
+    last = None
+    pos = 5
+    while pos + 7 <= len(raw):
+        us, kind, client, length = struct.unpack_from("<IBBB", raw, pos)
+        data = raw[pos + 7:pos + 7 + length]
+        pos += 7 + length
+        # micros() wraps, the time between records is the unsigned difference
+        if last is not None:
+            clock += (us - last) % WRAP
+        last = us
+        if kind == COMMAND:
+            cmd = {"us": clock, "client": client, "data": data, "replies": 0,
+                   "service": None, "heap": None}
+            commands.append(cmd)
+            pending[client] = cmd
+        elif kind == REPLY and client in pending:
+            pending[client]["replies"] += 1
+        elif kind == DONE and client in pending:
+            service, heap = struct.unpack("<Ii", data[0:8])
+            pending[client]["service"] = service
+            pending[client]["heap"] = heap
+            del pending[client]
+    return commands
+
+
+def code(cmd):
+    return cmd["data"][1:3].decode("ascii", "replace")
+
+
+def percentile(values, p):
+    values = sorted(values)
+    i = min(len(values) - 1, int(round(p / 100.0 * (len(values) - 1))))
+    return values[i]
+
+
+def read_reply(sock, buff):
+    while b"#" not in buff:
+        chunk = sock.recv(256)
+        if not chunk:
+            raise ConnectionError("controller closed the connection")
+        buff += chunk
+    i = buff.index(b"#")
+    return buff[i + 1:]
+
+
+def replay(commands, host, port, flat, timeout):
+    """Sends each command on the connection of its client and waits for
+    the replies the controller sent in the capture. Returns the latency of
+    each command in us and the elapsed time in seconds"""
+    socks = {}
+    buffs = {}
+    latency = []
+    start = time.monotonic()
+    for cmd in commands:
+        client = cmd["client"]
+        if client not in socks:
+            socks[client] = socket.create_connection((host, port), timeout)
+            socks[client].setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            buffs[client] = b""
+        if not flat:
+            wait = start + cmd["us"] / 1e6 - time.monotonic()
+            if wait > 0:
+                time.sleep(wait)
+        sent = time.monotonic()
+        socks[client].sendall(cmd["data"])
+        for _ in range(cmd["replies"]):
+            buffs[client] = read_reply(socks[client], buffs[client])
+        latency.append((code(cmd), (time.monotonic() - sent) * 1e6))
+    elapsed = time.monotonic() - start
+    for sock in socks.values():
+        sock.close()
+    return latency, elapsed
+
+
+def print_table(title, columns, rows):
+    print(title)
+    print("  " + "".join("%10s" % c for c in columns))
+    for row in rows:
+        print("  " + "".join("%10s" % c for c in row))
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="myFP2ESP32 tcp/ip trace replay")
+    parser.add_argument("trace")
+    parser.add_argument("--host", help="controller to replay the trace to")
+    parser.add_argument("--port", type=int, default=2020)
+    parser.add_argument("--flat", action="store_true", help="send each command as soon as the last is answered")
+    parser.add_argument("--timeout", type=float, default=5.0, help="seconds to wait for a reply")
+    args = parser.parse_args()
+
+    commands = read_trace(args.trace)
+    if not commands:
+        sys.exit("%s: no commands" % args.trace)
+    span = commands[-1]["us"] / 1e6
+    codes = sorted(set(code(c) for c in commands))
+    print("%d commands, %d clients, %.1f s, %.1f cmds/s captured\n"
+          % (len(commands), len(set(c["client"] for c in commands)), span,
+             len(commands) / span if span > 0 else 0))
+
+    # measured on the controller during the capture
+    rows = []
+    for k in codes:
+        done = [c for c in commands if code(c) == k and c["service"] is not None]
+        if not done:
+            continue
+        service = [c["service"] for c in done]
+        heap = [c["heap"] for c in done]
+        rows.append((k, len(done), percentile(service, 50), percentile(service, 99), max(service),
+                     "%.0f" % (sum(heap) / float(len(heap))), max(heap)))
+    print_table("capture, service us and heap bytes held after the command",
+                ("code", "count", "p50", "p99", "max", "heap_avg", "heap_max"), rows)
+
+    if args.host is None:
+        return
+    latency, elapsed = replay(commands, args.host, args.port, args.flat, args.timeout)
+    rows = []
+    for k in codes:
+        values = [us for c, us in latency if c == k]
+        rows.append((k, len(values), "%.0f" % percentile(values, 50), "%.0f" % percentile(values, 90),
+                     "%.0f" % percentile(values, 99), "%.0f" % max(values)))
+    print_table("replay %s, latency us" % ("flat out" if args.flat else "at captured pace"),
+                ("code", "count", "p50", "p90", "p99", "max"), rows)
+    print("%d commands in %.2f s, %.1f cmds/s" % (len(latency), elapsed, len(latency) / elapsed))
+
+
+if __name__ == "__main__":
+    main()